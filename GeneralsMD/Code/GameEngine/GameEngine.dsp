@@ -341,6 +341,10 @@ SOURCE=.\Source\Common\System\Upgrade.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\Source\Common\System\WorkerPool.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\Source\Common\System\Xfer.cpp
 # End Source File
 # Begin Source File
@@ -2726,6 +2730,10 @@ SOURCE=.\Source\GameNetwork\NetCommandWrapperList.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\Source\GameNetwork\NetCompression.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\Source\GameNetwork\NetMessageStream.cpp
 # End Source File
 # Begin Source File
@@ -2738,10 +2746,18 @@ SOURCE=.\Source\GameNetwork\Network.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\Source\GameNetwork\NetworkSimulator.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\Source\GameNetwork\NetworkUtil.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\Source\GameNetwork\RunAheadController.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\Source\GameNetwork\Transport.cpp
 # End Source File
 # Begin Source File
@@ -3328,6 +3344,10 @@ SOURCE=.\Include\Common\WellKnownKeys.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\Include\Common\WorkerPool.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Include\Common\Xfer.h
 # End Source File
 # Begin Source File
@@ -5148,6 +5168,10 @@ SOURCE=.\Include\GameNetwork\NetCommandWrapperList.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\Include\GameNetwork\NetCompression.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Include\GameNetwork\NetPacket.h
 # End Source File
 # Begin Source File
@@ -5160,6 +5184,10 @@ SOURCE=.\Include\GameNetwork\NetworkInterface.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\Include\GameNetwork\NetworkSimulator.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Include\GameNetwork\NetworkUtil.h
 # End Source File
 # Begin Source File
@@ -5168,6 +5196,10 @@ SOURCE=.\Include\GameNetwork\RankPointValue.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\Include\GameNetwork\RunAheadController.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Include\GameNetwork\Transport.h
 # End Source File
 # Begin Source File
@@ -167,6 +167,7 @@ class ArchiveFileSystem : public SubsystemInterface
 
 	void					getFileListInDirectory(const AsciiString& currentDirectory, const AsciiString& originalDirectory, const AsciiString& searchName, FilenameList &filenameList, Bool searchSubdirectories) const; ///< search the given directory for files matching the searchName (egs. *.ini, *.rep).  Possibly search subdirectories.  Scans each Archive file.
 	Bool					getFileInfo(const AsciiString& filename, FileInfo *fileInfo) const; ///< see FileSystem.h
+	Bool					getArchivedFileInfo(const AsciiString& filename, ArchivedFileInfo *fileInfo) const; ///< which archive the file is in, and where in it, so it can be read without going through the archive's own file handle
 	
 	virtual Bool	loadBigFilesFromDirectory(AsciiString dir, AsciiString fileMask, Bool overwrite = FALSE) = 0;
 
@@ -178,6 +178,7 @@ public:
 	Bool m_preloadAssets;
 	Bool m_preloadEverything;			///< Preload everything, everywhere (for debugging only)
 	Bool m_preloadReport;					///< dump a log of all W3D assets that are being preloaded.
+	Int m_assetLoadThreads;				///< worker threads for reading preloaded models, 0 for none, -1 for one less than the processors
 
 	Real m_partitionCellSize;
 
@@ -229,6 +230,9 @@ public:
 	Int m_maxVisibleOccludeeObjects;
 	Int m_maxVisibleNonOccluderOrOccludeeObjects;
 	Real m_occludedLuminanceScale;
+	Bool m_useHierarchicalViewCulling;	///< cull the 3D scene against an AABTree of the render objects instead of testing every one
+	Bool m_shareAnimationPoses;		///< let copies of a skeleton playing the same animation frame share one evaluated pose
+	Int m_animationFrameCacheSize;	///< kilobytes of decoded compressed animation frames to keep around, 0 to decode every time
 
 	Int m_numGlobalLights;	//number of active global lights
 	Int m_maxRoadSegments;
@@ -329,6 +333,7 @@ public:
 
 	Int m_maxParticleCount;						///< maximum number of particles that can exist
 	Int m_maxFieldParticleCount;			///< maximum number of field-type particles that can exist (roughly)
+	Int m_particleUpdateThreads;			///< worker threads for particle updates, 0 for none, -1 for one less than the processors
 	WeaponBonusSet* m_weaponBonusSet;
 	Real m_healthBonus[LEVEL_COUNT];			///< global bonuses to health for veterancy.
 	Real m_defaultStructureRubbleHeight;	///< for rubbled structures, compress height to this if none specified
@@ -442,9 +447,12 @@ public:
 	UnsignedInt m_networkRunAheadMetricsTime;	      	///< The number of miliseconds between run ahead metrics things
 	UnsignedInt m_networkKeepAliveDelay;			      	///< The number of seconds between when the connections to each player send a keep-alive packet.
 	UnsignedInt m_networkRunAheadSlack;				      	///< The amount of slack in the run ahead value. This is the percentage of the calculated run ahead that is added.
+	UnsignedInt m_networkRunAheadMaxStep;			      	///< The most frames the run ahead can change by in one run ahead decision.
+	UnsignedInt m_networkRunAheadHysteresis;	      	///< How many frames more run ahead than we need we put up with before bringing it down.
 	UnsignedInt m_networkDisconnectTime;			      	///< The number of milliseconds between when the game gets stuck on a frame for a network stall and when the disconnect dialog comes up.
 	UnsignedInt m_networkPlayerTimeoutTime;		      	///< The number of milliseconds between when a player's last keep alive command was recieved and when they are considered disconnected from the game.
 	UnsignedInt	m_networkDisconnectScreenNotifyTime;  ///< The number of milliseconds between when the disconnect screen comes up and when the other players are notified that we are on the disconnect screen.
+	Bool				m_networkPacketPacking;								///< Should we coalesce and compress packets at the transport layer, with peers that do too?
 	
 	Real				m_keyboardCameraRotateSpeed;    ///< How fast the camera rotates when rotated via keyboard controls.
   Int					m_playStats;									///< Int whether we want to log play stats or not, if <= 0 then we don't log
@@ -503,6 +511,26 @@ public:
 	Int m_latencyPeriod;					///< Period of sinusoidal modulation of latency
 	Int m_latencyNoise;						///< Max amplitude of jitter to throw in
 	Int m_packetLoss;							///< Percent of packets to drop
+	Int m_packetBandwidth;				///< Bytes per second a simulated link can carry, 0 for unlimited
+	Int m_netSoakClients;					///< If nonzero, run the simulated network soak with this many clients and quit
+	Int m_netSoakFrames;					///< How many frames the network soak runs for
+	Int m_particleBenchmarkSystems;	///< If nonzero, run the particle benchmark with this many systems and quit
+	Int m_particleBenchmarkFrames;	///< How many frames the particle benchmark runs for
+	Bool m_viewCullBenchmark;			///< If TRUE, run the synthetic view culling benchmark and quit
+	AsciiString m_animBenchmarkModel;	///< If not empty, run the animation benchmark with this model and quit
+	AsciiString m_animBenchmarkAnim;	///< The animation the benchmark plays on the model
+	Int m_animBenchmarkCount;			///< How many copies of the model the animation benchmark animates
+	AsciiString m_collisionBenchmarkTemplate;	///< If not empty, run the collision benchmark with this unit once a map is loaded and quit
+	Int m_collisionBenchmarkUnits;	///< How many units the collision benchmark crowds together
+	Int m_collisionBenchmarkFrames;	///< How many frames the collision benchmark runs for
+	AsciiString m_barrageBenchmarkWeapon;	///< If not empty, run the barrage benchmark with this weapon once a map is loaded and quit
+	AsciiString m_barrageBenchmarkTarget;	///< The unit the barrage benchmark fires on
+	Int m_barrageBenchmarkUnits;		///< How many targets the barrage benchmark lays out
+	Int m_barrageBenchmarkShots;		///< How many shots land in each frame of the barrage benchmark
+	Int m_barrageBenchmarkFrames;		///< How many frames the barrage benchmark runs for
+	Int m_losBenchmarkQueries;			///< If nonzero, run the line of sight benchmark with this many queries once a map is loaded and quit
+	Int m_stateMachineBenchmarkFrames;	///< If nonzero, log how many state updates ran and slept over this many frames and quit
+	Int m_terrainPanBenchmarkFrames;	///< If nonzero, pan the terrain across the loaded map in this many steps, log the time, and quit
 	Bool m_extraLogging;					///< More expensive debug logging to catch crashes.
 #endif
 
@@ -452,6 +452,11 @@ public:
 	/// Get the center of the ai's base.
 	virtual Bool getAiBaseCenter(Coord3D *pos);
 
+#ifdef DUMP_PERF_STATS
+	/// Time the ai spent thinking, in msec.  Returns false if this player has no ai.
+	Bool getAiPlannerStats(double& msecThisFrame, double& msecAverage) const;
+#endif
+
 	/// Have the ai check for bridges.
 	virtual void repairStructure(ObjectID structureID);
 
@@ -107,6 +107,20 @@ inline StateReturnType MIN_SLEEP(UnsignedInt encloserSleep, StateReturnType encl
 }
 
 
+/**
+ * Things that can happen to a machine's owner while its current state sleeps.
+ * A state that wants to hear about one overrides State::wakeOnEvent(); states
+ * that don't simply sleep for as long as they asked to.
+ */
+enum StateWakeEvent
+{
+	STATE_WAKE_DAMAGED,						///< the owner started taking damage
+	STATE_WAKE_TARGET_DIED,				///< the owner killed something
+	STATE_WAKE_WAYPOINT_REACHED,	///< the owner finished a waypoint path
+	STATE_WAKE_COMMAND_RECEIVED,	///< the owner was given an AI command
+	STATE_WAKE_DOCK_CHANGED				///< a dock the owner is queued at cleared it to enter, closed, or went away
+};
+
 /** 
  * Special argument for onCondition. It means when the given condition
  * becomes true, the state machine will exit and return the given status.
@@ -152,6 +166,7 @@ public:
 	virtual StateReturnType onEnter() { return STATE_CONTINUE; }	///< executed once when entering state
 	virtual void onExit( StateExitType status ) { }											///< executed once when leaving state
 	virtual StateReturnType update() = 0;	///< implements this state's behavior, decides when to change state
+	virtual Bool wakeOnEvent( StateWakeEvent event ) { return false; }	///< return true to be updated next frame, even if asleep
 
 	virtual Bool isIdle() const { return false; }
 	virtual Bool isAttack() const { return false; }
@@ -263,6 +278,13 @@ public:
 
 	virtual StateReturnType setState( StateID newStateID );			///< change the current state of the machine (which may cause further state changes, due to onEnter)
 
+	Bool wakeOnEvent( StateWakeEvent event );				///< pass an event to the current state, returns true if it woke up
+
+	/// How many state updates ran this frame, and how many were skipped because the state was asleep.
+	static void getUpdateStats( Int& executed, Int& skipped );
+	/// The same, summed over every frame so far.
+	static void getUpdateTotals( Int& executed, Int& skipped );
+
 	StateID getCurrentStateID() const { return m_currentState ? m_currentState->getID() : INVALID_STATE_ID; }	///< return the id of the current state of the machine
 	Bool isInIdleState() const { return m_currentState ? m_currentState->isIdle() : true; }	// stateless things are considered 'idle'
 	Bool isInAttackState() const { return m_currentState ? m_currentState->isAttack() : true; }	// stateless things are considered 'idle'
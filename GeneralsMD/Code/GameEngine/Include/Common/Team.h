@@ -388,6 +388,12 @@ public:
 	*/
 	Bool removeOverridePlayerRelationship( Int playerIndex );
 
+	/**
+		return true if this team has any special relationships, ie, if getRelationship
+		might not just be what our controlling player thinks.
+	*/
+	Bool hasOverrideRelationships() const;
+
 	/**
 		a convenience routine to count the number of owned objects that match a set of ThingTemplates.
 		You input the count and an array of ThingTemplate*, and provide an array of Int of the same
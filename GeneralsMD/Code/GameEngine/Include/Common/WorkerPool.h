@@ -0,0 +1,88 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+// WorkerPool.h ///////////////////////////////////////////////////////////////
+// A few worker threads for splitting one job into batches on the main thread's behalf.
+
+#pragma once
+
+#ifndef __WORKERPOOL_H__
+#define __WORKERPOOL_H__
+
+#include "Lib/BaseType.h"
+
+class WorkerThread;
+
+/**
+ * A piece of work that can be split into independent batches.  runBatch may be called from any
+ * thread, and from several threads at once for different batches.
+ */
+class WorkerJob
+{
+public:
+	virtual ~WorkerJob() { }
+	virtual void runBatch( Int batch ) = 0;
+};
+
+/**
+ * The calling thread and the workers all take the next batch that hasn't been started until
+ * there are none left, so a thread that gets cheap batches just ends up running more of them.
+ * run() only returns once every batch has finished, so nothing outside the job needs to be
+ * thread safe.  Only the thread that owns the pool may call run().
+ */
+class WorkerPool
+{
+public:
+	enum { MAX_WORKER_THREADS = 16 };
+
+	WorkerPool();
+	~WorkerPool();
+
+	/// Start numThreads workers, or one less than the number of processors if numThreads is negative.
+	void init( Int numThreads );
+	void shutdown( void );
+
+	Int getNumThreads( void ) const { return m_numThreads; }
+
+	/// Run job->runBatch() for every batch from 0 to numBatches - 1 and wait for them all to finish.
+	void run( WorkerJob *job, Int numBatches );
+
+private:
+	friend class WorkerThread;
+
+	void runBatches( void );		///< run batches until there aren't any left
+	void workerDone( void );
+
+	WorkerThread *m_threads[ MAX_WORKER_THREADS ];
+	HANDLE m_startEvents[ MAX_WORKER_THREADS ];	///< one per worker, set when there's a job
+	HANDLE m_doneEvent;													///< set when the last worker runs out of batches
+	Int m_numThreads;
+
+	WorkerJob * volatile m_job;
+	Int m_numBatches;
+	volatile LONG m_nextBatch;
+	volatile LONG m_busyWorkers;
+};
+
+#endif // __WORKERPOOL_H__
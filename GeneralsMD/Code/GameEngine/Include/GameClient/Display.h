@@ -68,6 +68,7 @@ public:
 	};
 
 	typedef void (DebugDisplayCallback)( DebugDisplayInterface *debugDisplay, void *userData, FILE *fp = NULL );
+	typedef void (PreloadProgressCallback)( Int loaded, Int total );
 
 	Display();
 	virtual ~Display();
@@ -168,6 +169,8 @@ public:
 #endif
 	virtual void preloadModelAssets( AsciiString model ) = 0;	///< preload model asset
 	virtual void preloadTextureAssets( AsciiString texture ) = 0;	///< preload texture asset
+	virtual void beginPreloadBatch( void ) { }		///< preloadModelAssets may hold on to models until endPreloadBatch
+	virtual void endPreloadBatch( PreloadProgressCallback *callback ) { }	///< finish loading every model held since beginPreloadBatch
 
 	virtual void takeScreenShot(void) = 0;										///< saves screenshot to a file
 	virtual void toggleMovieCapture(void) = 0;							///< starts saving frames to an avi or frame sequence
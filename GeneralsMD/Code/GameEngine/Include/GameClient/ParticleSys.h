@@ -55,6 +55,7 @@ struct FieldParse;
 class INI;
 class DebugWindowDialog;		// really ParticleEditorDialog
 class RenderInfoClass;			// ick
+class WorkerPool;
 
 enum ParticleSystemID
 {
@@ -156,6 +157,23 @@ protected:
 };
 
 
+/**
+ * Everything a particle's update needs from its system.  The system works this out once per
+ * update, so the per particle loop doesn't go back to the system (or look up the object it's
+ * attached to) for each particle.
+ */
+struct ParticleUpdateInfo
+{
+	Coord3D m_driftVel;													///< drift velocity of the system
+	Real m_gravity;															///< added to each particle's z acceleration
+	UnsignedInt m_frame;												///< current client frame, for keyframes
+	Bool m_updateAlpha;													///< additive particles don't use alpha
+	Bool m_doWind;															///< the system has wind motion
+	Coord3D m_windPos;													///< world position the wind blows from
+	Real m_windCos;															///< direction of the wind
+	Real m_windSin;
+};
+
 /**
  * An individual particle created by a ParticleSystem.
  * NOTE: Particles cannot exist without a parent particle system.
@@ -170,8 +188,8 @@ public:
 
 	Particle( ParticleSystem *system, const ParticleInfo *data );
 
-	inline Bool update( void );												///< update this particle's behavior - return false if dead
-	void doWindMotion( void );									///< do wind motion (if present) from particle system
+	inline Bool update( const ParticleUpdateInfo &info );		///< update this particle's behavior - return false if dead
+	void doWindMotion( const ParticleUpdateInfo &info );		///< do wind motion (if present) from particle system
 
 	void applyForce( const Coord3D *force );		///< add the given acceleration
 
@@ -553,6 +571,14 @@ public:
 
 	virtual Bool update( Int localPlayerIndex );								///< update this particle system, return false if dead
 	void updateWindMotion( void );							///< update wind motion
+	void computeUpdateInfo( ParticleUpdateInfo *info );	///< work out what every particle's update needs this frame
+
+	// update() in stages, so the particle updates of different systems can run on different threads
+	Bool updateEmitter( Int localPlayerIndex );	///< move the system and emit new particles, return false if particles shouldn't update yet
+	void updateParticles( void );								///< update every particle, destroying the dead ones
+	void integrateParticles( void );						///< update every particle, setting the dead ones aside - touches nothing outside this system
+	void releaseDeadParticles( void );					///< destroy the particles integrateParticles() set aside
+	Bool updateLifetime( void );								///< return false if the system is finished
 
 	void setControlParticle( Particle *p );			///< set control particle
 
@@ -605,6 +631,7 @@ public:
 
 	/// called when the particle this system is controlled by dies
 	void detachControlParticle( Particle *p ) { m_controlParticle = NULL; }
+	Particle *getControlParticle( void ) const { return m_controlParticle; }
 
 	/// called to merge two systems info. If slaveNeedsFullPromotion is true, then the slave needs to be aware of how many particles
 	/// to generate as well.
@@ -654,6 +681,9 @@ protected:
 protected:
 	Particle *				m_systemParticlesHead;
 	Particle *				m_systemParticlesTail;
+	Particle *				m_deadParticlesHead;						///< dead particles waiting for releaseDeadParticles(), chained through m_systemNext
+
+	std::list<ParticleSystem*>::iterator	m_managerListIt;	///< where we are in the manager's list of all systems
 
 	UnsignedInt				m_particleCount;								///< current count of particles for this system
 	ParticleSystemID	m_systemID;											///< unique id given to this system from the particle system manager
@@ -779,9 +809,14 @@ public:
 	
 	virtual void preloadAssets( TimeOfDay timeOfDay );
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+	/// Keep numSystems systems from the loaded templates alive for numFrames updates, and log how long the updates took.
+	void runBenchmark( Int numSystems, Int numFrames );
+#endif
+
 	// these are only for use by partcle systems to link and unlink themselves
-	void friend_addParticleSystem( ParticleSystem *particleSystemToAdd );
-	void friend_removeParticleSystem( ParticleSystem *particleSystemToRemove );
+	ParticleSystemListIt friend_addParticleSystem( ParticleSystem *particleSystemToAdd );
+	void friend_removeParticleSystem( ParticleSystem *particleSystemToRemove, ParticleSystemListIt it );
 
 protected:
 
@@ -790,6 +825,9 @@ protected:
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
 
+	void updateWithWorkers( void );							///< update all particle systems, spreading the particle updates over m_workerPool
+	void updateSystemsWithWorkers( std::vector<ParticleSystem*> &systems );
+
 	Particle *m_allParticlesHead[ NUM_PARTICLE_PRIORITIES ];
 	Particle *m_allParticlesTail[ NUM_PARTICLE_PRIORITIES ];
 
@@ -804,6 +842,12 @@ protected:
 	UnsignedInt m_lastLogicFrameUpdate;
 	Int m_localPlayerIndex;	///<used to tell particle systems which particles can be skipped due to player shroud status
 
+	WorkerPool *m_workerPool;									///< NULL unless ParticleUpdateThreads is set
+	std::vector<ParticleSystem*> m_updateSystems;				///< scratch for updateWithWorkers()
+	std::vector<ParticleSystem*> m_controlledSystems;		///< scratch for updateWithWorkers()
+	std::vector<ParticleSystem*> m_integrateSystems;		///< scratch for updateSystemsWithWorkers()
+	std::vector<Int> m_integrateBatches;								///< first system in each batch of m_integrateSystems
+
 private:
 	TemplateMap m_templateMap;		///< a hash map of all particle system templates
 };
@@ -296,6 +296,9 @@ public:
 protected:
 	Pathfinder *m_pathfinder;							///< the pathfinding system
 	std::list<AIGroup *> m_groupList;			///< the list of AIGroups
+
+	typedef std::hash_map< UnsignedInt, std::list<AIGroup *>::iterator, rts::hash<UnsignedInt>, rts::equal_to<UnsignedInt> > GroupIDMap;
+	GroupIDMap m_groupIDMap;							///< where each group is in m_groupList, by group ID
 	TAiData *m_aiData;
 	void newOverride(void);
 	void addSideInfo(AISideInfo *info);
@@ -986,6 +989,9 @@ public:
 
 	void recomputeGroupSpeed() { m_dirty = true; }
 
+	/// A member moved, or was held or let go, so the center and bounds have to be worked out again.
+	void invalidateCachedCenter() { m_centerValid = false; m_boundsValid = false; }
+
 	void setMineClearingDetail( Bool set );
 	Bool setWeaponLockForGroup( WeaponSlotType weaponSlot, WeaponLockType lockType ); ///< Set the groups' weapon choice.  
 	void releaseWeaponLockForGroup(WeaponLockType lockType);///< Clear each guys weapon choice
@@ -1007,6 +1013,7 @@ private:
 	AIGroup( void );
 
 	void recompute( void );									///< recompute various group info, such as speed, leader, etc
+	void computeMinMaxAndCenter( void );		///< fill in the cached bounds for getMinMaxAndCenter()
 
 	ListObjectPtr m_memberList;							///< the list of member Objects
 	UnsignedInt	m_memberListSize;	 					///< the size of the list of member Objects
@@ -1018,6 +1025,17 @@ private:
 	Path *m_groundPath;											///< Group ground path.
 	
 	mutable VecObjectID	m_lastRequestedIDList;			///< this is used so we can return by reference, saving a copy
+
+	Bool m_centerValid;											///< m_center and m_centerFound are up to date
+	Bool m_centerFound;											///< what getCenter() returned last time
+	Coord3D m_center;												///< what getCenter() worked out last time
+
+	Bool m_boundsValid;											///< the m_bounds values are up to date
+	Coord2D m_boundsMin;										///< what getMinMaxAndCenter() worked out last time
+	Coord2D m_boundsMax;
+	Coord3D m_boundsCenter;
+	Int m_boundsCount;											///< how many members were counted in the bounds
+	Object *m_boundsFirstMember;						///< the first member counted, whose formation decides if we're in one
 };
 
 
@@ -105,6 +105,7 @@ public:
 	virtual StateReturnType onEnter( void );
 	virtual StateReturnType update( void );
 	virtual void onExit( StateExitType status );
+	virtual Bool wakeOnEvent( StateWakeEvent event ) { return event == STATE_WAKE_DOCK_CHANGED; }
 protected:
 	UnsignedInt m_enterFrame;
 protected:
@@ -174,6 +174,7 @@ public:
 	virtual StateReturnType onEnter( void );
 	virtual StateReturnType update( void );
 	virtual void onExit( StateExitType status );
+	virtual Bool wakeOnEvent( StateWakeEvent event );
 protected:
 	// snapshot interface
 	virtual void crc( Xfer *xfer );
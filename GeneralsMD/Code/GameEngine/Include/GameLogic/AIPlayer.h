@@ -31,6 +31,7 @@
 #ifndef _AI_PLAYER_H_
 #define _AI_PLAYER_H_
 
+#include "Common/GameCommon.h"	// ensure we get DUMP_PERF_STATS, or not
 #include "Common/GameMemory.h"
 #include "Common/Snapshot.h"
 
@@ -191,6 +192,27 @@ public: // AIPlayer interface, may be overridden by AISkirmishPlayer.  jba.
 
 	virtual void selectSkillset(Int skillset);
 
+public:
+	/**
+	 * The planner's jobs.  Each one only does its work on its own frames, picked from the player
+	 * index and the logic frame, so AIs that come due together don't all think on the same frame.
+	 */
+	enum PlannerTask
+	{
+		PLAN_BASE_BUILDING,
+		PLAN_TEAM_BUILDING,
+		PLAN_TEAM_QUEUES,
+		PLAN_UPGRADES_AND_SKILLS,
+		PLAN_BRIDGE_REPAIR,
+
+		PLAN_TASK_COUNT
+	};
+
+#ifdef DUMP_PERF_STATS
+	/// Time spent in update() in msec, this frame and averaged over every frame so far.
+	void getPlannerStats(double& msecThisFrame, double& msecAverage) const;
+#endif
+
 public:
 	Bool getBaseCenter(Coord3D *pos) const {*pos = m_baseCenter; return m_baseCenterSet;}
 	/// Difficulty level for this player.
@@ -255,6 +277,7 @@ protected:
 	void checkForSupplyCenter( BuildListInfo *info, Object *bldg);
  	void queueSupplyTruck(void);
 	void updateBridgeRepair(void);
+	Bool isPlannerTurn(PlannerTask task) const;	///< true if task may do its work this frame
 	Bool dozerInQueue(void);
 	Object *findSupplyCenter(Int minSupplies);
 	static void getPlayerStructureBounds(Region2D *bounds, Int playerNdx, Bool conservative = FALSE );
@@ -296,6 +319,13 @@ protected:
 	ObjectID m_attackedSupplyCenter;
 
 	ObjectID m_curWarehouseID;
+
+#ifdef DUMP_PERF_STATS
+	UnsignedInt m_plannerPerfFrame;			///< the frame m_plannerTicksThisFrame is for
+	Int64		m_plannerTicksThisFrame;
+	Int64		m_plannerTicksTotal;
+	Int			m_plannerFrames;						///< frames that m_plannerTicksTotal covers
+#endif
 };
 
 #endif // _AI_PLAYER_H_
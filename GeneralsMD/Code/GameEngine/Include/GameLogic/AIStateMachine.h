@@ -1081,6 +1081,7 @@ public:
 	virtual StateReturnType onEnter();
 	virtual void onExit( StateExitType status );
 	virtual StateReturnType update();
+	virtual Bool wakeOnEvent( StateWakeEvent event );
 #ifdef STATE_MACHINE_DEBUG
 	virtual AsciiString getName() const ;
 #endif
@@ -1174,6 +1175,7 @@ public:
 	virtual StateReturnType onEnter();
 	virtual void onExit( StateExitType status );
 	virtual StateReturnType update();
+	virtual Bool wakeOnEvent( StateWakeEvent event );
 #ifdef STATE_MACHINE_DEBUG
 	virtual AsciiString getName() const ;
 #endif
@@ -329,6 +329,8 @@ public:
 #endif
 
 	virtual void joinTeam( void );			///< This unit just got added to a team & needs to catch up.
+
+	void wakeUpStateMachine( StateWakeEvent event );	///< something happened to us, wake our current state if it cares
 	
 	Bool areTurretsLinked() const { return getAIUpdateModuleData()->m_turretsLinked; }
 
@@ -500,7 +502,7 @@ public:
 
 	// "Waypoint Mode" -----------------------------------------------------------------------------------
 	const Waypoint *getCompletedWaypoint(void) const {return m_completedWaypoint;}
-	void setCompletedWaypoint(const Waypoint *pWay) {m_completedWaypoint = pWay;}
+	void setCompletedWaypoint(const Waypoint *pWay) {m_completedWaypoint = pWay; if (pWay) wakeUpStateMachine(STATE_WAKE_WAYPOINT_REACHED);}
 
 	const LocomotorSet& getLocomotorSet(void) const {return m_locomotorSet;}
 	void setPathExtraDistance(Real dist) {m_pathExtraDistance = dist;}
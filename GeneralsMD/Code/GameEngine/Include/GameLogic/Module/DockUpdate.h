@@ -88,9 +88,10 @@ public:
 
 	/** Return true when it is OK for docker to begin entering the dock 
 			The Dock will lift the restriction on one particular docker on its own, 
-			so you must continually ask.
+			and wakes that docker when it does.
 	*/
 	virtual Bool isClearToEnter( Object const* docker ) const;
+	virtual Bool wakesWaitingDockers() const { return TRUE; }
 
 	/** Return true when it is OK for docker to request a new Approach position.  The dock is in
 			charge of keeping track of holes in the line, but the docker will remind us of their spot.
@@ -121,7 +122,7 @@ public:
 	virtual void cancelDock( Object* docker );	///< Clear me from any reserved points, and if I was the reason you were Busy, you aren't anymore.
 
 	virtual Bool isDockOpen( void ) { return m_dockOpen; }				///< Is the dock open to accepting dockers
-	virtual void setDockOpen( Bool open ) { m_dockOpen = open; }	///< Open/Close the dock
+	virtual void setDockOpen( Bool open );												///< Open/Close the dock
 
 	virtual Bool isAllowPassthroughType();	///< Not all docks allow you to path through them in your AIDock machine
 
@@ -130,6 +131,7 @@ public:
 	virtual void setDockCrippled( Bool setting ); ///< Game Logic can set me as inoperative.  I get to decide what that means.
 
 	virtual UpdateSleepTime update();	///< In charge of lifting dock restriction for one registered as Approached if all is ready
+	virtual void onDelete( void );
 
 protected:
 
@@ -154,6 +156,8 @@ protected:
 	Bool m_dockOpen;  ///< Is the dock open for dockers
 
 	void loadDockPositions();  ///< load all the dock positions 
+	void wakeDocker( ObjectID dockerID );		///< let a waiting docker know things changed
+	void wakeAllDockers( void );
 	Coord3D computeApproachPosition( Int positionIndex, Object *forWhom ); ///< Do a smart lookup of this bone position
 };
 
@@ -231,6 +231,7 @@ protected:
 	void applyFrictionalForces();
 	Bool handleBounce(Real oldZ, Real newZ, Real groundZ, Coord3D* bounceForce);
 	void applyYPRDamping(Real factor);
+	Bool tryBallisticStep();		///< the cheap update for things in free flight, false if it doesn't apply
 	UpdateSleepTime calcSleepTime() const;
 
 	void doBounceSound(const Coord3D& prevPos);
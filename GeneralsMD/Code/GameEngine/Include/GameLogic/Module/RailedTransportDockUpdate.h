@@ -89,6 +89,7 @@ public:
 	virtual DockUpdateInterface* getDockUpdateInterface() { return this; }
 	virtual Bool action( Object* docker, Object *drone = NULL );
 	virtual Bool isClearToEnter( Object const* docker ) const;
+	virtual Bool wakesWaitingDockers() const { return FALSE; }	///< we also need room inside, which nobody tells the docker about
 
 	// our own methods
 	virtual Bool isLoadingOrUnloading( void );
@@ -291,10 +291,15 @@ public:
 
 	/** Return true when it is OK for docker to begin entering the dock 
 			The Dock will lift the restriction on one particular docker on its own, 
-			so you must continually ask.
+			so you must continually ask, unless wakesWaitingDockers() says otherwise.
 	*/
 	virtual Bool isClearToEnter( Object const* docker ) const = 0;
 
+	/** Return true if the dock wakes the AI of a queued docker whenever isClearToEnter() or
+			isDockOpen() might have changed for it, or the dock is destroyed, so it needn't keep asking.
+	*/
+	virtual Bool wakesWaitingDockers() const = 0;
+
 	/** Return true when it is OK for docker to request a new Approach position.  The dock is in
 			charge of keeping track of holes in the line, but the docker will remind us of their spot.
 	*/
@@ -178,6 +178,33 @@ struct CollideLocAndNormal
 //=====================================
 class PartitionContactList;
 
+//=====================================
+/** 
+	PartitionEnemyCandidates is a utility class used by the Partition Manager
+	to remember, cell by cell, which objects each player considers enemies,
+	so that every scan for enemies a player makes in a frame can share the work.
+*/
+//=====================================
+class PartitionEnemyCandidates;
+
+//=====================================
+/** 
+	PartitionValuePyramid is a utility class used by the Partition Manager
+	to keep the per player threat and cash values of the cells summed over
+	ever larger blocks of cells, so AI questions about them needn't look at
+	every cell.
+*/
+//=====================================
+class PartitionValuePyramid;
+
+//=====================================
+/** 
+	PartitionLineOfSightCache is a utility class used by the Partition Manager
+	to remember the answers to recent terrain line of sight checks, so the
+	same check from the same place needn't walk the terrain again.
+*/
+//=====================================
+class PartitionLineOfSightCache;
 
 //=====================================
 /** 
@@ -305,6 +332,9 @@ private:
 	Int														m_threatValue[MAX_PLAYER_COUNT];
 	Int														m_cashValue[MAX_PLAYER_COUNT];
 	Short													m_coiCount;					///< number of COIs in this cell.
+	UnsignedInt										m_coiListStamp;			///< changes whenever a COI joins or leaves this cell.
+	UnsignedInt										m_structureStamp;		///< m_coiListStamp when m_hasStructures was worked out
+	Bool													m_hasStructures;		///< does any structure touch this cell
 	Short													m_cellX;						///< x-coord of this cell within the Partition Mgr coords (NOT in world coords)
 	Short													m_cellY;						///< y-coord of this cell within the Partition Mgr coords (NOT in world coords)
 
@@ -325,6 +355,9 @@ public:
 	void loadPostProcess( void );
 
 	Int getCoiCount() const { return m_coiCount; }		///< return number of COIs touching this cell.
+	UnsignedInt getCoiListStamp() const { return m_coiListStamp; }	///< lists built from this cell's COIs are good while this is unchanged.
+	void friend_bumpCoiListStamp() { ++m_coiListStamp; }
+	Bool hasStructures();		///< does any structure touch this cell.
 	Int getCellX() const { return m_cellX; }
 	Int getCellY() const { return m_cellY; }
 
@@ -400,6 +433,7 @@ private:
 	ObjectShroudStatus					m_shroudednessPrevious[MAX_PLAYER_COUNT];	///<previous frames value of m_shroudedness						
 	Bool												m_everSeenByPlayer[MAX_PLAYER_COUNT];		///<whether this object has ever been seen by a given player.
 	const PartitionCell					*m_lastCell;							///< The last cell I thought my center was in.
+	UnsignedInt									m_contactStamp;						///< The last scan for contacts that offered me to the contact list.
 	
 	/**
 		Given a shape's geometry and size parameters, calculate the maximum number of COIs
@@ -513,6 +547,9 @@ public:
 	void invalidateShroudedStatusForPlayer(Int playerIndex);
 	void invalidateShroudedStatusForAllPlayers();
 
+	/// the cells I touch throw away lists built from their COIs (call when my team changes, say)
+	void invalidateCellContents();
+
 	ObjectShroudStatus getShroudedStatus(Int playerIndex);
 
 	inline Int wasSeenByAnyPlayers() const	///<check if a player in the game has seen the object but is now looking at fogged version.
@@ -1248,6 +1285,10 @@ private:
 	Int							m_totalCellCount;	///< x * y
 	PartitionCell*	m_cells;					///< array of cells
 	PartitionData*	m_dirtyModules;
+	PartitionContactList*	m_contactList;	///< reused every update, so its memory is only allocated while it grows
+	PartitionEnemyCandidates*	m_enemyCandidates;	///< per player enemies in each cell, shared by enemy scans
+	PartitionValuePyramid*	m_valuePyramid;	///< block sums of the cells' threat and cash values
+	PartitionLineOfSightCache*	m_lineOfSightCache;	///< recent terrain line of sight answers
 	Bool						m_updatedSinceLastReset;	///< Used to force a return of OBJECTSHROUD_INVALID before update has been called.
 
 	std::queue<SightingInfo *> m_pendingUndoShroudReveals;	///< Anything can queue up an Undo to happen later. This is a queue, because "later" is a constant
@@ -1271,7 +1312,8 @@ protected:
 		PartitionFilter **filters, 
 		SimpleObjectIterator *iter,	// if nonnull, append ALL satisfactory objects to the iterator (not just the single closest)
 		Real *closestDistArg,
-		Coord3D *closestVecArg
+		Coord3D *closestVecArg,
+		const Player *enemiesOf = NULL	// if nonnull, only look at objects enemiesOf's enemy candidates
 	);
 
 	void shutdown( void );
@@ -1309,6 +1351,19 @@ protected:
 	void processPendingUndoShroudRevealQueue(Bool considerTimestamp = TRUE);				///< keep popping and processing untill you get to one that is in the future
 	void resetPendingUndoShroudRevealQueue();					///< Just delete everything in the queue without doing anything with them
 
+	/// Bring the cells of every dirty module up to date and collide the ones that moved. Returns the number of pairs considered.
+	Int processDirtyModules(Int *numCollisions);
+
+	/// Could a scan of range around pos come across a structure? FALSE only if none of the cells it would look in has one.
+	Bool mayHaveStructuresInRange(const Coord3D *pos, Real range);
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+	/// Time the collision pass with a crowd of units jostling at the middle of the map, results go to the debug log.
+	void runCollisionBenchmark(const AsciiString& templateName, Int numUnits, Int numFrames);
+	/// Time terrain line of sight checks between random points on the map, results go to the debug log.
+	void runLineOfSightBenchmark(Int numQueries);
+#endif
+
 public:
 
 	PartitionManager( void );
@@ -1407,8 +1462,43 @@ public:
 
 #ifdef DUMP_PERF_STATS
 	void getPMStats(double& gcoTimeThisFrameTotal, double& gcoTimeThisFrameAvg);
+	void getEnemyScanStats(Int& queries, Int& cellsTouched, Int& cellsBuilt);
+	void getLineOfSightStats(Int& queries, Int& cacheHits);
 #endif
 
+	/**
+		Scans for enemies of obj can use a list of its player's enemies in each cell, worked
+		out once a frame, rather than looking at everything in the cell. This is only the same
+		as asking obj about each object when obj's relationships are just those of its player,
+		which is what this checks.
+	*/
+	Bool canShareEnemyCandidates(const Object *obj) const;
+
+	/**
+		Just like getClosestObject and iterateObjectsInRange, but only objects that obj's player
+		thinks are enemies are considered. The candidate lists are still allowed to hold objects
+		that have died this frame, and objects on the wrong side of the map edge from obj, so the
+		filters must reject those. Only use these when canShareEnemyCandidates(obj) is true.
+	*/
+	Object *getClosestEnemyCandidate(
+		const Object *obj, 
+		Real maxDist, 
+		DistanceCalculationType dc, 
+		PartitionFilter **filters = NULL, 
+		Real *closestDist = NULL,
+		Coord3D *closestDistVec = NULL
+	);
+	SimpleObjectIterator *iterateEnemyCandidatesInRange(
+		const Object *obj, 
+		Real maxDist, 
+		DistanceCalculationType dc, 
+		PartitionFilter **filters = NULL, 
+		IterOrderType order = ITER_FASTEST
+	);
+
+	/// Call when players change who their enemies are; every candidate list is rebuilt.
+	void invalidateEnemyCandidates();
+
 	SimpleObjectIterator *iterateObjectsInRange(
 		const Object *obj, 
 		Real maxDist, 
@@ -1524,6 +1614,9 @@ public:
 
 	Real getGroundOrStructureHeight(Real posx, Real posy);
 
+	/// Forget the remembered line of sight answers. Call whenever the terrain heights change.
+	void invalidateLineOfSightCache();
+
 	void getMostValuableLocation( Int playerIndex, UnsignedInt whichPlayerTypes, ValueOrThreat valType, Coord3D *outLocation );
 	void getNearestGroupWithValue( Int playerIndex, UnsignedInt whichPlayerTypes, ValueOrThreat valType, const Coord3D *sourceLocation,
 																 Int valueRequired, Bool greaterThan, Coord3D *outLocation );
@@ -326,13 +326,64 @@ struct HistoricWeaponDamageInfo
 	UnsignedInt						frame;
 	Coord3D								location;
 
+	HistoricWeaponDamageInfo() : frame(0)
+	{
+		location.zero();
+	}
+
 	HistoricWeaponDamageInfo(UnsignedInt f, const Coord3D& l) :
 		frame(f), location(l)
 	{
 	}
 };
 
-typedef std::list<HistoricWeaponDamageInfo> HistoricWeaponDamageList;
+//-------------------------------------------------------------------------------------------------
+/**
+	Where and when a WeaponTemplate has recently done damage, oldest first. New entries only
+	ever go on the new end and old ones only ever expire off the old end, so this is a ring
+	(that grows when it fills), and asking about the last few frames only looks at the newest
+	entries instead of every one that hasn't expired yet.
+*/
+class HistoricWeaponDamageRing
+{
+public:
+
+	HistoricWeaponDamageRing() : m_head(0), m_count(0) { }
+
+	void clear() { m_head = 0; m_count = 0; }
+	Int size() const { return m_count; }
+
+	void push(UnsignedInt frame, const Coord3D& location);
+
+	/// drop everything that happened on or before expirationDate
+	void expire(UnsignedInt expirationDate);
+
+	/**
+		count the entries from oldestFrame on that are within the radius of pos (in 2D). 
+		stops counting once it gets to enough, since the caller only cares whether there are that many.
+	*/
+	Int countNear(const Coord3D& pos, Real radiusSqr, UnsignedInt oldestFrame, Int enough) const;
+
+private:
+
+	std::vector<HistoricWeaponDamageInfo> m_entries;
+	Int m_head;			///< index of the oldest entry
+	Int m_count;
+};
+
+//-------------------------------------------------------------------------------------------------
+/**
+	One object caught in a radius of damage, and what it is going to take. All of them are found
+	before any are damaged, then they are damaged in the order they were found.
+*/
+struct RadiusDamageVictim
+{
+	Object*								m_victim;
+	Coord3D								m_damageDirection;		///< from the source to the victim, for shockwaves
+	Real									m_amount;
+};
+
+typedef std::vector<RadiusDamageVictim> RadiusDamageVictimVec;
 
 //-------------------------------------------------------------------------------------------------
 class WeaponTemplate : public MemoryPoolObject
@@ -557,7 +608,7 @@ private:
 	UnsignedInt m_suspendFXDelay;						///< The fx can be suspended for any delay, in frames, then they will execute as normal
 	Bool m_dieOnDetonate;
 
-	mutable HistoricWeaponDamageList m_historicDamage;
+	mutable HistoricWeaponDamageRing m_historicDamage;
 };  
 
 // ---------------------------------------------------------
@@ -859,6 +910,18 @@ protected:
 	void resetWeaponTemplates( void );
 	void setDelayedDamage(const WeaponTemplate *weapon, const Coord3D* pos, UnsignedInt whichFrame, ObjectID sourceID, ObjectID victimID, const WeaponBonus& bonus);
 
+	/**
+		radius damage can set off more radius damage (things blowing up when they die), 
+		so there is a victim buffer for each level of that, kept from one detonation to the next.
+	*/
+	RadiusDamageVictimVec *pushRadiusDamageVictims();
+	void popRadiusDamageVictims();
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+	/// Time the radius damage of repeated volleys of a weapon landing on a crowd of units, results go to the debug log.
+	void runBarrageBenchmark(const AsciiString& weaponName, const AsciiString& targetName, Int numUnits, Int numShots, Int numFrames);
+#endif
+
 private:
 
 	/**
@@ -880,6 +943,8 @@ private:
 
 	std::vector<WeaponTemplate*> m_weaponTemplateVector;
 	std::list<WeaponDelayedDamageInfo> m_weaponDDI;
+	std::vector<RadiusDamageVictimVec*> m_radiusDamageVictims;	///< one per level of radius damage setting off more radius damage
+	Int m_radiusDamageDepth;																		///< how many of m_radiusDamageVictims are in use
 };
 
 // EXTERNALS //////////////////////////////////////////////////////////////////////////////////////
@@ -79,6 +79,8 @@ public:
 	void setQuitting( void );
 	Bool isQuitting( void ) { return m_isQuitting; }
 
+	UnsignedInt getTotalRetries( void ) { return m_totalRetries; }	///< commands sent again because their ack was late, since init()
+
 #if defined(_DEBUG) || defined(_INTERNAL)
 	void debugPrintCommands();
 #endif
@@ -100,6 +102,7 @@ protected:
 	time_t m_frameGrouping;				///< The minimum time between packet sends.
 	time_t m_lastTimeSent;				///< The time of the last packet send.
 	Int m_numRetries;							///< The number of retries for the last second.
+	UnsignedInt m_totalRetries;		///< The number of retries since init().
 	time_t m_retryMetricsTime;		///< The start time of the current retry metrics thing.
 };
 
@@ -39,6 +39,7 @@
 #include "GameNetwork/FrameMetrics.h"
 #include "GameNetwork/NetworkDefs.h"
 #include "GameNetwork/DisconnectManager.h"
+#include "GameNetwork/RunAheadController.h"
 
 class GameInfo;
 class NetCommandWrapperList;
@@ -60,6 +61,8 @@ public:
 	// End SubsystemInterface functions
 
 	void updateRunAhead(Int oldRunAhead, Int frameRate, Bool didSelfSlug, Int nextExecutionFrame);	///< Update the run ahead value.  If we are the current packet router, issue the command.
+	static Int ComputeRunAhead(Real maxLatency, Int minFps);		///< The run ahead the packet router picks for this round trip latency (seconds) and frame rate.
+	const RunAheadController *getRunAheadController() const;		///< The packet router's run ahead decisions, for telemetry.
 
 	void attachTransport(Transport *transport);
 
@@ -111,6 +114,7 @@ public:
 	Real getIncomingBytesPerSecond( void );
 	Real getIncomingPacketsPerSecond( void );
 	Real getOutgoingBytesPerSecond( void );
+	Real getOutgoingPayloadBytesPerSecond( void );
 	Real getOutgoingPacketsPerSecond( void );
 	Real getUnknownBytesPerSecond( void );
 	Real getUnknownPacketsPerSecond( void );
@@ -173,8 +177,6 @@ private:
 	void processFileProgress(NetFileProgressCommandMsg *ref);
 
 	//	void doPerFrameMetrics(UnsignedInt frame);
-	void getMinimumFps(Int &minFps, Int &minFpsPlayer);			///< Returns the smallest FPS in the m_fpsAverages list.
-	Real getMaximumLatency(); ///< This actually sums the two biggest latencies in the m_latencyAverages list.
 
 	void requestFrameDataResend(Int playerID, UnsignedInt frame); ///< request of this player that he send the specified frame's data.
 
@@ -206,6 +208,7 @@ private:
 	// yup.
 	Real m_latencyAverages[MAX_SLOTS];
 	Int  m_fpsAverages[MAX_SLOTS];
+	RunAheadController m_runAheadController;				///< Decides the run ahead from the above when we're the packet router.
 	Int  m_minFpsPlayer;
 	Int  m_minFps;
 	UnsignedInt m_smallestPacketArrivalCushion;
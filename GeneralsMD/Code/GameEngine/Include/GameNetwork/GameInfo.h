@@ -233,6 +233,12 @@ public:
   inline Bool oldFactionsOnly(void) const;
   inline void setOldFactionsOnly( Bool oldFactionsOnly );
 
+	inline Bool getNetPacketPacking( void ) const;		///< May players pack transport packets?  Only set if the host supports it; each player still has to opt in.
+	inline void setNetPacketPacking( Bool packing );
+
+	inline Int getNetProtocolVersion( void ) const;		///< Command protocol version the host advertised (1 if it didn't)
+	inline void setNetProtocolVersion( Int version );
+
 protected:
 	Int m_preorderMask;
 	Int m_crcInterval;
@@ -254,6 +260,8 @@ protected:
   Money         m_startingCash;
   UnsignedShort m_superweaponRestriction;
   Bool m_oldFactionsOnly; // Only USA, China, GLA -- not USA Air Force General, GLA Toxic General, et al
+	Bool m_netPacketPacking;
+	Int m_netProtocolVersion;
 };
 
 extern GameInfo *TheGameInfo;
@@ -275,6 +283,10 @@ const Money&GameInfo::getStartingCash( void ) const         { return m_startingC
 UnsignedShort GameInfo::getSuperweaponRestriction( void ) const { return m_superweaponRestriction; }
 Bool        GameInfo::oldFactionsOnly(void) const           { return m_oldFactionsOnly; }
 void        GameInfo::setOldFactionsOnly( Bool oldFactionsOnly ) { m_oldFactionsOnly = oldFactionsOnly; }
+Bool				GameInfo::getNetPacketPacking( void ) const			{ return m_netPacketPacking; }
+void				GameInfo::setNetPacketPacking( Bool packing )		{ m_netPacketPacking = packing; }
+Int					GameInfo::getNetProtocolVersion( void ) const		{ return m_netProtocolVersion; }
+void				GameInfo::setNetProtocolVersion( Int version )	{ m_netProtocolVersion = version; }
 
 AsciiString GameInfoToAsciiString( const GameInfo *game );
 Bool ParseAsciiStringToGameInfo( GameInfo *game, AsciiString options );
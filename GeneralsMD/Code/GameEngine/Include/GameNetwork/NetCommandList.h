@@ -30,24 +30,48 @@
 
 #include "Common/GameMemory.h"
 #include "GameNetwork/NetCommandRef.h"
+#include "GameNetwork/NetworkDefs.h"
+
+/**
+ * Once a NetCommandList gets long enough to make walking it expensive, it builds one of these
+ * to go with it.  The hash finds a command by its identity (player and command ID, or for acks
+ * the command being acked) without walking the list, and the section table remembers the last
+ * command of each command type and player so that the right place for a new command can be
+ * found without walking the list either.
+ */
+class NetCommandListIndex : public MemoryPoolObject
+{
+	MEMORY_POOL_GLUE_WITH_USERLOOKUP_CREATE(NetCommandListIndex, "NetCommandListIndex")		
+public:
+	enum { HASH_SIZE = 64 };	///< must be a power of 2
+
+	NetCommandListIndex();
+	//virtual ~NetCommandListIndex();
+
+	NetCommandRef *m_buckets[HASH_SIZE];
+	NetCommandRef *m_sectionLast[NETCOMMANDTYPE_MAX][MAX_SLOTS];	///< Last command of each type from each player.
+};
 
 /**
  * The NetCommandList is a ordered linked list of NetCommandRef objects.
- * The list is ordered based on the command id, player id, and command type.
+ * The list is ordered based on the command type, player id, and command id.
  * It is ordered in this way to aid in constructing the packets efficiently.
  * The list keeps track of the last message inserted in order to accommodate
  * adding commands in order more efficiently since that is whats going to be
  * done most of the time.  If the new message doesn't go after the last message
  * inserted, then the list will be traversed linearly until the proper spot is
- * found.  We can get away with this inefficient method since these occurances
- * will be rare.  Also, the list is not expected to ever have more than 30 or so
- * commands on it at a time.  Five commands would probably be a normal amount.
+ * found.  Most lists only ever hold a handful of commands, but the ones waiting
+ * for acks on a packet router can hold a few hundred when latency is high, so
+ * once a list gets to INDEX_THRESHOLD commands it builds a NetCommandListIndex
+ * and stops walking itself.
  */
 
 class NetCommandList : public MemoryPoolObject
 {
 	MEMORY_POOL_GLUE_WITH_USERLOOKUP_CREATE(NetCommandList, "NetCommandList")		
 public:
+	enum { INDEX_THRESHOLD = 16 };
+
 	NetCommandList();
 	//virtual ~NetCommandList();
 
@@ -63,12 +87,24 @@ public:
 																								///< a command id.
 	void removeMessage(NetCommandRef *msg);			///< Remove the given message from the list.
 	void appendList(NetCommandList *list);			///< Append the given list to the end of this list.
-	Int length();									///< Returns the number of nodes in this list.  This is inefficient and is meant to be a debug tool.
+	Int length();									///< Returns the number of nodes in this list.
 
 protected:
+	static Int getHashBucket(NetCommandMsg *msg);	///< Which bucket of the index this command goes in, -1 if it can't be equal to any other command.
+	static Int getHashBucket(UnsignedShort commandID, UnsignedByte playerID);
+
+	void buildIndex();
+	void addToIndex(NetCommandRef *msg);
+	void removeFromIndex(NetCommandRef *msg);
+	NetCommandRef * addUnindexedMessage(NetCommandRef *msg);
+	NetCommandRef * addIndexedMessage(NetCommandRef *msg);
+	void insertAfter(NetCommandRef *msg, NetCommandRef *after);	///< NULL for after puts it at the head of the list.
+
 	NetCommandRef *m_first;							///< Head of the list.
 	NetCommandRef *m_last;							///< Tail of the list.
 	NetCommandRef *m_lastMessageInserted;			///< The last message that was inserted to this list.
+	Int m_count;
+	NetCommandListIndex *m_index;					///< NULL until the list gets long enough to need it.
 };
 
 #endif
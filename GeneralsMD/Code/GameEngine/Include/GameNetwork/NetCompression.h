@@ -0,0 +1,55 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// NetCompression.h ///////////////////////////////////////////////////////////
+// Small LZ-style compressor for in-game transport packets.
+// Packets are tiny, so unlike the file compressors there is no header or
+// huffman table, just the token stream.  Each packet is compressed on its own,
+// since any packet can be lost.
+
+#pragma once
+
+#ifndef __NETCOMPRESSION_H
+#define __NETCOMPRESSION_H
+
+#include "Lib/BaseType.h"
+
+class NetCompression
+{
+public:
+	/**
+	 * Compress srcLen bytes of src into dest.  Returns the compressed length, or 0
+	 * if the result would not fit in destLen or would not be smaller than the input.
+	 */
+	static Int compress( const UnsignedByte *src, Int srcLen, UnsignedByte *dest, Int destLen );
+
+	/**
+	 * Reverse of compress().  Returns the decompressed length, or -1 if the data
+	 * is malformed or overflows destLen.
+	 */
+	static Int decompress( const UnsignedByte *src, Int srcLen, UnsignedByte *dest, Int destLen );
+};
+
+#endif // __NETCOMPRESSION_H
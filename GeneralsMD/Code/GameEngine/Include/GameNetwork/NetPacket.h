@@ -68,6 +68,9 @@ public:
 	static NetCommandRef * ConstructNetCommandMsgFromRawData(UnsignedByte *data, UnsignedShort dataLength);
 	static NetPacketList ConstructBigCommandPacketList(NetCommandRef *ref);
 
+	static void SetCompactEncoding(Bool compact);	///< Use the compact (delta/varint) field encodings for packets built from now on.
+	static Bool IsCompactEncoding();
+
 	UnsignedByte *getData();
 	Int getLength();
 	UnsignedInt getAddr();
@@ -190,7 +193,7 @@ protected:
 	Bool isAckStage2Repeat(NetCommandRef *msg);
 	Bool isFrameRepeat(NetCommandRef *msg);
 
-	static NetCommandMsg * readGameMessage(UnsignedByte *data, Int &i);
+	static NetCommandMsg * readGameMessage(UnsignedByte *data, Int &i, Bool compact = FALSE);
 	static NetCommandMsg * readAckBothMessage(UnsignedByte *data, Int &i);
 	static NetCommandMsg * readAckStage1Message(UnsignedByte *data, Int &i);
 	static NetCommandMsg * readAckStage2Message(UnsignedByte *data, Int &i);
@@ -220,6 +223,15 @@ protected:
 
 	void writeGameMessageArgumentToPacket(GameMessageArgumentDataType type, GameMessageArgumentType arg);
 	static void readGameMessageArgumentFromPacket(GameMessageArgumentDataType type, NetGameCommandMsg *msg, UnsignedByte *data, Int &i);
+	void writeCompactGameMessageArgumentToPacket(GameMessageArgumentDataType type, GameMessageArgumentType arg, UnsignedInt &lastID);
+	static Int GetCompactGameMessageArgumentSize(GameMessageArgumentDataType type, GameMessageArgumentType arg, UnsignedInt &lastID);
+	static void readCompactGameMessageArgumentFromPacket(GameMessageArgumentDataType type, NetGameCommandMsg *msg, UnsignedByte *data, Int &i, UnsignedInt &lastID);
+
+	// Write the 'F'/'C' header fields, or their compact 'f'/'c' forms when those are enabled and smaller.
+	void writeFrameField(UnsignedInt frame);
+	Int getFrameFieldSize(UnsignedInt frame);
+	void writeCommandIDField(UnsignedShort id);
+	Int getCommandIDFieldSize(UnsignedShort id);
 
 	void dumpPacketToLog();
 
@@ -232,9 +244,12 @@ protected:
 	UnsignedInt			m_lastFrame;
 	UnsignedShort		m_port;
 	UnsignedShort		m_lastCommandID;
+	UnsignedShort		m_lastCommandIDField;		///< last command ID explicitly written, the base for compact 'c' deltas
 	UnsignedByte		m_lastPlayerID;
 	UnsignedByte		m_lastCommandType;
 	UnsignedByte		m_lastRelay;
+
+	static Bool			s_compactEncoding;
 };
 
 #endif // __NETPACKET_H
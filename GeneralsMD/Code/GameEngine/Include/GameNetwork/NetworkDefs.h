@@ -177,6 +177,19 @@ enum PlayerLeaveCode {
 // Magic number for identifying a Generals packet.
 static const UnsignedShort GENERALS_MAGIC_NUMBER = 0xF00D;
 
+// Magic number for identifying a Generals packet that the transport has packed (coalesced, and
+// possibly compressed).  These are only ever sent to peers that said they will take them.
+static const UnsignedShort GENERALS_PACKED_MAGIC_NUMBER = 0xF00E;
+
+// Magic number for an ordinary Generals packet whose sender will take packed packets in return.
+// Packing peers send these until they hear back from the other end.
+static const UnsignedShort GENERALS_PACKING_MAGIC_NUMBER = 0xF00F;
+
+// Version of the in-game command protocol, advertised in the game options.  Games whose host
+// doesn't advertise one are version 1.  Version 2 adds the compact ('f', 'c', 'd') NetPacket fields.
+static const Int NETWORK_PROTOCOL_VERSION = 2;
+static const Int NETWORK_PROTOCOL_VERSION_COMPACT = 2;
+
 // The number of fps history entries.
 //static const Int NETWORK_FPS_HISTORY_LENGTH = 30;
 
@@ -94,6 +94,7 @@ public:
 	virtual Real getIncomingBytesPerSecond( void ) = 0;
 	virtual Real getIncomingPacketsPerSecond( void ) = 0;
 	virtual Real getOutgoingBytesPerSecond( void ) = 0;
+	virtual Real getOutgoingPayloadBytesPerSecond( void ) = 0;
 	virtual Real getOutgoingPacketsPerSecond( void ) = 0;
 	virtual Real getUnknownBytesPerSecond( void ) = 0;
 	virtual Real getUnknownPacketsPerSecond( void ) = 0;
@@ -0,0 +1,215 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+// NetworkSimulator.h /////////////////////////////////////////////////////////
+// In-process stand-in for the UDP network, for reproducing bad connections
+// without needing real machines (or real players) on the other end.
+// Debug and internal builds only.
+
+#pragma once
+
+#ifndef __NETWORKSIMULATOR_H
+#define __NETWORKSIMULATOR_H
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+
+#include "Lib/BaseType.h"
+#include "GameNetwork/NetworkDefs.h"
+#include "GameNetwork/RunAheadController.h"
+
+class Connection;
+class FrameDataManager;
+class NetCommandMsg;
+class NetCommandRef;
+class Transport;
+
+/**
+ * The conditions on a one-way link between two simulated addresses.
+ */
+struct NetLinkConditions
+{
+	Int latency;			///< one way delay, in milliseconds
+	Int jitter;				///< max random delay added on top of latency, in milliseconds
+	Int packetLoss;		///< percent of packets that never arrive
+	Int bandwidth;		///< bytes per second the link can carry, 0 for unlimited
+};
+
+/**
+ * A virtual switch that Transports can be attached to in place of a UDP socket.  Packets
+ * written by one Transport are held until the link conditions say they've arrived, then
+ * read by the Transport at the other end.  The clock can be driven by hand, so a soak
+ * can run much faster than real time.
+ */
+class NetworkSimulator
+{
+public:
+	enum
+	{
+		MAX_SIMULATED_PACKETS = 1024,		///< packets in flight across all links
+		MAX_SIMULATED_LINKS = 64,				///< links with their own conditions, the rest use the default
+		LATENCY_HISTOGRAM_BUCKETS = 32,
+		LATENCY_HISTOGRAM_BUCKET_SIZE = 20	///< milliseconds per bucket; the last bucket holds everything slower
+	};
+
+	NetworkSimulator();
+
+	void reset( void );
+
+	void setDefaultLinkConditions( const NetLinkConditions &conditions );
+	void setLinkConditions( UnsignedInt fromAddr, UnsignedInt toAddr, const NetLinkConditions &conditions );	///< conditions for packets going fromAddr -> toAddr
+
+	void setManualClock( Bool manual ) { m_manualClock = manual; }
+	void setTime( UnsignedInt now ) { m_now = now; }
+	UnsignedInt getTime( void ) const;
+
+	/// Put a packet on the wire.  Returns the number of bytes sent, which is all of them even if the link loses it.
+	Int write( UnsignedInt fromAddr, UnsignedShort fromPort, const UnsignedByte *buf, Int len, UnsignedInt toAddr, UnsignedShort toPort );
+	/// Take the oldest packet that has arrived for this address.  Returns its length, or 0 if nothing has arrived.
+	Int read( UnsignedInt addr, UnsignedShort port, UnsignedByte *buf, Int len, UnsignedInt *fromAddr, UnsignedShort *fromPort );
+
+	void logStatistics( void ) const;
+
+	// Statistics
+	UnsignedInt m_packetsSent;
+	UnsignedInt m_packetsDelivered;
+	UnsignedInt m_packetsLost;				///< dropped by the link's packet loss
+	UnsignedInt m_packetsOverflowed;	///< dropped because too many packets were in flight
+	UnsignedInt m_bytesSent;
+	UnsignedInt m_latencyHistogram[LATENCY_HISTOGRAM_BUCKETS];	///< time from write() to arrival of delivered packets
+
+private:
+	struct SimulatedPacket
+	{
+		UnsignedInt fromAddr;
+		UnsignedShort fromPort;
+		UnsignedInt toAddr;
+		UnsignedShort toPort;
+		UnsignedInt sendTime;
+		UnsignedInt deliveryTime;
+		Int length;			///< 0 if this slot is free
+		UnsignedByte data[MAX_MESSAGE_LEN + sizeof(TransportMessageHeader)];
+	};
+
+	struct SimulatedLink
+	{
+		UnsignedInt fromAddr;
+		UnsignedInt toAddr;
+		NetLinkConditions conditions;
+		UnsignedInt busyUntil;		///< when the last packet finishes going out, for the bandwidth limit
+	};
+
+	SimulatedLink *findLink( UnsignedInt fromAddr, UnsignedInt toAddr );
+	Int random( Int lo, Int hi );
+
+	SimulatedPacket m_packets[MAX_SIMULATED_PACKETS];
+	SimulatedLink m_links[MAX_SIMULATED_LINKS];
+	Int m_numLinks;
+	NetLinkConditions m_defaultConditions;
+
+	Bool m_manualClock;
+	UnsignedInt m_now;
+	UnsignedInt m_seed;
+};
+
+/**
+ * Drives several lockstep clients over a NetworkSimulator and reports how the game would
+ * have felt: frame times, stalls waiting for other players, resends, and the run ahead the
+ * packet router picked.  Each client is built from the game's own pieces - a Connection to
+ * every other client for acks and resends, and a FrameDataManager per player deciding when a
+ * frame can run - and sends frame info, game commands and run ahead changes the way
+ * ConnectionManager does when it sends directly.  What it leaves out is ConnectionManager
+ * itself, which is tied to the one game in progress: there is no relaying through the packet
+ * router, and the game commands are a scripted stream rather than anyone's orders.
+ */
+class NetworkSoak
+{
+public:
+	enum
+	{
+		MAX_SOAK_CLIENTS = MAX_SLOTS,
+		FRAME_TIME_BUCKETS = 64,		///< milliseconds; the last bucket holds everything slower
+		SOAK_FRAME_WINDOW = 128			///< frames we remember frame info send times for; run ahead stays under half of this
+	};
+
+	NetworkSoak();
+	~NetworkSoak();
+
+	NetworkSimulator *getSimulator( void ) { return &m_simulator; }
+
+	/// Run numClients clients until every one of them has executed numFrames frames.  Results go to the debug log.
+	void run( Int numClients, Int numFrames );
+
+private:
+	struct SoakClient
+	{
+		Transport *transport;
+		UnsignedInt addr;
+		UnsignedShort port;
+		Connection *connections[MAX_SOAK_CLIENTS];				///< to every other client, NULL for ourselves
+		FrameDataManager *frameData[MAX_SOAK_CLIENTS];		///< every player's commands, ours included
+
+		UnsignedInt frame;								///< the logic frame, the next one to execute
+		UnsignedInt lastFrameCompleted;		///< frame info has gone out for every frame up to here
+		UnsignedInt lastExecutionFrame;		///< the frame our last commands were issued for
+		Int runAhead;
+		Int frameRate;
+		Int frameGrouping;
+		UnsignedShort lastCommandID;
+		UnsignedInt nextFrameTime;
+		UnsignedInt lastFrameTime;
+		UnsignedInt stallStart;						///< 0 if not stalled
+		UnsignedInt frameInfoTime[SOAK_FRAME_WINDOW];		///< when we sent frame info for each frame, for round trip times
+
+		// Results
+		UnsignedInt executedFrames;
+		UnsignedInt executedCommands;			///< game commands executed, which has to come out the same on every client
+		UnsignedInt stalls;
+		UnsignedInt stallTime;
+		UnsignedInt frameDataResets;			///< frames that got more commands than their frame info said
+		Real averageLatency;		///< round trip, in seconds, smoothed the way FrameMetrics does it
+		UnsignedInt frameTimes[FRAME_TIME_BUCKETS];
+	};
+
+	void startFrame( Int c );
+	void issueCommands( Int c );
+	void sendLocalCommand( Int c, NetCommandMsg *msg, UnsignedByte relay );
+	void receive( Int c );
+	void processCommand( Int c, NetCommandRef *ref );
+	Bool allCommandsReady( Int c );
+	void executeFrame( Int c );
+	UnsignedInt getExecutionFrame( Int c );
+	void logResults( UnsignedInt elapsed );
+
+	NetworkSimulator m_simulator;
+	SoakClient m_clients[MAX_SOAK_CLIENTS];
+	Int m_numClients;
+	Int m_runAheadChanges;
+	RunAheadController m_runAheadController;
+};
+
+#endif // defined(_DEBUG) || defined(_INTERNAL)
+
+#endif // __NETWORKSIMULATOR_H
@@ -0,0 +1,136 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+// RunAheadController.h ///////////////////////////////////////////////////////
+// Decides the run ahead and frame rate for the game on the packet router.
+
+#pragma once
+
+#ifndef __RUNAHEADCONTROLLER_H
+#define __RUNAHEADCONTROLLER_H
+
+#include "Lib/BaseType.h"
+#include "GameNetwork/NetworkDefs.h"
+
+/**
+ * The packet router feeds this the latency and fps reports from each player.  It keeps a window
+ * of each player's latency reports so that it can plan for the median plus one player's worth of
+ * jitter, rather than whatever the worst report of the last half second happened to be, and it
+ * smooths the fps reports so a momentary dip doesn't change the game's frame rate.  The run ahead
+ * goes up as soon as it is needed, but only a few frames at a time, and only comes down once it has
+ * been too high for a while.
+ */
+class RunAheadController
+{
+public:
+	enum
+	{
+		LATENCY_WINDOW = 64,							///< latency reports kept per player, at one report per NetworkRunAheadMetricsTime
+		MIN_LATENCY_SAMPLES = 4,					///< below this the percentiles are just the latest report
+		DECREASE_HOLD_DECISIONS = 4,			///< decisions in a row the run ahead has to be too high before it comes down
+		MAX_FRAME_RATE_STEP = 5,					///< most the frame rate changes in one decision
+		MIN_FRAME_RATE = 5,								///< absolutely do not run below 5 fps
+		DECISION_HISTORY = 32
+	};
+
+	/// Why a decision came out the way it did.
+	enum DecisionReason
+	{
+		DECISION_NO_CHANGE,
+		DECISION_INCREASE,					///< run ahead went up towards the target
+		DECISION_DECREASE,					///< run ahead came down towards the target
+		DECISION_HOLD,							///< the target is lower, but it hasn't been lower for long enough yet
+		DECISION_FRAME_RATE,				///< only the frame rate (or the slowest player) changed
+		DECISION_COUNT
+	};
+
+	struct Decision
+	{
+		UnsignedInt time;
+		DecisionReason reason;
+		Real latencyP50;				///< the two slowest players' median round trips, summed
+		Real latencyP95;				///< the same with their 95th percentiles, for comparison
+		Real targetLatency;			///< what the run ahead was planned for
+		Int minFps;							///< smoothed fps of the slowest player
+		Int minFpsPlayer;
+		Int targetRunAhead;
+		Int oldRunAhead;
+		Int newRunAhead;
+		Int oldFrameRate;
+		Int newFrameRate;
+	};
+
+	RunAheadController();
+
+	void reset( void );																	///< Forget every player's reports and all telemetry.
+	void setCurrent( Int runAhead, Int frameRate );			///< What the game is running at now, if we haven't decided anything yet.
+	Bool hasCurrent( void ) const { return m_runAhead > 0; }
+
+	void addLatencySample( Int slot, Real latency );		///< A round trip time to the packet router, in seconds.
+	void addFpsSample( Int slot, Int fps );
+	void removePlayer( Int slot );
+
+	/// Make a new decision for the players in playerMask.  Returns TRUE if the run ahead, the frame rate, or the slowest player changed.
+	Bool update( UnsignedInt now, UnsignedInt playerMask );
+
+	Int getRunAhead( void ) const { return m_runAhead; }
+	Int getFrameRate( void ) const { return m_frameRate; }
+	Int getMinFpsPlayer( void ) const { return m_minFpsPlayer; }
+
+	Real getLatencyPercentile( Int slot, Int percentile ) const;	///< 0 if this player hasn't reported yet.
+	Int getSmoothedFps( Int slot ) const;												///< -1 if this player hasn't reported yet.
+
+	// Telemetry
+	Int getNumDecisions( void ) const { return m_numDecisions; }
+	const Decision *getDecision( Int decisionsAgo ) const;				///< 0 is the latest; NULL if we don't remember that far back.
+	Int getDecisionCount( DecisionReason reason ) const { return m_decisionCounts[reason]; }
+	void logTelemetry( void ) const;
+
+	static const char *getDecisionReasonName( DecisionReason reason );
+
+	/// Milliseconds between packet sends for this run ahead, keeping the old value if the new one is within 10% of it.
+	static Int ComputeFrameGrouping( Int runAhead, Int frameRate, Int oldFrameGrouping );
+
+private:
+	Int chooseFrameRate( Int minFps ) const;
+	void recordDecision( const Decision &decision );
+
+	Real m_latencySamples[MAX_SLOTS][LATENCY_WINDOW];
+	Int m_numLatencySamples[MAX_SLOTS];
+	Int m_nextLatencySample[MAX_SLOTS];
+	Real m_smoothedFps[MAX_SLOTS];
+
+	Int m_runAhead;
+	Int m_frameRate;
+	Int m_minFpsPlayer;
+	Int m_decreaseVotes;
+
+	Decision m_decisions[DECISION_HISTORY];
+	Int m_numDecisions;
+	Int m_decisionCounts[DECISION_COUNT];
+};
+
+#endif // __RUNAHEADCONTROLLER_H
@@ -34,6 +34,8 @@
 #include "GameNetwork/udp.h"
 #include "GameNetwork/NetworkDefs.h"
 
+class NetworkSimulator;
+
 /**
  * The transport layer handles the UDP socket for the game, and will packetize and
  * de-packetize multiple ACK/CommandPacket/etc packets into larger aggregates.
@@ -50,17 +52,26 @@ public:
 
 	Bool init( AsciiString ip, UnsignedShort port );
 	Bool init( UnsignedInt ip, UnsignedShort port );
+#if defined(_DEBUG) || defined(_INTERNAL)
+	Bool init( NetworkSimulator *simulator, UnsignedInt ip, UnsignedShort port );	///< Use a simulated network instead of a UDP socket.
+#endif
 	void reset( void );
 	Bool update( void );									///< Call this once a GameEngine tick, regardless of whether the frame advances.
 
 	Bool doRecv( void );		///< call this to service the receive packets
 	Bool doSend( void );		///< call this to service the send queue.
 
+	UnsignedInt getTime( void ) const;		///< The clock sends, resends and statistics run on; the simulator's when there is one.
+
 	Bool queueSend(UnsignedInt addr, UnsignedShort port, const UnsignedByte *buf, Int len /*,
 		NetMessageFlags flags, Int id */);				///< Queue a packet for sending to the specified address and port.  This will be sent on the next update() call.
 
 	inline Bool allowBroadcasts(Bool val) { if (!m_udpsock) return false; return (m_udpsock->AllowBroadcasts(val))?true:false; }
 
+	// Packet packing - coalescing and compression of everything sent to a peer in one update
+	void setPeerPacking( UnsignedInt addr, UnsignedShort port, Bool val );	///< Offer packing to this address.  Nothing is packed until it offers too.
+	void clearPeerPacking( void );
+
 	// Latency insertion and packet loss
 	void setLatency( Bool val ) { m_useLatency = val; }
 	void setPacketLoss( Bool val ) { m_usePacketLoss = val; }
@@ -72,6 +83,7 @@ public:
 	Real getOutgoingPacketsPerSecond( void );
 	Real getUnknownBytesPerSecond( void );
 	Real getUnknownPacketsPerSecond( void );
+	Real getOutgoingPayloadBytesPerSecond( void );	///< What getOutgoingBytesPerSecond() would be without packing.
 
 	TransportMessage m_outBuffer[MAX_MESSAGES];
 	TransportMessage m_inBuffer[MAX_MESSAGES];
@@ -82,9 +94,51 @@ public:
 
 	UnsignedShort m_port;
 private:
+	enum
+	{
+		PACKED_FLAG_COMPRESSED = 0x01,		///< body is NetCompression data
+		PACKED_HEADER_SIZE = sizeof(UnsignedByte),
+		PACKED_MAX_BODY = MAX_PACKET_SIZE - PACKED_HEADER_SIZE
+	};
+
+	/**
+	 * Per-peer packing state.  The body of a packed packet is a list of
+	 * (UnsignedShort length, data) entries, one per queueSend() call.  Every
+	 * packed packet decodes on its own, so losing one costs nothing more than
+	 * the messages in it.
+	 */
+	struct TransportPeer
+	{
+		UnsignedInt addr;
+		UnsignedShort port;
+		Bool packing;
+		Bool peerAccepts;																		///< the peer offered packing too, so we can send it packed packets
+
+		UnsignedByte pending[PACKED_MAX_BODY];							///< messages queued this update, not yet packed
+		Int pendingLen;
+	};
+
+	TransportPeer *findPeer( UnsignedInt addr, UnsignedShort port );
+	Bool flushPeer( TransportPeer *peer );
+	Bool queueRawSend( UnsignedInt addr, UnsignedShort port, UnsignedShort magic, const UnsignedByte *buf, Int len );
+	Bool unpackMessage( TransportMessage *msg );
+	void storeIncomingMessage( TransportMessage *msg );
+
+	TransportPeer m_peers[MAX_SLOTS];
+
+	void initBuffers( UnsignedShort port );
+	Int writePacket( const UnsignedByte *buf, Int len, UnsignedInt addr, UnsignedShort port );
+	Int readPacket( UnsignedByte *buf, Int len, UnsignedInt *addr, UnsignedShort *port );
+	Bool isOpen( void ) const;
+
 	Bool m_winsockInit;
 	UDP *m_udpsock;
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+	NetworkSimulator *m_simulator;
+	UnsignedInt m_simulatedAddr;
+#endif
+
 	// Latency insertion and packet loss
 	Bool m_useLatency;
 	Bool m_usePacketLoss;
@@ -96,6 +150,7 @@ private:
 	UnsignedInt m_incomingPackets[MAX_TRANSPORT_STATISTICS_SECONDS];
 	UnsignedInt m_unknownPackets[MAX_TRANSPORT_STATISTICS_SECONDS];
 	UnsignedInt m_outgoingPackets[MAX_TRANSPORT_STATISTICS_SECONDS];
+	UnsignedInt m_outgoingPayloadBytes[MAX_TRANSPORT_STATISTICS_SECONDS];
 	Int m_statisticsSlot;
 	UnsignedInt m_lastSecond;
 
@@ -469,6 +469,206 @@ Int parsePacketLoss(char *args[], int num)
 	return 2;
 }
 
+//=============================================================================
+//=============================================================================
+Int parsePacketBandwidth(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_packetBandwidth = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseNetSoak(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_netSoakClients = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseNetSoakFrames(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_netSoakFrames = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseParticleBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_particleBenchmarkSystems = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseParticleBenchmarkFrames(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_particleBenchmarkFrames = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseViewCullBenchmark(char *args[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_viewCullBenchmark = TRUE;
+	}
+	return 1;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseAnimBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 2)
+	{
+		TheWritableGlobalData->m_animBenchmarkModel = args[1];
+		TheWritableGlobalData->m_animBenchmarkAnim = args[2];
+	}
+	return 3;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseAnimBenchmarkCount(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_animBenchmarkCount = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseCollisionBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_collisionBenchmarkTemplate = args[1];
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseCollisionBenchmarkUnits(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_collisionBenchmarkUnits = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseCollisionBenchmarkFrames(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_collisionBenchmarkFrames = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseBarrageBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 2)
+	{
+		TheWritableGlobalData->m_barrageBenchmarkWeapon = args[1];
+		TheWritableGlobalData->m_barrageBenchmarkTarget = args[2];
+	}
+	return 3;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseBarrageBenchmarkUnits(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_barrageBenchmarkUnits = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseBarrageBenchmarkShots(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_barrageBenchmarkShots = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseBarrageBenchmarkFrames(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_barrageBenchmarkFrames = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseLineOfSightBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_losBenchmarkQueries = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseStateMachineBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_stateMachineBenchmarkFrames = atoi(args[1]);
+	}
+	return 2;
+}
+
+//=============================================================================
+//=============================================================================
+Int parseTerrainPanBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_terrainPanBenchmarkFrames = atoi(args[1]);
+	}
+	return 2;
+}
+
 //=============================================================================
 //=============================================================================
 Int parseLowDetail(char *args[], int num)
@@ -1182,6 +1382,24 @@ static CommandLineParam params[] =
 	{ "-latAmp", parseLatencyAmplitude },
 	{ "-latPeriod", parseLatencyPeriod },
 	{ "-latNoise", parseLatencyNoise },
+	{ "-bandwidth", parsePacketBandwidth },
+	{ "-netSoak", parseNetSoak },
+	{ "-netSoakFrames", parseNetSoakFrames },
+	{ "-particleBenchmark", parseParticleBenchmark },
+	{ "-particleBenchmarkFrames", parseParticleBenchmarkFrames },
+	{ "-viewCullBenchmark", parseViewCullBenchmark },
+	{ "-animBenchmark", parseAnimBenchmark },
+	{ "-animBenchmarkCount", parseAnimBenchmarkCount },
+	{ "-collisionBenchmark", parseCollisionBenchmark },
+	{ "-collisionBenchmarkUnits", parseCollisionBenchmarkUnits },
+	{ "-collisionBenchmarkFrames", parseCollisionBenchmarkFrames },
+	{ "-barrageBenchmark", parseBarrageBenchmark },
+	{ "-barrageBenchmarkUnits", parseBarrageBenchmarkUnits },
+	{ "-barrageBenchmarkShots", parseBarrageBenchmarkShots },
+	{ "-barrageBenchmarkFrames", parseBarrageBenchmarkFrames },
+	{ "-losBenchmark", parseLineOfSightBenchmark },
+	{ "-stateMachineBenchmark", parseStateMachineBenchmark },
+	{ "-terrainPanBenchmark", parseTerrainPanBenchmark },
 	{ "-noViewLimit", parseNoViewLimit },
 	{ "-lowDetail", parseLowDetail },
 	{ "-noDynamicLOD", parseNoDynamicLOD },
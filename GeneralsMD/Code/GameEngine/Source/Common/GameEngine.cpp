@@ -102,6 +102,7 @@
 #include "GameClient/GUICallbacks.h"
 
 #include "GameNetwork/NetworkInterface.h"
+#include "GameNetwork/NetworkSimulator.h"
 #include "GameNetwork/WOLBrowser/WebBrowser.h"
 #include "GameNetwork/LANAPI.h"
 #include "GameNetwork/GameSpy/GameResultsThread.h"
@@ -621,6 +622,36 @@ void GameEngine::init( int argc, char *argv[] )
 			//populateMapListbox(NULL, true, true);
 			m_quitting = TRUE;
 		}
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+		if (TheGlobalData->m_netSoakClients > 0)
+		{
+			// run the simulated network soak, log the results, and quit
+			NetworkSoak *soak = NEW NetworkSoak;
+			soak->run(TheGlobalData->m_netSoakClients, TheGlobalData->m_netSoakFrames);
+			delete soak;
+			m_quitting = TRUE;
+		}
+
+		if (TheGlobalData->m_particleBenchmarkSystems > 0)
+		{
+			// run the headless particle benchmark, log the results, and quit
+			TheParticleSystemManager->runBenchmark(TheGlobalData->m_particleBenchmarkSystems, TheGlobalData->m_particleBenchmarkFrames);
+			m_quitting = TRUE;
+		}
+
+		if (TheGlobalData->m_viewCullBenchmark)
+		{
+			// the view culling benchmark ran when the display was created, so just quit
+			m_quitting = TRUE;
+		}
+
+		if (TheGlobalData->m_animBenchmarkModel.isNotEmpty())
+		{
+			// so did the animation benchmark
+			m_quitting = TRUE;
+		}
+#endif
 		
 		// load the initial shell screen
 		//TheShell->push( AsciiString("Menus/MainMenu.wnd") );
@@ -306,6 +306,9 @@ GlobalData* GlobalData::m_theOriginal = NULL;
 
 	{ "MaxTranslucentObjects",						INI::parseInt,				NULL,			offsetof( GlobalData, m_maxVisibleTranslucentObjects) },
 	{ "OccludedColorLuminanceScale",				INI::parseReal,				NULL,			offsetof( GlobalData, m_occludedLuminanceScale) },
+	{ "UseHierarchicalViewCulling",				INI::parseBool,				NULL,			offsetof( GlobalData, m_useHierarchicalViewCulling) },
+	{ "ShareAnimationPoses",							INI::parseBool,				NULL,			offsetof( GlobalData, m_shareAnimationPoses) },
+	{ "AnimationFrameCacheSize",					INI::parseInt,				NULL,			offsetof( GlobalData, m_animationFrameCacheSize) },
 
 /* These are internal use only, they do not need file definitons 
 	{ "TerrainAmbientRGB",				INI::parseRGBColor,		NULL,			offsetof( GlobalData, m_terrainAmbient ) },
@@ -367,6 +370,7 @@ GlobalData* GlobalData::m_theOriginal = NULL;
 	{ "LatencyPeriod",							INI::parseInt,				NULL,			offsetof( GlobalData, m_latencyPeriod ) },
 	{ "LatencyNoise",								INI::parseInt,				NULL,			offsetof( GlobalData, m_latencyNoise ) },
 	{ "PacketLoss",									INI::parseInt,				NULL,			offsetof( GlobalData, m_packetLoss ) },
+	{ "PacketBandwidth",						INI::parseInt,				NULL,			offsetof( GlobalData, m_packetBandwidth ) },
 */
 
 	{ "BuildSpeed",									INI::parseReal,				NULL,			offsetof( GlobalData, m_BuildSpeed ) },
@@ -390,6 +394,8 @@ GlobalData* GlobalData::m_theOriginal = NULL;
 
 	{ "MaxParticleCount",						INI::parseInt,				NULL,			offsetof( GlobalData, m_maxParticleCount ) },
 	{ "MaxFieldParticleCount",						INI::parseInt,				NULL,			offsetof( GlobalData, m_maxFieldParticleCount ) },
+	{ "ParticleUpdateThreads",						INI::parseInt,				NULL,			offsetof( GlobalData, m_particleUpdateThreads ) },
+	{ "AssetLoadThreads",						INI::parseInt,				NULL,			offsetof( GlobalData, m_assetLoadThreads ) },
 	{ "HorizontalScrollSpeedFactor",INI::parseReal,				NULL,			offsetof( GlobalData, m_horizontalScrollSpeedFactor ) },
 	{ "VerticalScrollSpeedFactor",	INI::parseReal,				NULL,			offsetof( GlobalData, m_verticalScrollSpeedFactor ) },
 	{ "ScrollAmountCutoff",					INI::parseReal,				NULL,			offsetof( GlobalData, m_scrollAmountCutoff ) },
@@ -480,10 +486,13 @@ GlobalData* GlobalData::m_theOriginal = NULL;
 	{ "NetworkRunAheadMetricsTime", INI::parseInt, NULL, offsetof(GlobalData, m_networkRunAheadMetricsTime) },
 	{ "NetworkCushionHistoryLength", INI::parseInt, NULL, offsetof(GlobalData, m_networkCushionHistoryLength) },
 	{ "NetworkRunAheadSlack", INI::parseInt, NULL, offsetof(GlobalData, m_networkRunAheadSlack) },
+	{ "NetworkRunAheadMaxStep", INI::parseInt, NULL, offsetof(GlobalData, m_networkRunAheadMaxStep) },
+	{ "NetworkRunAheadHysteresis", INI::parseInt, NULL, offsetof(GlobalData, m_networkRunAheadHysteresis) },
 	{ "NetworkKeepAliveDelay", INI::parseInt, NULL, offsetof(GlobalData, m_networkKeepAliveDelay) },
 	{ "NetworkDisconnectTime", INI::parseInt, NULL, offsetof(GlobalData, m_networkDisconnectTime) },
 	{ "NetworkPlayerTimeoutTime", INI::parseInt, NULL, offsetof(GlobalData, m_networkPlayerTimeoutTime) },
 	{ "NetworkDisconnectScreenNotifyTime", INI::parseInt, NULL, offsetof(GlobalData, m_networkDisconnectScreenNotifyTime) },
+	{ "NetworkPacketPacking", INI::parseBool, NULL, offsetof(GlobalData, m_networkPacketPacking) },
 	
 	{ "KeyboardCameraRotateSpeed", INI::parseReal, NULL, offsetof( GlobalData, m_keyboardCameraRotateSpeed ) },
 	{ "PlayStats",									INI::parseInt,				NULL,			offsetof( GlobalData, m_playStats ) },
@@ -587,6 +596,26 @@ GlobalData::GlobalData()
 	m_latencyPeriod = 0;
 	m_latencyNoise = 0;
 	m_packetLoss = 0;
+	m_packetBandwidth = 0;
+	m_netSoakClients = 0;
+	m_netSoakFrames = 3000;
+	m_particleBenchmarkSystems = 0;
+	m_particleBenchmarkFrames = 1000;
+	m_viewCullBenchmark = FALSE;
+	m_animBenchmarkModel.clear();
+	m_animBenchmarkAnim.clear();
+	m_animBenchmarkCount = 500;
+	m_collisionBenchmarkTemplate.clear();
+	m_collisionBenchmarkUnits = 500;
+	m_collisionBenchmarkFrames = 300;
+	m_barrageBenchmarkWeapon.clear();
+	m_barrageBenchmarkTarget.clear();
+	m_barrageBenchmarkUnits = 500;
+	m_barrageBenchmarkShots = 20;
+	m_barrageBenchmarkFrames = 100;
+	m_losBenchmarkQueries = 0;
+	m_stateMachineBenchmarkFrames = 0;
+	m_terrainPanBenchmarkFrames = 0;
 	m_saveStats = FALSE;
 	m_saveAllStats = FALSE;
 	m_useLocalMOTD = FALSE;
@@ -768,6 +797,9 @@ GlobalData::GlobalData()
 	m_maxVisibleOccludeeObjects = 512;
 	m_maxVisibleNonOccluderOrOccludeeObjects = 512;
 	m_occludedLuminanceScale = 0.5f;
+	m_useHierarchicalViewCulling = FALSE;
+	m_shareAnimationPoses = FALSE;
+	m_animationFrameCacheSize = 1024;
 
 	m_useFX = TRUE;
 
@@ -808,6 +840,7 @@ GlobalData::GlobalData()
 	m_drawEntireTerrain = FALSE;
 	m_maxParticleCount = 0;
 	m_maxFieldParticleCount = 30;
+	m_particleUpdateThreads = 0;
 	
 	// End Add
 
@@ -838,6 +871,7 @@ GlobalData::GlobalData()
 	m_preloadAssets = FALSE;
 	m_preloadEverything = FALSE;
 	m_preloadReport = FALSE;
+	m_assetLoadThreads = -1;
 
 	m_netMinPlayers = 1; // allowing sandbox mode
 
@@ -936,10 +970,13 @@ GlobalData::GlobalData()
 	m_networkRunAheadMetricsTime = 500;
 	m_networkCushionHistoryLength = 10;
 	m_networkRunAheadSlack = 10;
+	m_networkRunAheadMaxStep = 4;
+	m_networkRunAheadHysteresis = 2;
 	m_networkKeepAliveDelay = 20;
 	m_networkDisconnectTime = 5000;
 	m_networkPlayerTimeoutTime = 60000;
 	m_networkDisconnectScreenNotifyTime = 15000;
+	m_networkPacketPacking = TRUE;
 
 	m_isBreakableMovie = FALSE;
 	m_breakTheMovie = FALSE;
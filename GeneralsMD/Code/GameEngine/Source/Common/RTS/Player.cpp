@@ -606,6 +606,9 @@ Relationship Player::getRelationship(const Team *that) const
 //=============================================================================
 void Player::setPlayerRelationship(const Player *that, Relationship r)
 {
+	if (ThePartitionManager)
+		ThePartitionManager->invalidateEnemyCandidates();
+
 	if (that != NULL)
 	{
 		// note that this creates the entry if it doesn't exist.
@@ -616,6 +619,9 @@ void Player::setPlayerRelationship(const Player *that, Relationship r)
 // ------------------------------------------------------------------------
 Bool Player::removePlayerRelationship(const Player *that)
 {
+	if (ThePartitionManager)
+		ThePartitionManager->invalidateEnemyCandidates();
+
 	if (!m_playerRelations->m_map.empty())
 	{
 		if (that == NULL)
@@ -639,6 +645,9 @@ Bool Player::removePlayerRelationship(const Player *that)
 //=============================================================================
 void Player::setTeamRelationship(const Team *that, Relationship r)
 {
+	if (ThePartitionManager)
+		ThePartitionManager->invalidateEnemyCandidates();
+
 	if (that != NULL)
 	{
 		// note that this creates the entry if it doesn't exist.
@@ -649,6 +658,9 @@ void Player::setTeamRelationship(const Team *that, Relationship r)
 // ------------------------------------------------------------------------
 Bool Player::removeTeamRelationship(const Team *that)
 {
+	if (ThePartitionManager)
+		ThePartitionManager->invalidateEnemyCandidates();
+
 	if (!m_teamRelations->m_map.empty())
 	{
 		if (that == NULL)
@@ -1016,6 +1028,10 @@ void Player::initFromDict(const Dict* d)
 	/// @todo Ack!  the todo in PlayerList::reset() mentioning the need for a Player::reset() really needs to get done.
 	m_playerRelations->m_map.clear(); // For now, it has been decided to just fix this one.  Dear god me must reset.
 	m_teamRelations->m_map.clear(); // For now, it has been decided to just fix this one.  Dear god me must reset.
+
+	// our teams and relationships were just redone, so who counts as an enemy may have changed.
+	if (ThePartitionManager)
+		ThePartitionManager->invalidateEnemyCandidates();
 	
 	Int i;
 	for ( i = 0; i < MAX_PLAYER_COUNT; ++i ) // For now, it has been decided to just fix this one.  Dear god me must reset.
@@ -1573,6 +1589,20 @@ Bool Player::getAiBaseCenter(Coord3D *pos)
 	return m_ai?m_ai->getBaseCenter(pos):false; 
 }
 
+#ifdef DUMP_PERF_STATS
+//-------------------------------------------------------------------------------------------------
+/** How long the ai took to think this frame, and on average. */
+//-------------------------------------------------------------------------------------------------
+Bool Player::getAiPlannerStats(double& msecThisFrame, double& msecAverage) const
+{
+	if (!m_ai)
+		return false;
+
+	m_ai->getPlannerStats(msecThisFrame, msecAverage);
+	return true;
+}
+#endif
+
 //-------------------------------------------------------------------------------------------------
 /** Repair bridge or structure. */
 //-------------------------------------------------------------------------------------------------
@@ -1405,6 +1405,10 @@ void Team::setControllingPlayer(Player *newController)
 	// NULL is not allowed, but is caught by TeamPrototype::setControllingPlayer()
 	m_proto->setControllingPlayer(newController);
 
+	// everyone's enemies on this team just changed sides.
+	if (ThePartitionManager)
+		ThePartitionManager->invalidateEnemyCandidates();
+
 	// This function is used by one script, and it is kind of odd.  The actual units
 	// are not getting captured, the team they are on is being reassigned to a new player.  
 	// The Team doesn't change, it just starts to return a different answer when you ask for
@@ -1613,6 +1617,12 @@ Bool Team::removeOverridePlayerRelationship( Int playerIndex )
 	return false;
 }
 
+// ------------------------------------------------------------------------
+Bool Team::hasOverrideRelationships() const
+{
+	return !m_teamRelations->m_map.empty() || !m_playerRelations->m_map.empty();
+}
+
 // ------------------------------------------------------------------------
 void Team::countObjectsByThingTemplate(Int numTmplates, const ThingTemplate* const* things, Bool ignoreDead, Int *counts, Bool ignoreUnderConstruction) const
 {
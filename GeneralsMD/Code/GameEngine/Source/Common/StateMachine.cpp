@@ -49,6 +49,36 @@
 //#include "Common/PerfTimer.h"
 
 //static PerfTimer s_stateMachineTimer("StateMachine::update", false, PERFMETRICS_LOGIC_STARTFRAME, PERFMETRICS_LOGIC_STOPFRAME);
+
+// state updates run and skipped, over every machine, for the frame in s_updateStatsFrame.
+// (a machine whose owner's update module is asleep isn't called at all, so isn't counted.)
+static UnsignedInt s_updateStatsFrame = 0xffffffff;
+static Int s_updatesExecuted = 0;
+static Int s_updatesSkipped = 0;
+static Int s_updatesExecutedTotal = 0;
+static Int s_updatesSkippedTotal = 0;
+
+static inline void countStateUpdate( UnsignedInt now, Bool executed )
+{
+	if (now != s_updateStatsFrame)
+	{
+		s_updateStatsFrame = now;
+		s_updatesExecuted = 0;
+		s_updatesSkipped = 0;
+	}
+
+	if (executed)
+	{
+		++s_updatesExecuted;
+		++s_updatesExecutedTotal;
+	}
+	else
+	{
+		++s_updatesSkipped;
+		++s_updatesSkippedTotal;
+	}
+}
+
 //-------------------------------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 /**
@@ -425,6 +455,7 @@ StateReturnType StateMachine::updateStateMachine()
 		{
 			return STATE_FAILURE;
 		}
+		countStateUpdate( now, false );
 		return m_currentState->friend_checkForSleepTransitions( STATE_SLEEP(m_sleepTill - now) );
 	}
 
@@ -433,6 +464,8 @@ StateReturnType StateMachine::updateStateMachine()
 
 	if (m_currentState)
 	{
+		countStateUpdate( now, true );
+
 		// update() can change m_currentState, so save it for a moment...
 		State* stateBeforeUpdate = m_currentState;
 
@@ -554,6 +587,40 @@ StateReturnType StateMachine::setState( StateID newStateID )
 	return internalSetState( newStateID );
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Let the current state know something happened to our owner. If the state
+ * wants to react to it, any sleep it asked for is cut short, so it will be
+ * updated the next time the machine is.
+ */
+Bool StateMachine::wakeOnEvent( StateWakeEvent event )
+{
+	if (m_currentState == NULL || !m_currentState->wakeOnEvent( event ))
+		return false;
+
+	m_sleepTill = 0;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void StateMachine::getUpdateStats( Int& executed, Int& skipped )
+{
+	if (TheGameLogic->getFrame() != s_updateStatsFrame)
+	{
+		executed = skipped = 0;
+		return;
+	}
+	executed = s_updatesExecuted;
+	skipped = s_updatesSkipped;
+}
+
+//-----------------------------------------------------------------------------
+void StateMachine::getUpdateTotals( Int& executed, Int& skipped )
+{
+	executed = s_updatesExecutedTotal;
+	skipped = s_updatesSkippedTotal;
+}
+
 //-----------------------------------------------------------------------------
 /**
  * Change the current state of the machine.
@@ -264,6 +264,33 @@ Bool ArchiveFileSystem::getFileInfo(const AsciiString& filename, FileInfo *fileI
 	}
 }
 
+Bool ArchiveFileSystem::getArchivedFileInfo(const AsciiString& filename, ArchivedFileInfo *fileInfo) const
+{
+	if (fileInfo == NULL) {
+		return FALSE;
+	}
+
+	if (filename.getLength() <= 0) {
+		return FALSE;
+	}
+
+	AsciiString archiveFilename = getArchiveFilenameForFile(filename);
+	ArchiveFileMap::const_iterator it = m_archiveFileMap.find(archiveFilename);
+	if (it == m_archiveFileMap.end())
+	{
+		return FALSE;
+	}
+
+	const ArchivedFileInfo *archivedFileInfo = it->second->getArchivedFileInfo(filename);
+	if (archivedFileInfo == NULL)
+	{
+		return FALSE;
+	}
+
+	*fileInfo = *archivedFileInfo;
+	return TRUE;
+}
+
 AsciiString ArchiveFileSystem::getArchiveFilenameForFile(const AsciiString& filename) const
 {
 	AsciiString path;
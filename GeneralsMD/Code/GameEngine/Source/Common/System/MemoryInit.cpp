@@ -87,7 +87,6 @@ struct PoolSizeRec
 // not const -- we might override from INI
 static PoolSizeRec sizes[] = 
 {
-	{ "PartitionContactListNode", 2048, 512 },
 	{ "BattleshipUpdate", 32, 32 },
 	{ "FlyToDestAndDestroyUpdate", 32, 32 },
 	{ "MusicTrack", 32, 32 },
@@ -591,6 +590,7 @@ static PoolSizeRec sizes[] =
 	{ "Anim2DTemplate", 32, 32 },
 	{ "ObjectTypes", 32, 32 },
 	{ "NetCommandList", 512, 32 },
+	{ "NetCommandListIndex", 16, 16 },
 	{ "TurretAIData", 256, 32 },
 	{ "NetCommandMsg", 32, 32 },
 	{ "NetGameCommandMsg", 64, 32 },
@@ -658,6 +658,7 @@ static PoolSizeRec sizes[] =
 	{ "AlphaEdgeTextureClass", 4, 4 },
 	{ "AlphaTerrainTextureClass", 4, 4 },
 	{ "TerrainTextureClass", 4, 4 },
+	{ "W3DSceneCullProxy", 4096, 1024 },
 	{ "MeshClass", 14000, 2000 },
 	{ "HTreeClass", 2048, 512 },
 	{ "HLodClass", 2048, 512 },
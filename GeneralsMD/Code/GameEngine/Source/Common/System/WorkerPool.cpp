@@ -0,0 +1,187 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+// WorkerPool.cpp /////////////////////////////////////////////////////////////
+// A few worker threads for splitting one job into batches on the main thread's behalf.
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+
+#include "Common/WorkerPool.h"
+
+#include "thread.h"
+
+//-------------------------------------------------------------------------------------------------
+class WorkerThread : public ThreadClass
+{
+public:
+	WorkerThread( WorkerPool *pool, Int index ) : ThreadClass( "WorkerPool" ), m_pool( pool ), m_index( index ), m_quit( FALSE ) { }
+
+	void quit( void ) { m_quit = TRUE; }
+
+protected:
+	virtual void Thread_Function( void );
+
+	WorkerPool *m_pool;
+	Int m_index;
+	volatile Bool m_quit;
+};
+
+//-------------------------------------------------------------------------------------------------
+void WorkerThread::Thread_Function( void )
+{
+	while (!m_quit)
+	{
+		WaitForSingleObject( m_pool->m_startEvents[m_index], INFINITE );
+		if (m_quit)
+			break;
+
+		m_pool->runBatches();
+		m_pool->workerDone();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+WorkerPool::WorkerPool()
+{
+	for (Int i = 0; i < MAX_WORKER_THREADS; ++i)
+	{
+		m_threads[i] = NULL;
+		m_startEvents[i] = NULL;
+	}
+	m_doneEvent = NULL;
+	m_numThreads = 0;
+	m_job = NULL;
+	m_numBatches = 0;
+	m_nextBatch = 0;
+	m_busyWorkers = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+WorkerPool::~WorkerPool()
+{
+	shutdown();
+}
+
+//-------------------------------------------------------------------------------------------------
+void WorkerPool::init( Int numThreads )
+{
+	shutdown();
+
+	if (numThreads < 0)
+	{
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo( &systemInfo );
+		numThreads = (Int)systemInfo.dwNumberOfProcessors - 1;
+	}
+
+	if (numThreads > MAX_WORKER_THREADS)
+		numThreads = MAX_WORKER_THREADS;
+	if (numThreads <= 0)
+		return;
+
+	m_doneEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+	for (Int i = 0; i < numThreads; ++i)
+	{
+		m_startEvents[i] = CreateEvent( NULL, FALSE, FALSE, NULL );
+		m_threads[i] = NEW WorkerThread( this, i );
+		m_threads[i]->Execute();
+	}
+	m_numThreads = numThreads;
+
+	DEBUG_LOG(("WorkerPool::init - started %d worker threads\n", m_numThreads));
+}
+
+//-------------------------------------------------------------------------------------------------
+void WorkerPool::shutdown( void )
+{
+	for (Int i = 0; i < m_numThreads; ++i)
+	{
+		m_threads[i]->quit();
+		SetEvent( m_startEvents[i] );
+		m_threads[i]->Stop();
+		delete m_threads[i];
+		m_threads[i] = NULL;
+
+		CloseHandle( m_startEvents[i] );
+		m_startEvents[i] = NULL;
+	}
+
+	if (m_doneEvent)
+	{
+		CloseHandle( m_doneEvent );
+		m_doneEvent = NULL;
+	}
+
+	m_numThreads = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+void WorkerPool::run( WorkerJob *job, Int numBatches )
+{
+	if (numBatches <= 0)
+		return;
+
+	// not worth waking anybody up for
+	if (m_numThreads == 0 || numBatches == 1)
+	{
+		for (Int i = 0; i < numBatches; ++i)
+			job->runBatch( i );
+		return;
+	}
+
+	m_job = job;
+	m_numBatches = numBatches;
+	m_nextBatch = 0;
+
+	// only wake as many workers as there are batches for them to take
+	Int numWorkers = min( m_numThreads, numBatches - 1 );
+	m_busyWorkers = numWorkers;
+	for (Int i = 0; i < numWorkers; ++i)
+		SetEvent( m_startEvents[i] );
+
+	runBatches();
+
+	WaitForSingleObject( m_doneEvent, INFINITE );
+	m_job = NULL;
+}
+
+//-------------------------------------------------------------------------------------------------
+void WorkerPool::runBatches( void )
+{
+	for (;;)
+	{
+		Int batch = InterlockedIncrement( (LONG *)&m_nextBatch ) - 1;
+		if (batch >= m_numBatches)
+			break;
+
+		m_job->runBatch( batch );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+void WorkerPool::workerDone( void )
+{
+	if (InterlockedDecrement( (LONG *)&m_busyWorkers ) == 0)
+		SetEvent( m_doneEvent );
+}
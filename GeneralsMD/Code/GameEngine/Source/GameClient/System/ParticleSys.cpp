@@ -36,6 +36,7 @@
 #include "Common/PerfTimer.h"
 #include "Common/ThingFactory.h"
 #include "Common/GameLOD.h"
+#include "Common/WorkerPool.h"
 #include "Common/Xfer.h"
 
 #include "GameClient/Drawable.h"
@@ -355,29 +356,25 @@ void Particle::applyForce( const Coord3D *force )
 // ------------------------------------------------------------------------------------------------
 /** Update the behavior of an individual particle */
 // ------------------------------------------------------------------------------------------------
-Bool Particle::update( void )
+Bool Particle::update( const ParticleUpdateInfo &info )
 {
-	// integrate acceleration into velocity
+	// integrate acceleration (and the system's gravity) into velocity
 	m_vel.x += m_accel.x;
 	m_vel.y += m_accel.y;
-	m_vel.z += m_accel.z;
+	m_vel.z += m_accel.z + info.m_gravity;
 
 	m_vel.x *= m_velDamping;
 	m_vel.y *= m_velDamping;
 	m_vel.z *= m_velDamping;
 
 	// integrate velocity into position
-	const Coord3D *driftVel = m_system->getDriftVelocity();
-	m_pos.x += m_vel.x + driftVel->x;
-	m_pos.y += m_vel.y + driftVel->y;
-	m_pos.z += m_vel.z + driftVel->z;
+	m_pos.x += m_vel.x + info.m_driftVel.x;
+	m_pos.y += m_vel.y + info.m_driftVel.y;
+	m_pos.z += m_vel.z + info.m_driftVel.z;
 
 	// integrate the wind (if specified) into position
-	ParticleSystemInfo::WindMotion windMotion = m_system->getWindMotion();
-
-	// see if we should even do anything
-	if( windMotion != ParticleSystemInfo::WIND_MOTION_NOT_USED )
-		doWindMotion();
+	if( info.m_doWind )
+		doWindMotion( info );
 
 	// update orientation
 	m_angleZ += m_angularRateZ;
@@ -402,13 +399,13 @@ Bool Particle::update( void )
 	// Update alpha (if used)
 	//
 
-	if (m_system->getShaderType() != ParticleSystemInfo::ADDITIVE)
+	if (info.m_updateAlpha)
 	{
 		m_alpha += m_alphaRate;
 
 		if (m_alphaTargetKey < MAX_KEYFRAMES && m_alphaKey[ m_alphaTargetKey ].frame)
 		{
-			if (TheGameClient->getFrame() - m_createTimestamp >= m_alphaKey[ m_alphaTargetKey ].frame)
+			if (info.m_frame - m_createTimestamp >= m_alphaKey[ m_alphaTargetKey ].frame)
 			{
 				m_alpha = m_alphaKey[ m_alphaTargetKey ].value;
 				m_alphaTargetKey++;
@@ -434,7 +431,7 @@ Bool Particle::update( void )
 
 	if (m_colorTargetKey < MAX_KEYFRAMES && m_colorKey[ m_colorTargetKey ].frame)
 	{
-		if (TheGameClient->getFrame() - m_createTimestamp >= m_colorKey[ m_colorTargetKey ].frame)
+		if (info.m_frame - m_createTimestamp >= m_colorKey[ m_colorTargetKey ].frame)
 		{
 			// can't set, because of colorscale
 			// m_color = m_colorKey[ m_colorTargetKey ].color;
@@ -488,56 +485,17 @@ Bool Particle::update( void )
 // ------------------------------------------------------------------------------------------------
 /** Do wind motion as specified by the particle system template, if present */
 // ------------------------------------------------------------------------------------------------
-void Particle::doWindMotion( void )
+void Particle::doWindMotion( const ParticleUpdateInfo &info )
 {
 
-	// get the angle of the wind
-	Real windAngle = m_system->getWindAngle();
-
-	// get the system position
-	Coord3D systemPos;
-	m_system->getPosition( &systemPos );
-
-	// when we're attached objects and drawables we offset by that position as well
-	if( ObjectID attachedObj = m_system->getAttachedObject() )
-	{
-		Object *obj = TheGameLogic->findObjectByID( attachedObj );
-
-		if( obj )
-		{
-			const Coord3D *objPos = obj->getPosition();
-
-			systemPos.x += objPos->x;
-			systemPos.y += objPos->y;
-			systemPos.z += objPos->z;
-
-		}  // end if
-
-	}  // end if
-	else if( DrawableID attachedDraw = m_system->getAttachedDrawable() )
-	{
-		Drawable *draw = TheGameClient->findDrawableByID( attachedDraw );
-
-		if( draw )
-		{
-			const Coord3D *drawPos = draw->getPosition();
-
-			systemPos.x += drawPos->x;
-			systemPos.y += drawPos->y;
-			systemPos.z += drawPos->z;
-
-		}  // end if
-
-	}  // end else if
-
 	//
 	// compute a vector from the system position in the world to the particle ... we will use
 	// this to compute how much force we apply
 	//
 	Coord3D v;
-	v.x = m_pos.x - systemPos.x;
-	v.y = m_pos.y - systemPos.y;
-	v.z = m_pos.z - systemPos.z;
+	v.x = m_pos.x - info.m_windPos.x;
+	v.y = m_pos.y - info.m_windPos.y;
+	v.z = m_pos.z - info.m_windPos.z;
 
 	// distance amounts for full force from wind and no force at all
 	Real fullForceDistance = 75.0f;
@@ -560,8 +518,8 @@ void Particle::doWindMotion( void )
 																		(noForceDistance - fullForceDistance)));
 
 		// integate the wind motion into the position
-		m_pos.x += (Cos( windAngle ) * windForceStrength);
-		m_pos.y += (Sin( windAngle ) * windForceStrength);
+		m_pos.x += (info.m_windCos * windForceStrength);
+		m_pos.y += (info.m_windSin * windForceStrength);
 
 	}  // end if
 
@@ -1037,6 +995,7 @@ ParticleSystem::ParticleSystem( const ParticleSystemTemplate *sysTemplate,
 																Bool createSlaves )
 {
 	m_systemParticlesHead = m_systemParticlesTail = NULL;
+	m_deadParticlesHead = NULL;
 
 	m_isFirstPos = true;
 	m_template = sysTemplate;
@@ -1179,7 +1138,7 @@ ParticleSystem::ParticleSystem( const ParticleSystemTemplate *sysTemplate,
 	m_personalityStore = 0;
 	m_controlParticle = NULL;
 
-	TheParticleSystemManager->friend_addParticleSystem(this);
+	m_managerListIt = TheParticleSystemManager->friend_addParticleSystem(this);
 
 	//DEBUG_ASSERTLOG(!(m_totalParticleSystemCount % 10 == 0), ( "TotalParticleSystemCount = %d\n", m_totalParticleSystemCount ));
 }
@@ -1214,6 +1173,7 @@ ParticleSystem::~ParticleSystem()
 	// destroy all particles "in the air"
 	while (m_systemParticlesHead)
 		m_systemParticlesHead->deleteInstance();
+	releaseDeadParticles();
 
 	m_attachedToDrawableID = INVALID_DRAWABLE_ID;
 	m_attachedToObjectID = INVALID_ID;
@@ -1224,7 +1184,7 @@ ParticleSystem::~ParticleSystem()
 
 	m_controlParticle = NULL;
 	
-	TheParticleSystemManager->friend_removeParticleSystem(this);
+	TheParticleSystemManager->friend_removeParticleSystem(this, m_managerListIt);
 	//DEBUG_ASSERTLOG(!(m_totalParticleSystemCount % 10 == 0), ( "TotalParticleSystemCount = %d\n", m_totalParticleSystemCount ));
 }
 
@@ -1851,6 +1811,21 @@ Bool ParticleSystem::update( Int localPlayerIndex  )
 	if (TheGlobalData->m_useFX == FALSE)
 		return false;
 
+	if (updateEmitter( localPlayerIndex ) == false)
+		return true;
+
+	updateParticles();
+
+	return updateLifetime();
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Move the system with whatever it's attached to and emit this frame's particles.  Returns
+	* false if the system is still waiting out its initial delay, in which case its particles
+	* (and its lifetime) don't update this frame either. */
+// ------------------------------------------------------------------------------------------------
+Bool ParticleSystem::updateEmitter( Int localPlayerIndex )
+{
 	// do initial delay ... note, this currently delays the lifetime
 	if (m_delayLeft)
 	{
@@ -1861,7 +1836,7 @@ Bool ParticleSystem::update( Int localPlayerIndex  )
 		if (m_delayLeft == 0)
 			m_startTimestamp = TheGameClient->getFrame();
 
-		return true;
+		return false;
 	}
 
 	// update the wind motion
@@ -2048,34 +2023,78 @@ Bool ParticleSystem::update( Int localPlayerIndex  )
 		} // end if system lifetime check
 	} // end if is destroyed
 
-	//
-	// Update all particles in the system
-	//
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Update all particles in the system, destroying the ones that die */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystem::updateParticles( void )
+{
+	ParticleUpdateInfo updateInfo;
+	computeUpdateInfo( &updateInfo );
+
 	Particle *p = m_systemParticlesHead;
 	Particle *oldParticle;
 	while (p)
 	{
-
-		// apply 'gravity' force
-		if (m_gravity != 0.0f)
+		if (p->update( updateInfo ) == false)
 		{
-			Coord3D force;
-			force.x = 0.0f;
-			force.y = 0.0f;
-			force.z = m_gravity;
-			p->applyForce( &force );
+			oldParticle = p;
+			p = p->m_systemNext;
+			oldParticle->deleteInstance();
+		} else {
+			p = p->m_systemNext;
 		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Update all particles in the system.  The ones that die are only taken out of this system's 
+	* list, since destroying them touches the manager's lists and any system they control, and
+	* other systems may be integrating on other threads.  releaseDeadParticles() finishes them off. */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystem::integrateParticles( void )
+{
+	ParticleUpdateInfo updateInfo;
+	computeUpdateInfo( &updateInfo );
 
-		if (p->update() == false)
+	Particle *p = m_systemParticlesHead;
+	Particle *oldParticle;
+	while (p)
+	{
+		if (p->update( updateInfo ) == false)
 		{
 			oldParticle = p;
 			p = p->m_systemNext;
-			oldParticle->deleteInstance();
+			removeParticle( oldParticle );
+			oldParticle->m_systemNext = m_deadParticlesHead;
+			m_deadParticlesHead = oldParticle;
 		} else {
 			p = p->m_systemNext;
 		}
 	}
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Destroy the particles that died in integrateParticles() */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystem::releaseDeadParticles( void )
+{
+	while (m_deadParticlesHead)
+	{
+		Particle *p = m_deadParticlesHead;
+		m_deadParticlesHead = p->m_systemNext;
+		p->m_systemNext = NULL;
+		p->deleteInstance();
+	}
+}
 
+// ------------------------------------------------------------------------------------------------
+/** Count down the system lifetime.  Returns false once the system is finished and can be destroyed */
+// ------------------------------------------------------------------------------------------------
+Bool ParticleSystem::updateLifetime( void )
+{
 	//
 	// If we have been "destroyed", wait for all of our particles to die off,
 	// then destroy ourselves (return false).
@@ -2103,6 +2122,62 @@ Bool ParticleSystem::update( Int localPlayerIndex  )
 	return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+/** Work out the parts of a particle's update that are the same for every particle in the
+	* system this frame */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystem::computeUpdateInfo( ParticleUpdateInfo *info )
+{
+
+	info->m_driftVel = m_driftVelocity;
+	info->m_gravity = m_gravity;
+	info->m_frame = TheGameClient->getFrame();
+	info->m_updateAlpha = (m_shaderType != ParticleSystemInfo::ADDITIVE);
+	info->m_doWind = (m_windMotion != ParticleSystemInfo::WIND_MOTION_NOT_USED);
+
+	if( info->m_doWind == FALSE )
+		return;
+
+	info->m_windCos = Cos( m_windAngle );
+	info->m_windSin = Sin( m_windAngle );
+
+	// the wind blows from the system position
+	getPosition( &info->m_windPos );
+
+	// when we're attached objects and drawables we offset by that position as well
+	if( m_attachedToObjectID )
+	{
+		Object *obj = TheGameLogic->findObjectByID( m_attachedToObjectID );
+
+		if( obj )
+		{
+			const Coord3D *objPos = obj->getPosition();
+
+			info->m_windPos.x += objPos->x;
+			info->m_windPos.y += objPos->y;
+			info->m_windPos.z += objPos->z;
+
+		}  // end if
+
+	}  // end if
+	else if( m_attachedToDrawableID )
+	{
+		Drawable *draw = TheGameClient->findDrawableByID( m_attachedToDrawableID );
+
+		if( draw )
+		{
+			const Coord3D *drawPos = draw->getPosition();
+
+			info->m_windPos.x += drawPos->x;
+			info->m_windPos.y += drawPos->y;
+			info->m_windPos.z += drawPos->z;
+
+		}  // end if
+
+	}  // end else if
+
+}  // end computeUpdateInfo
+
 // ------------------------------------------------------------------------------------------------
 /** Update the wind motion */
 // ------------------------------------------------------------------------------------------------
@@ -2829,6 +2904,7 @@ ParticleSystemManager::ParticleSystemManager( void )
 
 	m_onScreenParticleCount = 0;
 	m_localPlayerIndex = 0;
+	m_workerPool = NULL;
 	
 	//Added By Sadullah Nader
 	//Initializations inserted
@@ -2846,6 +2922,12 @@ ParticleSystemManager::ParticleSystemManager( void )
 
 	}  // end for, i
 
+	if (TheGlobalData->m_particleUpdateThreads != 0 && m_workerPool == NULL)
+	{
+		m_workerPool = NEW WorkerPool;
+		m_workerPool->init( TheGlobalData->m_particleUpdateThreads );
+	}
+
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -2854,6 +2936,12 @@ ParticleSystemManager::~ParticleSystemManager()
 {
 	reset();
 
+	if (m_workerPool)
+	{
+		delete m_workerPool;
+		m_workerPool = NULL;
+	}
+
 	TemplateMap::iterator begin(m_templateMap.begin());
 	TemplateMap::iterator end(m_templateMap.end());
 	for (; begin != end; ++begin) {
@@ -2924,7 +3012,7 @@ void ParticleSystemManager::reset( void )
 // ------------------------------------------------------------------------------------------------
 /** Update all particle systems */
 // ------------------------------------------------------------------------------------------------
-//DECLARE_PERF_TIMER(ParticleSystemManager)
+DECLARE_PERF_TIMER(ParticleSystemManager)
 void ParticleSystemManager::update( void )
 {
 	if (m_lastLogicFrameUpdate == TheGameLogic->getFrame()) {
@@ -2934,7 +3022,14 @@ void ParticleSystemManager::update( void )
 	// update the last logic frame.
 	m_lastLogicFrameUpdate = TheGameLogic->getFrame();
 
-	//USE_PERF_TIMER(ParticleSystemManager)
+	USE_PERF_TIMER(ParticleSystemManager)
+
+	if (m_workerPool && m_workerPool->getNumThreads() > 0 && TheGlobalData->m_useFX)
+	{
+		updateWithWorkers();
+		return;
+	}
+
 	ParticleSystem *sys;
 
 	for(ParticleSystemListIt it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end();) 
@@ -2954,6 +3049,201 @@ void ParticleSystemManager::update( void )
 	}
 }
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+// ------------------------------------------------------------------------------------------------
+/** Headless particle benchmark.  Systems are created from the loaded templates in turn, spread
+	* over a grid, and topped back up to numSystems as they die, so the load stays steady the way
+	* it does under a long artillery barrage.  The particle cap is lifted for the run so the count
+	* is set by the number of systems rather than by the INI. */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystemManager::runBenchmark( Int numSystems, Int numFrames )
+{
+	std::vector<const ParticleSystemTemplate *> templates;
+	for( TemplateMap::const_iterator tit = m_templateMap.begin(); tit != m_templateMap.end(); ++tit )
+		templates.push_back( tit->second );
+	Int numTemplates = (Int)templates.size();
+
+	if( numTemplates == 0 || numSystems <= 0 || numFrames <= 0 )
+	{
+		DEBUG_LOG(("ParticleSystemManager::runBenchmark - nothing to run (%d templates)\n", numTemplates));
+		return;
+	}
+
+	Int oldMaxParticleCount = TheGlobalData->m_maxParticleCount;
+	TheWritableGlobalData->m_maxParticleCount = 0x7fffffff;
+
+	const Int gridSize = 32;
+	const Real gridSpacing = 50.0f;
+	Int nextTemplate = 0;
+	Int systemsCreated = 0;
+	UnsignedInt peakParticles = 0;
+	Real totalParticles = 0.0f;
+	__int64 startTime64, endTime64, freq64, updateTime64 = 0;
+	__int64 slowestTime64 = 0;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&freq64);
+
+	UnsignedInt frame = TheGameClient->getFrame();
+	for( Int i = 0; i < numFrames; ++i )
+	{
+
+		// top the systems back up
+		while( (Int)m_particleSystemCount < numSystems )
+		{
+			ParticleSystem *sys = createParticleSystem( templates[ nextTemplate ] );
+			nextTemplate = (nextTemplate + 1) % numTemplates;
+			++systemsCreated;
+
+			Coord3D pos;
+			pos.x = (systemsCreated % gridSize) * gridSpacing;
+			pos.y = ((systemsCreated / gridSize) % gridSize) * gridSpacing;
+			pos.z = 0.0f;
+			sys->setPosition( &pos );
+		}
+
+		TheGameClient->setFrame( ++frame );
+		m_lastLogicFrameUpdate = TheGameLogic->getFrame() + 1;	// we're the only thing advancing time
+
+		QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+		update();
+		QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+
+		updateTime64 += endTime64 - startTime64;
+		if( endTime64 - startTime64 > slowestTime64 )
+			slowestTime64 = endTime64 - startTime64;
+
+		if( m_particleCount > peakParticles )
+			peakParticles = m_particleCount;
+		totalParticles += m_particleCount;
+
+	}  // end for, i
+
+	Real totalMs = (Real)((double)updateTime64 * 1000.0 / (double)freq64);
+	Real averageParticles = totalParticles / numFrames;
+	DEBUG_LOG(("ParticleSystemManager::runBenchmark - %d frames, %d systems from %d templates (%d created), %d worker threads\n",
+		numFrames, numSystems, numTemplates, systemsCreated, m_workerPool ? m_workerPool->getNumThreads() : 0));
+	DEBUG_LOG(("  particles: %.0f average, %d peak\n", averageParticles, peakParticles));
+	DEBUG_LOG(("  update: %.3f ms average, %.3f ms slowest, %.1f ns per particle\n",
+		totalMs / numFrames,
+		(Real)((double)slowestTime64 * 1000.0 / (double)freq64),
+		averageParticles > 0.0f ? totalMs * 1000000.0f / (averageParticles * numFrames) : 0.0f));
+
+	reset();
+	TheWritableGlobalData->m_maxParticleCount = oldMaxParticleCount;
+
+}  // end runBenchmark
+#endif
+
+// ------------------------------------------------------------------------------------------------
+/** Runs integrateParticles() on a batch of systems at a time, for the worker pool */
+// ------------------------------------------------------------------------------------------------
+class ParticleIntegrateJob : public WorkerJob
+{
+public:
+	ParticleIntegrateJob( std::vector<ParticleSystem*> &systems, std::vector<Int> &batches ) :
+		m_systems( systems ), m_batches( batches ) { }
+
+	virtual void runBatch( Int batch )
+	{
+		for (Int i = m_batches[batch]; i < m_batches[batch + 1]; ++i)
+			m_systems[i]->integrateParticles();
+	}
+
+private:
+	std::vector<ParticleSystem*> &m_systems;
+	std::vector<Int> &m_batches;
+};
+
+// ------------------------------------------------------------------------------------------------
+/** Update all particle systems, with the particle updates spread over the worker threads.
+	* Emitting, destroying particles and systems, and the particle cap all touch the global
+	* lists (and other systems), so they stay on this thread.  Systems controlled by a particle
+	* emit from that particle, so they wait until the systems that own those particles have
+	* moved them - just as they did when the whole update was one pass over the list, since a
+	* controlled system is always created after the system that controls it. */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystemManager::updateWithWorkers( void )
+{
+	ParticleSystemID lastOldID = m_uniqueSystemID;
+
+	m_updateSystems.clear();
+	m_controlledSystems.clear();
+	for (ParticleSystemListIt it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end(); ++it)
+	{
+		ParticleSystem *sys = *it;
+		if (sys->getControlParticle())
+			m_controlledSystems.push_back(sys);
+		else
+			m_updateSystems.push_back(sys);
+	}
+
+	updateSystemsWithWorkers( m_updateSystems );
+
+	// systems created while emitting are at the end of the list, and get their first update now
+	for (ParticleSystemList::reverse_iterator rit = m_allParticleSystemList.rbegin(); rit != m_allParticleSystemList.rend(); ++rit)
+	{
+		if ((UnsignedInt)(*rit)->getSystemID() <= (UnsignedInt)lastOldID)
+			break;
+		m_controlledSystems.push_back(*rit);
+	}
+
+	updateSystemsWithWorkers( m_controlledSystems );
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Emit, integrate on the workers, then clean up after the given systems */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystemManager::updateSystemsWithWorkers( std::vector<ParticleSystem*> &systems )
+{
+	// emit, and find out which systems have particles to update
+	m_integrateSystems.clear();
+	UnsignedInt particleCount = 0;
+	Int i;
+	for (i = 0; i < systems.size(); ++i)
+	{
+		if (systems[i]->updateEmitter( m_localPlayerIndex ))
+		{
+			m_integrateSystems.push_back(systems[i]);
+			particleCount += systems[i]->getParticleCount();
+		}
+	}
+
+	//
+	// Split the systems into batches of roughly the same number of particles.  There are a few
+	// batches per thread, so a thread that draws cheap ones can pick up another.
+	//
+	const UnsignedInt MIN_PARTICLES_PER_BATCH = 256;
+	UnsignedInt particlesPerBatch = particleCount / ((m_workerPool->getNumThreads() + 1) * 4);
+	if (particlesPerBatch < MIN_PARTICLES_PER_BATCH)
+		particlesPerBatch = MIN_PARTICLES_PER_BATCH;
+
+	m_integrateBatches.clear();
+	m_integrateBatches.push_back(0);
+	UnsignedInt batchParticles = 0;
+	for (i = 0; i < m_integrateSystems.size(); ++i)
+	{
+		batchParticles += m_integrateSystems[i]->getParticleCount();
+		if (batchParticles >= particlesPerBatch)
+		{
+			m_integrateBatches.push_back(i + 1);
+			batchParticles = 0;
+		}
+	}
+	if (m_integrateBatches.back() != m_integrateSystems.size())
+		m_integrateBatches.push_back(m_integrateSystems.size());
+
+	ParticleIntegrateJob job( m_integrateSystems, m_integrateBatches );
+	m_workerPool->run( &job, m_integrateBatches.size() - 1 );
+
+	// now it's safe to destroy things
+	for (i = 0; i < m_integrateSystems.size(); ++i)
+	{
+		ParticleSystem *sys = m_integrateSystems[i];
+		sys->releaseDeadParticles();
+		if (sys->updateLifetime() == false)
+			sys->deleteInstance();
+	}
+}
+
 // ------------------------------------------------------------------------------------------------
 /** sets the count of the particles on screen after each frame */
 // ------------------------------------------------------------------------------------------------
@@ -3175,23 +3465,20 @@ void ParticleSystemManager::removeParticle( Particle *particleToRemove)
 // ------------------------------------------------------------------------------------------------
 /** Add a particle system to the master particle system list. */
 // ------------------------------------------------------------------------------------------------
-void ParticleSystemManager::friend_addParticleSystem( ParticleSystem *particleSystemToAdd )
+ParticleSystemManager::ParticleSystemListIt ParticleSystemManager::friend_addParticleSystem( ParticleSystem *particleSystemToAdd )
 {
-	m_allParticleSystemList.push_back(particleSystemToAdd);
 	++m_particleSystemCount;
+	return m_allParticleSystemList.insert(m_allParticleSystemList.end(), particleSystemToAdd);
 }
 
 // ------------------------------------------------------------------------------------------------
-/** Remove a particle system from the master particle system list. */
+/** Remove a particle system from the master particle system list, given where friend_addParticleSystem put it. */
 // ------------------------------------------------------------------------------------------------
-void ParticleSystemManager::friend_removeParticleSystem( ParticleSystem *particleSystemToRemove )
+void ParticleSystemManager::friend_removeParticleSystem( ParticleSystem *particleSystemToRemove, ParticleSystemListIt it )
 {
-	ParticleSystemListIt it = std::find(m_allParticleSystemList.begin(), m_allParticleSystemList.end(), particleSystemToRemove);
-	if (it != m_allParticleSystemList.end()) {
-		m_allParticleSystemList.erase(it);
-		--m_particleSystemCount;
-	}
-
+	DEBUG_ASSERTCRASH( *it == particleSystemToRemove, ("friend_removeParticleSystem: system isn't where it was added\n") );
+	m_allParticleSystemList.erase(it);
+	--m_particleSystemCount;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -28,10 +28,13 @@
 #include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
 
 #include "Common/CRCDebug.h"
+#include "Common/GameEngine.h"
 #include "Common/GameState.h"
+#include "Common/GlobalData.h"
 #include "Common/PerfTimer.h"
 #include "Common/Player.h"
 #include "Common/PlayerList.h"
+#include "Common/StateMachine.h"
 #include "Common/ThingTemplate.h"
 #include "Common/Xfer.h"
 #include "Common/XferCRC.h"
@@ -345,6 +348,7 @@ void AI::reset( void )
 			m_groupList.pop_front(); // NULL group, just kill from list.  Shouldn't really happen, but just in case.
 		}
 	}
+	m_groupIDMap.clear();
 	m_nextGroupID = 0;
 	m_nextFormationID = NO_FORMATION_ID;
 	getNextFormationID(); // increment once past NO_FORMATION_ID.  jba.
@@ -363,6 +367,38 @@ void AI::update( void )
 		ThePlayerList->UPDATE();
 	}
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+	static Bool stateMachineBenchmarkRun = FALSE;
+	if (!stateMachineBenchmarkRun && TheGlobalData->m_stateMachineBenchmarkFrames > 0)
+	{
+		// count state updates that ran against those skipped while asleep, over a stretch of the
+		// game we were given, log the results, and quit
+		static Bool stateMachineBenchmarkStarted = FALSE;
+		static UnsignedInt stateMachineBenchmarkStartFrame = 0;
+		static Int startExecuted = 0, startSkipped = 0;
+		Int executed, skipped;
+		StateMachine::getUpdateTotals(executed, skipped);
+		UnsignedInt now = TheGameLogic->getFrame();
+		if (!stateMachineBenchmarkStarted)
+		{
+			stateMachineBenchmarkStarted = TRUE;
+			stateMachineBenchmarkStartFrame = now;
+			startExecuted = executed;
+			startSkipped = skipped;
+		}
+		else if (now - stateMachineBenchmarkStartFrame >= (UnsignedInt)TheGlobalData->m_stateMachineBenchmarkFrames)
+		{
+			executed -= startExecuted;
+			skipped -= startSkipped;
+			Int total = executed + skipped;
+			DEBUG_LOG(("AI::update - state machine benchmark, %d frames: %d state updates run, %d skipped while asleep (%.1f%% skipped)\n",
+				now - stateMachineBenchmarkStartFrame, executed, skipped, total ? 100.0f * skipped / total : 0.0f));
+			stateMachineBenchmarkRun = TRUE;
+			TheGameEngine->setQuitting(TRUE);
+		}
+	}
+#endif
+
 }
 
 /**
@@ -452,6 +488,7 @@ AIGroup *AI::createGroup( void )
 	// add it to the list
 //	DEBUG_LOG(("***AIGROUP %x is being added to m_groupList.\n", group ));
 	m_groupList.push_back( group );
+	m_groupIDMap[ group->getID() ] = --m_groupList.end();
 
 	return group;
 }
@@ -461,17 +498,19 @@ AIGroup *AI::createGroup( void )
  */
 void AI::destroyGroup( AIGroup *group )
 {
-	std::list<AIGroup *>::iterator i = std::find( m_groupList.begin(), m_groupList.end(), group );
+	DEBUG_ASSERTCRASH(group != NULL, ("A NULL group made its way into the AIGroup list.. jkmcd"));
+	if (group == NULL)
+		return;
 
 	// make sure group is actually in the list
-	if (i == m_groupList.end())
+	GroupIDMap::iterator it = m_groupIDMap.find( group->getID() );
+	if (it == m_groupIDMap.end() || *it->second != group)
 		return;
 
-	DEBUG_ASSERTCRASH(group != NULL, ("A NULL group made its way into the AIGroup list.. jkmcd"));
-
 	// remove it
 //	DEBUG_LOG(("***AIGROUP %x is being removed from m_groupList.\n", group ));
-	m_groupList.erase( i );
+	m_groupList.erase( it->second );
+	m_groupIDMap.erase( it );
 
 	// destroy group
 	group->deleteInstance();
@@ -482,13 +521,11 @@ void AI::destroyGroup( AIGroup *group )
  */
 AIGroup *AI::findGroup( UnsignedInt id )
 {
-	/// @todo Optimize this (MSB)
-	std::list<AIGroup *>::iterator i;
-	for( i=m_groupList.begin(); i!=m_groupList.end(); ++i )
-		if ((*i)->getID() == id)
-			return (*i);
+	GroupIDMap::const_iterator it = m_groupIDMap.find( id );
+	if (it == m_groupIDMap.end())
+		return NULL;
 
-	return NULL;
+	return *it->second;
 }
 
 //--------------------------------------------------------------------------------------------------------
@@ -532,6 +569,35 @@ public:
 #endif
 };
 
+//-----------------------------------------------------------------------------
+/**
+	PartitionFilterLiveMapEnemies, for objects that already came from the shared enemy 
+	candidates: the relationship was checked when the candidates were gathered, but
+	they can have died since, and they don't know which side of the map edge we're on.
+*/
+class PartitionFilterLiveMapEnemyCandidates : public PartitionFilter
+{
+private:
+	const Object *m_obj;
+public:
+	PartitionFilterLiveMapEnemyCandidates(const Object *obj) : m_obj(obj) { }
+
+	virtual Bool allow(Object *objOther)
+	{
+		if (objOther->isEffectivelyDead())
+			return false;
+
+		if (objOther->isOffMap() != m_obj->isOffMap())
+			return false;
+
+		return true;
+	}
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+	virtual const char* debugGetName() { return "PartitionFilterLiveMapEnemyCandidates"; }
+#endif
+};
+
 //-----------------------------------------------------------------------------
 class PartitionFilterWithinAttackRange : public PartitionFilter
 {
@@ -602,6 +668,11 @@ Object *AI::findClosestEnemy( const Object *me, Real range, UnsignedInt qualifie
 	// combine several canned ones, in the name of speed (srj)
 	PartitionFilterLiveMapEnemies filterObvious(me);
 
+	// if our enemies are just our player's enemies, the partition manager already knows who
+	// they are in each cell (as of this frame), so we only have to weed out the newly dead.
+	const Bool shareCandidates = ThePartitionManager->canShareEnemyCandidates(me);
+	PartitionFilterLiveMapEnemyCandidates filterCandidates(me);
+
 	PartitionFilterWithinAttackRange filterWithinAttackRange(me);
 
 	// never target buildings (unless they can attack)
@@ -643,7 +714,10 @@ Object *AI::findClosestEnemy( const Object *me, Real range, UnsignedInt qualifie
 	// -- filterStealth is BY FAR the least common to be useful, so it goes last.
 	// GS Fog check used to be inside can attack, so it feels right to be right after it
 
-	filters[numFilters++] = &filterObvious;	
+	if (shareCandidates)
+		filters[numFilters++] = &filterCandidates;
+	else
+		filters[numFilters++] = &filterObvious;	
 
 	if( !(qualifiers & ATTACK_BUILDINGS) )
 		filters[numFilters++] = &filterBldgs;
@@ -675,14 +749,22 @@ Object *AI::findClosestEnemy( const Object *me, Real range, UnsignedInt qualifie
 	if (info == NULL || info == TheScriptEngine->getDefaultAttackInfo()) 
 	{
 		// No additional attack info, so just return the closest one.
-		Object* o = ThePartitionManager->getClosestObject( me, range, FROM_BOUNDINGSPHERE_2D, filters );
+		Object* o;
+		if (shareCandidates)
+			o = ThePartitionManager->getClosestEnemyCandidate( me, range, FROM_BOUNDINGSPHERE_2D, filters );
+		else
+			o = ThePartitionManager->getClosestObject( me, range, FROM_BOUNDINGSPHERE_2D, filters );
 		return o;
 	}
 
 	Object *bestEnemy = NULL;
 	Int			effectivePriority=0;
 	Int			actualPriority=0;
-	ObjectIterator *iter = ThePartitionManager->iterateObjectsInRange(me, range, FROM_BOUNDINGSPHERE_2D, filters, ITER_SORTED_NEAR_TO_FAR);
+	ObjectIterator *iter;
+	if (shareCandidates)
+		iter = ThePartitionManager->iterateEnemyCandidatesInRange(me, range, FROM_BOUNDINGSPHERE_2D, filters, ITER_SORTED_NEAR_TO_FAR);
+	else
+		iter = ThePartitionManager->iterateObjectsInRange(me, range, FROM_BOUNDINGSPHERE_2D, filters, ITER_SORTED_NEAR_TO_FAR);
 	MemoryPoolObjectHolder holder(iter);
 	for (Object *theEnemy = iter->first(); theEnemy; theEnemy = iter->next()) 
 	{
@@ -279,10 +279,18 @@ StateReturnType AIDockWaitForClearanceState::update( void )
 	if (dock->isClearToEnter( getMachineOwner() ))
 		return STATE_SUCCESS;
 
-	if (m_enterFrame + 30*LOGICFRAMES_PER_SECOND < TheGameLogic->getFrame()) {
+	UnsignedInt now = TheGameLogic->getFrame();
+	UnsignedInt giveUpFrame = m_enterFrame + 30*LOGICFRAMES_PER_SECOND + 1;
+	if (giveUpFrame <= now) {
 		return STATE_FAILURE;
 	}
-	// continue to wait
+
+	// continue to wait.  If the dock tells us when any of the above changes, we can
+	// sleep until it does; a dock that's being destroyed still has to be watched
+	// until it's gone.
+	if (dock->wakesWaitingDockers() && !goalObject->isDestroyed())
+		return STATE_SLEEP(giveUpFrame - now);
+
 	return STATE_CONTINUE;
 }
 
@@ -82,6 +82,11 @@ AIGroup::AIGroup( void )
 	m_id = TheAI->getNextGroupID();
 	m_memberListSize = 0;
 	m_memberList.clear();
+	m_centerValid = false;
+	m_centerFound = false;
+	m_boundsValid = false;
+	m_boundsCount = 0;
+	m_boundsFirstMember = NULL;
 	//DEBUG_LOG(( "AIGroup #%d created\n", m_id ));
 }
 
@@ -155,12 +160,8 @@ Real AIGroup::getSpeed( void )
  */
 Bool AIGroup::isMember( Object *obj )
 {
-	std::list<Object *>::iterator i = std::find( m_memberList.begin(), m_memberList.end(), obj );
-
-	if (i == m_memberList.end())
-		return false;
-
-	return true;
+	// an object is in our member list exactly when it thinks it's in this group
+	return obj != NULL && obj->getGroup() == this;
 }
 
 /**
@@ -198,6 +199,7 @@ void AIGroup::add( Object *obj )
 
 	// list has changed, properties need recomputation
 	m_dirty = true;
+	invalidateCachedCenter();
 }
 
 /**
@@ -222,6 +224,7 @@ Bool AIGroup::remove( Object *obj )
 
 	// list has changed, properties need recomputation
 	m_dirty = true;
+	invalidateCachedCenter();
 
 	// if the group is empty, no-one is using it any longer, so destroy it
 	if (isEmpty()) {
@@ -284,10 +287,17 @@ Bool AIGroup::removeAnyObjectsNotOwnedByPlayer( const Player *ownerPlayer )
 
 
 /**
- * Compute the centroid of the group
+ * Compute the centroid of the group.  It's kept until a member is added, removed, moved,
+ * or held or let go, since the group's orders ask for it once per member.
  */
 Bool AIGroup::getCenter( Coord3D *center )
 {
+	if (m_centerValid)
+	{
+		*center = m_center;
+		return m_centerFound;
+	}
+
 	Int count = 0;
 	center->x = 0.0f;
 	center->y = 0.0f;
@@ -338,11 +348,40 @@ Bool AIGroup::getCenter( Coord3D *center )
 	center->y /= count;
 	center->z /= count;
 
-	return count > 0;
+	m_center = *center;
+	m_centerFound = count > 0;
+	m_centerValid = true;
+
+	return m_centerFound;
 }
 
 Bool AIGroup::getMinMaxAndCenter( Coord2D *min, Coord2D *max, Coord3D *center )
 {
+	if (!m_boundsValid)
+	{
+		computeMinMaxAndCenter();
+	}
+
+	*min = m_boundsMin;
+	*max = m_boundsMax;
+	*center = m_boundsCenter;
+
+	// formation IDs change without telling the group, so always ask the first member for its own
+	FormationID id = m_boundsFirstMember ? m_boundsFirstMember->getFormationID() : NO_FORMATION_ID;
+	Bool isFormation = (id!=NO_FORMATION_ID);
+	if (m_boundsCount<2) isFormation = false;
+	return isFormation;
+}
+
+/**
+ * Work out the bounds and centroid for getMinMaxAndCenter(), and the member whose formation counts.
+ */
+void AIGroup::computeMinMaxAndCenter( void )
+{
+	Coord2D *min = &m_boundsMin;
+	Coord2D *max = &m_boundsMax;
+	Coord3D *center = &m_boundsCenter;
+
 	Int count = 0;
 	min->x = 1e10f;
 	max->x = -1e10f;
@@ -351,9 +390,9 @@ Bool AIGroup::getMinMaxAndCenter( Coord2D *min, Coord2D *max, Coord3D *center )
 	center->x = 0.0f;
 	center->y = 0.0f;
 	center->z = 0.0f;
+	m_boundsFirstMember = NULL;
 
 	std::list<Object *>::iterator i;
-	FormationID id= NO_FORMATION_ID;
 	for( i = m_memberList.begin(); i != m_memberList.end(); ++i )
 	{
 		if( (*i)->isDisabledByType( DISABLED_HELD) ) 
@@ -373,13 +412,8 @@ Bool AIGroup::getMinMaxAndCenter( Coord2D *min, Coord2D *max, Coord3D *center )
 			max->x = max->x < objPos->x ? objPos->x : max->x;
 			min->y = min->y > objPos->y ? objPos->y : min->y;
 			max->y = max->y < objPos->y ? objPos->y : max->y;
-			FormationID curID = (*i)->getFormationID() ;
 			if (count==0) {
-				id = curID;	
-			} else {
-				if (id == NO_FORMATION_ID) {
-					id = NO_FORMATION_ID;
-				}
+				m_boundsFirstMember = *i;
 			}
 
 			count++;
@@ -389,9 +423,9 @@ Bool AIGroup::getMinMaxAndCenter( Coord2D *min, Coord2D *max, Coord3D *center )
 	center->x /= count;
 	center->y /= count;
 	center->z /= count;
-	Bool isFormation = (id!=NO_FORMATION_ID);
-	if (count<2) isFormation = false;
-	return isFormation;
+
+	m_boundsCount = count;
+	m_boundsValid = true;
 }
 
 
@@ -710,6 +710,21 @@ StateReturnType AIGuardIdleState::onEnter( void )
 	return STATE_CONTINUE;
 }
 
+//--------------------------------------------------------------------------------------
+/**
+ * Being shot at is a good reason to look around now rather than at the next scan.
+ */
+Bool AIGuardIdleState::wakeOnEvent( StateWakeEvent event )
+{
+	if (event != STATE_WAKE_DAMAGED)
+		return FALSE;
+
+	UnsignedInt now = TheGameLogic->getFrame();
+	if (m_nextEnemyScanTime > now)
+		m_nextEnemyScanTime = now;
+	return TRUE;
+}
+
 //--------------------------------------------------------------------------------------
 StateReturnType AIGuardIdleState::update( void )
 {
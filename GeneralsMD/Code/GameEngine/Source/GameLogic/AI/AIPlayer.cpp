@@ -72,6 +72,9 @@
 
 #define USE_DOZER 1
 
+/// Each planner task gets one frame in this many.  Keep it short, or the AI will be slow to react.
+#define AI_PLANNER_SLOT_FRAMES 8
+
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 AIPlayer::AIPlayer( Player *p ) :
@@ -103,6 +106,13 @@ m_curWarehouseID(INVALID_ID)
 	m_baseCenterSet = false;
 	m_difficulty = TheScriptEngine->getGlobalDifficulty(); 
 	m_teamSeconds = TheAI->getAiData()->m_teamSeconds;
+
+#ifdef DUMP_PERF_STATS
+	m_plannerPerfFrame = 0xffffffff;
+	m_plannerTicksThisFrame = 0;
+	m_plannerTicksTotal = 0;
+	m_plannerFrames = 0;
+#endif
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -2323,6 +2333,7 @@ void AIPlayer::updateBridgeRepair(void)
 	// Check once a second.
 	m_bridgeTimer--;
 	if (m_bridgeTimer>0) return;
+	if (!isPlannerTurn(PLAN_BRIDGE_REPAIR)) return;
 	m_bridgeTimer = LOGICFRAMES_PER_SECOND;
 	Object *bridgeObj=NULL;
 	while (bridgeObj==NULL && m_structuresInQueue>0) {
@@ -2734,7 +2745,7 @@ void AIPlayer::doBaseBuilding( void )
 		// This timer is to keep from banging on the logic each frame.  If something interesting
 		// happens, like a building is added or a unit finished, the timers are shortcut.
 		m_buildDelay--;		
-		if (m_buildDelay<1) {
+		if (m_buildDelay<1 && isPlannerTurn(PLAN_BASE_BUILDING)) {
 			if (m_readyToBuildStructure) {
 				processBaseBuilding();
 			}
@@ -2752,6 +2763,10 @@ void AIPlayer::doBaseBuilding( void )
  */
 void AIPlayer::checkReadyTeams( void )
 {
+	if (!isPlannerTurn(PLAN_TEAM_QUEUES)) {
+		return;
+	}
+
 	// See if any ready teams are gathered at their rally point
 	{	// needed to scope iter.  silly ms c++.
 		for ( DLINK_ITERATOR<TeamInQueue> iter = iterate_TeamReadyQueue(); !iter.done(); iter.advance())
@@ -2833,6 +2848,10 @@ void AIPlayer::checkReadyTeams( void )
  */
 void AIPlayer::checkQueuedTeams( void )
 {
+	if (!isPlannerTurn(PLAN_TEAM_QUEUES)) {
+		return;
+	}
+
 	// See if any teams are expired.
 	{	// needed to scope iter.  silly ms c++.
 		for ( DLINK_ITERATOR<TeamInQueue> iter = iterate_TeamBuildQueue(); !iter.done(); iter.advance())
@@ -2914,7 +2933,7 @@ void AIPlayer::doTeamBuilding( void )
 		// This timer is to keep from banging on the logic each frame.  If something interesting
 		// happens, like a building is added or a unit finished, the timers are shortcut.
 		m_teamDelay--;
-		if (m_teamDelay<1) {
+		if (m_teamDelay<1 && isPlannerTurn(PLAN_TEAM_BUILDING)) {
 			queueUnits(); // update the queues.
 			if (m_readyToBuildTeam) {
 				processTeamBuilding();
@@ -2936,6 +2955,10 @@ void AIPlayer::doUpgradesAndSkills( void )
 		return;
 	}
 
+	if (!isPlannerTurn(PLAN_UPGRADES_AND_SKILLS)) {
+		return;
+	}
+
 	Bool checkScience = m_player->getSciencePurchasePoints()>0;
 	if (!checkScience) {
 		return;
@@ -3011,6 +3034,10 @@ void AIPlayer::doUpgradesAndSkills( void )
 void AIPlayer::update( void )
 {
 	//USE_PERF_TIMER(AIPlayer_update)
+#ifdef DUMP_PERF_STATS
+	Int64 startTime64;
+	GetPrecisionTimer(&startTime64);
+#endif
 
 	doBaseBuilding();		// See if it's time to build another building.
 
@@ -3024,8 +3051,49 @@ void AIPlayer::update( void )
 
 	updateBridgeRepair(); // Handle any bridge repairs.
 
+#ifdef DUMP_PERF_STATS
+	Int64 endTime64;
+	GetPrecisionTimer(&endTime64);
+	if (m_plannerPerfFrame != TheGameLogic->getFrame())
+	{
+		m_plannerPerfFrame = TheGameLogic->getFrame();
+		m_plannerTicksThisFrame = 0;
+		++m_plannerFrames;
+	}
+	m_plannerTicksThisFrame += endTime64 - startTime64;
+	m_plannerTicksTotal += endTime64 - startTime64;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------
+/**
+ * Planner tasks are spread over AI_PLANNER_SLOT_FRAMES frames, one frame each, so that a task
+ * that comes due waits at most that long.  The turn only depends on the player index and the
+ * frame, so every machine in a game gives the same answer.
+ */
+Bool AIPlayer::isPlannerTurn( PlannerTask task ) const
+{
+	UnsignedInt slot = (m_player->getPlayerIndex() * PLAN_TASK_COUNT + task) % AI_PLANNER_SLOT_FRAMES;
+	return TheGameLogic->getFrame() % AI_PLANNER_SLOT_FRAMES == slot;
 }
 
+#ifdef DUMP_PERF_STATS
+//----------------------------------------------------------------------------------------------------------
+void AIPlayer::getPlannerStats( double& msecThisFrame, double& msecAverage ) const
+{
+	Int64 freq64;
+	GetPrecisionTimerTicksPerSec(&freq64);
+
+	msecThisFrame = 0;
+	if (m_plannerPerfFrame == TheGameLogic->getFrame())
+		msecThisFrame = (double)m_plannerTicksThisFrame * 1000.0 / (double)freq64;
+
+	msecAverage = 0;
+	if (m_plannerFrames > 0)
+		msecAverage = (double)m_plannerTicksTotal * 1000.0 / (double)freq64 / (double)m_plannerFrames;
+}
+#endif
+
 //----------------------------------------------------------------------------------------------------------
 /**
  * Find any things that build stuff & add them to the build list.  Then build any initially built
@@ -885,7 +885,7 @@ void AISkirmishPlayer::doBaseBuilding( void )
 		// This timer is to keep from banging on the logic each frame.  If something interesting
 		// happens, like a building is added or a unit finished, the timers are shortcut.
 		m_buildDelay--;		
-		if (m_buildDelay<1) {
+		if (m_buildDelay<1 && isPlannerTurn(PLAN_BASE_BUILDING)) {
 			if (m_readyToBuildStructure) {
 				processBaseBuilding();
 			}
@@ -938,7 +938,7 @@ void AISkirmishPlayer::doTeamBuilding( void )
 		// This timer is to keep from banging on the logic each frame.  If something interesting
 		// happens, like a building is added or a unit finished, the timers are shortcut.
 		m_teamDelay--;
-		if (m_teamDelay<1) {
+		if (m_teamDelay<1 && isPlannerTurn(PLAN_TEAM_BUILDING)) {
 			queueUnits(); // update the queues.
 			if (m_readyToBuildTeam) {
 				processTeamBuilding();
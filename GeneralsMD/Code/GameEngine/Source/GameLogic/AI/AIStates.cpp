@@ -6182,6 +6182,13 @@ StateReturnType AIDockState::update()
 	return CONVERT_SLEEP_TO_CONTINUE(m_dockMachine->updateStateMachine());
 }
 
+//----------------------------------------------------------------------------------------------------------
+Bool AIDockState::wakeOnEvent( StateWakeEvent event )
+{
+	// our sub-machine may be asleep even though we never are.
+	return m_dockMachine ? m_dockMachine->wakeOnEvent( event ) : false;
+}
+
 //----------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------
@@ -6753,6 +6760,13 @@ StateReturnType AIGuardState::update()
 	return ret;
 }
 
+//----------------------------------------------------------------------------------------------------------
+Bool AIGuardState::wakeOnEvent( StateWakeEvent event )
+{
+	// we sleep whenever our guard machine does, so let its state decide.
+	return m_guardMachine ? m_guardMachine->wakeOnEvent( event ) : false;
+}
+
 //----------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------
@@ -1444,6 +1444,16 @@ Real TerrainLogic::getGroundHeight( Real x, Real y, Coord3D* normal ) const
 
 }  // end getHight
 
+//-------------------------------------------------------------------------------------------------
+/** default batched get height for terrain logic */
+//-------------------------------------------------------------------------------------------------
+void TerrainLogic::getGroundHeights( const Coord2D *points, Real *heights, Int count ) const
+{
+	for( Int i = 0; i < count; i++ )
+		heights[ i ] = getGroundHeight( points[ i ].x, points[ i ].y );
+
+}  // end getGroundHeights
+
 //-------------------------------------------------------------------------------------------------
 /** default get height for terrain logic */
 //-------------------------------------------------------------------------------------------------
@@ -2852,6 +2862,9 @@ void TerrainLogic::flattenTerrain(Object *obj)
 		break;
 	} // switch
 
+	// line of sight answers may have changed along with the heights
+	ThePartitionManager->invalidateLineOfSightCache();
+
 }
 
 
@@ -2903,6 +2916,9 @@ void TerrainLogic::createCraterInTerrain(Object *obj)
     } // next j
   } // next i
 
+	// line of sight answers may have changed along with the heights
+	ThePartitionManager->invalidateLineOfSightCache();
+
 }
 
 
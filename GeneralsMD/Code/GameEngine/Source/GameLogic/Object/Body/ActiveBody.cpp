@@ -568,7 +568,9 @@ void ActiveBody::attemptDamage( DamageInfo *damageInfo )
 		// (object pointer loses scope as soon as atteptdamage's caller ends)
 		// m_lastDamageTimestamp is initialized to FFFFFFFFFF, so doing a < compare is problematic.
 		// jba.
+		Bool startedTakingDamage = FALSE;
 		if (m_lastDamageTimestamp!=TheGameLogic->getFrame() && m_lastDamageTimestamp != TheGameLogic->getFrame()-1) {
+			startedTakingDamage = TRUE;
 			m_lastDamageInfo = *damageInfo;
 			m_lastDamageCleared = false;
 			m_lastDamageTimestamp = TheGameLogic->getFrame();
@@ -617,6 +619,10 @@ void ActiveBody::attemptDamage( DamageInfo *damageInfo )
 
 				d->onDamage( damageInfo );
 			}
+
+			// only wake the AI when an attack starts, not for every hit of a sustained one.
+			if (startedTakingDamage && obj->getAI())
+				obj->getAI()->wakeUpStateMachine( STATE_WAKE_DAMAGED );
 		}
 
 		if (m_curDamageState != oldState)
@@ -797,10 +797,17 @@ void Object::setGeometryInfoZ( Real newZ )
 //=============================================================================
 void Object::friend_setUndetectedDefector( Bool status )
 {
+	if (status == getIsUndetectedDefector())
+		return;
+
 	if (status)
 		m_privateStatus |= UNDETECTED_DEFECTOR;
 	else
 		m_privateStatus &= ~UNDETECTED_DEFECTOR;
+
+	// nobody's enemy while undetected, so the enemy lists that have us in them are wrong now
+	if (m_partitionData)
+		m_partitionData->invalidateCellContents();
 }
 
 //=============================================================================
@@ -869,6 +876,10 @@ void Object::setOrRestoreTeam( Team* team, Bool restoring )
 	// Switch //////////////////////////
 	m_team = team;
 
+	// whose enemy we are just changed, so the enemy lists that have us in them are wrong now
+	if (m_partitionData)
+		m_partitionData->invalidateCellContents();
+
 	// After Switch //////////////////////////
 	if (m_team)
 	{
@@ -1776,6 +1787,10 @@ void Object::reactToTransformChange(const Matrix3D* oldMtx, const Coord3D* oldPo
 	Bool posDiff = isPosDifferent(oldPos, getPosition());
 	Bool angDiff = isAngleDifferent(oldAngle, getOrientation());
 
+	// the group's center has to match the members exactly, so even tiny moves count here
+	if (m_group && (oldPos->x != getPosition()->x || oldPos->y != getPosition()->y || oldPos->z != getPosition()->z))
+		m_group->invalidateCachedCenter();
+
 	if (posDiff || angDiff)
 	{
 		if (m_partitionData)
@@ -2124,6 +2139,10 @@ void Object::setDisabledUntil( DisabledType type, UnsignedInt frame )
 		m_disabledTillFrame[ type ] = frame;
 		m_disabledMask.set( type, frame > TheGameLogic->getFrame() );
 
+		// held members don't count towards the group's center
+		if( type == DISABLED_HELD && m_group )
+			m_group->invalidateCachedCenter();
+
 		if( m_drawable )
 		{
 			if( isDisabled() )
@@ -2305,6 +2324,9 @@ Bool Object::clearDisabled( DisabledType type )
 	m_disabledTillFrame[ type ] = NEVER;
 	m_disabledMask.set( type, 0 );
 
+	if( type == DISABLED_HELD && m_group )
+		m_group->invalidateCachedCenter();
+
 	DisabledMaskType exceptions;
 	exceptions.set(DISABLED_HELD);
 	exceptions.set(DISABLED_SCRIPT_DISABLED);
@@ -2913,6 +2935,9 @@ Bool Object::isMobile() const
 //-------------------------------------------------------------------------------------------------
 void Object::scoreTheKill( const Object *victim )
 {
+	if (getAI())
+		getAI()->wakeUpStateMachine( STATE_WAKE_TARGET_DIED );
+
 	// Do stuff that has nothing to do with experience points here, like tell our Player we killed something
 	/// @todo Multiplayer score hook location?
 
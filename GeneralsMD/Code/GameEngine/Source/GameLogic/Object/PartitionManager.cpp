@@ -60,6 +60,7 @@
 #include "Common/PlayerList.h"
 #include "Common/Radar.h"
 #include "Common/ThingFactory.h"	// for bullet type hack
+#include "Common/Team.h"
 #include "Common/ThingTemplate.h"
 #include "Common/Xfer.h"
 
@@ -979,20 +980,19 @@ PartitionManager *ThePartitionManager = NULL;  ///< the object manager singleton
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 
-class PartitionContactListNode : public MemoryPoolObject
+/**
+	One possibly-colliding pair. These live in one array that is reused from 
+	frame to frame, so noting a pair costs no allocation once the array has 
+	grown to fit a busy frame.
+*/
+struct PartitionContact
 {
-	MEMORY_POOL_GLUE_WITH_USERLOOKUP_CREATE(PartitionContactListNode, "PartitionContactListNode" )
-
-public:
-	PartitionContactListNode*			m_nextHash;	///< next node with same hash value 
-	PartitionContactListNode*			m_next;			///< next node
 	PartitionData*								m_obj;			///< one object that is possibly colliding
 	PartitionData*								m_other;		///< the other object (or null for collisions with the terrain)
 	Int														m_hashValue;///< index into hash table 
+	Int														m_nextHash;	///< index of next contact with same hash value, or -1
 };
 
-inline PartitionContactListNode::~PartitionContactListNode() { }
-
 //-----------------------------------------------------------------------------
 
 class PartitionContactList
@@ -1009,16 +1009,19 @@ private:
 	*/
 	enum { PartitionContactList_SOCKET_COUNT = 5381 };
 
+	typedef std::vector<PartitionContact> ContactVec;
 
-	PartitionContactListNode* m_contactHash[PartitionContactList_SOCKET_COUNT];
-	PartitionContactListNode* m_contactList;
+	Int					m_contactHash[PartitionContactList_SOCKET_COUNT];	///< index of first contact in each socket, or -1
+	ContactVec	m_contacts;				///< in the order they were noted
+	UnsignedInt	m_scanStamp;			///< bumped for each object's scan for contacts
 
 public:
 
 	PartitionContactList()
 	{
-		memset(m_contactHash, 0, sizeof(m_contactHash));
-		m_contactList = NULL;
+		for (Int i = 0; i < PartitionContactList_SOCKET_COUNT; ++i)
+			m_contactHash[i] = -1;
+		m_scanStamp = 0;
 	}
 
 	~PartitionContactList()
@@ -1037,12 +1040,13 @@ public:
 	/**
 		process all pairs in the contact list: first, determine if they
 		truly collide, based on their geometry. if so, call the collide
-		actions for each object in the pair.
+		actions for each object in the pair. returns the number of pairs
+		that really collided.
 	*/
-	void processContactList();
+	Int processContactList();
 
 	/**
-		discard the contents of the contact list.
+		discard the contents of the contact list. (the memory is kept for next time.)
 	*/
 	void resetContactList();
 
@@ -1051,6 +1055,202 @@ public:
 	*/
 	void removeSpecificPartitionData(PartitionData* data);
 
+	/**
+		start a new scan for contacts. a PartitionData stamped with the returned 
+		value has already been offered to the list during this scan.
+	*/
+	UnsignedInt nextScanStamp()
+	{
+		// zero is what every PartitionData starts out with, so never hand it out
+		if (++m_scanStamp == 0)
+			++m_scanStamp;
+		return m_scanStamp;
+	}
+
+	Int getContactCount() const { return (Int)m_contacts.size(); }
+
+};
+
+//-----------------------------------------------------------------------------
+
+class PartitionEnemyCandidates
+{
+public:
+
+	/// where one cell's candidates are in CandidateSet::m_candidates
+	struct CellRun
+	{
+		UnsignedInt		m_generation;			///< the CandidateSet::m_generation this was built in, 0 for never
+		UnsignedInt		m_coiListStamp;		///< the cell's COI list stamp when this was built
+		Int						m_first;
+		Int						m_count;
+
+		CellRun() : m_generation(0), m_coiListStamp(0), m_first(0), m_count(0) { }
+	};
+
+	typedef std::vector<CellRun> CellRunVec;
+	typedef std::vector<PartitionData*> CandidateVec;
+
+	/// the enemies of one player, built cell by cell as scans need them
+	struct CandidateSet
+	{
+		const Player*	m_player;
+		UnsignedInt		m_frame;							///< the frame the runs were built on
+		UnsignedInt		m_relationshipStamp;	///< PartitionEnemyCandidates::m_relationshipStamp when the runs were built
+		UnsignedInt		m_generation;					///< bumped whenever the runs are all thrown away
+		CellRunVec		m_runs;								///< one per cell
+		CandidateVec	m_candidates;					///< the runs, one after another
+
+		CandidateSet() : m_player(NULL), m_frame(0), m_relationshipStamp(0), m_generation(0) { }
+	};
+
+private:
+
+	CandidateSet*	m_sets[MAX_PLAYER_COUNT];
+	UnsignedInt		m_relationshipStamp;
+
+	UnsignedInt		m_statsFrame;
+	Int						m_queries;					///< scans this frame
+	Int						m_cellsTouched;			///< cells those scans looked in
+	Int						m_cellsBuilt;				///< cells whose candidates had to be worked out this frame
+
+public:
+
+	PartitionEnemyCandidates();
+	~PartitionEnemyCandidates();
+
+	/// throw away every set. (call when the cells go away.)
+	void reset();
+
+	/// every run is stale, since someone's enemies have changed
+	void invalidate() { ++m_relationshipStamp; }
+
+	/// start a scan for player's enemies, returns the set to pass to getCellRun.
+	CandidateSet *beginQuery(const Player *player, Int totalCellCount);
+
+	/// the candidates of set's player in cell, working them out if the set doesn't know them yet
+	const CellRun& getCellRun(CandidateSet *set, PartitionCell *cell, Int cellIndex);
+
+	void getStats(Int& queries, Int& cellsTouched, Int& cellsBuilt) const;
+
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+	The threat and cash values of the cells, for each player, summed over 2x2 blocks
+	of cells, then over 2x2 blocks of those, and so on up to one block that covers the
+	whole map. The cells are the bottom level, so that one isn't stored here. Since the
+	values are never negative, a block's sum is also the most that any one cell in it
+	can hold, which is what lets the value queries skip most of the map.
+*/
+class PartitionValuePyramid
+{
+public:
+
+	enum { VALUE_TYPE_COUNT = VOT_NumItems - VOT_CashValue };
+
+private:
+
+	struct Level
+	{
+		Int		m_width;
+		Int		m_height;
+		Int		m_offset;		///< of this level's blocks in the sums (level 0 has none)
+	};
+
+	typedef std::vector<Level> LevelVec;
+	typedef std::vector<Int64> SumVec;
+
+	LevelVec	m_levels;			///< m_levels[k] has blocks (1 << k) cells on a side
+	Int				m_sumCount;		///< blocks in all the levels above 0
+	SumVec		m_sums[MAX_PLAYER_COUNT][VALUE_TYPE_COUNT];	///< empty until the player has a value of that type somewhere
+
+public:
+
+	PartitionValuePyramid() : m_sumCount(0) { }
+
+	void init(Int cellCountX, Int cellCountY);
+	void reset();
+
+	/// a cell's value for the player went up (or down) by delta
+	void changeCellValue(Int playerIndex, ValueOrThreat valType, Int cellX, Int cellY, Int64 delta);
+
+	Int getLevelCount() const { return m_levels.size(); }
+	Int getLevelWidth(Int level) const { return m_levels[level].m_width; }
+	Int getLevelHeight(Int level) const { return m_levels[level].m_height; }
+
+	/// the sum of the values of the players in allowed over the block. (not for level 0: ask the cell.)
+	Int64 getBlockSum(const Bool *allowed, ValueOrThreat valType, Int level, Int x, Int y) const;
+
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+	The answers to the most recent terrain line of sight checks, looked up by the exact
+	bits of the two positions asked about. Units that keep asking the same thing from the
+	same spot (base defenses, anything standing guard) then only walk the terrain once.
+	The answer used longest ago makes way for a new one. Since the key is exact, a
+	remembered answer is always the one the terrain would give, as long as the terrain
+	heights haven't changed; whoever changes them has to call invalidate().
+*/
+class PartitionLineOfSightCache
+{
+public:
+
+	enum
+	{
+		ENTRY_COUNT = 512,
+		BUCKET_COUNT = 1024		///< must be a power of 2
+	};
+
+private:
+
+	enum { KEY_SIZE = 6 };
+
+	struct Entry
+	{
+		UnsignedInt		m_key[KEY_SIZE];	///< the bits of from and to
+		Bool					m_used;
+		Bool					m_clear;
+		Int						m_nextInBucket;
+		Int						m_newer;					///< toward the most recently used, -1 at the end
+		Int						m_older;					///< toward the least recently used, -1 at the end
+	};
+
+	Entry					m_entries[ENTRY_COUNT];
+	Int						m_buckets[BUCKET_COUNT];	///< first entry in each bucket, -1 for none
+	Int						m_newest;
+	Int						m_oldest;
+
+	UnsignedInt		m_statsFrame;
+	Int						m_queries;				///< lookups this frame
+	Int						m_hits;						///< lookups this frame that were answered
+	Int						m_totalQueries;
+	Int						m_totalHits;
+
+	static void makeKey(const Coord3D& from, const Coord3D& to, UnsignedInt *key);
+	static Int getBucket(const UnsignedInt *key);
+	void unlink(Int i);
+	void makeNewest(Int i);
+
+public:
+
+	PartitionLineOfSightCache();
+
+	/// forget everything, since the terrain has changed
+	void invalidate();
+
+	/// if the answer for from and to is known, put it in clear and return TRUE
+	Bool lookup(const Coord3D& from, const Coord3D& to, Bool& clear);
+
+	/// remember the answer for from and to, which lookup just failed to find
+	void insert(const Coord3D& from, const Coord3D& to, Bool clear);
+
+	void getStats(Int& queries, Int& hits) const;
+	void getTotals(Int& queries, Int& hits) const { queries = m_totalQueries; hits = m_totalHits; }
+
 };
 
 //-----------------------------------------------------------------------------
@@ -1123,6 +1323,349 @@ try_again:
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+PartitionEnemyCandidates::PartitionEnemyCandidates()
+{
+	for (Int i = 0; i < MAX_PLAYER_COUNT; ++i)
+		m_sets[i] = NULL;
+	m_relationshipStamp = 1;
+	m_statsFrame = 0xffffffff;
+	m_queries = 0;
+	m_cellsTouched = 0;
+	m_cellsBuilt = 0;
+}
+
+//-----------------------------------------------------------------------------
+PartitionEnemyCandidates::~PartitionEnemyCandidates()
+{
+	reset();
+}
+
+//-----------------------------------------------------------------------------
+void PartitionEnemyCandidates::reset()
+{
+	for (Int i = 0; i < MAX_PLAYER_COUNT; ++i)
+	{
+		delete m_sets[i];
+		m_sets[i] = NULL;
+	}
+	++m_relationshipStamp;
+}
+
+//-----------------------------------------------------------------------------
+PartitionEnemyCandidates::CandidateSet *PartitionEnemyCandidates::beginQuery(const Player *player, Int totalCellCount)
+{
+	UnsignedInt frame = TheGameLogic->getFrame();
+	if (frame != m_statsFrame)
+	{
+		m_statsFrame = frame;
+		m_queries = 0;
+		m_cellsTouched = 0;
+		m_cellsBuilt = 0;
+	}
+	++m_queries;
+
+	Int playerIndex = player->getPlayerIndex();
+	DEBUG_ASSERTCRASH(playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT, ("bad player index"));
+	CandidateSet *set = m_sets[playerIndex];
+	if (set == NULL)
+	{
+		set = NEW CandidateSet;
+		m_sets[playerIndex] = set;
+	}
+
+	// the lists only hold for one frame, so they never have to notice units dying or being built.
+	if (set->m_player != player || set->m_frame != frame || set->m_relationshipStamp != m_relationshipStamp 
+			|| set->m_runs.size() != totalCellCount)
+	{
+		set->m_player = player;
+		set->m_frame = frame;
+		set->m_relationshipStamp = m_relationshipStamp;
+		if (++set->m_generation == 0)
+			++set->m_generation;
+		if (set->m_runs.size() != totalCellCount)
+		{
+			set->m_runs.clear();
+			set->m_runs.resize(totalCellCount);
+		}
+		set->m_candidates.clear();
+	}
+
+	return set;
+}
+
+//-----------------------------------------------------------------------------
+const PartitionEnemyCandidates::CellRun& PartitionEnemyCandidates::getCellRun(CandidateSet *set, PartitionCell *cell, Int cellIndex)
+{
+	++m_cellsTouched;
+
+	CellRun& run = set->m_runs[cellIndex];
+	if (run.m_generation == set->m_generation && run.m_coiListStamp == cell->getCoiListStamp())
+		return run;
+
+	++m_cellsBuilt;
+
+	// keep the cell's order, so that scans come out exactly as they would from the cell itself.
+	run.m_generation = set->m_generation;
+	run.m_coiListStamp = cell->getCoiListStamp();
+	run.m_first = set->m_candidates.size();
+	for (CellAndObjectIntersection *coi = cell->getFirstCoiInCell(); coi; coi = coi->getNextCoi())
+	{
+		PartitionData *mod = coi->getModule();
+		const Object *other = mod->getObject();
+		if (other == NULL || other->isEffectivelyDead())
+			continue;
+
+		// this is Object::getRelationship, for an object whose relationships are just its player's.
+		if (other->getIsUndetectedDefector())
+			continue;
+		if (set->m_player->getRelationship(other->getTeam()) != ENEMIES)
+			continue;
+
+		set->m_candidates.push_back(mod);
+	}
+	run.m_count = set->m_candidates.size() - run.m_first;
+
+	return run;
+}
+
+//-----------------------------------------------------------------------------
+void PartitionEnemyCandidates::getStats(Int& queries, Int& cellsTouched, Int& cellsBuilt) const
+{
+	if (TheGameLogic->getFrame() != m_statsFrame)
+	{
+		queries = cellsTouched = cellsBuilt = 0;
+		return;
+	}
+	queries = m_queries;
+	cellsTouched = m_cellsTouched;
+	cellsBuilt = m_cellsBuilt;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void PartitionValuePyramid::init(Int cellCountX, Int cellCountY)
+{
+	reset();
+
+	Level level;
+	level.m_width = cellCountX;
+	level.m_height = cellCountY;
+	level.m_offset = 0;
+	m_levels.push_back(level);
+
+	while (level.m_width > 1 || level.m_height > 1)
+	{
+		level.m_offset = m_sumCount;
+		level.m_width = (level.m_width + 1) / 2;
+		level.m_height = (level.m_height + 1) / 2;
+		m_levels.push_back(level);
+		m_sumCount += level.m_width * level.m_height;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void PartitionValuePyramid::reset()
+{
+	m_levels.clear();
+	m_sumCount = 0;
+	for (Int i = 0; i < MAX_PLAYER_COUNT; ++i)
+	{
+		for (Int j = 0; j < VALUE_TYPE_COUNT; ++j)
+		{
+			// swap to really give back the memory
+			SumVec empty;
+			m_sums[i][j].swap(empty);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void PartitionValuePyramid::changeCellValue(Int playerIndex, ValueOrThreat valType, Int cellX, Int cellY, Int64 delta)
+{
+	if (delta == 0 || playerIndex < 0 || playerIndex >= MAX_PLAYER_COUNT)
+		return;
+
+	SumVec& sums = m_sums[playerIndex][valType - VOT_CashValue];
+	if (sums.empty())
+		sums.resize(m_sumCount, 0);
+
+	for (Int k = 1; k < m_levels.size(); ++k)
+	{
+		cellX >>= 1;
+		cellY >>= 1;
+		const Level& level = m_levels[k];
+		sums[level.m_offset + cellY * level.m_width + cellX] += delta;
+	}
+}
+
+//-----------------------------------------------------------------------------
+Int64 PartitionValuePyramid::getBlockSum(const Bool *allowed, ValueOrThreat valType, Int level, Int x, Int y) const
+{
+	DEBUG_ASSERTCRASH(level > 0 && level < m_levels.size(), ("bad level"));
+	Int index = m_levels[level].m_offset + y * m_levels[level].m_width + x;
+	Int type = valType - VOT_CashValue;
+
+	Int64 sum = 0;
+	for (Int i = 0; i < MAX_PLAYER_COUNT; ++i)
+	{
+		if (allowed[i] && !m_sums[i][type].empty())
+			sum += m_sums[i][type][index];
+	}
+	return sum;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+PartitionLineOfSightCache::PartitionLineOfSightCache()
+{
+	m_statsFrame = 0xffffffff;
+	m_queries = 0;
+	m_hits = 0;
+	m_totalQueries = 0;
+	m_totalHits = 0;
+	invalidate();
+}
+
+//-----------------------------------------------------------------------------
+void PartitionLineOfSightCache::invalidate()
+{
+	Int i;
+	for (i = 0; i < BUCKET_COUNT; ++i)
+		m_buckets[i] = -1;
+
+	for (i = 0; i < ENTRY_COUNT; ++i)
+	{
+		m_entries[i].m_used = false;
+		m_entries[i].m_nextInBucket = -1;
+		m_entries[i].m_newer = i - 1;
+		m_entries[i].m_older = (i + 1 < ENTRY_COUNT) ? i + 1 : -1;
+	}
+	m_newest = 0;
+	m_oldest = ENTRY_COUNT - 1;
+}
+
+//-----------------------------------------------------------------------------
+void PartitionLineOfSightCache::makeKey(const Coord3D& from, const Coord3D& to, UnsignedInt *key)
+{
+	key[0] = *(const UnsignedInt *)&from.x;
+	key[1] = *(const UnsignedInt *)&from.y;
+	key[2] = *(const UnsignedInt *)&from.z;
+	key[3] = *(const UnsignedInt *)&to.x;
+	key[4] = *(const UnsignedInt *)&to.y;
+	key[5] = *(const UnsignedInt *)&to.z;
+}
+
+//-----------------------------------------------------------------------------
+Int PartitionLineOfSightCache::getBucket(const UnsignedInt *key)
+{
+	UnsignedInt hash = 2166136261U;
+	for (Int i = 0; i < KEY_SIZE; ++i)
+		hash = (hash ^ key[i]) * 16777619U;
+	return (hash ^ (hash >> 15)) & (BUCKET_COUNT - 1);
+}
+
+//-----------------------------------------------------------------------------
+void PartitionLineOfSightCache::unlink(Int i)
+{
+	Entry& entry = m_entries[i];
+	if (entry.m_newer >= 0)
+		m_entries[entry.m_newer].m_older = entry.m_older;
+	else
+		m_newest = entry.m_older;
+	if (entry.m_older >= 0)
+		m_entries[entry.m_older].m_newer = entry.m_newer;
+	else
+		m_oldest = entry.m_newer;
+}
+
+//-----------------------------------------------------------------------------
+void PartitionLineOfSightCache::makeNewest(Int i)
+{
+	if (m_newest == i)
+		return;
+	unlink(i);
+	m_entries[i].m_newer = -1;
+	m_entries[i].m_older = m_newest;
+	m_entries[m_newest].m_newer = i;
+	m_newest = i;
+}
+
+//-----------------------------------------------------------------------------
+Bool PartitionLineOfSightCache::lookup(const Coord3D& from, const Coord3D& to, Bool& clear)
+{
+	UnsignedInt frame = TheGameLogic->getFrame();
+	if (frame != m_statsFrame)
+	{
+		m_statsFrame = frame;
+		m_queries = 0;
+		m_hits = 0;
+	}
+	++m_queries;
+	++m_totalQueries;
+
+	UnsignedInt key[KEY_SIZE];
+	makeKey(from, to, key);
+	for (Int i = m_buckets[getBucket(key)]; i >= 0; i = m_entries[i].m_nextInBucket)
+	{
+		Entry& entry = m_entries[i];
+		if (memcmp(entry.m_key, key, sizeof(key)) == 0)
+		{
+			makeNewest(i);
+			clear = entry.m_clear;
+			++m_hits;
+			++m_totalHits;
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+void PartitionLineOfSightCache::insert(const Coord3D& from, const Coord3D& to, Bool clear)
+{
+	// reuse the entry used longest ago
+	Int i = m_oldest;
+	Entry& entry = m_entries[i];
+	if (entry.m_used)
+	{
+		Int *link = &m_buckets[getBucket(entry.m_key)];
+		while (*link != i)
+			link = &m_entries[*link].m_nextInBucket;
+		*link = entry.m_nextInBucket;
+	}
+
+	makeKey(from, to, entry.m_key);
+	entry.m_used = true;
+	entry.m_clear = clear;
+	Int bucket = getBucket(entry.m_key);
+	entry.m_nextInBucket = m_buckets[bucket];
+	m_buckets[bucket] = i;
+	makeNewest(i);
+}
+
+//-----------------------------------------------------------------------------
+void PartitionLineOfSightCache::getStats(Int& queries, Int& hits) const
+{
+	if (TheGameLogic->getFrame() != m_statsFrame)
+	{
+		queries = hits = 0;
+		return;
+	}
+	queries = m_queries;
+	hits = m_hits;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 CellAndObjectIntersection::CellAndObjectIntersection()
 {
@@ -1228,6 +1771,9 @@ PartitionCell::PartitionCell()
 	//
 	m_firstCoiInCell = NULL;
 	m_coiCount = 0;
+	m_coiListStamp = 0;
+	m_structureStamp = 0xffffffff;
+	m_hasStructures = false;
 #ifdef PM_CACHE_TERRAIN_HEIGHT
 	m_loTerrainZ = HUGE_DIST;		// huge positive
 	m_hiTerrainZ = -HUGE_DIST;	// huge negative
@@ -1464,6 +2010,7 @@ void PartitionCell::friend_addToCellList(CellAndObjectIntersection *coi)
 	{
 		coi->friend_addToCellList(&m_firstCoiInCell);
 		++m_coiCount;
+		++m_coiListStamp;
 	}
 }
 
@@ -1474,9 +2021,30 @@ void PartitionCell::friend_removeFromCellList(CellAndObjectIntersection *coi)
 	{
 		coi->friend_removeFromCellList(&m_firstCoiInCell);
 		--m_coiCount;
+		++m_coiListStamp;
 	}
 }
 
+//-----------------------------------------------------------------------------
+Bool PartitionCell::hasStructures()
+{
+	if (m_structureStamp != m_coiListStamp)
+	{
+		m_structureStamp = m_coiListStamp;
+		m_hasStructures = false;
+		for (CellAndObjectIntersection *coi = m_firstCoiInCell; coi; coi = coi->getNextCoi())
+		{
+			const Object *obj = coi->getModule()->getObject();
+			if (obj && obj->isKindOf(KINDOF_STRUCTURE))
+			{
+				m_hasStructures = true;
+				break;
+			}
+		}
+	}
+	return m_hasStructures;
+}
+
 //-----------------------------------------------------------------------------
 void PartitionCell::getCellCenterPos(Real& x, Real& y)
 {
@@ -1555,6 +2123,7 @@ PartitionData::PartitionData()
 	m_doneFlag = 0;
 	m_dirtyStatus = NOT_DIRTY;
 	m_lastCell = NULL;
+	m_contactStamp = 0;
 	for (int i = 0; i < MAX_PLAYER_COUNT; ++i)
 	{
 		m_everSeenByPlayer[i] = false;
@@ -1937,6 +2506,10 @@ void PartitionData::addPossibleCollisions(PartitionContactList *ctList)
 
 	//DEBUG_LOG(("adding possible collision for %s\n",getObject()->getTemplate()->getName().str()));
 
+	// stamp myself too, so I get skipped along with the duplicates
+	UnsignedInt stamp = ctList->nextScanStamp();
+	m_contactStamp = stamp;
+
 	CellAndObjectIntersection *myCoi = m_coiArray;
 	for (Int i = m_coiInUseCount; i > 0; --i, ++myCoi)
 	{
@@ -1946,11 +2519,13 @@ void PartitionData::addPossibleCollisions(PartitionContactList *ctList)
 
 		for (CellAndObjectIntersection *coi = cell->getFirstCoiInCell(); coi; coi = coi->getNextCoi())
 		{
+			// anything that shares more than one cell with me only needs offering once
 			PartitionData *that = coi->getModule();
-			if (this != that)
-			{
-				ctList->addToContactList(this, that);
-			}
+			if (that->m_contactStamp == stamp)
+				continue;
+			that->m_contactStamp = stamp;
+
+			ctList->addToContactList(this, that);
 		}
 	}
 }
@@ -2126,7 +2701,18 @@ void PartitionData::invalidateShroudedStatusForAllPlayers()
 { 
 	for (Int i = 0; i < MAX_PLAYER_COUNT; i++) 
 	{
-		invalidateShroudedStatusForPlayer(i);
+		invalidateShroudedStatusForPlayer(i);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void PartitionData::invalidateCellContents()
+{
+	CellAndObjectIntersection *coi = m_coiArray;
+	for (Int i = m_coiArrayCount; i > 0; --i, ++coi)
+	{
+		if (coi->getModule())
+			coi->getCell()->friend_bumpCoiListStamp();
 	}
 }
 
@@ -2377,35 +2963,34 @@ void PartitionContactList::addToContactList( PartitionData *obj, PartitionData *
 	hashValue %= PartitionContactList_SOCKET_COUNT;
 
 	// make sure given hit has not already been recorded 
-	for (PartitionContactListNode* cd = m_contactHash[ hashValue ]; cd; cd = cd->m_nextHash )
+	for (Int cd = m_contactHash[ hashValue ]; cd >= 0; cd = m_contacts[ cd ].m_nextHash )
 	{
-		if ((cd->m_obj == obj && cd->m_other == other) ||
-				(cd->m_obj == other && cd->m_other == obj)) 
+		const PartitionContact& contact = m_contacts[ cd ];
+		if ((contact.m_obj == obj && contact.m_other == other) ||
+				(contact.m_obj == other && contact.m_other == obj)) 
 		{
 			// already noted 
 			return;
 		}
 	}
 
-	// new hit 
-	PartitionContactListNode *ncd = newInstance(PartitionContactListNode);
-	ncd->m_obj = obj;
-	ncd->m_other = other;
-	ncd->m_hashValue = hashValue;
+	// new hit, added to list of contacts for this frame 
+	PartitionContact ncd;
+	ncd.m_obj = obj;
+	ncd.m_other = other;
+	ncd.m_hashValue = hashValue;
 
 	// add to hash table 
-	ncd->m_nextHash = m_contactHash[ hashValue ];
-	m_contactHash[ hashValue ] = ncd;
-
-	// add to list of contacts for this frame 
-	ncd->m_next = m_contactList;
-	m_contactList = ncd;
+	ncd.m_nextHash = m_contactHash[ hashValue ];
+	m_contactHash[ hashValue ] = (Int)m_contacts.size();
+	m_contacts.push_back(ncd);
 
 
 #if 0
 
 Int depth = 0;
-for (PartitionContactListNode *cd2 = m_contactHash[ hashValue ]; cd2; cd2 = cd2->m_nextHash )
+Int cd2;
+for (cd2 = m_contactHash[ hashValue ]; cd2 >= 0; cd2 = m_contacts[ cd2 ].m_nextHash )
 {
 	depth++;
 }
@@ -2416,15 +3001,16 @@ if (depth > 3)
 		other_obj->getTemplate()->getName().str(),other_obj,other_obj->getID()
 		));
 
-	for (cd2 = m_contactHash[ hashValue ]; cd2; cd2 = cd2->m_nextHash )
+	for (cd2 = m_contactHash[ hashValue ]; cd2 >= 0; cd2 = m_contacts[ cd2 ].m_nextHash )
 	{
-		UnsignedInt rawhash = djb2hash2ints(cd2->m_obj->getObject()->getID(), cd2->m_other->getObject()->getID());
+		const PartitionContact& c2 = m_contacts[ cd2 ];
+		UnsignedInt rawhash = djb2hash2ints(c2.m_obj->getObject()->getID(), c2.m_other->getObject()->getID());
 		//hashValue %= PartitionContactList_SOCKET_COUNT;
 
 
 		DEBUG_LOG(("ENTRY: %s %08lx (%d) - %s %08lx (%d) [rawhash %d]\n",
-			cd2->m_obj->getObject()->getTemplate()->getName().str(),cd2->m_obj->getObject(),cd2->m_obj->getObject()->getID(),
-			cd2->m_other->getObject()->getTemplate()->getName().str(),cd2->m_other->getObject(),cd2->m_other->getObject()->getID(),
+			c2.m_obj->getObject()->getTemplate()->getName().str(),c2.m_obj->getObject(),c2.m_obj->getObject()->getID(),
+			c2.m_other->getObject()->getTemplate()->getName().str(),c2.m_other->getObject(),c2.m_other->getObject()->getID(),
 			rawhash));
 	}
 }
@@ -2434,10 +3020,10 @@ static Real aggfull = 0;
 static Real aggcount = 0;
 for (int ii = 0; ii < PartitionContactList_SOCKET_COUNT; ++ii)
 {
-	if (m_contactHash[ii])
+	if (m_contactHash[ii] >= 0)
 		aggfull += 1.0f;
 
-	for (cd2 = m_contactHash[ ii ]; cd2; cd2 = cd2->m_nextHash )
+	for (cd2 = m_contactHash[ ii ]; cd2 >= 0; cd2 = m_contacts[ cd2 ].m_nextHash )
 	{
 		aggtotal += 1.0f;
 	}
@@ -2453,7 +3039,7 @@ aggcount,aggtotal/(aggcount*PartitionContactList_SOCKET_COUNT),(aggfull*100)/(ag
 //-----------------------------------------------------------------------------
 void PartitionContactList::removeSpecificPartitionData(PartitionData* data)
 {
-	for (PartitionContactListNode* cd = m_contactList; cd; cd = cd->m_next)
+	for (ContactVec::iterator cd = m_contacts.begin(); cd != m_contacts.end(); ++cd)
 	{
 		if (cd->m_obj == data || cd->m_other == data)
 		{
@@ -2466,23 +3052,26 @@ void PartitionContactList::removeSpecificPartitionData(PartitionData* data)
 //-----------------------------------------------------------------------------
 void PartitionContactList::resetContactList()
 {
-	// remove items from hash table 
-	PartitionContactListNode* cdnext;
-	for (PartitionContactListNode* cd = m_contactList; cd; cd = cdnext)
+	// remove items from hash table. only the sockets that were used need clearing, 
+	// which is far fewer than all of them on most frames.
+	for (ContactVec::const_iterator cd = m_contacts.begin(); cd != m_contacts.end(); ++cd)
 	{
-		cdnext = cd->m_next;
-		cd->deleteInstance();
+		m_contactHash[ cd->m_hashValue ] = -1;
 	}
 
-	memset(m_contactHash, 0, sizeof(m_contactHash));
-	m_contactList = NULL;
+	m_contacts.clear();
 }
 
 //-----------------------------------------------------------------------------
-void PartitionContactList::processContactList()
+Int PartitionContactList::processContactList()
 {
-	for (PartitionContactListNode* cd = m_contactList; cd; cd = cd->m_next) 
+	Int numCollisions = 0;
+
+	// newest first, which is the order these have always been processed in; 
+	// the onCollide() calls care about the order, so keep it.
+	for (Int i = (Int)m_contacts.size() - 1; i >= 0; --i) 
 	{
+		PartitionContact* cd = &m_contacts[i];
 		if (cd->m_obj == NULL || cd->m_other == NULL)
 			continue;
 
@@ -2508,6 +3097,7 @@ void PartitionContactList::processContactList()
 		cd->m_obj = NULL;
 		cd->m_other = NULL;
 
+		++numCollisions;
 		obj->onCollide(other, &cinfo.loc, &cinfo.normal);
 		flipCoord3D(&cinfo.normal);
 
@@ -2537,6 +3127,8 @@ void PartitionContactList::processContactList()
 			other->friend_getPartitionData()->makeDirty(false);
 		}
 	}
+
+	return numCollisions;
 }
 
 //-----------------------------------------------------------------------------
@@ -2555,6 +3147,10 @@ PartitionManager::PartitionManager()
 	m_worldExtents.lo.zero();
 	m_worldExtents.hi.zero();
 	m_dirtyModules = NULL;
+	m_contactList = NEW PartitionContactList;
+	m_enemyCandidates = NEW PartitionEnemyCandidates;
+	m_valuePyramid = NEW PartitionValuePyramid;
+	m_lineOfSightCache = NEW PartitionLineOfSightCache;
 	m_updatedSinceLastReset = false;
 #ifdef FASTER_GCO
 	m_maxGcoRadius = 0;
@@ -2567,6 +3163,18 @@ PartitionManager::~PartitionManager()
 
 	shutdown();
 
+	delete m_contactList;
+	m_contactList = NULL;
+
+	delete m_enemyCandidates;
+	m_enemyCandidates = NULL;
+
+	delete m_valuePyramid;
+	m_valuePyramid = NULL;
+
+	delete m_lineOfSightCache;
+	m_lineOfSightCache = NULL;
+
 }  // end ~PartitionManager
 
 //-----------------------------------------------------------------------------
@@ -2637,6 +3245,8 @@ void PartitionManager::init()
 		calcRadiusVec();
 #endif
 
+		m_valuePyramid->init(m_cellCountX, m_cellCountY);
+
 	}
 	else
 	{
@@ -2662,6 +3272,18 @@ void PartitionManager::getPMStats(double& gcoTimeThisFrameTotal, double& gcoTime
 	gcoTimeThisFrameTotal = gcoTimeInMSecs;
 	gcoTimeThisFrameAvg = gcoTimeInMSecs / (double)s_countInClosestObjectsThisFrame;
 }
+
+//-----------------------------------------------------------------------------
+void PartitionManager::getEnemyScanStats(Int& queries, Int& cellsTouched, Int& cellsBuilt)
+{
+	m_enemyCandidates->getStats(queries, cellsTouched, cellsBuilt);
+}
+
+//-----------------------------------------------------------------------------
+void PartitionManager::getLineOfSightStats(Int& queries, Int& cacheHits)
+{
+	m_lineOfSightCache->getStats(queries, cacheHits);
+}
 #endif
 
 //-----------------------------------------------------------------------------
@@ -2704,6 +3326,10 @@ void PartitionManager::shutdown()
 #endif
 
 	resetPendingUndoShroudRevealQueue();
+
+	m_enemyCandidates->reset();
+	m_valuePyramid->reset();
+	m_lineOfSightCache->invalidate();
 	
 	delete [] m_cells;
 	m_cells = NULL;
@@ -2717,56 +3343,89 @@ void PartitionManager::shutdown()
 }
 
 //-----------------------------------------------------------------------------
-//DECLARE_PERF_TIMER(PartitionManager_update)
-void PartitionManager::update()
+Int PartitionManager::processDirtyModules(Int *numCollisions)
 {
-	//USE_PERF_TIMER(PartitionManager_update)
+#ifdef INTENSE_DEBUG
+	Int cc = 0;
+#endif
+
+	TheContactList = m_contactList;
+	while (m_dirtyModules)
 	{
 #ifdef INTENSE_DEBUG
-		Int cc = 0;
+		++cc;
 #endif
-		if (!m_updatedSinceLastReset) 
+
+		// save it.
+		PartitionData *dirty = m_dirtyModules;
+		DEBUG_ASSERTCRASH(dirty->getObject() != NULL || dirty->getGhostObject() != NULL, 
+											("must be attached to an Object here %08lx",dirty));
+
+		// get this BEFORE removing from dirty list, since that clears the
+		// flag in question.
+		Bool updateEm = dirty->isInNeedOfUpdatingCells();
+		Bool collideEm = dirty->isInNeedOfCollisionCheck() && dirty->getObject();	//only update collisions if we have object
+		
+		// detach it from the dirty list.
+		removeFromDirtyModules(dirty);
+
+		if (updateEm)
 		{
-			m_updatedSinceLastReset = true;
+			dirty->friend_updateCellsTouched();
 		}
 
-		PartitionContactList ctList;
-		TheContactList = &ctList;
-		while (m_dirtyModules)
+		if (collideEm && !dirty->getObject()->isKindOf(KINDOF_IMMOBILE))
 		{
+			dirty->addPossibleCollisions(m_contactList);
+		}
+	}
+	
+	Int numContacts = m_contactList->getContactCount();
+	Int collisions = m_contactList->processContactList();
+	if (numCollisions)
+		*numCollisions = collisions;
+
 #ifdef INTENSE_DEBUG
-			++cc;
+	DEBUG_ASSERTLOG(cc==0,("updated partition info for %d objects\n",cc));
 #endif
+	m_contactList->resetContactList();
+	TheContactList = NULL;
 
-			// save it.
-			PartitionData *dirty = m_dirtyModules;
-			DEBUG_ASSERTCRASH(dirty->getObject() != NULL || dirty->getGhostObject() != NULL, 
-												("must be attached to an Object here %08lx",dirty));
+	return numContacts;
+}
 
-			// get this BEFORE removing from dirty list, since that clears the
-			// flag in question.
-			Bool updateEm = dirty->isInNeedOfUpdatingCells();
-			Bool collideEm = dirty->isInNeedOfCollisionCheck() && dirty->getObject();	//only update collisions if we have object
-			
-			// detach it from the dirty list.
-			removeFromDirtyModules(dirty);
+//-----------------------------------------------------------------------------
+//DECLARE_PERF_TIMER(PartitionManager_update)
+void PartitionManager::update()
+{
+	//USE_PERF_TIMER(PartitionManager_update)
+	{
+		if (!m_updatedSinceLastReset) 
+		{
+			m_updatedSinceLastReset = true;
+		}
 
-			if (updateEm)
-			{
-				dirty->friend_updateCellsTouched();
-			}
+#if defined(_DEBUG) || defined(_INTERNAL)
+		static Bool collisionBenchmarkRun = FALSE;
+		if (!collisionBenchmarkRun && TheGlobalData->m_collisionBenchmarkTemplate.isNotEmpty() && m_cells != NULL)
+		{
+			// run the collision benchmark on the map we were given, log the results, and quit
+			collisionBenchmarkRun = TRUE;
+			runCollisionBenchmark(TheGlobalData->m_collisionBenchmarkTemplate, TheGlobalData->m_collisionBenchmarkUnits, TheGlobalData->m_collisionBenchmarkFrames);
+			TheGameEngine->setQuitting(TRUE);
+		}
 
-			if (collideEm && !dirty->getObject()->isKindOf(KINDOF_IMMOBILE))
-			{
-				dirty->addPossibleCollisions(&ctList);
-			}
+		static Bool lineOfSightBenchmarkRun = FALSE;
+		if (!lineOfSightBenchmarkRun && TheGlobalData->m_losBenchmarkQueries > 0 && m_cells != NULL)
+		{
+			// run the line of sight benchmark on the map we were given, log the results, and quit
+			lineOfSightBenchmarkRun = TRUE;
+			runLineOfSightBenchmark(TheGlobalData->m_losBenchmarkQueries);
+			TheGameEngine->setQuitting(TRUE);
 		}
-		
-		ctList.processContactList();
-#ifdef INTENSE_DEBUG
-		DEBUG_ASSERTLOG(cc==0,("updated partition info for %d objects\n",cc));
 #endif
-		TheContactList = NULL;
+
+		processDirtyModules(NULL);
 
 		processPendingUndoShroudRevealQueue();
 	}
@@ -2834,6 +3493,190 @@ void PartitionManager::update()
 #endif // defined(_DEBUG) || defined(_INTERNAL)
 }  // end update
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+//-----------------------------------------------------------------------------
+void PartitionManager::runCollisionBenchmark(const AsciiString& templateName, Int numUnits, Int numFrames)
+{
+	const ThingTemplate *tmpl = TheThingFactory->findTemplate(templateName);
+	if (tmpl == NULL || numUnits <= 0 || numFrames <= 0 || m_cells == NULL)
+	{
+		DEBUG_LOG(("PartitionManager::runCollisionBenchmark - nothing to run (%s)\n", templateName.str()));
+		return;
+	}
+
+	// pack them in a square at the middle of the map, one radius apart, so that
+	// every unit overlaps its neighbours.
+	Real spacing = tmpl->getTemplateGeometryInfo().getBoundingCircleRadius();
+	if (spacing < 1.0f)
+		spacing = 1.0f;
+	Int side = REAL_TO_INT_CEIL(sqrtf((Real)numUnits));
+	Coord3D center;
+	center.x = (m_worldExtents.lo.x + m_worldExtents.hi.x) * 0.5f - side * spacing * 0.5f;
+	center.y = (m_worldExtents.lo.y + m_worldExtents.hi.y) * 0.5f - side * spacing * 0.5f;
+
+	Team *team = ThePlayerList->getNeutralPlayer()->getDefaultTeam();
+	std::vector<Object *> units;
+	Int i;
+	for (i = 0; i < numUnits; ++i)
+	{
+		Object *obj = TheThingFactory->newObject(tmpl, team);
+		if (obj)
+			units.push_back(obj);
+	}
+	Int numCreated = (Int)units.size();
+
+	// get everything that was already dirty out of the way, so the first frame isn't charged for it
+	processDirtyModules(NULL);
+
+	__int64 startTime64, endTime64, freq64, updateTime64 = 0;
+	__int64 slowestTime64 = 0;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&freq64);
+	Real totalContacts = 0.0f;
+	Real totalCollisions = 0.0f;
+
+	for (Int frame = 0; frame < numFrames; ++frame)
+	{
+		// shuffle everyone a little, the same way every run, so they all need their cells and collisions redone
+		for (i = 0; i < numCreated; ++i)
+		{
+			Object *obj = units[i];
+			if (obj->isDestroyed())
+				continue;
+
+			Coord3D pos;
+			pos.x = center.x + (i % side) * spacing + (((i + frame) % 5) - 2) * spacing * 0.125f;
+			pos.y = center.y + (i / side) * spacing + (((i * 3 + frame) % 5) - 2) * spacing * 0.125f;
+			pos.z = TheTerrainLogic->getGroundHeight(pos.x, pos.y);
+			obj->setPosition(&pos);
+		}
+
+		Int numCollisions;
+		QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+		Int numContacts = processDirtyModules(&numCollisions);
+		QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+
+		updateTime64 += endTime64 - startTime64;
+		if (endTime64 - startTime64 > slowestTime64)
+			slowestTime64 = endTime64 - startTime64;
+
+		totalContacts += numContacts;
+		totalCollisions += numCollisions;
+	}
+
+	DEBUG_LOG(("PartitionManager::runCollisionBenchmark - %d frames, %d %s\n",
+		numFrames, numCreated, templateName.str()));
+	DEBUG_LOG(("  pairs: %.1f considered, %.1f colliding per frame\n",
+		totalContacts / numFrames, totalCollisions / numFrames));
+	DEBUG_LOG(("  collision pass: %.3f ms average, %.3f ms slowest\n",
+		(Real)((double)updateTime64 * 1000.0 / (double)freq64) / numFrames,
+		(Real)((double)slowestTime64 * 1000.0 / (double)freq64)));
+
+	for (i = 0; i < numCreated; ++i)
+		TheGameLogic->destroyObject(units[i]);
+
+}  // end runCollisionBenchmark
+
+//-----------------------------------------------------------------------------
+void PartitionManager::runLineOfSightBenchmark(Int numQueries)
+{
+	if (numQueries <= 0 || m_cells == NULL)
+		return;
+
+	// eye height pairs scattered over the map, no more than a long weapon range apart.
+	// the same pairs every run, so runs can be compared.
+	const Real MAX_QUERY_DIST = 400.0f;
+	const Real EYE_HEIGHT = 10.0f;
+	UnsignedInt seed = 0x12345678;
+	std::vector<Coord3D> from, to;
+	std::vector<Coord2D> points;
+	from.resize(numQueries);
+	to.resize(numQueries);
+	points.resize(numQueries * 2);
+	Int i;
+	for (i = 0; i < numQueries; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		from[i].x = m_worldExtents.lo.x + m_worldExtents.width() * ((seed >> 8) & 0xffff) / 65535.0f;
+		seed = seed * 1664525 + 1013904223;
+		from[i].y = m_worldExtents.lo.y + m_worldExtents.height() * ((seed >> 8) & 0xffff) / 65535.0f;
+		seed = seed * 1664525 + 1013904223;
+		to[i].x = from[i].x + MAX_QUERY_DIST * (((seed >> 8) & 0xffff) / 32767.5f - 1.0f);
+		seed = seed * 1664525 + 1013904223;
+		to[i].y = from[i].y + MAX_QUERY_DIST * (((seed >> 8) & 0xffff) / 32767.5f - 1.0f);
+		points[i * 2].x = from[i].x;
+		points[i * 2].y = from[i].y;
+		points[i * 2 + 1].x = to[i].x;
+		points[i * 2 + 1].y = to[i].y;
+	}
+
+	__int64 startTime64, endTime64, freq64;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&freq64);
+
+	// the ground heights, one at a time and then as a batch
+	Int numPoints = numQueries * 2;
+	std::vector<Real> heights;
+	heights.resize(numPoints);
+	QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+	for (i = 0; i < numPoints; ++i)
+		heights[i] = TheTerrainLogic->getGroundHeight(points[i].x, points[i].y);
+	QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+	double singleSecs = (double)(endTime64 - startTime64) / (double)freq64;
+
+	QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+	TheTerrainLogic->getGroundHeights(&points[0], &heights[0], numPoints);
+	QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+	double batchSecs = (double)(endTime64 - startTime64) / (double)freq64;
+
+	for (i = 0; i < numQueries; ++i)
+	{
+		from[i].z = heights[i * 2] + EYE_HEIGHT;
+		to[i].z = heights[i * 2 + 1] + EYE_HEIGHT;
+	}
+
+	// every pair once, straight to the terrain
+	Int numClear = 0;
+	QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+	for (i = 0; i < numQueries; ++i)
+	{
+		if (TheTerrainLogic->isClearLineOfSight(from[i], to[i]))
+			++numClear;
+	}
+	QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+	double losSecs = (double)(endTime64 - startTime64) / (double)freq64;
+
+	// then the same number of checks through the cache, picking from a smaller set of
+	// pairs, the way units standing around keep asking about the same targets.
+	Int workingSet = minInt(numQueries, PartitionLineOfSightCache::ENTRY_COUNT / 2);
+	Int queriesBefore, hitsBefore, queriesAfter, hitsAfter;
+	m_lineOfSightCache->invalidate();
+	m_lineOfSightCache->getTotals(queriesBefore, hitsBefore);
+	QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+	for (i = 0; i < numQueries; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		Int pair = ((seed >> 8) & 0xffff) % workingSet;
+		isClearLineOfSightTerrain(NULL, from[pair], NULL, to[pair]);
+	}
+	QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+	double cachedSecs = (double)(endTime64 - startTime64) / (double)freq64;
+	m_lineOfSightCache->getTotals(queriesAfter, hitsAfter);
+	Int cacheQueries = queriesAfter - queriesBefore;
+	Int cacheHits = hitsAfter - hitsBefore;
+	m_lineOfSightCache->invalidate();
+
+	DEBUG_LOG(("PartitionManager::runLineOfSightBenchmark - %d queries, %.1f%% clear\n",
+		numQueries, numClear * 100.0f / numQueries));
+	DEBUG_LOG(("  line of sight: %.3f ms, %.0f queries/sec\n",
+		(Real)(losSecs * 1000.0), losSecs > 0.0 ? numQueries / losSecs : 0.0));
+	DEBUG_LOG(("  cached, %d pairs: %.3f ms, %.0f queries/sec, %.1f%% cache hits\n",
+		workingSet, (Real)(cachedSecs * 1000.0), cachedSecs > 0.0 ? numQueries / cachedSecs : 0.0,
+		cacheQueries > 0 ? cacheHits * 100.0f / cacheQueries : 0.0f));
+	DEBUG_LOG(("  ground height: %.3f ms one at a time, %.3f ms batched, for %d points\n",
+		(Real)(singleSecs * 1000.0), (Real)(batchSecs * 1000.0), numPoints));
+
+}  // end runLineOfSightBenchmark
+#endif
+
 //------------------------------------------------------------------------------
 void PartitionManager::registerObject( Object* object )
 {
@@ -3209,7 +4052,8 @@ Object *PartitionManager::getClosestObjects(
 	PartitionFilter **filters, 
 	SimpleObjectIterator *iterArg,	// if nonnull, append ALL satisfactory objects to the iterator (not just the single closest)
 	Real *closestDistArg,
-	Coord3D *closestVecArg
+	Coord3D *closestVecArg,
+	const Player *enemiesOf
 )
 {
 	//USE_PERF_TIMER(getClosestObjects)
@@ -3259,6 +4103,11 @@ Object *PartitionManager::getClosestObjects(
 
 #ifdef FASTER_GCO
 
+	// if we're only after enemies, look at the (shared) candidates in each cell rather than all of it.
+	PartitionEnemyCandidates::CandidateSet *candidates = NULL;
+	if (enemiesOf)
+		candidates = m_enemyCandidates->beginQuery(enemiesOf, m_totalCellCount);
+
 	Int maxRadius = m_maxGcoRadius;
 	if (maxDist < HUGE_DIST)
 	{
@@ -3296,9 +4145,40 @@ Object *PartitionManager::getClosestObjects(
 			if (thisCell == NULL)
 				continue;
 
-			for (CellAndObjectIntersection *thisCoi = thisCell->getFirstCoiInCell(); thisCoi; thisCoi = thisCoi->getNextCoi())
+			CellAndObjectIntersection *thisCoi = NULL;
+			PartitionData **thisCandidate = NULL;
+			PartitionData **endCandidate = NULL;
+			if (candidates)
+			{
+				if (thisCell->getCoiCount() == 0)
+					continue;
+				const PartitionEnemyCandidates::CellRun& run = m_enemyCandidates->getCellRun(candidates, thisCell, thisCell - m_cells);
+				if (run.m_count == 0)
+					continue;
+				thisCandidate = &candidates->m_candidates[run.m_first];
+				endCandidate = thisCandidate + run.m_count;
+			}
+			else
+			{
+				thisCoi = thisCell->getFirstCoiInCell();
+			}
+
+			for (;;)
 			{
-				PartitionData *thisMod = thisCoi->getModule();
+				PartitionData *thisMod;
+				if (candidates)
+				{
+					if (thisCandidate == endCandidate)
+						break;
+					thisMod = *thisCandidate++;
+				}
+				else
+				{
+					if (thisCoi == NULL)
+						break;
+					thisMod = thisCoi->getModule();
+					thisCoi = thisCoi->getNextCoi();
+				}
 				Object *thisObj = thisMod->getObject();
 
 				// never compare against ourself.
@@ -3348,6 +4228,8 @@ Object *PartitionManager::getClosestObjects(
 
 #else // not FASTER_GCO
 
+	DEBUG_ASSERTCRASH(enemiesOf == NULL, ("enemy candidates need FASTER_GCO"));
+
 	CellOutwardIterator iter(this, cellCenterX, cellCenterY);
 	if (maxDist < HUGE_DIST)
 	{
@@ -3472,6 +4354,42 @@ Object *PartitionManager::getClosestObject(
 	return getClosestObjects(NULL, pos, maxDist, dc, filters, NULL, closestDist, closestDistVec);
 }
 
+//-----------------------------------------------------------------------------
+Bool PartitionManager::canShareEnemyCandidates(const Object *obj) const
+{
+#ifdef FASTER_GCO
+	// see Object::getRelationship and Team::getRelationship for what we're making sure we can skip.
+	const Team *team = obj->getTeam();
+	if (team == NULL || team->getControllingPlayer() == NULL)
+		return false;
+	if (obj->getIsUndetectedDefector() || team->hasOverrideRelationships())
+		return false;
+	return true;
+#else
+	return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+Object *PartitionManager::getClosestEnemyCandidate(
+	const Object *obj, 
+	Real maxDist, 
+	DistanceCalculationType dc, 
+	PartitionFilter **filters, 
+	Real *closestDist,
+	Coord3D *closestDistVec
+)
+{
+	DEBUG_ASSERTCRASH(canShareEnemyCandidates(obj), ("this object can't use the shared enemy candidates"));
+	return getClosestObjects(obj, NULL, maxDist, dc, filters, NULL, closestDist, closestDistVec, obj->getControllingPlayer());
+}
+
+//-----------------------------------------------------------------------------
+void PartitionManager::invalidateEnemyCandidates()
+{
+	m_enemyCandidates->invalidate();
+}
+
 //-----------------------------------------------------------------------------
 void PartitionManager::getVectorTo(const Object *obj, const Object *otherObj, DistanceCalculationType dc, Coord3D& vec)
 {
@@ -3633,6 +4551,28 @@ SimpleObjectIterator *PartitionManager::iterateObjectsInRange(
 	return iter;
 }
 
+//-----------------------------------------------------------------------------
+SimpleObjectIterator *PartitionManager::iterateEnemyCandidatesInRange(
+	const Object *obj, 
+	Real maxDist, 
+	DistanceCalculationType dc, 
+	PartitionFilter **filters, 
+	IterOrderType order
+)
+{
+	DEBUG_ASSERTCRASH(canShareEnemyCandidates(obj), ("this object can't use the shared enemy candidates"));
+
+	MemoryPoolObjectHolder iterHolder;
+	SimpleObjectIterator *iter = newInstance(SimpleObjectIterator);
+	iterHolder.hold(iter);
+
+	getClosestObjects(obj, NULL, maxDist, dc, filters, iter, NULL, NULL, obj->getControllingPlayer());
+
+	iter->sort(order);
+	iterHolder.release();
+	return iter;
+}
+
 //-----------------------------------------------------------------------------
 SimpleObjectIterator* PartitionManager::iteratePotentialCollisions(
 	const Coord3D* pos, 
@@ -4466,7 +5406,7 @@ Int PartitionManager::iterateCellsBreadthFirst(const Coord3D *pos, CellBreadthFi
 		}
 
 		// bottom
-		if (curY + 1 > 0) {
+		if (curY + 1 < m_cellCountY) {
 			if (!bitField[(curY + 1) * m_cellCountX + curX]) {
 				bitField[(curY + 1) * m_cellCountX + curX] = true;
 				cellQ.push(&m_cells[(curY + 1) * m_cellCountX + curX]);
@@ -4563,7 +5503,13 @@ Bool PartitionManager::isClearLineOfSightTerrain(const Object* obj, const Coord3
 	return true;
 
 #else
-	return TheTerrainLogic->isClearLineOfSight(pos, posOther);
+	Bool clear;
+	if (m_lineOfSightCache->lookup(pos, posOther, clear))
+		return clear;
+
+	clear = TheTerrainLogic->isClearLineOfSight(pos, posOther);
+	m_lineOfSightCache->insert(pos, posOther, clear);
+	return clear;
 #endif
 }
 
@@ -4700,22 +5646,63 @@ void PartitionManager::xfer( Xfer *xfer )
 void PartitionManager::loadPostProcess( void )
 {
 
+	// relationships and teams were just loaded out from under the candidate lists
+	invalidateEnemyCandidates();
+
+	// and the terrain heights out from under the line of sight answers
+	invalidateLineOfSightCache();
+
 }  // end loadPostProcess
 
+//-----------------------------------------------------------------------------
+void PartitionManager::invalidateLineOfSightCache()
+{
+	m_lineOfSightCache->invalidate();
+}
+
+//-----------------------------------------------------------------------------
+Bool PartitionManager::mayHaveStructuresInRange(const Coord3D *pos, Real range)
+{
+#ifdef FASTER_GCO
+	// exactly the cells that getClosestObjects would look in.
+	Int cellCenterX, cellCenterY;
+	worldToCell(pos->x, pos->y, &cellCenterX, &cellCenterY);
+	Int maxRadius = minInt(m_maxGcoRadius, worldToCellDist(range));
+	for (Int curRadius = 0; curRadius <= maxRadius; ++curRadius)
+	{
+		const OffsetVec& offsets = m_radiusVec[curRadius];
+		for (OffsetVec::const_iterator it = offsets.begin(); it != offsets.end(); ++it)
+		{
+			PartitionCell* thisCell = getCellAt(cellCenterX + it->x, cellCenterY + it->y);
+			if (thisCell && thisCell->hasStructures())
+				return true;
+		}
+	}
+	return false;
+#else
+	return true;
+#endif
+}
+
 //-----------------------------------------------------------------------------
 Real PartitionManager::getGroundOrStructureHeight(Real posx, Real posy)
 {
 	// get the terrain height
 	Real terrainHeightHere = TheTerrainLogic->getGroundHeight( posx, posy );
 
-	// scan all objects in the radius of our extent and find the tallest height among them
-	PartitionFilterAcceptByKindOf filter1( MAKE_KINDOF_MASK( KINDOF_STRUCTURE ), KINDOFMASK_NONE );
-	PartitionFilter *filters[] = { &filter1, NULL };
   Coord3D pos;
   pos.x = posx;
   pos.y = posy;
   pos.z = terrainHeightHere;
 	const Real RANGE = 1.0f;
+
+	// the cells remember whether any structure touches them, so most of the map needn't be scanned at all
+	if (!mayHaveStructuresInRange( &pos, RANGE ))
+		return terrainHeightHere;
+
+	// scan all objects in the radius of our extent and find the tallest height among them
+	PartitionFilterAcceptByKindOf filter1( MAKE_KINDOF_MASK( KINDOF_STRUCTURE ), KINDOFMASK_NONE );
+	PartitionFilter *filters[] = { &filter1, NULL };
 	ObjectIterator *iter = iterateObjectsInRange( &pos, RANGE, FROM_BOUNDINGSPHERE_2D, filters );
 	MemoryPoolObjectHolder hold( iter );
 
@@ -4733,6 +5720,178 @@ Real PartitionManager::getGroundOrStructureHeight(Real posx, Real posy)
   return terrainHeightHere + tallestHeight;
 }
 
+//-------------------------------------------------------------------------------------------------
+/**
+	What getMostValuableLocation is looking for, and the best it has found so far.
+*/
+struct MostValuableSearch
+{
+	PartitionCell*								cells;
+	Int														cellCountX;
+	const PartitionValuePyramid*	pyramid;
+	Bool													allowed[MAX_PLAYER_COUNT];
+	ValueOrThreat									valType;
+	Int														bestCell;
+	Int														bestValue;
+};
+
+//-------------------------------------------------------------------------------------------------
+static Int getAllowedCellValue(PartitionCell *cell, const Bool *allowed, ValueOrThreat valType)
+{
+	Int cellValue = 0;
+	for (Int player = 0; player < MAX_PLAYER_COUNT; ++player) {
+		if (allowed[player]) {
+			if (valType == VOT_CashValue) {
+				cellValue += cell->getCashValue(player);
+			} else {
+				cellValue += cell->getThreatValue(player);
+			}
+		}
+	}
+	return cellValue;
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+	Look through the blocks under block (x, y) of the given level for a cell better than the best
+	so far, most promising first. A block can only hold a better cell if its sum is more than the 
+	best value, or equal to it and it has a cell earlier in the map than the best cell (that's the
+	one a scan of every cell would have kept).
+*/
+static void findMostValuableCell(MostValuableSearch& search, Int level, Int x, Int y)
+{
+	Int childLevel = level - 1;
+	Int childWidth = search.pyramid->getLevelWidth(childLevel);
+	Int childHeight = search.pyramid->getLevelHeight(childLevel);
+
+	Int childX[4], childY[4], childFirstCell[4];
+	Int64 childBound[4];
+	Int numChildren = 0;
+
+	for (Int cy = y * 2; cy <= y * 2 + 1 && cy < childHeight; ++cy) {
+		for (Int cx = x * 2; cx <= x * 2 + 1 && cx < childWidth; ++cx) {
+			Int firstCell = (cy << childLevel) * search.cellCountX + (cx << childLevel);
+			Int64 bound;
+			if (childLevel == 0) {
+				bound = getAllowedCellValue(&search.cells[firstCell], search.allowed, search.valType);
+			} else {
+				bound = search.pyramid->getBlockSum(search.allowed, search.valType, childLevel, cx, cy);
+			}
+
+			// keep them in order, biggest bound first
+			Int i = numChildren++;
+			while (i > 0 && childBound[i - 1] < bound) {
+				childX[i] = childX[i - 1];
+				childY[i] = childY[i - 1];
+				childFirstCell[i] = childFirstCell[i - 1];
+				childBound[i] = childBound[i - 1];
+				--i;
+			}
+			childX[i] = cx;
+			childY[i] = cy;
+			childFirstCell[i] = firstCell;
+			childBound[i] = bound;
+		}
+	}
+
+	for (Int i = 0; i < numChildren; ++i) {
+		if (childBound[i] < search.bestValue) 
+			continue;
+		if (childBound[i] == search.bestValue && childFirstCell[i] > search.bestCell)
+			continue;
+
+		if (childLevel == 0) {
+			search.bestValue = (Int)childBound[i];
+			search.bestCell = childFirstCell[i];
+		} else {
+			findMostValuableCell(search, childLevel, childX[i], childY[i]);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+	What getNearestGroupWithValue is looking for, and the nearest it has found so far.
+*/
+struct NearestValueSearch
+{
+	PartitionCell*								cells;
+	Int														cellCountX;
+	Int														cellCountY;
+	const PartitionValuePyramid*	pyramid;
+	Bool													allowed[MAX_PLAYER_COUNT];
+	CellValueProcParms*						parms;
+	Int														startX;
+	Int														startY;
+	Int														bestCell;
+	Int														bestDist;			///< in cells, across plus down, which is the order the breadth first search finds them in
+	Int														countAtBestDist;
+};
+
+//-------------------------------------------------------------------------------------------------
+/**
+	Find the cells under block (x, y) of the given level with more than parms->valueRequired that are
+	nearest the start. Blocks whose sum is no more than that, or that are farther away than a cell
+	we've already found, can be skipped.
+*/
+static void findNearestCellWithValue(NearestValueSearch& search, Int level, Int x, Int y)
+{
+	Int childLevel = level - 1;
+	Int childWidth = search.pyramid->getLevelWidth(childLevel);
+	Int childHeight = search.pyramid->getLevelHeight(childLevel);
+
+	Int childX[4], childY[4], childDist[4];
+	Int numChildren = 0;
+
+	for (Int cy = y * 2; cy <= y * 2 + 1 && cy < childHeight; ++cy) {
+		for (Int cx = x * 2; cx <= x * 2 + 1 && cx < childWidth; ++cx) {
+			Int loX = cx << childLevel;
+			Int loY = cy << childLevel;
+			Int hiX = minInt(((cx + 1) << childLevel) - 1, search.cellCountX - 1);
+			Int hiY = minInt(((cy + 1) << childLevel) - 1, search.cellCountY - 1);
+			Int dist = maxInt(0, maxInt(loX - search.startX, search.startX - hiX)) 
+							 + maxInt(0, maxInt(loY - search.startY, search.startY - hiY));
+
+			// keep them in order, nearest first
+			Int i = numChildren++;
+			while (i > 0 && childDist[i - 1] > dist) {
+				childX[i] = childX[i - 1];
+				childY[i] = childY[i - 1];
+				childDist[i] = childDist[i - 1];
+				--i;
+			}
+			childX[i] = cx;
+			childY[i] = cy;
+			childDist[i] = dist;
+		}
+	}
+
+	for (Int i = 0; i < numChildren; ++i) {
+		if (search.bestCell != -1 && childDist[i] > search.bestDist)
+			continue;
+
+		if (childLevel == 0) {
+			Int cellIndex = childY[i] * search.cellCountX + childX[i];
+			if (cellValueProc(&search.cells[cellIndex], search.parms) == 0)
+				continue;
+
+			if (search.bestCell == -1 || childDist[i] < search.bestDist) {
+				search.bestCell = cellIndex;
+				search.bestDist = childDist[i];
+				search.countAtBestDist = 1;
+			} else {
+				++search.countAtBestDist;
+			}
+		} else {
+			Int64 sum = search.pyramid->getBlockSum(search.allowed, search.parms->valueType, childLevel, childX[i], childY[i]);
+			if (sum <= (Int64)(UnsignedInt)search.parms->valueRequired)
+				continue;
+
+			findNearestCellWithValue(search, childLevel, childX[i], childY[i]);
+		}
+	}
+}
+
 //-------------------------------------------------------------------------------------------------
 void PartitionManager::getMostValuableLocation( Int playerIndex, UnsignedInt whichPlayerTypes, ValueOrThreat valType, Coord3D *outLocation )
 {
@@ -4758,27 +5917,33 @@ void PartitionManager::getMostValuableLocation( Int playerIndex, UnsignedInt whi
 		allPlayerMasks[i] = player->getPlayerMask();
 	}
 
-	Int greatestValueCell = -1;
-	Int maxCellValue = -1;
-	for (i = 0; i < cellCount; ++i) {
-		Int cellValue = 0;
-
-		for (Int player = 0; player < MAX_PLAYER_COUNT; ++player) {
-			if (BitTest(allPlayerMasks[player], playerMask)) {
-				if (valType == VOT_CashValue) {
-					cellValue += m_cells[i].getCashValue(player);
-				} else {
-					cellValue += m_cells[i].getThreatValue(player);
-				}
+	MostValuableSearch search;
+	search.cells = m_cells;
+	search.cellCountX = m_cellCountX;
+	search.pyramid = m_valuePyramid;
+	for (i = 0; i < MAX_PLAYER_COUNT; ++i)
+		search.allowed[i] = BitTest(allPlayerMasks[i], playerMask);
+	search.valType = valType;
+	search.bestCell = -1;
+	search.bestValue = -1;
+
+	// the same cell that looking at every cell and keeping the first with the most would find.
+	Int topLevel = m_valuePyramid->getLevelCount() - 1;
+	if (topLevel > 0) {
+		findMostValuableCell(search, topLevel, 0, 0);
+	} else {
+		for (i = 0; i < cellCount; ++i) {
+			Int cellValue = getAllowedCellValue(&m_cells[i], search.allowed, valType);
+			if (cellValue > search.bestValue) {
+				search.bestValue = cellValue;
+				search.bestCell = i;
 			}
 		}
-
-		if (cellValue > maxCellValue) {
-			maxCellValue = cellValue;
-			greatestValueCell = i;
-		}
 	}
 
+	Int greatestValueCell = search.bestCell;
+	Int maxCellValue = search.bestValue;
+
 	if (greatestValueCell == -1 || maxCellValue == -1) {
 		DEBUG_CRASH(("PartitionManager::getMostValuableLocation: jkmcd"));
 		return;
@@ -4822,7 +5987,39 @@ void PartitionManager::getNearestGroupWithValue( Int playerIndex, UnsignedInt wh
 	for (i = 0; i < MAX_PLAYER_COUNT; ++i) 
 		parms.allPlayersMask[i] = allPlayerMasks[i];
 	
-	Int nearestGreat = iterateCellsBreadthFirst(sourceLocation, cellValueProc, &parms);
+	Int cellX, cellY;
+	worldToCell(sourceLocation->x, sourceLocation->y, &cellX, &cellY);
+
+	Int nearestGreat;
+	if (parms.greaterThan && m_valuePyramid->getLevelCount() > 1
+			&& cellX >= 0 && cellX < m_cellCountX && cellY >= 0 && cellY < m_cellCountY) {
+		// the breadth first search finds cells in order of distance across plus down, so if there's
+		// only one cell at the nearest such distance that will do, it's the one it would find.
+		NearestValueSearch search;
+		search.cells = m_cells;
+		search.cellCountX = m_cellCountX;
+		search.cellCountY = m_cellCountY;
+		search.pyramid = m_valuePyramid;
+		for (i = 0; i < MAX_PLAYER_COUNT; ++i)
+			search.allowed[i] = BitTest(allPlayerMasks[i], playerMask);
+		search.parms = &parms;
+		search.startX = cellX;
+		search.startY = cellY;
+		search.bestCell = -1;
+		search.bestDist = 0;
+		search.countAtBestDist = 0;
+		findNearestCellWithValue(search, m_valuePyramid->getLevelCount() - 1, 0, 0);
+
+		if (search.bestCell == -1 || search.countAtBestDist == 1) {
+			nearestGreat = search.bestCell;
+		} else {
+			// a tie, which only the search itself knows how to break. at least it won't have to go far.
+			nearestGreat = iterateCellsBreadthFirst(sourceLocation, cellValueProc, &parms);
+		}
+	} else {
+		nearestGreat = iterateCellsBreadthFirst(sourceLocation, cellValueProc, &parms);
+	}
+
 	if (nearestGreat != -1) {
 		(*outLocation).x = m_cells[nearestGreat].getCellX() * TheGlobalData->m_partitionCellSize;
 		(*outLocation).y = m_cells[nearestGreat].getCellY() * TheGlobalData->m_partitionCellSize;
@@ -5689,7 +6886,9 @@ static void hLineAddThreat(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 
+		UnsignedInt oldValue = cell->getThreatValue( parms->playerIndex );
 		cell->addThreatValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		ThePartitionManager->m_valuePyramid->changeCellValue( parms->playerIndex, VOT_ThreatValue, x, y, (Int64)cell->getThreatValue( parms->playerIndex ) - (Int64)oldValue );
 	}
 }
 
@@ -5717,7 +6916,9 @@ static void hLineRemoveThreat(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 		
+		UnsignedInt oldValue = cell->getThreatValue( parms->playerIndex );
 		cell->removeThreatValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		ThePartitionManager->m_valuePyramid->changeCellValue( parms->playerIndex, VOT_ThreatValue, x, y, (Int64)cell->getThreatValue( parms->playerIndex ) - (Int64)oldValue );
 	}
 }
 
@@ -5745,7 +6946,9 @@ static void hLineAddValue(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 		
+		UnsignedInt oldValue = cell->getCashValue( parms->playerIndex );
 		cell->addCashValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		ThePartitionManager->m_valuePyramid->changeCellValue( parms->playerIndex, VOT_CashValue, x, y, (Int64)cell->getCashValue( parms->playerIndex ) - (Int64)oldValue );
 	}
 }
 
@@ -5773,7 +6976,9 @@ static void hLineRemoveValue(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 
+		UnsignedInt oldValue = cell->getCashValue( parms->playerIndex );
 		cell->removeCashValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		ThePartitionManager->m_valuePyramid->changeCellValue( parms->playerIndex, VOT_CashValue, x, y, (Int64)cell->getCashValue( parms->playerIndex ) - (Int64)oldValue );
 	}
 }
 
@@ -995,6 +995,18 @@ void AIUpdateInterface::wakeUpNow()
 #endif
 }
 
+//-------------------------------------------------------------------------------------------------
+/**
+ * Pass an event on to the state machine. If the current state was sleeping and wants
+ * to react to it, wake the module too, so the state is updated next frame rather than
+ * whenever its sleep would have run out.
+ */
+void AIUpdateInterface::wakeUpStateMachine( StateWakeEvent event )
+{
+	if (m_stateMachine && m_stateMachine->wakeOnEvent( event ))
+		wakeUpNow();
+}
+
 //-------------------------------------------------------------------------------------------------
 void AIUpdateInterface::friend_notifyStateMachineChanged()
 {
@@ -2628,6 +2640,8 @@ void AIUpdateInterface::aiDoCommand(const AICommandParms* parms)
 	if (!isAllowedToRespondToAiCommands(parms))
 		return;
 
+	wakeUpStateMachine(STATE_WAKE_COMMAND_RECEIVED);
+
 #ifdef ALLOW_SURRENDER
 	// surrendered items have very limited options, and only via AI cmds
 	if (isSurrendered())
@@ -34,6 +34,7 @@
 #include "GameLogic/GameLogic.h"
 #include "GameLogic/Object.h"
 #include "GameLogic/PartitionManager.h"
+#include "GameLogic/Module/AIUpdate.h"
 #include "GameLogic/Module/DockUpdate.h"
 
 // ------------------------------------------------------------------------------------------------
@@ -406,6 +407,36 @@ void DockUpdate::cancelDock( Object* docker )
 	}
 }
 
+void DockUpdate::setDockOpen( Bool open )
+{
+	if( m_dockOpen && !open )
+		wakeAllDockers();
+	m_dockOpen = open;
+}
+
+void DockUpdate::onDelete( void )
+{
+	// anyone still queued here has to find out that we're gone
+	wakeAllDockers();
+	UpdateModule::onDelete();
+}
+
+void DockUpdate::wakeDocker( ObjectID dockerID )
+{
+	Object *docker = TheGameLogic->findObjectByID( dockerID );
+	if( docker && docker->getAI() )
+		docker->getAI()->wakeUpStateMachine( STATE_WAKE_DOCK_CHANGED );
+}
+
+void DockUpdate::wakeAllDockers( void )
+{
+	for( Int positionIndex = 0; positionIndex < m_approachPositionOwners.size(); ++positionIndex )
+	{
+		if( m_approachPositionOwners[positionIndex] != INVALID_ID )
+			wakeDocker( m_approachPositionOwners[positionIndex] );
+	}
+}
+
 void DockUpdate::setDockCrippled( Bool setting )
 {
 	// At this level, Crippling means I will accept Approach requests, but I will never grant Enter clearence.
@@ -422,6 +453,7 @@ UpdateSleepTime DockUpdate::update()
 			if( m_approachPositionReached[positionIndex] )
 			{
 				m_activeDocker = m_approachPositionOwners[positionIndex];
+				wakeDocker( m_activeDocker );
 				return UPDATE_SLEEP_NONE;
 			}
 		}
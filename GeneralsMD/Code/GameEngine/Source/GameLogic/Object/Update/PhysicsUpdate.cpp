@@ -617,6 +617,75 @@ void PhysicsBehavior::setBounceSound(const AudioEventRTS* bounceSound)
 	}
 }
 
+//-------------------------------------------------------------------------------------------------
+/**
+ * Shells and debris spend most of their life in free flight: no rotation, no ground contact,
+ * and only gravity and air resistance acting on them.  This takes exactly the step update()
+ * would for them, without the friction, bounce, ground and rotation handling.  If the object
+ * needs any of that this frame, nothing is changed and false is returned.
+ */
+Bool PhysicsBehavior::tryBallisticStep()
+{
+	const Int SPECIAL_FLAGS = STICK_TO_GROUND | APPLY_FRICTION2D_WHEN_AIRBORNE | HAS_PITCHROLLYAW | IS_IN_FREEFALL | IS_STUNNED;
+	if (m_flags & SPECIAL_FLAGS)
+		return false;
+
+	// applyRandomRotation() doesn't set HAS_PITCHROLLYAW, so check the rates themselves
+	if (m_yawRate != 0.0f || m_pitchRate != 0.0f || m_rollRate != 0.0f)
+		return false;
+
+	Object* obj = getObject();
+	if (obj->testStatus(OBJECT_STATUS_BRAKING) || obj->testStatus(OBJECT_STATUS_DECK_HEIGHT_OFFSET))
+		return false;
+
+	// close to the ground, we get ground friction instead of air resistance
+	if (!obj->isSignificantlyAboveTerrain())
+		return false;
+
+	// same sums, in the same order, as applyGravitationalForces() and applyFrictionalForces()
+	Real aerodynamics = -getAerodynamicFriction();	// negated!
+	Coord3D accel = m_accel;
+	accel.z += TheGlobalData->m_gravity;
+	accel.x += m_vel.x * aerodynamics;
+	accel.y += m_vel.y * aerodynamics;
+	accel.z += m_vel.z * aerodynamics;
+
+	Coord3D vel;
+	vel.x = m_vel.x + accel.x;
+	vel.y = m_vel.y + accel.y;
+	vel.z = m_vel.z + accel.z;
+
+	const Real THRESH = 0.001f;
+	if (fabsf(vel.x) < THRESH) vel.x = 0.0f;
+	if (fabsf(vel.y) < THRESH) vel.y = 0.0f;
+	if (fabsf(vel.z) < THRESH) vel.z = 0.0f;
+
+	Matrix3D mtx = *obj->getTransformMatrix();
+	mtx.Adjust_X_Translation(vel.x);
+	mtx.Adjust_Y_Translation(vel.y);
+	mtx.Adjust_Z_Translation(vel.z);
+
+	if (_isnan(mtx.Get_X_Translation()) || _isnan(mtx.Get_Y_Translation()) ||
+		_isnan(mtx.Get_Z_Translation())) 
+		return false;
+
+	// if we'd touch the ground, let the full update bounce or land us
+	Real groundZ = TheTerrainLogic->getLayerHeight(mtx.Get_X_Translation(), mtx.Get_Y_Translation(), obj->getLayer());
+	if (mtx.Get_Z_Translation() <= groundZ)
+		return false;
+
+	m_vel = vel;
+	m_velMag = INVALID_VEL_MAG;
+	obj->setTransformMatrix(&mtx);
+
+	m_accel.zero();
+
+	m_previousOverlap = m_currentOverlap;
+	m_currentOverlap = INVALID_ID;
+
+	return true;
+}
+
 //-------------------------------------------------------------------------------------------------
 /**
  * Basic rigid body physics using an Euler integrator.
@@ -647,6 +716,16 @@ UpdateSleepTime PhysicsBehavior::update()
 	Coord3D prevPos = *obj->getPosition();
 	m_prevAccel = m_accel;
 
+	if (!obj->isDisabledByType(DISABLED_HELD) && tryBallisticStep())
+	{
+		// still clear of the ground, so there's no landing to deal with
+		setFlag(UPDATE_EVER_RUN, true);
+		setFlag(WAS_AIRBORNE_LAST_FRAME, true);
+
+		setFlag(IS_IN_UPDATE, false);
+		return calcSleepTime();
+	}
+
 	if (!obj->isDisabledByType(DISABLED_HELD))
 	{
 		Matrix3D mtx = *obj->getTransformMatrix();
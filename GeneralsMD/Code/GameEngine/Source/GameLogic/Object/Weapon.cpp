@@ -41,10 +41,12 @@
 #include "Common/CRC.h"
 #include "Common/CRCDebug.h"
 #include "Common/GameAudio.h"
+#include "Common/GameEngine.h"
 #include "Common/GameState.h"
 #include "Common/INI.h"
 #include "Common/PerfTimer.h"
 #include "Common/Player.h"
+#include "Common/PlayerList.h"
 #include "Common/ThingFactory.h"
 #include "Common/ThingTemplate.h"
 #include "Common/Xfer.h"
@@ -1193,21 +1195,7 @@ UnsignedInt WeaponTemplate::fireWeaponTemplate
 void WeaponTemplate::trimOldHistoricDamage() const
 {
 	UnsignedInt expirationDate = TheGameLogic->getFrame() - TheGlobalData->m_historicDamageLimit;
-	while (m_historicDamage.size() > 0)
-	{
-		HistoricWeaponDamageInfo& h = m_historicDamage.front();
-		if (h.frame <= expirationDate)
-		{
-			m_historicDamage.pop_front();
-			continue;
-		}
-		else
-		{
-			// since they are in strict chronological order,
-			// stop as soon as we get to a nonexpired one
-			break;
-		}
-	}
+	m_historicDamage.expire(expirationDate);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1217,6 +1205,59 @@ static Bool is2DDistSquaredLessThan(const Coord3D& a, const Coord3D& b, Real dis
 	return da <= distSqr;
 }
 
+//-------------------------------------------------------------------------------------------------
+void HistoricWeaponDamageRing::push(UnsignedInt frame, const Coord3D& location)
+{
+	Int capacity = m_entries.size();
+	if (m_count == capacity)
+	{
+		// full, so unroll it into a bigger one, oldest first
+		std::vector<HistoricWeaponDamageInfo> entries;
+		entries.resize(capacity > 0 ? capacity * 2 : 16);
+		for (Int i = 0; i < m_count; ++i)
+			entries[i] = m_entries[(m_head + i) % capacity];
+		m_entries.swap(entries);
+		m_head = 0;
+		capacity = m_entries.size();
+	}
+
+	HistoricWeaponDamageInfo& h = m_entries[(m_head + m_count) % capacity];
+	h.frame = frame;
+	h.location = location;
+	++m_count;
+}
+
+//-------------------------------------------------------------------------------------------------
+void HistoricWeaponDamageRing::expire(UnsignedInt expirationDate)
+{
+	// since they are in strict chronological order,
+	// stop as soon as we get to a nonexpired one
+	while (m_count > 0 && m_entries[m_head].frame <= expirationDate)
+	{
+		m_head = (m_head + 1) % m_entries.size();
+		--m_count;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+Int HistoricWeaponDamageRing::countNear(const Coord3D& pos, Real radiusSqr, UnsignedInt oldestFrame, Int enough) const
+{
+	Int capacity = m_entries.size();
+	Int count = 0;
+	for (Int i = m_count - 1; i >= 0 && count < enough; --i)
+	{
+		const HistoricWeaponDamageInfo& h = m_entries[(m_head + i) % capacity];
+
+		// newest first, so once one is too old, so are all the rest
+		if (h.frame < oldestFrame)
+			break;
+
+		if (is2DDistSquaredLessThan(pos, h.location, radiusSqr))
+			++count;
+	}
+	return count;
+}
+
 //-------------------------------------------------------------------------------------------------
 void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, const Coord3D *pos, const WeaponBonus& bonus, Bool isProjectileDetonation) const
 {
@@ -1240,19 +1281,12 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 	if( m_historicBonusCount > 0 && m_historicBonusWeapon != this )
 	{
 		Real radSqr = m_historicBonusRadius * m_historicBonusRadius;
-		Int count = 0;
 		UnsignedInt frameNow = TheGameLogic->getFrame();
 		UnsignedInt oldestThatWillCount = frameNow - m_historicBonusTime; // Anything before this frame is "more than two seconds ago" eg
-		for( HistoricWeaponDamageList::const_iterator it = m_historicDamage.begin(); it != m_historicDamage.end(); ++it )
-		{
-			if( it->frame >= oldestThatWillCount && 
-					is2DDistSquaredLessThan( *pos, it->location, radSqr ) )
-			{
-				// This one is close enough in time and distance, so count it. This is tracked by template since it applies
-				// across units, so don't try to clear historicDamage on success in here.
-				++count;
-			}
-		}
+
+		// Count the ones close enough in time and distance. This is tracked by template since it applies
+		// across units, so don't try to clear historicDamage on success in here.
+		Int count = m_historicDamage.countNear( *pos, radSqr, oldestThatWillCount, m_historicBonusCount - 1 );
 		
 		if( count >= m_historicBonusCount - 1 )	// minus 1 since we include ourselves implicitly
 		{
@@ -1268,7 +1302,7 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 		{
 			
 			// add AFTER checking for historic stuff
-			m_historicDamage.push_back( HistoricWeaponDamageInfo(frameNow, *pos) );
+			m_historicDamage.push( frameNow, *pos );
 
 		}  // end else
 
@@ -1332,6 +1366,46 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 		}
 		MemoryPoolObjectHolder hold(iter);
 
+		// everything below depends only on the weapon and the source, so work it out once
+		// rather than once per victim.
+		Real allowedAngle = getRadiusDamageAngle();
+		Real cosAllowedAngle = 0.0f;
+		Vector3 sourceVector(0.0f, 0.0f, 0.0f);
+		if( allowedAngle < PI && source != NULL )
+		{
+			// People can only be hit in a cone oriented as the firer is oriented
+			sourceVector = source->getTransformMatrix()->Get_X_Vector();
+			sourceVector.Normalize();
+			cosAllowedAngle = Cos(allowedAngle);
+		}
+
+		ObjectID damageSourceID = sourceID;
+		PlayerMaskType sourcePlayerMask = 0;
+		if (source != NULL)
+		{
+			if (source->getControllingPlayer()) 
+			{
+				sourcePlayerMask = source->getControllingPlayer()->getPlayerMask();
+			}
+
+			// if the damage-dealer is a projectile, designate the damage as done by its launcher, not the projectile.
+			// this is much more useful for the AI...
+			if (source->isKindOf(KINDOF_PROJECTILE))
+			{
+				for (BehaviorModule** u = source->getBehaviorModules(); *u; ++u)
+				{
+					ProjectileUpdateInterface* pui = (*u)->getProjectileUpdateInterface();
+					if (pui != NULL)
+					{
+						damageSourceID = pui->projectileGetLauncherID();
+						break;
+					}
+				}
+			}
+		}
+
+		// first, find everyone who will be hurt and how much, without hurting anyone yet
+		RadiusDamageVictimVec *victims = TheWeaponStore->pushRadiusDamageVictims();
 		for (; curVictim != NULL; curVictim = iter ? iter->nextWithNumeric(&curVictimDistSqr) : NULL)
 		{
 			Bool killSelf = false;
@@ -1399,67 +1473,32 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 				}
 			}
 
-			DamageInfo damageInfo;
-			damageInfo.in.m_damageType = damageType;
-			damageInfo.in.m_deathType = deathType;
-			damageInfo.in.m_sourceID = sourceID;
-			damageInfo.in.m_sourcePlayerMask = 0;
-			damageInfo.in.m_damageStatusType = damageStatusType;
-			
-			Coord3D damageDirection;
-			damageDirection.zero();
-			if( curVictim && source )
+			RadiusDamageVictim victim;
+			victim.m_victim = curVictim;
+			victim.m_damageDirection.zero();
+			if( source )
 			{
-				damageDirection.set( curVictim->getPosition() );
-				damageDirection.sub( source->getPosition() );
+				victim.m_damageDirection.set( curVictim->getPosition() );
+				victim.m_damageDirection.sub( source->getPosition() );
 			}
 
-			Real allowedAngle = getRadiusDamageAngle();
 			if( allowedAngle < PI )
 			{
-				if( curVictim == NULL  ||  source == NULL )
+				if( source == NULL )
 					continue; // We are directional damage, but can't figure out our direction.  Just bail.
 				
-				// People can only be hit in a cone oriented as the firer is oriented
-				Vector3 sourceVector = source->getTransformMatrix()->Get_X_Vector();
-				Vector3 damageVector(damageDirection.x, damageDirection.y, damageDirection.z);
-				sourceVector.Normalize();
+				Vector3 damageVector(victim.m_damageDirection.x, victim.m_damageDirection.y, victim.m_damageDirection.z);
 				damageVector.Normalize();
 
 				// These are now normalized, so the dot productis actually the Cos of the angle they form
 				// A smaller Cos would mean a more obtuse angle
-				if( Vector3::Dot_Product(sourceVector, damageVector) < Cos(allowedAngle) )
+				if( Vector3::Dot_Product(sourceVector, damageVector) < cosAllowedAngle )
 					continue;// Too far to the side, can't hurt them.
 			}
 
-			// Grab the vector between the source object causing the damage and the victim in order that we can
-			// simulate a shockwave pushing objects around
-			damageInfo.in.m_shockWaveAmount = m_shockWaveAmount;
-			if (damageInfo.in.m_shockWaveAmount > 0.0f)
-			{
-				// Calculate the vector of the shockwave
-				Coord3D shockWaveVector = damageDirection;
-
-				// Guard against zero vector. Make vector stright up if that is the case
-				if (fabs(shockWaveVector.x) < WWMATH_EPSILON && 
-						fabs(shockWaveVector.y) < WWMATH_EPSILON && 
-						fabs(shockWaveVector.z) < WWMATH_EPSILON)
-				{
-					shockWaveVector.z = 1.0f;
-				}
-
-				// Populate the damge information with the shockwave information
-				damageInfo.in.m_shockWaveVector = shockWaveVector;
-				damageInfo.in.m_shockWaveRadius = m_shockWaveRadius;
-				damageInfo.in.m_shockWaveTaperOff = m_shockWaveTaperOff;
-			}
-
-      if (source && source->getControllingPlayer()) {
-				damageInfo.in.m_sourcePlayerMask = source->getControllingPlayer()->getPlayerMask();
-			}
 			// note, don't bother with damage multipliers here... 
 			// that's handled internally by the attemptDamage() method.
-			damageInfo.in.m_amount = (curVictimDistSqr <= primaryRadiusSqr) ? primaryDamage : secondaryDamage;
+			victim.m_amount = (curVictimDistSqr <= primaryRadiusSqr) ? primaryDamage : secondaryDamage;
 
 			if( killSelf )
 			{
@@ -1467,7 +1506,7 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 				//enough unresistable damage to die... however it's possible that we have different types of
 				//deaths based on damage type and/or the possibility to resist certain damage types and
 				//surviving -- so instead, I'm blindly inflicting a very high value of the intended damage type.
-				damageInfo.in.m_amount = HUGE_DAMAGE_AMOUNT;
+				victim.m_amount = HUGE_DAMAGE_AMOUNT;
 				//BodyModuleInterface* body = curVictim->getBodyModule();
 				//if( body )
 				//{
@@ -1476,26 +1515,50 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 				//}
 			}
 
-			// if the damage-dealer is a projectile, designate the damage as done by its launcher, not the projectile.
-			// this is much more useful for the AI...
-			if (source && source->isKindOf(KINDOF_PROJECTILE))
+			victims->push_back(victim);
+		}
+
+		// then hurt them, in the order they were found
+		for (Int i = 0; i < victims->size(); ++i)
+		{
+			const RadiusDamageVictim& victim = (*victims)[i];
+
+			DamageInfo damageInfo;
+			damageInfo.in.m_damageType = damageType;
+			damageInfo.in.m_deathType = deathType;
+			damageInfo.in.m_sourceID = damageSourceID;
+			damageInfo.in.m_sourcePlayerMask = sourcePlayerMask;
+			damageInfo.in.m_damageStatusType = damageStatusType;
+			damageInfo.in.m_amount = victim.m_amount;
+
+			// Grab the vector between the source object causing the damage and the victim in order that we can
+			// simulate a shockwave pushing objects around
+			damageInfo.in.m_shockWaveAmount = m_shockWaveAmount;
+			if (damageInfo.in.m_shockWaveAmount > 0.0f)
 			{
-				for (BehaviorModule** u = source->getBehaviorModules(); *u; ++u)
+				// Calculate the vector of the shockwave
+				Coord3D shockWaveVector = victim.m_damageDirection;
+
+				// Guard against zero vector. Make vector stright up if that is the case
+				if (fabs(shockWaveVector.x) < WWMATH_EPSILON && 
+						fabs(shockWaveVector.y) < WWMATH_EPSILON && 
+						fabs(shockWaveVector.z) < WWMATH_EPSILON)
 				{
-					ProjectileUpdateInterface* pui = (*u)->getProjectileUpdateInterface();
-					if (pui != NULL)
-					{
-						damageInfo.in.m_sourceID = pui->projectileGetLauncherID();
-						break;
-					}
+					shockWaveVector.z = 1.0f;
 				}
+
+				// Populate the damge information with the shockwave information
+				damageInfo.in.m_shockWaveVector = shockWaveVector;
+				damageInfo.in.m_shockWaveRadius = m_shockWaveRadius;
+				damageInfo.in.m_shockWaveTaperOff = m_shockWaveTaperOff;
 			}
 
-			curVictim->attemptDamage(&damageInfo);
+			victim.m_victim->attemptDamage(&damageInfo);
 			//DEBUG_ASSERTLOG(damageInfo.out.m_noEffect, ("WeaponTemplate::dealDamageInternal: dealt to %s %08lx: attempted %f, actual %f (%f)\n",
 			//	curVictim->getTemplate()->getName().str(),curVictim,
 			//	damageInfo.in.m_amount, damageInfo.out.m_actualDamageDealt, damageInfo.out.m_actualDamageClipped));
 		}
+		TheWeaponStore->popRadiusDamageVictims();
 	}
 	else
 	{
@@ -1508,6 +1571,7 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 //-------------------------------------------------------------------------------------------------
 WeaponStore::WeaponStore()
 {
+	m_radiusDamageDepth = 0;
 } 
 
 //-------------------------------------------------------------------------------------------------
@@ -1515,6 +1579,11 @@ WeaponStore::~WeaponStore()
 {
 	deleteAllDelayedDamage();
 
+	DEBUG_ASSERTCRASH(m_radiusDamageDepth == 0, ("radius damage victims still in use"));
+	for (Int j = 0; j < m_radiusDamageVictims.size(); ++j)
+		delete m_radiusDamageVictims[j];
+	m_radiusDamageVictims.clear();
+
 	for (Int i = 0; i < m_weaponTemplateVector.size(); i++)
 	{
 		WeaponTemplate* wt = m_weaponTemplateVector[i];
@@ -1609,9 +1678,39 @@ WeaponTemplate *WeaponStore::newOverride(WeaponTemplate *weaponTemplate)
 	return wt;
 } 
 
+//-------------------------------------------------------------------------------------------------
+RadiusDamageVictimVec *WeaponStore::pushRadiusDamageVictims()
+{
+	if (m_radiusDamageDepth == m_radiusDamageVictims.size())
+		m_radiusDamageVictims.push_back(NEW RadiusDamageVictimVec);
+
+	RadiusDamageVictimVec *victims = m_radiusDamageVictims[m_radiusDamageDepth++];
+	victims->clear();
+	return victims;
+}
+
+//-------------------------------------------------------------------------------------------------
+void WeaponStore::popRadiusDamageVictims()
+{
+	DEBUG_ASSERTCRASH(m_radiusDamageDepth > 0, ("radius damage victims popped too many times"));
+	--m_radiusDamageDepth;
+}
+
 //-------------------------------------------------------------------------------------------------
 void WeaponStore::update()
 {
+#if defined(_DEBUG) || defined(_INTERNAL)
+	static Bool barrageBenchmarkRun = FALSE;
+	if (!barrageBenchmarkRun && TheGlobalData->m_barrageBenchmarkWeapon.isNotEmpty())
+	{
+		// run the barrage benchmark on the map we were given, log the results, and quit
+		barrageBenchmarkRun = TRUE;
+		runBarrageBenchmark(TheGlobalData->m_barrageBenchmarkWeapon, TheGlobalData->m_barrageBenchmarkTarget,
+			TheGlobalData->m_barrageBenchmarkUnits, TheGlobalData->m_barrageBenchmarkShots, TheGlobalData->m_barrageBenchmarkFrames);
+		TheGameEngine->setQuitting(TRUE);
+	}
+#endif
+
 	for (std::list<WeaponDelayedDamageInfo>::iterator ddi = m_weaponDDI.begin(); ddi != m_weaponDDI.end(); )
 	{
 		UnsignedInt curFrame = TheGameLogic->getFrame();
@@ -1629,6 +1728,104 @@ void WeaponStore::update()
 	}
 }
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+//-------------------------------------------------------------------------------------------------
+void WeaponStore::runBarrageBenchmark(const AsciiString& weaponName, const AsciiString& targetName, Int numUnits, Int numShots, Int numFrames)
+{
+	const WeaponTemplate *wt = findWeaponTemplate(weaponName);
+	const ThingTemplate *tmpl = TheThingFactory->findTemplate(targetName);
+	if (wt == NULL || tmpl == NULL || numUnits <= 0 || numShots <= 0 || numFrames <= 0 || TheTerrainLogic == NULL)
+	{
+		DEBUG_LOG(("WeaponStore::runBarrageBenchmark - nothing to run (%s on %s)\n", weaponName.str(), targetName.str()));
+		return;
+	}
+
+	// lay the targets out in a square at the middle of the map, a little apart from each other
+	Region3D extent;
+	TheTerrainLogic->getExtent(&extent);
+	Real spacing = tmpl->getTemplateGeometryInfo().getBoundingCircleRadius() * 2.0f;
+	if (spacing < 1.0f)
+		spacing = 1.0f;
+	Int side = REAL_TO_INT_CEIL(sqrtf((Real)numUnits));
+	Coord3D corner;
+	corner.x = (extent.lo.x + extent.hi.x) * 0.5f - side * spacing * 0.5f;
+	corner.y = (extent.lo.y + extent.hi.y) * 0.5f - side * spacing * 0.5f;
+	corner.z = 0.0f;
+
+	Team *team = ThePlayerList->getNeutralPlayer()->getDefaultTeam();
+	std::vector<Object *> units;
+	Int i;
+	for (i = 0; i < numUnits; ++i)
+	{
+		Object *obj = TheThingFactory->newObject(tmpl, team);
+		if (obj == NULL)
+			continue;
+
+		Coord3D pos;
+		pos.x = corner.x + (i % side) * spacing;
+		pos.y = corner.y + (i / side) * spacing;
+		pos.z = TheTerrainLogic->getGroundHeight(pos.x, pos.y);
+		obj->setPosition(&pos);
+
+		// tough enough to stand up to the whole barrage, so every shot has the same crowd to hit
+		BodyModuleInterface *body = obj->getBodyModule();
+		if (body)
+			body->setMaxHealth(1000000.0f, FULLY_HEAL);
+
+		units.push_back(obj);
+	}
+
+	// the guns, off in a corner of the map
+	Object *source = TheThingFactory->newObject(tmpl, team);
+	if (source == NULL || units.empty())
+	{
+		DEBUG_LOG(("WeaponStore::runBarrageBenchmark - couldn't create any %s\n", targetName.str()));
+		return;
+	}
+	Int numCreated = (Int)units.size();
+	Coord3D sourcePos = extent.lo;
+	sourcePos.z = TheTerrainLogic->getGroundHeight(sourcePos.x, sourcePos.y);
+	source->setPosition(&sourcePos);
+
+	// so that the partition knows where everyone is
+	ThePartitionManager->update();
+
+	WeaponBonus bonus;
+	__int64 startTime64, endTime64, freq64, updateTime64 = 0;
+	__int64 slowestTime64 = 0;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&freq64);
+
+	for (Int frame = 0; frame < numFrames; ++frame)
+	{
+		QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+		for (Int shot = 0; shot < numShots; ++shot)
+		{
+			// spread the volley over the crowd, the same way every run
+			const Coord3D *pos = units[(shot * 37 + frame * 11) % numCreated]->getPosition();
+			wt->dealDamageInternal(source->getID(), INVALID_ID, pos, bonus, TRUE);
+		}
+		QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+
+		updateTime64 += endTime64 - startTime64;
+		if (endTime64 - startTime64 > slowestTime64)
+			slowestTime64 = endTime64 - startTime64;
+	}
+
+	Real totalMs = (Real)((double)updateTime64 * 1000.0 / (double)freq64);
+	DEBUG_LOG(("WeaponStore::runBarrageBenchmark - %d frames of %d %s on %d %s, radius %.1f\n",
+		numFrames, numShots, weaponName.str(), numCreated, targetName.str(), max(wt->getPrimaryDamageRadius(bonus), wt->getSecondaryDamageRadius(bonus))));
+	DEBUG_LOG(("  volley: %.3f ms average, %.3f ms slowest, %.3f ms per shot\n",
+		totalMs / numFrames,
+		(Real)((double)slowestTime64 * 1000.0 / (double)freq64),
+		totalMs / (numFrames * numShots)));
+
+	for (i = 0; i < numCreated; ++i)
+		TheGameLogic->destroyObject(units[i]);
+	TheGameLogic->destroyObject(source);
+
+}  // end runBarrageBenchmark
+#endif
+
 //-------------------------------------------------------------------------------------------------
 void WeaponStore::deleteAllDelayedDamage()
 {
@@ -1593,12 +1593,25 @@ enum
 	LOAD_PROGRESS_LOOP_INITIAL_NETWORK_BUILDINGS = LOAD_PROGRESS_MAX_ALL_THE_FREAKN_OBJECTS + 1,  // Increment the next one by at least MAX_SLOTS
 	LOAD_PROGRESS_POST_INITIAL_NETWORK_BUILDINGS = LOAD_PROGRESS_LOOP_INITIAL_NETWORK_BUILDINGS + MAX_SLOTS + 1,
 
-	LOAD_PROGRESS_POST_PRELOAD_ASSETS = LOAD_PROGRESS_POST_INITIAL_NETWORK_BUILDINGS + 1,
+	LOAD_PROGRESS_LOOP_PRELOAD_ASSETS = LOAD_PROGRESS_POST_INITIAL_NETWORK_BUILDINGS + 1,  // the preload reports its own progress up to the next one
+	LOAD_PROGRESS_POST_PRELOAD_ASSETS = LOAD_PROGRESS_LOOP_PRELOAD_ASSETS + 4,
 	LOAD_PROGRESS_POST_STARTING_CAMERA = LOAD_PROGRESS_POST_PRELOAD_ASSETS + 1,
 	LOAD_PROGRESS_POST_STARTING_CAMERA_2 = LOAD_PROGRESS_POST_STARTING_CAMERA + 1,
 	LOAD_PROGRESS_END = 100,
 };
 
+// ------------------------------------------------------------------------------------------------
+/** Progress callback for the display's batched model preload */
+// ------------------------------------------------------------------------------------------------
+static void updatePreloadProgress( Int loaded, Int total )
+{
+	if( total <= 0 )
+		return;
+
+	Int range = LOAD_PROGRESS_POST_PRELOAD_ASSETS - LOAD_PROGRESS_LOOP_PRELOAD_ASSETS;
+	TheGameLogic->updateLoadProgress( LOAD_PROGRESS_LOOP_PRELOAD_ASSETS + (range * loaded) / total );
+}
+
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 static Waypoint * findNamedWaypoint(AsciiString name)
@@ -3430,6 +3443,8 @@ void GameLogic::startNewGame( Bool loadingSaveGame )
 	//
 	if( TheGlobalData->m_preloadAssets )
 	{
+		// the models are read in parallel and registered in order when the batch ends
+		TheDisplay->beginPreloadBatch();
 		if (TheGlobalData->m_preloadEverything)
 		{
 			for (Int td = TIME_OF_DAY_FIRST; td < TIME_OF_DAY_COUNT; ++td)
@@ -3439,6 +3454,7 @@ void GameLogic::startNewGame( Bool loadingSaveGame )
 		{
 			TheGameClient->preloadAssets( TheGlobalData->m_timeOfDay );
 		}
+		TheDisplay->endPreloadBatch( updatePreloadProgress );
 	}
 
 	//put this here somewhat randomly.
@@ -89,6 +89,7 @@ void Connection::init() {
 	m_lastTimeSent = 0;
 	m_frameGrouping = 1;
 	m_numRetries = 0;
+	m_totalRetries = 0;
 	m_retryMetricsTime = 0;
 
 	for (Int i = 0; i < CONNECTION_LATENCY_HISTORY_LENGTH; ++i) {
@@ -251,7 +252,7 @@ Bool Connection::isQueueEmpty() {
 void Connection::setQuitting( void )
 {
 	m_isQuitting = TRUE;
-	m_quitTime = timeGetTime();
+	m_quitTime = m_transport->getTime();
 	DEBUG_LOG(("Connection::setQuitting() at time %d\n", m_quitTime));
 }
 
@@ -261,7 +262,7 @@ void Connection::setQuitting( void )
  */
 UnsignedInt Connection::doSend() {
 	Int numpackets = 0;
-	time_t curtime = timeGetTime();
+	time_t curtime = m_transport->getTime();
 	Bool couldQueue = TRUE;
 
 	// Do this check first, since it's an important fail-safe
@@ -300,6 +301,7 @@ UnsignedInt Connection::doSend() {
 					if (CommandRequiresAck(msg->getCommand())) {
 						if (timeLastSent != -1) {
 							++m_numRetries;
+							++m_totalRetries;
 						}
 						doRetryMetrics();
 						msg->setTimeLastSent(curtime);
@@ -380,7 +382,7 @@ NetCommandRef * Connection::processAck(UnsignedShort commandID, UnsignedByte ori
 
 	Int index = temp->getCommand()->getID() % CONNECTION_LATENCY_HISTORY_LENGTH;
 	m_averageLatency -= ((Real)(m_latencies[index])) / CONNECTION_LATENCY_HISTORY_LENGTH;
-	Real lat = timeGetTime() - temp->getTimeLastSent();
+	Real lat = m_transport->getTime() - temp->getTimeLastSent();
 	m_averageLatency += lat / CONNECTION_LATENCY_HISTORY_LENGTH;
 	m_latencies[index] = lat;
 
@@ -400,7 +402,7 @@ void Connection::setFrameGrouping(time_t frameGrouping) {
 
 void Connection::doRetryMetrics() {
 	static Int numSeconds = 0;
-	time_t curTime = timeGetTime();
+	time_t curTime = m_transport->getTime();
 
 	if ((curTime - m_retryMetricsTime) > 10000) {
 		m_retryMetricsTime = curTime;
@@ -155,6 +155,9 @@ void ConnectionManager::init()
 		m_connections[i] = NULL;
 	}
 
+	// Don't use the compact packet fields until we know everyone in the game understands them.
+	NetPacket::SetCompactEncoding(FALSE);
+
 	if (m_pendingCommands == NULL) {
 		m_pendingCommands = newInstance(NetCommandList);
 		m_pendingCommands->init();
@@ -192,6 +195,7 @@ void ConnectionManager::init()
 	for (i = 0; i < MAX_SLOTS; ++i) {
 		m_latencyAverages[i] = 0.0; // using zero since all floating point standards should be able to specify 0.0 accurately.
 	}
+	m_runAheadController.reset();
 	m_smallestPacketArrivalCushion = -1;
 
 	m_frameMetrics.init();
@@ -274,6 +278,10 @@ void ConnectionManager::reset()
 	for (i = 0; i < TheGlobalData->m_networkLatencyHistoryLength; ++i) {
 		m_latencyAverages[i] = 0.0;
 	}
+	if (m_runAheadController.getNumDecisions() > 0) {
+		m_runAheadController.logTelemetry();
+	}
+	m_runAheadController.reset();
 
 	for (i = 0; i < MAX_SLOTS; ++i) {
 		m_packetRouterFallback[i] = -1;
@@ -618,6 +626,8 @@ void ConnectionManager::processRunAheadMetrics(NetRunAheadMetricsCommandMsg *msg
 			// 300, that was deemed "ugly" by the powers that be.
 			m_fpsAverages[player] = 100;
 		}
+		m_runAheadController.addLatencySample(player, m_latencyAverages[player]);
+		m_runAheadController.addFpsSample(player, m_fpsAverages[player]);
 	}
 }
 
@@ -1210,6 +1220,22 @@ void ConnectionManager::update(Bool isInGame) {
 	m_transport->doSend();
 }
 
+/**
+ * The run ahead needed to hide the given round trip latency (in seconds) at the given frame rate.
+ */
+Int ConnectionManager::ComputeRunAhead(Real maxLatency, Int minFps) {
+	Int newRunAhead = (Int)((maxLatency / 2.0) * (Real)minFps);
+	newRunAhead += (newRunAhead * TheGlobalData->m_networkRunAheadSlack) / 100; // Add in 10% of slack to the run ahead in case of network hiccups.
+	if (newRunAhead < MIN_RUNAHEAD) {
+		newRunAhead = MIN_RUNAHEAD; // make sure its at least MIN_RUNAHEAD.
+	}
+
+	if (newRunAhead > (MAX_FRAMES_AHEAD / 2)) {
+		newRunAhead = MAX_FRAMES_AHEAD / 2; // dont let run ahead get out of hand.
+	}
+	return newRunAhead;
+}
+
 void ConnectionManager::updateRunAhead(Int oldRunAhead, Int frameRate, Bool didSelfSlug, Int nextExecutionFrame) {
 	static time_t lasttimesent = 0;
 	time_t curTime = timeGetTime();
@@ -1231,30 +1257,30 @@ void ConnectionManager::updateRunAhead(Int oldRunAhead, Int frameRate, Bool didS
 			} else {
 				//DEBUG_LOG(("ConnectionManager::updateRunAhead - local player run ahead metrics, fps = %d, latency = %f, didSelfSlug = false\n", m_fpsAverages[m_localSlot], m_latencyAverages[m_localSlot]));
 			}
-			Int minFps;
-			Int minFpsPlayer;
-			getMinimumFps(minFps, minFpsPlayer);
-			DEBUG_LOG(("ConnectionManager::updateRunAhead - max latency = %f, min fps = %d, min fps player = %d old FPS = %d\n", getMaximumLatency(), minFps, minFpsPlayer, frameRate));
-			if ((minFps >= ((frameRate * 9) / 10)) && (minFps < frameRate)) {
-				// if the minimum fps is within 10% of the desired framerate, then keep the current minimum fps.
-				minFps = frameRate;
-			}
-			if (minFps < 5) {
-				minFps = 5; // Absolutely do not run below 5 fps.
-			}
-			if (minFps > TheGlobalData->m_framesPerSecondLimit) {
-				minFps = TheGlobalData->m_framesPerSecondLimit; // Cap to 30 FPS.
+			m_runAheadController.addLatencySample(m_localSlot, m_latencyAverages[m_localSlot]);
+			m_runAheadController.addFpsSample(m_localSlot, m_fpsAverages[m_localSlot]);
+
+			// If we just became the packet router, carry on from whatever the last one decided.
+			if (!m_runAheadController.hasCurrent()) {
+				m_runAheadController.setCurrent(oldRunAhead, frameRate);
 			}
-			DEBUG_LOG(("ConnectionManager::updateRunAhead - minFps after adjustment is %d\n", minFps));
-			Int newRunAhead = (Int)((getMaximumLatency() / 2.0) * (Real)minFps);
-			newRunAhead += (newRunAhead * TheGlobalData->m_networkRunAheadSlack) / 100; // Add in 10% of slack to the run ahead in case of network hiccups.
-			if (newRunAhead < MIN_RUNAHEAD) {
-				newRunAhead = MIN_RUNAHEAD; // make sure its at least MIN_RUNAHEAD.
+
+			UnsignedInt playerMask = 0;
+			for (Int i = 0; i < MAX_SLOTS; ++i) {
+				if (isPlayerConnected(i)) {
+					playerMask |= 1 << i;
+				}
 			}
 
-			if (newRunAhead > (MAX_FRAMES_AHEAD / 2)) {
-				newRunAhead = MAX_FRAMES_AHEAD / 2; // dont let run ahead get out of hand.
+			// Only tell everyone when something actually changed; they keep the last run ahead they were sent.
+			if (!m_runAheadController.update(curTime, playerMask)) {
+				lasttimesent = curTime;
+				return;
 			}
+			Int minFps = m_runAheadController.getFrameRate();
+			Int minFpsPlayer = m_runAheadController.getMinFpsPlayer();
+			Int newRunAhead = m_runAheadController.getRunAhead();
+			DEBUG_LOG(("ConnectionManager::updateRunAhead - run ahead %d, frame rate %d, min fps player %d, old frame rate %d\n", newRunAhead, minFps, minFpsPlayer, frameRate));
 
 			NetRunAheadCommandMsg *msg = newInstance(NetRunAheadCommandMsg);
 			msg->setPlayerID(m_localSlot);
@@ -1353,43 +1379,8 @@ void ConnectionManager::updateRunAhead(Int oldRunAhead, Int frameRate, Bool didS
 	}
 }
 
-Real ConnectionManager::getMaximumLatency() {
-	// This works for 2 player games because the latency for the packet router is always 0.
-	Real lat1 = 0.0;
-	Real lat2 = 0.0;
-
-	for (Int i = 0; i < MAX_SLOTS; ++i) {
-		if (isPlayerConnected(i)) {
-			if (m_latencyAverages[i] != 0.0) {
-				if (m_latencyAverages[i] > lat1) {
-					lat2 = lat1;
-					lat1 = m_latencyAverages[i];
-				} else if (m_latencyAverages[i] > lat2) {
-					lat2 = m_latencyAverages[i];
-				}
-			}
-		}
-	}
-
-	return (lat1 + lat2);
-}
-
-void ConnectionManager::getMinimumFps(Int &minFps, Int &minFpsPlayer) {
-	minFps = -1;
-	minFpsPlayer = -1;
-//	DEBUG_LOG(("ConnectionManager::getMinimumFps -"));
-	for (Int i = 0; i < MAX_SLOTS; ++i) {
-		if ((m_connections[i] != NULL) || (i == m_localSlot)) {
-//			DEBUG_LOG((" %d: %d,", i, m_fpsAverages[i]));
-			if (m_fpsAverages[i] != -1) {
-				if ((minFps == -1) || (m_fpsAverages[i] < minFps)) {
-					minFps = m_fpsAverages[i];
-					minFpsPlayer = i;
-				}
-			}
-		}
-	}
-//	DEBUG_LOG(("\n"));
+const RunAheadController *ConnectionManager::getRunAheadController() const {
+	return &m_runAheadController;
 }
 
 UnsignedInt ConnectionManager::getMinimumCushion() {
@@ -1735,6 +1726,7 @@ PlayerLeaveCode ConnectionManager::disconnectPlayer(Int slot) {
 		m_connections[slot]->deleteInstance();
 		m_connections[slot] = NULL;
 	}
+	m_runAheadController.removePlayer(slot);
 
 //	if (playerID == m_localSlot) {
 //		TheMessageStream->appendMessage(GameMessage::MSG_CLEAR_GAME_DATA);
@@ -1861,6 +1853,9 @@ void ConnectionManager::parseUserList(const GameInfo *game)
 	Int numUsers = 0;
 	m_localSlot = -1;
 	DEBUG_LOG(("Local slot is %d\n", game->getLocalSlotNum()));
+
+	// Everyone accepted the host's options, so everyone speaks the host's protocol version.
+	NetPacket::SetCompactEncoding(game->getNetProtocolVersion() >= NETWORK_PROTOCOL_VERSION_COMPACT);
 	for (i=0; i<MAX_SLOTS; ++i)
 	{
 		const GameSlot *slot = game->getConstSlot(i);	// badness, but since we cast right back to const, we should be ok
@@ -1882,6 +1877,11 @@ void ConnectionManager::parseUserList(const GameInfo *game)
 				m_connections[i]->setUser(newInstance(User)(slot->getName(), slot->getIP(), port));
 				m_frameData[i] = newInstance(FrameDataManager)(FALSE);
 				DEBUG_LOG(("Remote user is at %X:%d\n", slot->getIP(), slot->getPort()));
+				// the host allows it and so do we; the transport still waits for the peer to offer too.
+				if (m_transport != NULL && game->getNetPacketPacking() && TheGlobalData->m_networkPacketPacking)
+				{
+					m_transport->setPeerPacking(slot->getIP(), port, TRUE);
+				}
 			}
 			else
 			{
@@ -2027,6 +2027,17 @@ Real ConnectionManager::getOutgoingBytesPerSecond( void )
 	  return 0.0;
 }
 
+/**
+ * Return the number of bytes per second we would be sending if the transport didn't pack packets.
+ */
+Real ConnectionManager::getOutgoingPayloadBytesPerSecond( void )
+{
+	if (m_transport)
+		return m_transport->getOutgoingPayloadBytesPerSecond();
+	else
+	  return 0.0;
+}
+
 /**
  * Return the number of outgoing packets per second averaged over the last 30 sec.
  */
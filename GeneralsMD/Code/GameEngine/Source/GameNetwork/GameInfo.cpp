@@ -312,6 +312,8 @@ void GameInfo::reset( void )
 	m_useStats = TRUE;
 	m_surrendered = FALSE;
   m_oldFactionsOnly = FALSE;
+	m_netPacketPacking = TheGlobalData->m_networkPacketPacking;
+	m_netProtocolVersion = NETWORK_PROTOCOL_VERSION;
 	// Added By Sadullah Nader
 	// Initializations missing and needed
 //	m_localIP = 0; // BGC - actually we don't want this to be reset since the m_localIP is 
@@ -930,6 +932,17 @@ AsciiString GameInfoToAsciiString( const GameInfo *game )
 		game->getMapCRC(), game->getMapSize(), game->getSeed(), game->getCRCInterval(), game->getSuperweaponRestriction(),
 		game->getStartingCash().countMoney(), game->oldFactionsOnly() ? 'Y' : 'N' );
 
+	// Packing is optional; hosts that don't know about it just leave it out.
+	if (game->getNetPacketPacking())
+	{
+		optionsString.concat("NP=1;");
+	}
+
+	// Older hosts don't send a protocol version, which tells the clients to stick to version 1.
+	AsciiString versionString;
+	versionString.format("NV=%d;", game->getNetProtocolVersion());
+	optionsString.concat(versionString);
+
 	//add player info for each slot
 	optionsString.concat(slotListID);
 	optionsString.concat('=');
@@ -1018,6 +1031,8 @@ Bool ParseAsciiStringToGameInfo(GameInfo *game, AsciiString options)
 	Int crc = 100;
 	Bool sawCRC = FALSE;
   Bool oldFactionsOnly = FALSE;
+	Bool netPacketPacking = FALSE;
+	Int netProtocolVersion = 1;
 	Int useStats = TRUE;
   Money startingCash = TheGlobalData->m_defaultStartingCash;
   UnsignedShort restriction = 0; // Always the default
@@ -1123,6 +1138,19 @@ Bool ParseAsciiStringToGameInfo(GameInfo *game, AsciiString options)
       oldFactionsOnly = ( val.compareNoCase( "Y" ) == 0 );
       sawOldFactions = TRUE;
     }
+		else if (key.compare("NP") == 0)
+		{
+			netPacketPacking = (atoi(val.str()) != 0);
+		}
+		else if (key.compare("NV") == 0)
+		{
+			netProtocolVersion = atoi(val.str());
+			if (netProtocolVersion != NETWORK_PROTOCOL_VERSION)
+			{
+				DEBUG_LOG(("ParseAsciiStringToGameInfo - host uses protocol version %d, we use %d\n", netProtocolVersion, NETWORK_PROTOCOL_VERSION));
+				optionsOk = false;
+			}
+		}
 		else if (key.getLength() == 1 && *key.str() == slotListID)
 		{
 			sawSlotlist = true;
@@ -1485,6 +1513,8 @@ Bool ParseAsciiStringToGameInfo(GameInfo *game, AsciiString options)
     game->setSuperweaponRestriction(restriction);
     game->setStartingCash( startingCash );
     game->setOldFactionsOnly( oldFactionsOnly );
+		game->setNetPacketPacking( netPacketPacking );
+		game->setNetProtocolVersion( netProtocolVersion );
 
 		return true;
 	}
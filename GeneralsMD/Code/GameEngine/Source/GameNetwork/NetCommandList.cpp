@@ -28,6 +28,27 @@
 #include "GameNetwork/NetCommandList.h"
 #include "GameNetwork/NetworkUtil.h"
 
+/**
+ * Constructor.
+ */
+NetCommandListIndex::NetCommandListIndex() {
+	Int i;
+	for (i = 0; i < HASH_SIZE; ++i) {
+		m_buckets[i] = NULL;
+	}
+	for (i = 0; i < NETCOMMANDTYPE_MAX; ++i) {
+		for (Int j = 0; j < MAX_SLOTS; ++j) {
+			m_sectionLast[i][j] = NULL;
+		}
+	}
+}
+
+/**
+ * Destructor.
+ */
+NetCommandListIndex::~NetCommandListIndex() {
+}
+
 /**
  * Constructor.
  */
@@ -35,6 +56,8 @@ NetCommandList::NetCommandList() {
 	m_first = NULL;
 	m_last = NULL;
 	m_lastMessageInserted = NULL;
+	m_count = 0;
+	m_index = NULL;
 }
 
 /**
@@ -77,6 +100,11 @@ NetCommandRef *NetCommandList::getFirstMessage() {
  * Remove the given message from this list.
  */
 void NetCommandList::removeMessage(NetCommandRef *msg) {
+	if (m_index != NULL) {
+		removeFromIndex(msg);
+	}
+	--m_count;
+
 	if (m_lastMessageInserted == msg) {
 		m_lastMessageInserted = msg->getNext();
 	}
@@ -115,11 +143,18 @@ void NetCommandList::reset() {
 		temp = m_first->getNext();
 		m_first->setNext(NULL);
 		m_first->setPrev(NULL);
+		m_first->setHashNext(NULL);
 		m_first->deleteInstance();
 		m_first = temp;
 	}
 	m_last = NULL;
 	m_lastMessageInserted = NULL;
+	m_count = 0;
+
+	if (m_index != NULL) {
+		m_index->deleteInstance();
+		m_index = NULL;
+	}
 }
 
 /**
@@ -134,8 +169,33 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 
 //	UnsignedInt id = cmdMsg->getID();
 
+	// Make sure this command isn't already in the list.  It's a duplicate if it's equal to any
+	// command on the list, wherever that sits, however long the list is.
+	if (findMessage(cmdMsg) != NULL) {
+		return NULL;
+	}
+
 	NetCommandRef *msg = NEW_NETCOMMANDREF(cmdMsg);
 
+	if (m_index != NULL) {
+		msg = addIndexedMessage(msg);
+	} else {
+		msg = addUnindexedMessage(msg);
+	}
+
+	if (msg != NULL) {
+		++m_count;
+		if ((m_index == NULL) && (m_count >= INDEX_THRESHOLD)) {
+			buildIndex();
+		}
+	}
+	return msg;
+}
+
+/**
+ * Insert sorts msg by walking the list, for lists short enough that the walk is cheap.
+ */
+NetCommandRef * NetCommandList::addUnindexedMessage(NetCommandRef *msg) {
 	if (m_first == NULL) {
 		// this is the first node, so we don't have to worry about ordering it.
 		m_first = msg;
@@ -156,15 +216,6 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 			 (theNext->getCommand()->getPlayerID() > msg->getCommand()->getPlayerID()) ||
 			 (theNext->getCommand()->getID() > msg->getCommand()->getID())))) {
 
-			// Make sure this command isn't already in the list.
-			if (isEqualCommandMsg(m_lastMessageInserted->getCommand(), msg->getCommand())) {
-
-				// This command is already in the list, don't duplicate it.
-				msg->deleteInstance();
-				msg = NULL;
-				return NULL;
-			}
-
 			if (theNext == NULL) {
 				// this means that m_lastMessageInserted == m_last, so m_last should point to the msg that is being inserted.
 				msg->setNext(m_lastMessageInserted->getNext());
@@ -187,15 +238,6 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 		// easy optimization for a command that goes at the end of the list
 		// since they are likely to be added in order.
 
-		// Make sure this command isn't already in the list.
-		if (isEqualCommandMsg(m_last->getCommand(), msg->getCommand())) {
-
-			// This command is already in the list, don't duplicate it.
-			msg->deleteInstance();
-			msg = NULL;
-			return NULL;
-		}
-
 		msg->setPrev(m_last);
 		msg->setNext(NULL);
 		m_last->setNext(msg);
@@ -205,15 +247,6 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 	}
 	
 	if (msg->getCommand()->getNetCommandType() < m_first->getCommand()->getNetCommandType()) {
-		// Make sure this command isn't already in the list.
-		if (isEqualCommandMsg(m_first->getCommand(), msg->getCommand())) {
-
-			// This command is already in the list, don't duplicate it.
-			msg->deleteInstance();
-			msg = NULL;
-			return NULL;
-		}
-
 		// The command goes at the head of the list.
 		msg->setNext(m_first);
 		msg->setPrev(NULL);
@@ -231,15 +264,6 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 	}
 
 	if (tempmsg == NULL) {
-		// Make sure this command isn't already in the list.
-		if (isEqualCommandMsg(m_last->getCommand(), msg->getCommand())) {
-
-			// This command is already in the list, don't duplicate it.
-			msg->deleteInstance();
-			msg = NULL;
-			return NULL;
-		}
-
 		// message goes at the end of the list.
 		msg->setPrev(m_last);
 		msg->setNext(NULL);
@@ -255,15 +279,6 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 	}
 
 	if (tempmsg == NULL) {
-		// Make sure this command isn't already in the list.
-		if (isEqualCommandMsg(m_last->getCommand(), msg->getCommand())) {
-
-			// This command is already in the list, don't duplicate it.
-			msg->deleteInstance();
-			msg = NULL;
-			return NULL;
-		}
-
 		// message goes at the end of the list.
 		msg->setPrev(m_last);
 		msg->setNext(NULL);
@@ -280,15 +295,6 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 	}
 
 	if (tempmsg == NULL) {
-		// Make sure this command isn't already in the list.
-		if (isEqualCommandMsg(m_last->getCommand(), msg->getCommand())) {
-
-			// This command is already in the list, don't duplicate it.
-			msg->deleteInstance();
-			msg = NULL;
-			return NULL;
-		}
-
 		// This message goes at the end of the list.
 		msg->setPrev(m_last);
 		msg->setNext(NULL);
@@ -299,14 +305,6 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 	}
 
 	if (tempmsg == m_first) {
-		// Make sure this command isn't already in the list.
-		if (isEqualCommandMsg(m_first->getCommand(), msg->getCommand())) {
-
-			// This command is already in the list, don't duplicate it.
-			msg->deleteInstance();
-			return NULL;
-		}
-
 		// This message goes at the head of the list.
 		msg->setNext(m_first);
 		msg->setPrev(NULL);
@@ -316,15 +314,6 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 		return msg;
 	}
 
-	// Make sure this command isn't already in the list.
-		if (isEqualCommandMsg(tempmsg->getCommand(), msg->getCommand())) {
-
-		// This command is already in the list, don't duplicate it.
-		msg->deleteInstance();
-		msg = NULL;
-		return NULL;
-	}
-
 	// Insert message before tempmsg.
 	msg->setNext(tempmsg);
 	msg->setPrev(tempmsg->getPrev());
@@ -335,21 +324,200 @@ NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
 	return msg;
 }
 
-Int NetCommandList::length() {
-	Int retval = 0;
-	NetCommandRef *temp = m_first;
-	while (temp != NULL) {
-		++retval;
-		temp = temp->getNext();
+/**
+ * Insert sorts msg using the index.  The new command goes at the end of the commands of its type
+ * from its player, which is nearly always where it belongs, so the only walking is backwards over
+ * the odd command in that section that came in out of order.
+ */
+NetCommandRef * NetCommandList::addIndexedMessage(NetCommandRef *msg) {
+	NetCommandMsg *cmdMsg = msg->getCommand();
+
+	Int type = cmdMsg->getNetCommandType();
+	Int player = cmdMsg->getPlayerID();
+	if ((type < 0) || (type >= NETCOMMANDTYPE_MAX) || (player >= MAX_SLOTS)) {
+		DEBUG_CRASH(("NetCommandList::addIndexedMessage - command type %d from player %d doesn't fit in the index", type, player));
+		msg = addUnindexedMessage(msg);
+		if (msg != NULL) {
+			addToIndex(msg);
+		}
+		return msg;
+	}
+
+	NetCommandRef *after = m_index->m_sectionLast[type][player];
+	if (after != NULL) {
+		Int sortNumber = cmdMsg->getSortNumber();
+		while ((after != NULL) &&
+					 (after->getCommand()->getNetCommandType() == type) &&
+					 (after->getCommand()->getPlayerID() == player) &&
+					 (after->getCommand()->getSortNumber() >= sortNumber)) {
+			after = after->getPrev();
+		}
+	} else {
+		// First command of its type from this player, it goes after the last command of whichever section comes before it.
+		for (Int section = type * MAX_SLOTS + player - 1; section >= 0; --section) {
+			after = m_index->m_sectionLast[section / MAX_SLOTS][section % MAX_SLOTS];
+			if (after != NULL) {
+				break;
+			}
+		}
+	}
+
+	insertAfter(msg, after);
+	addToIndex(msg);
+	m_lastMessageInserted = msg;
+	return msg;
+}
+
+/**
+ * Link msg into the list right after the given message, or at the head of the list if after is NULL.
+ */
+void NetCommandList::insertAfter(NetCommandRef *msg, NetCommandRef *after) {
+	NetCommandRef *next = (after != NULL) ? after->getNext() : m_first;
+	msg->setPrev(after);
+	msg->setNext(next);
+	if (after != NULL) {
+		after->setNext(msg);
+	} else {
+		m_first = msg;
+	}
+	if (next != NULL) {
+		next->setPrev(msg);
+	} else {
+		m_last = msg;
+	}
+}
+
+/**
+ * Build the index for everything already on the list.
+ */
+void NetCommandList::buildIndex() {
+	DEBUG_ASSERTCRASH(m_index == NULL, ("NetCommandList::buildIndex - list already has an index"));
+	m_index = newInstance(NetCommandListIndex);
+	NetCommandRef *msg = m_first;
+	while (msg != NULL) {
+		addToIndex(msg);
+		msg = msg->getNext();
+	}
+}
+
+/**
+ * Put msg, which is already linked into the list, into the index.
+ */
+void NetCommandList::addToIndex(NetCommandRef *msg) {
+	NetCommandMsg *cmdMsg = msg->getCommand();
+	Int bucket = getHashBucket(cmdMsg);
+	if (bucket != -1) {
+		msg->setHashNext(m_index->m_buckets[bucket]);
+		m_index->m_buckets[bucket] = msg;
+	}
+
+	Int type = cmdMsg->getNetCommandType();
+	Int player = cmdMsg->getPlayerID();
+	if ((type < 0) || (type >= NETCOMMANDTYPE_MAX) || (player >= MAX_SLOTS)) {
+		return;
+	}
+
+	NetCommandRef *next = msg->getNext();
+	if ((next == NULL) || (next->getCommand()->getNetCommandType() != type) || (next->getCommand()->getPlayerID() != player)) {
+		m_index->m_sectionLast[type][player] = msg;
+	}
+}
+
+/**
+ * Take msg out of the index.  This has to happen before msg is unlinked from the list.
+ */
+void NetCommandList::removeFromIndex(NetCommandRef *msg) {
+	NetCommandMsg *cmdMsg = msg->getCommand();
+	Int bucket = getHashBucket(cmdMsg);
+	if (bucket != -1) {
+		NetCommandRef *prev = NULL;
+		NetCommandRef *temp = m_index->m_buckets[bucket];
+		while ((temp != NULL) && (temp != msg)) {
+			prev = temp;
+			temp = temp->getHashNext();
+		}
+		if (temp != NULL) {
+			if (prev != NULL) {
+				prev->setHashNext(msg->getHashNext());
+			} else {
+				m_index->m_buckets[bucket] = msg->getHashNext();
+			}
+		}
+		msg->setHashNext(NULL);
+	}
+
+	Int type = cmdMsg->getNetCommandType();
+	Int player = cmdMsg->getPlayerID();
+	if ((type < 0) || (type >= NETCOMMANDTYPE_MAX) || (player >= MAX_SLOTS)) {
+		return;
+	}
+
+	if (m_index->m_sectionLast[type][player] == msg) {
+		NetCommandRef *prev = msg->getPrev();
+		if ((prev != NULL) && (prev->getCommand()->getNetCommandType() == type) && (prev->getCommand()->getPlayerID() == player)) {
+			m_index->m_sectionLast[type][player] = prev;
+		} else {
+			m_index->m_sectionLast[type][player] = NULL;
+		}
 	}
-	return retval;
 }
 
 /**
- * This is really inefficient, but we can probably get away with it because
- * there shouldn't be too many messages for any given frame.
+ * Commands that isEqualCommandMsg can match to each other always land in the same bucket.  Commands
+ * that need a command ID are the same command if they have the same player and ID, whatever their type,
+ * and acks are the same ack if they are of the same type from the same player and ack the same command.
+ */
+Int NetCommandList::getHashBucket(NetCommandMsg *msg) {
+	NetCommandType type = msg->getNetCommandType();
+	if (DoesCommandRequireACommandID(type)) {
+		return getHashBucket(msg->getID(), msg->getPlayerID());
+	}
+
+	UnsignedShort commandID;
+	UnsignedByte originalPlayerID;
+	if (type == NETCOMMANDTYPE_ACKBOTH) {
+		commandID = ((NetAckBothCommandMsg *)msg)->getCommandID();
+		originalPlayerID = ((NetAckBothCommandMsg *)msg)->getOriginalPlayerID();
+	} else if (type == NETCOMMANDTYPE_ACKSTAGE1) {
+		commandID = ((NetAckStage1CommandMsg *)msg)->getCommandID();
+		originalPlayerID = ((NetAckStage1CommandMsg *)msg)->getOriginalPlayerID();
+	} else if (type == NETCOMMANDTYPE_ACKSTAGE2) {
+		commandID = ((NetAckStage2CommandMsg *)msg)->getCommandID();
+		originalPlayerID = ((NetAckStage2CommandMsg *)msg)->getOriginalPlayerID();
+	} else {
+		return -1;
+	}
+
+	return (commandID + originalPlayerID * 17 + msg->getPlayerID() * 5 + type * 3) & (NetCommandListIndex::HASH_SIZE - 1);
+}
+
+Int NetCommandList::getHashBucket(UnsignedShort commandID, UnsignedByte playerID) {
+	return (commandID + playerID * 17) & (NetCommandListIndex::HASH_SIZE - 1);
+}
+
+/**
+ * Returns the number of commands on the list.
+ */
+Int NetCommandList::length() {
+	return m_count;
+}
+
+/**
+ * Without an index this is a walk of the list, but lists without an index are short.
  */
 NetCommandRef * NetCommandList::findMessage(NetCommandMsg *msg) {
+	if (m_index != NULL) {
+		Int bucket = getHashBucket(msg);
+		if (bucket == -1) {
+			return NULL; // isEqualCommandMsg never matches these.
+		}
+		NetCommandRef *temp = m_index->m_buckets[bucket];
+		while ((temp != NULL) && (isEqualCommandMsg(temp->getCommand(), msg) == FALSE)) {
+			temp = temp->getHashNext();
+		}
+		return temp;
+	}
+
 	NetCommandRef *retval = m_first;
 	while ((retval != NULL) && (isEqualCommandMsg(retval->getCommand(), msg) == FALSE)) {
 		retval = retval->getNext();
@@ -358,6 +526,18 @@ NetCommandRef * NetCommandList::findMessage(NetCommandMsg *msg) {
 }
 
 NetCommandRef * NetCommandList::findMessage(UnsignedShort commandID, UnsignedByte playerID) {
+	if (m_index != NULL) {
+		NetCommandRef *temp = m_index->m_buckets[getHashBucket(commandID, playerID)];
+		while (temp != NULL) {
+			NetCommandMsg *cmdMsg = temp->getCommand();
+			if (DoesCommandRequireACommandID(cmdMsg->getNetCommandType()) && (cmdMsg->getID() == commandID) && (cmdMsg->getPlayerID() == playerID)) {
+				return temp;
+			}
+			temp = temp->getHashNext();
+		}
+		return NULL;
+	}
+
 	NetCommandRef *retval = m_first;
 	while (retval != NULL) {
 		if (DoesCommandRequireACommandID(retval->getCommand()->getNetCommandType())) {
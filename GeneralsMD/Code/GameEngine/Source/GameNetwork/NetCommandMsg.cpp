@@ -175,7 +175,11 @@ GameMessage *NetGameCommandMsg::constructGameMessage()
 
 	AsciiString name;
 	name.format("player%d", getPlayerID());
-	retval->friend_setPlayerIndex( ThePlayerList->findPlayerWithNameKey(TheNameKeyGenerator->nameToKey(name))->getPlayerIndex());
+	// Outside of a game (the network soak, say) there are no slot players, so keep the local one.
+	Player *player = ThePlayerList->findPlayerWithNameKey(TheNameKeyGenerator->nameToKey(name));
+	if (player != NULL) {
+		retval->friend_setPlayerIndex(player->getPlayerIndex());
+	}
 //	retval->friend_setPlayerIndex(indexFromMask(ThePlayerList->findPlayerWithNameKey(TheNameKeyGenerator->nameToKey(name))->getPlayerMask()));
 
 	GameMessageArgument *arg = m_argList;
@@ -43,6 +43,7 @@ NetCommandRef::NetCommandRef(NetCommandMsg *msg)
 	m_msg = msg;
 	m_next = NULL;
 	m_prev = NULL;
+	m_hashNext = NULL;
 	m_msg->attach();
 	m_timeLastSent = -1;
 
@@ -63,6 +64,7 @@ NetCommandRef::~NetCommandRef()
 	}
  	DEBUG_ASSERTCRASH(m_next == NULL, ("NetCommandRef::~NetCommandRef - m_next != NULL"));
 	DEBUG_ASSERTCRASH(m_prev == NULL, ("NetCommandRef::~NetCommandRef - m_prev != NULL"));
+	DEBUG_ASSERTCRASH(m_hashNext == NULL, ("NetCommandRef::~NetCommandRef - m_hashNext != NULL"));
 
 #ifdef DEBUG_NETCOMMANDREF
 	DEBUG_LOG(("NetCommandRef %d deleted\n", m_id));
@@ -0,0 +1,197 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// NetCompression.cpp /////////////////////////////////////////////////////////
+// LZSS coder used by the transport layer for packed packets.
+//
+// Stream format: a flag byte precedes every group of up to 8 tokens, LSB first.
+// A clear bit is a literal byte, a set bit is a two byte match reference of
+// the form (offset-1):12 | (length-NET_LZ_MIN_MATCH):4, high byte first.
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+
+#include "GameNetwork/NetCompression.h"
+
+enum
+{
+	NET_LZ_MIN_MATCH = 3,
+	NET_LZ_MAX_MATCH = NET_LZ_MIN_MATCH + 15,
+	NET_LZ_MAX_OFFSET = 4096,
+	NET_LZ_MAX_INPUT = 1024,
+	NET_LZ_HASH_SIZE = 1024,
+	NET_LZ_MAX_CHAIN = 32
+};
+
+// The transport only ever runs on the main thread, so the scratch space is shared.
+static UnsignedByte s_window[NET_LZ_MAX_INPUT];
+static Int s_hashHead[NET_LZ_HASH_SIZE];
+static Int s_hashPrev[NET_LZ_MAX_INPUT];
+
+//-------------------------------------------------------------------------------------------------
+static inline Int hashBytes( const UnsignedByte *p )
+{
+	return ((p[0] << 6) ^ (p[1] << 3) ^ p[2]) & (NET_LZ_HASH_SIZE - 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+static inline void insertPosition( Int pos, Int total )
+{
+	if (pos + NET_LZ_MIN_MATCH > total)
+		return;
+
+	Int h = hashBytes(s_window + pos);
+	s_hashPrev[pos] = s_hashHead[h];
+	s_hashHead[h] = pos;
+}
+
+//-------------------------------------------------------------------------------------------------
+Int NetCompression::compress( const UnsignedByte *src, Int srcLen, UnsignedByte *dest, Int destLen )
+{
+	if (src == NULL || dest == NULL || srcLen <= 0 || srcLen > NET_LZ_MAX_INPUT)
+		return 0;
+
+	memcpy(s_window, src, srcLen);
+	Int total = srcLen;
+
+	Int i;
+	for (i = 0; i < NET_LZ_HASH_SIZE; ++i)
+		s_hashHead[i] = -1;
+
+	Int out = 0;
+	Int flagPos = 0;
+	Int flagBit = 8;
+	Int pos = 0;
+	while (pos < total)
+	{
+		if (flagBit == 8)
+		{
+			if (out >= destLen)
+				return 0;
+			flagPos = out++;
+			dest[flagPos] = 0;
+			flagBit = 0;
+		}
+
+		// find the longest match we can in the hash chain for this position.
+		Int bestLen = 0;
+		Int bestOffset = 0;
+		if (pos + NET_LZ_MIN_MATCH <= total)
+		{
+			Int maxLen = min((Int)NET_LZ_MAX_MATCH, total - pos);
+			Int candidate = s_hashHead[hashBytes(s_window + pos)];
+			Int chain = 0;
+			while (candidate >= 0 && chain < NET_LZ_MAX_CHAIN)
+			{
+				Int offset = pos - candidate;
+				if (offset > NET_LZ_MAX_OFFSET)
+					break;
+
+				Int len = 0;
+				while (len < maxLen && s_window[candidate + len] == s_window[pos + len])
+					++len;
+
+				if (len > bestLen)
+				{
+					bestLen = len;
+					bestOffset = offset;
+					if (len == maxLen)
+						break;
+				}
+				candidate = s_hashPrev[candidate];
+				++chain;
+			}
+		}
+
+		if (bestLen >= NET_LZ_MIN_MATCH)
+		{
+			if (out + 2 > destLen)
+				return 0;
+			UnsignedShort code = (UnsignedShort)(((bestOffset - 1) << 4) | (bestLen - NET_LZ_MIN_MATCH));
+			dest[out++] = (UnsignedByte)(code >> 8);
+			dest[out++] = (UnsignedByte)(code & 0xff);
+			dest[flagPos] |= (1 << flagBit);
+			for (i = 0; i < bestLen; ++i)
+				insertPosition(pos + i, total);
+			pos += bestLen;
+		}
+		else
+		{
+			if (out >= destLen)
+				return 0;
+			dest[out++] = s_window[pos];
+			insertPosition(pos, total);
+			++pos;
+		}
+		++flagBit;
+	}
+
+	if (out >= srcLen)
+		return 0; // not worth it.
+
+	return out;
+}
+
+//-------------------------------------------------------------------------------------------------
+Int NetCompression::decompress( const UnsignedByte *src, Int srcLen, UnsignedByte *dest, Int destLen )
+{
+	if (src == NULL || dest == NULL || srcLen <= 0 || destLen <= 0)
+		return -1;
+
+	Int limit = min(destLen, (Int)NET_LZ_MAX_INPUT);
+	Int pos = 0;
+	Int in = 0;
+	while (in < srcLen)
+	{
+		UnsignedByte flags = src[in++];
+		for (Int bit = 0; (bit < 8) && (in < srcLen); ++bit)
+		{
+			if (flags & (1 << bit))
+			{
+				if (in + 2 > srcLen)
+					return -1;
+				UnsignedShort code = (UnsignedShort)((src[in] << 8) | src[in + 1]);
+				in += 2;
+
+				Int offset = (code >> 4) + 1;
+				Int len = (code & 0xf) + NET_LZ_MIN_MATCH;
+				if (offset > pos || pos + len > limit)
+					return -1;
+
+				// byte at a time, the reference is allowed to overlap what we're writing.
+				for (Int i = 0; i < len; ++i, ++pos)
+					s_window[pos] = s_window[pos - offset];
+			}
+			else
+			{
+				if (pos >= limit)
+					return -1;
+				s_window[pos++] = src[in++];
+			}
+		}
+	}
+
+	memcpy(dest, s_window, pos);
+	return pos;
+}
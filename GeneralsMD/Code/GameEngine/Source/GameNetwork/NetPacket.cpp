@@ -38,6 +38,59 @@
 //#pragma MESSAGE("************************************** WARNING, optimization disabled for debugging purposes")
 #endif
 
+// Whether packets we build use the compact field encodings.  Packets we read are always
+// decoded according to their tags, so this only has to agree between peers for sending.
+Bool NetPacket::s_compactEncoding = FALSE;
+
+//-------------------------------------------------------------------------------------------------
+// Variable length integer helpers for the compact encodings.  Values are written 7 bits at a
+// time, low bits first, with the high bit set on every byte but the last.  Signed values are
+// zigzagged first so that small negative deltas stay small.
+//-------------------------------------------------------------------------------------------------
+static inline UnsignedInt zigZagEncode(Int val)
+{
+	return ((UnsignedInt)val << 1) ^ (UnsignedInt)(val >> 31);
+}
+
+static inline Int zigZagDecode(UnsignedInt val)
+{
+	return (Int)(val >> 1) ^ -(Int)(val & 1);
+}
+
+static inline Int getVarIntSize(UnsignedInt val)
+{
+	Int size = 1;
+	while (val >= 0x80) {
+		val >>= 7;
+		++size;
+	}
+	return size;
+}
+
+static inline Int writeVarInt(UnsignedByte *buffer, UnsignedInt val)
+{
+	Int len = 0;
+	while (val >= 0x80) {
+		buffer[len++] = (UnsignedByte)(val | 0x80);
+		val >>= 7;
+	}
+	buffer[len++] = (UnsignedByte)val;
+	return len;
+}
+
+static inline UnsignedInt readVarInt(const UnsignedByte *buffer, Int &i)
+{
+	UnsignedInt val = 0;
+	Int shift = 0;
+	UnsignedByte b;
+	do {
+		b = buffer[i++];
+		val |= (UnsignedInt)(b & 0x7f) << shift;
+		shift += 7;
+	} while ((b & 0x80) && (shift < 35));
+	return val;
+}
+
 // This function assumes that all of the fields are either of default value or are
 // present in the raw data.
 NetCommandRef * NetPacket::ConstructNetCommandMsgFromRawData(UnsignedByte *data, UnsignedShort dataLength) {
@@ -1939,6 +1992,7 @@ void NetPacket::init() {
 	m_lastPlayerID = 0;
 	m_lastFrame = 0;
 	m_lastCommandID = 0;
+	m_lastCommandIDField = 0;
 	m_lastCommandType = 0;
 	m_lastRelay = 0;
 
@@ -1961,6 +2015,81 @@ void NetPacket::setAddress(Int addr, Int port) {
 	m_port = port;
 }
 
+/**
+ * Turn the compact field encodings on or off for all packets built from here on.  Only turn
+ * this on once every peer in the game is known to understand them.
+ */
+void NetPacket::SetCompactEncoding(Bool compact) {
+	s_compactEncoding = compact;
+}
+
+Bool NetPacket::IsCompactEncoding() {
+	return s_compactEncoding;
+}
+
+/**
+ * Write the execution frame for the next command.  In compact mode this is written as a delta
+ * from the last frame in this packet, which is nearly always one or two bytes.
+ */
+void NetPacket::writeFrameField(UnsignedInt frame) {
+	UnsignedInt delta = zigZagEncode((Int)(frame - m_lastFrame));
+	if (s_compactEncoding && (getVarIntSize(delta) < (Int)sizeof(UnsignedInt))) {
+		m_packet[m_packetLen] = 'f';
+		++m_packetLen;
+		m_packetLen += writeVarInt(m_packet + m_packetLen, delta);
+	} else {
+		m_packet[m_packetLen] = 'F';
+		++m_packetLen;
+		memcpy(m_packet + m_packetLen, &frame, sizeof(UnsignedInt));
+		m_packetLen += sizeof(UnsignedInt);
+	}
+
+	m_lastFrame = frame;
+}
+
+/**
+ * Returns the number of bytes writeFrameField would use for this frame.
+ */
+Int NetPacket::getFrameFieldSize(UnsignedInt frame) {
+	UnsignedInt delta = zigZagEncode((Int)(frame - m_lastFrame));
+	if (s_compactEncoding && (getVarIntSize(delta) < (Int)sizeof(UnsignedInt))) {
+		return sizeof(UnsignedByte) + getVarIntSize(delta);
+	}
+	return sizeof(UnsignedByte) + sizeof(UnsignedInt);
+}
+
+/**
+ * Write an explicit command ID.  In compact mode this is written as a one byte delta from the
+ * last command ID that was explicitly written to this packet, when the delta is small enough.
+ */
+void NetPacket::writeCommandIDField(UnsignedShort id) {
+	UnsignedInt delta = zigZagEncode((Short)(id - m_lastCommandIDField));
+	if (s_compactEncoding && (delta < 0x80)) {
+		m_packet[m_packetLen] = 'c';
+		++m_packetLen;
+		m_packet[m_packetLen] = (UnsignedByte)delta;
+		++m_packetLen;
+	} else {
+		m_packet[m_packetLen] = 'C';
+		++m_packetLen;
+		memcpy(m_packet + m_packetLen, &id, sizeof(UnsignedShort));
+		m_packetLen += sizeof(UnsignedShort);
+	}
+
+	m_lastCommandIDField = id;
+}
+
+/**
+ * Returns the number of bytes writeCommandIDField would use for this command ID.
+ */
+Int NetPacket::getCommandIDFieldSize(UnsignedShort id) {
+	UnsignedInt delta = zigZagEncode((Short)(id - m_lastCommandIDField));
+	if (s_compactEncoding && (delta < 0x80)) {
+		return sizeof(UnsignedByte) + sizeof(UnsignedByte);
+	}
+	return sizeof(UnsignedByte) + sizeof(UnsignedShort);
+}
+
 /**
  * Adds this command to the packet.  Returns false if there wasn't enough room
  * in the packet for this message, true otherwise.
@@ -2064,13 +2193,7 @@ Bool NetPacket::addFrameResendRequestCommand(NetCommandRef *msg) {
 
 		// If necessary, put the execution frame into the packet.
 		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = 'F';
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet+m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
+			writeFrameField(cmdMsg->getExecutionFrame());
 		}
 
 		// If necessary, put the relay into the packet.
@@ -2097,11 +2220,7 @@ Bool NetPacket::addFrameResendRequestCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -2175,13 +2294,7 @@ Bool NetPacket::addDisconnectScreenOffCommand(NetCommandRef *msg) {
 
 		// If necessary, put the execution frame into the packet.
 		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = 'F';
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet+m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
+			writeFrameField(cmdMsg->getExecutionFrame());
 		}
 
 		// If necessary, put the relay into the packet.
@@ -2208,11 +2321,7 @@ Bool NetPacket::addDisconnectScreenOffCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -2286,13 +2395,7 @@ Bool NetPacket::addDisconnectFrameCommand(NetCommandRef *msg) {
 
 		// If necessary, put the execution frame into the packet.
 		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = 'F';
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet+m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
+			writeFrameField(cmdMsg->getExecutionFrame());
 		}
 
 		// If necessary, put the relay into the packet.
@@ -2319,11 +2422,7 @@ Bool NetPacket::addDisconnectFrameCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -2419,11 +2518,7 @@ Bool NetPacket::addFileCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -2523,11 +2618,7 @@ Bool NetPacket::addFileAnnounceCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -2632,11 +2723,7 @@ Bool NetPacket::addFileProgressCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -2733,11 +2820,7 @@ Bool NetPacket::addWrapperCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -2872,11 +2955,7 @@ Bool NetPacket::addTimeOutGameStartMessage(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -2966,11 +3045,7 @@ Bool NetPacket::addLoadCompleteMessage(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -3152,11 +3227,7 @@ Bool NetPacket::addDisconnectVoteCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -3328,13 +3399,7 @@ Bool NetPacket::addChatCommand(NetCommandRef *msg) {
 
 		// If necessary, put the execution frame into the packet.
 		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = 'F';
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet+m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
+			writeFrameField(cmdMsg->getExecutionFrame());
 		}
 
 		// If necessary, put the relay into the packet.
@@ -3364,11 +3429,7 @@ Bool NetPacket::addChatCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -3646,11 +3707,7 @@ Bool NetPacket::addDisconnectPlayerCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -3905,13 +3962,7 @@ Bool NetPacket::addRunAheadCommand(NetCommandRef *msg) {
 
 		// If necessary, put the execution frame into the packet.
 		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = 'F';
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet+m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
+			writeFrameField(cmdMsg->getExecutionFrame());
 		}
 
 //		DEBUG_LOG(("relay = %d, ", m_lastRelay));
@@ -3930,11 +3981,7 @@ Bool NetPacket::addRunAheadCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -4030,13 +4077,7 @@ Bool NetPacket::addDestroyPlayerCommand(NetCommandRef *msg) {
 
 		// If necessary, put the execution frame into the packet.
 		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = 'F';
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet+m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
+			writeFrameField(cmdMsg->getExecutionFrame());
 		}
 
 //		DEBUG_LOG(("relay = %d, ", m_lastRelay));
@@ -4055,11 +4096,7 @@ Bool NetPacket::addDestroyPlayerCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -4165,11 +4202,7 @@ Bool NetPacket::addRunAheadMetricsCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -4264,13 +4297,7 @@ Bool NetPacket::addPlayerLeaveCommand(NetCommandRef *msg) {
 
 		// If necessary, put the execution frame into the packet.
 		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = 'F';
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet+m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
+			writeFrameField(cmdMsg->getExecutionFrame());
 		}
 
 //		DEBUG_LOG(("relay = %d, ", m_lastRelay));
@@ -4289,11 +4316,7 @@ Bool NetPacket::addPlayerLeaveCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -4389,13 +4412,7 @@ Bool NetPacket::addFrameCommand(NetCommandRef *msg) {
 
 		// If necessary, put the execution frame into the packet.
 		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = 'F';
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet+m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
+			writeFrameField(cmdMsg->getExecutionFrame());
 		}
 
 		// If necessary, put the relay into the packet.
@@ -4425,11 +4442,7 @@ Bool NetPacket::addFrameCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
@@ -4717,13 +4730,7 @@ Bool NetPacket::addGameCommand(NetCommandRef *msg) {
 
 		// If necessary, put the execution frame into the packet.
 		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = 'F';
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet+m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
+			writeFrameField(cmdMsg->getExecutionFrame());
 		}
 
 		// If necessary, put the relay into the packet.
@@ -4751,21 +4758,22 @@ Bool NetPacket::addGameCommand(NetCommandRef *msg) {
 
 		// If necessary, specify the command ID of this command.
 		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = 'C';
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+			writeCommandIDField(cmdMsg->getID());
 		}
 		m_lastCommandID = cmdMsg->getID();
 
-		m_packet[m_packetLen] = 'D';
+		// Compact game messages get their own data tag so the reader knows how to decode them.
+		m_packet[m_packetLen] = s_compactEncoding ? 'd' : 'D';
 		++m_packetLen;
 
 		// Now copy the GameMessage type into the packet.
 		GameMessage::Type newType = gmsg->getType();
-		memcpy(m_packet + m_packetLen, &newType, sizeof(GameMessage::Type));
-		m_packetLen += sizeof(GameMessage::Type);
+		if (s_compactEncoding) {
+			m_packetLen += writeVarInt(m_packet + m_packetLen, (UnsignedInt)newType);
+		} else {
+			memcpy(m_packet + m_packetLen, &newType, sizeof(GameMessage::Type));
+			m_packetLen += sizeof(GameMessage::Type);
+		}
 
 
 		GameMessageParser *parser = newInstance(GameMessageParser)(gmsg);
@@ -4787,10 +4795,15 @@ Bool NetPacket::addGameCommand(NetCommandRef *msg) {
 		}
 
 		Int numArgs = gmsg->getArgumentCount();
+		UnsignedInt lastID = 0;
 		for (Int i = 0; i < numArgs; ++i) {
 			GameMessageArgumentDataType type = gmsg->getArgumentDataType(i);
 			GameMessageArgumentType arg = *(gmsg->getArgument(i));
-			writeGameMessageArgumentToPacket(type, arg);
+			if (s_compactEncoding) {
+				writeCompactGameMessageArgumentToPacket(type, arg, lastID);
+			} else {
+				writeGameMessageArgumentToPacket(type, arg);
+			}
 		}
 
 		parser->deleteInstance();
@@ -4855,6 +4868,66 @@ void NetPacket::writeGameMessageArgumentToPacket(GameMessageArgumentDataType typ
 	}
 }
 
+/**
+ * Compact form of writeGameMessageArgumentToPacket.  Integers, team IDs, timestamps and
+ * characters are written as varints.  Object and drawable IDs are written as deltas from the
+ * previous ID in the same message, so a group selection costs a byte or two per unit instead
+ * of four.  Everything else is written as-is.
+ */
+void NetPacket::writeCompactGameMessageArgumentToPacket(GameMessageArgumentDataType type, GameMessageArgumentType arg, UnsignedInt &lastID) {
+	if (type == ARGUMENTDATATYPE_INTEGER) {
+		m_packetLen += writeVarInt(m_packet + m_packetLen, zigZagEncode(arg.integer));
+	} else if (type == ARGUMENTDATATYPE_OBJECTID) {
+		m_packetLen += writeVarInt(m_packet + m_packetLen, zigZagEncode((Int)((UnsignedInt)arg.objectID - lastID)));
+		lastID = (UnsignedInt)arg.objectID;
+	} else if (type == ARGUMENTDATATYPE_DRAWABLEID) {
+		m_packetLen += writeVarInt(m_packet + m_packetLen, zigZagEncode((Int)((UnsignedInt)arg.drawableID - lastID)));
+		lastID = (UnsignedInt)arg.drawableID;
+	} else if (type == ARGUMENTDATATYPE_TEAMID) {
+		m_packetLen += writeVarInt(m_packet + m_packetLen, arg.teamID);
+	} else if (type == ARGUMENTDATATYPE_TIMESTAMP) {
+		m_packetLen += writeVarInt(m_packet + m_packetLen, arg.timestamp);
+	} else if (type == ARGUMENTDATATYPE_WIDECHAR) {
+		m_packetLen += writeVarInt(m_packet + m_packetLen, (UnsignedInt)arg.wChar);
+	} else {
+		writeGameMessageArgumentToPacket(type, arg);
+	}
+}
+
+/**
+ * Returns the number of bytes writeCompactGameMessageArgumentToPacket would use for this argument.
+ */
+Int NetPacket::GetCompactGameMessageArgumentSize(GameMessageArgumentDataType type, GameMessageArgumentType arg, UnsignedInt &lastID) {
+	if (type == ARGUMENTDATATYPE_INTEGER) {
+		return getVarIntSize(zigZagEncode(arg.integer));
+	} else if (type == ARGUMENTDATATYPE_REAL) {
+		return sizeof(Real);
+	} else if (type == ARGUMENTDATATYPE_BOOLEAN) {
+		return sizeof(Bool);
+	} else if (type == ARGUMENTDATATYPE_OBJECTID) {
+		Int size = getVarIntSize(zigZagEncode((Int)((UnsignedInt)arg.objectID - lastID)));
+		lastID = (UnsignedInt)arg.objectID;
+		return size;
+	} else if (type == ARGUMENTDATATYPE_DRAWABLEID) {
+		Int size = getVarIntSize(zigZagEncode((Int)((UnsignedInt)arg.drawableID - lastID)));
+		lastID = (UnsignedInt)arg.drawableID;
+		return size;
+	} else if (type == ARGUMENTDATATYPE_TEAMID) {
+		return getVarIntSize(arg.teamID);
+	} else if (type == ARGUMENTDATATYPE_LOCATION) {
+		return sizeof(Coord3D);
+	} else if (type == ARGUMENTDATATYPE_PIXEL) {
+		return sizeof(ICoord2D);
+	} else if (type == ARGUMENTDATATYPE_PIXELREGION) {
+		return sizeof(IRegion2D);
+	} else if (type == ARGUMENTDATATYPE_TIMESTAMP) {
+		return getVarIntSize(arg.timestamp);
+	} else if (type == ARGUMENTDATATYPE_WIDECHAR) {
+		return getVarIntSize((UnsignedInt)arg.wChar);
+	}
+	return 0;
+}
+
 /**
  * Returns true if there is enough room in this packet for this message.
  */
@@ -4867,7 +4940,7 @@ Bool NetPacket::isRoomForGameMessage(NetCommandRef *msg, GameMessage *gmsg) {
 	Bool needNewCommandID = FALSE;
 
 	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		msglen += sizeof(UnsignedInt) + sizeof(UnsignedByte);
+		msglen += getFrameFieldSize(cmdMsg->getExecutionFrame());
 	}
 	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
 		msglen += sizeof(UnsignedByte) + sizeof(UnsignedByte);
@@ -4880,14 +4953,35 @@ Bool NetPacket::isRoomForGameMessage(NetCommandRef *msg, GameMessage *gmsg) {
 		msglen += sizeof(UnsignedByte) + sizeof(UnsignedByte);
 	}
 	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		msglen += sizeof(UnsignedShort) + sizeof(UnsignedByte);
+		msglen += getCommandIDFieldSize(cmdMsg->getID());
 	}
 
 	GameMessageParser *parser = newInstance(GameMessageParser)(gmsg);
 
 	++msglen; // for 'D'
-	msglen += sizeof(GameMessage::Type);
 	msglen += sizeof(UnsignedByte);
+	if (s_compactEncoding) {
+		// The compact encoding depends on the values, not just the types, so measure each argument.
+		msglen += getVarIntSize((UnsignedInt)gmsg->getType());
+		GameMessageParserArgumentType *arg = parser->getFirstArgumentType();
+		while (arg != NULL) {
+			msglen += 2 * sizeof(UnsignedByte); // for the type and number of args of that type declaration.
+			arg = arg->getNext();
+		}
+
+		UnsignedInt lastID = 0;
+		Int numArgs = gmsg->getArgumentCount();
+		for (Int i = 0; i < numArgs; ++i) {
+			msglen += GetCompactGameMessageArgumentSize(gmsg->getArgumentDataType(i), *(gmsg->getArgument(i)), lastID);
+		}
+
+		parser->deleteInstance();
+		parser = NULL;
+
+		return (msglen <= (MAX_PACKET_SIZE - m_packetLen));
+	}
+
+	msglen += sizeof(GameMessage::Type);
 //	Int numTypes = parser->getNumTypes();
 	GameMessageParserArgumentType *arg = parser->getFirstArgumentType();
 	while (arg != NULL) {
@@ -4941,6 +5035,7 @@ NetCommandList * NetPacket::getCommandList() {
 	UnsignedByte playerID = 0;
 	UnsignedInt frame = 0;
 	UnsignedShort commandID = 1; // The first command is going to be
+	UnsignedShort commandIDField = 0; // the last command ID explicitly given, for 'c' deltas.
 	UnsignedByte commandType = 0;
 	UnsignedByte relay = 0;
 	NetCommandRef *lastCommand = NULL;
@@ -4955,6 +5050,9 @@ NetCommandList * NetPacket::getCommandList() {
 			++i;
 			memcpy(&frame, m_packet + i, sizeof(UnsignedInt));
 			i += sizeof(UnsignedInt);
+		} else if (m_packet[i] == 'f') {
+			++i;
+			frame += zigZagDecode(readVarInt(m_packet, i));
 		} else if (m_packet[i] == 'P') {
 			++i;
 			memcpy(&playerID, m_packet + i, sizeof(UnsignedByte));
@@ -4967,7 +5065,14 @@ NetCommandList * NetPacket::getCommandList() {
 			++i;
 			memcpy(&commandID, m_packet + i, sizeof(UnsignedShort));
 			i += sizeof(UnsignedShort);
-		} else if (m_packet[i] == 'D') {
+			commandIDField = commandID;
+		} else if (m_packet[i] == 'c') {
+			++i;
+			commandIDField = (UnsignedShort)(commandIDField + zigZagDecode(m_packet[i]));
+			++i;
+			commandID = commandIDField;
+		} else if ((m_packet[i] == 'D') || (m_packet[i] == 'd')) {
+			Bool compact = (m_packet[i] == 'd');
 			++i;
 
 			NetCommandMsg *msg = NULL;
@@ -4977,7 +5082,7 @@ NetCommandList * NetPacket::getCommandList() {
 			switch((NetCommandType)commandType)
 			{
 			case NETCOMMANDTYPE_GAMECOMMAND:
-				msg = readGameMessage(m_packet, i);
+				msg = readGameMessage(m_packet, i, compact);
 				//DEBUG_LOG(("read game command from player %d for frame %d\n", playerID, frame));
 				break;
 			case NETCOMMANDTYPE_ACKBOTH:
@@ -5199,7 +5304,7 @@ NetCommandList * NetPacket::getCommandList() {
 /**
  * Reads the data portion of a game message from the given position in the packet.
  */
-NetCommandMsg * NetPacket::readGameMessage(UnsignedByte *data, Int &i) 
+NetCommandMsg * NetPacket::readGameMessage(UnsignedByte *data, Int &i, Bool compact) 
 {
 	NetGameCommandMsg *msg = newInstance(NetGameCommandMsg);
 
@@ -5207,8 +5312,12 @@ NetCommandMsg * NetPacket::readGameMessage(UnsignedByte *data, Int &i)
 
 	// Get the GameMessage command type.
 	GameMessage::Type newType;
-	memcpy(&newType, data + i, sizeof(GameMessage::Type));
-	i += sizeof(GameMessage::Type);
+	if (compact) {
+		newType = (GameMessage::Type)readVarInt(data, i);
+	} else {
+		memcpy(&newType, data + i, sizeof(GameMessage::Type));
+		i += sizeof(GameMessage::Type);
+	}
 	msg->setGameMessageType(newType);
 
 	// Get the number of argument types
@@ -5239,8 +5348,13 @@ NetCommandMsg * NetPacket::readGameMessage(UnsignedByte *data, Int &i)
 		lasttype = parserArgType->getType();
 		argsLeftForType = parserArgType->getArgCount();
 	}
+	UnsignedInt lastID = 0;
 	for (j = 0; j < totalArgCount; ++j) {
-		readGameMessageArgumentFromPacket(lasttype, msg, data, i);
+		if (compact) {
+			readCompactGameMessageArgumentFromPacket(lasttype, msg, data, i, lastID);
+		} else {
+			readGameMessageArgumentFromPacket(lasttype, msg, data, i);
+		}
 
 		--argsLeftForType;
 		if (argsLeftForType == 0) {
@@ -5345,6 +5459,36 @@ void NetPacket::readGameMessageArgumentFromPacket(GameMessageArgumentDataType ty
 	}
 }
 
+/**
+ * Reads an argument written by writeCompactGameMessageArgumentToPacket.
+ */
+void NetPacket::readCompactGameMessageArgumentFromPacket(GameMessageArgumentDataType type, NetGameCommandMsg *msg, UnsignedByte *data, Int &i, UnsignedInt &lastID) {
+	GameMessageArgumentType arg;
+	if (type == ARGUMENTDATATYPE_INTEGER) {
+		arg.integer = zigZagDecode(readVarInt(data, i));
+		msg->addArgument(type, arg);
+	} else if (type == ARGUMENTDATATYPE_OBJECTID) {
+		lastID += (UnsignedInt)zigZagDecode(readVarInt(data, i));
+		arg.objectID = (ObjectID)lastID;
+		msg->addArgument(type, arg);
+	} else if (type == ARGUMENTDATATYPE_DRAWABLEID) {
+		lastID += (UnsignedInt)zigZagDecode(readVarInt(data, i));
+		arg.drawableID = (DrawableID)lastID;
+		msg->addArgument(type, arg);
+	} else if (type == ARGUMENTDATATYPE_TEAMID) {
+		arg.teamID = readVarInt(data, i);
+		msg->addArgument(type, arg);
+	} else if (type == ARGUMENTDATATYPE_TIMESTAMP) {
+		arg.timestamp = readVarInt(data, i);
+		msg->addArgument(type, arg);
+	} else if (type == ARGUMENTDATATYPE_WIDECHAR) {
+		arg.wChar = (WideChar)readVarInt(data, i);
+		msg->addArgument(type, arg);
+	} else {
+		readGameMessageArgumentFromPacket(type, msg, data, i);
+	}
+}
+
 /**
  * Reads the data portion of the ack message at this position in the packet.
  */
@@ -143,6 +143,7 @@ public:
 	Real getIncomingBytesPerSecond( void );
 	Real getIncomingPacketsPerSecond( void );
 	Real getOutgoingBytesPerSecond( void );
+	Real getOutgoingPayloadBytesPerSecond( void );
 	Real getOutgoingPacketsPerSecond( void );
 	Real getUnknownBytesPerSecond( void );
 	Real getUnknownPacketsPerSecond( void );
@@ -203,6 +204,7 @@ protected:
 
 	Int m_runAhead;																						///< The current run ahead of the game.
 	Int m_frameRate;
+	Int m_frameGrouping;																			///< Milliseconds between packet sends that we last gave the connections.
 	Int m_lastExecutionFrame;																	///< The highest frame number that a command could have been executed on.
 	Int m_lastFrameCompleted;
 	Bool m_didSelfSlug;
@@ -335,6 +337,7 @@ void Network::init()
 	m_lastFrame = 0;
 	m_runAhead = min(max(30, MIN_RUNAHEAD), MAX_FRAMES_AHEAD/2); ///< @todo: don't hard-code the run-ahead.
 	m_frameRate = 30;
+	m_frameGrouping = 0;
 	m_lastExecutionFrame = m_runAhead - 1; // subtract 1 since we're starting on frame 0
 	m_lastFrameCompleted = m_runAhead - 1; // subtract 1 since we're starting on frame 0
 	m_frameDataReady = FALSE;
@@ -353,6 +356,8 @@ void Network::init()
 	DEBUG_LOG(("NetworkRunAheadMetricsTime: %d\n", TheGlobalData->m_networkRunAheadMetricsTime));
 	DEBUG_LOG(("NetworkCushionHistoryLength: %d\n", TheGlobalData->m_networkCushionHistoryLength));
 	DEBUG_LOG(("NetworkRunAheadSlack: %d\n", TheGlobalData->m_networkRunAheadSlack));
+	DEBUG_LOG(("NetworkRunAheadMaxStep: %d\n", TheGlobalData->m_networkRunAheadMaxStep));
+	DEBUG_LOG(("NetworkRunAheadHysteresis: %d\n", TheGlobalData->m_networkRunAheadHysteresis));
 	DEBUG_LOG(("NetworkKeepAliveDelay: %d\n", TheGlobalData->m_networkKeepAliveDelay));
 	DEBUG_LOG(("NetworkDisconnectTime: %d\n", TheGlobalData->m_networkDisconnectTime));
 	DEBUG_LOG(("NetworkPlayerTimeoutTime: %d\n", TheGlobalData->m_networkPlayerTimeoutTime));
@@ -644,16 +649,12 @@ void Network::processFrameSynchronizedNetCommand(NetCommandRef *msg) {
 void Network::processRunAheadCommand(NetRunAheadCommandMsg *msg) {
 	m_runAhead = msg->getRunAhead();
 	m_frameRate = msg->getFrameRate();
-	time_t frameGrouping = (1000 * m_runAhead) / m_frameRate; // number of miliseconds between packet sends
-	frameGrouping = frameGrouping / 2; // since we only want the latency for one way to be a factor.
+	Int frameGrouping = RunAheadController::ComputeFrameGrouping(m_runAhead, m_frameRate, m_frameGrouping);
 //	DEBUG_LOG(("Network::processRunAheadCommand - trying to set frame grouping to %d.  run ahead = %d, m_frameRate = %d\n", frameGrouping, m_runAhead, m_frameRate));
-	if (frameGrouping < 1) {
-		frameGrouping = 1; // Having a value less than 1 doesn't make sense.
+	if (frameGrouping != m_frameGrouping) {
+		m_frameGrouping = frameGrouping;
+		m_conMgr->setFrameGrouping(frameGrouping);
 	}
-	if (frameGrouping > 500) {
-		frameGrouping = 500; // Max of a half a second.
-	}
-	m_conMgr->setFrameGrouping(frameGrouping);
 }
 
 void Network::processDestroyPlayerCommand(NetDestroyPlayerCommandMsg *msg)
@@ -841,6 +842,17 @@ Real Network::getOutgoingBytesPerSecond( void )
 	  return 0.0;
 }
 
+/**
+ * returns the number of outgoing bytes per second before the transport packed them, averaged over the last 30 sec.
+ */
+Real Network::getOutgoingPayloadBytesPerSecond( void )
+{
+	if (m_conMgr)
+		return m_conMgr->getOutgoingPayloadBytesPerSecond();
+	else
+	  return 0.0;
+}
+
 /**
  * returns the number of outgoing packets per second averaged over the last 30 sec.
  */
@@ -0,0 +1,934 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+////////// NetworkSimulator.cpp ///////////////////////////
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+
+#include "Common/GlobalData.h"
+#include "GameNetwork/Connection.h"
+#include "GameNetwork/FrameDataManager.h"
+#include "GameNetwork/NetCommandMsg.h"
+#include "GameNetwork/NetPacket.h"
+#include "GameNetwork/NetworkSimulator.h"
+#include "GameNetwork/NetworkUtil.h"
+#include "GameNetwork/Transport.h"
+
+//-------------------------------------------------------------------------------------------------
+// NetworkSimulator
+//-------------------------------------------------------------------------------------------------
+
+NetworkSimulator::NetworkSimulator()
+{
+	m_defaultConditions.latency = 0;
+	m_defaultConditions.jitter = 0;
+	m_defaultConditions.packetLoss = 0;
+	m_defaultConditions.bandwidth = 0;
+	m_manualClock = FALSE;
+	m_seed = 0x5EED;
+	reset();
+}
+
+/**
+ * Forget everything in flight, all per-link conditions, and all statistics.
+ */
+void NetworkSimulator::reset( void )
+{
+	Int i;
+	for (i = 0; i < MAX_SIMULATED_PACKETS; ++i)
+	{
+		m_packets[i].length = 0;
+	}
+	m_numLinks = 0;
+	m_now = 0;
+
+	m_packetsSent = 0;
+	m_packetsDelivered = 0;
+	m_packetsLost = 0;
+	m_packetsOverflowed = 0;
+	m_bytesSent = 0;
+	for (i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i)
+	{
+		m_latencyHistogram[i] = 0;
+	}
+}
+
+void NetworkSimulator::setDefaultLinkConditions( const NetLinkConditions &conditions )
+{
+	m_defaultConditions = conditions;
+}
+
+void NetworkSimulator::setLinkConditions( UnsignedInt fromAddr, UnsignedInt toAddr, const NetLinkConditions &conditions )
+{
+	SimulatedLink *link = findLink(fromAddr, toAddr);
+	if (link == NULL)
+	{
+		return;
+	}
+	link->conditions = conditions;
+}
+
+UnsignedInt NetworkSimulator::getTime( void ) const
+{
+	if (m_manualClock)
+	{
+		return m_now;
+	}
+	return timeGetTime();
+}
+
+/**
+ * Returns the link from fromAddr to toAddr, making a new one with the default conditions if
+ * there isn't one yet.  Returns NULL if we're out of links.
+ */
+NetworkSimulator::SimulatedLink * NetworkSimulator::findLink( UnsignedInt fromAddr, UnsignedInt toAddr )
+{
+	for (Int i = 0; i < m_numLinks; ++i)
+	{
+		if (m_links[i].fromAddr == fromAddr && m_links[i].toAddr == toAddr)
+		{
+			return &m_links[i];
+		}
+	}
+
+	if (m_numLinks >= MAX_SIMULATED_LINKS)
+	{
+		DEBUG_CRASH(("NetworkSimulator::findLink - too many links"));
+		return NULL;
+	}
+
+	SimulatedLink *link = &m_links[m_numLinks++];
+	link->fromAddr = fromAddr;
+	link->toAddr = toAddr;
+	link->conditions = m_defaultConditions;
+	link->busyUntil = 0;
+	return link;
+}
+
+/**
+ * Our own random numbers, so that simulating the network doesn't disturb the game's.
+ */
+Int NetworkSimulator::random( Int lo, Int hi )
+{
+	if (hi <= lo)
+	{
+		return lo;
+	}
+	m_seed = m_seed * 1103515245 + 12345;
+	return lo + (Int)((m_seed >> 16) % (UnsignedInt)(hi - lo + 1));
+}
+
+Int NetworkSimulator::write( UnsignedInt fromAddr, UnsignedShort fromPort, const UnsignedByte *buf, Int len, UnsignedInt toAddr, UnsignedShort toPort )
+{
+	if (len <= 0 || len > (Int)sizeof(m_packets[0].data))
+	{
+		return -1;
+	}
+
+	UnsignedInt now = getTime();
+	++m_packetsSent;
+	m_bytesSent += len;
+
+	SimulatedLink *link = findLink(fromAddr, toAddr);
+	if (link == NULL)
+	{
+		++m_packetsLost;
+		return len;
+	}
+
+	// The packet takes up the link whether or not it makes it to the other end.
+	UnsignedInt departure = now;
+	if (link->conditions.bandwidth > 0)
+	{
+		if (link->busyUntil > departure)
+		{
+			departure = link->busyUntil;
+		}
+		departure += (len * 1000) / link->conditions.bandwidth;
+		link->busyUntil = departure;
+	}
+
+	if (link->conditions.packetLoss > 0 && random(1, 100) <= link->conditions.packetLoss)
+	{
+		++m_packetsLost;
+		return len;
+	}
+
+	for (Int i = 0; i < MAX_SIMULATED_PACKETS; ++i)
+	{
+		SimulatedPacket *packet = &m_packets[i];
+		if (packet->length == 0)
+		{
+			packet->fromAddr = fromAddr;
+			packet->fromPort = fromPort;
+			packet->toAddr = toAddr;
+			packet->toPort = toPort;
+			packet->sendTime = now;
+			packet->deliveryTime = departure + link->conditions.latency + random(0, link->conditions.jitter);
+			packet->length = len;
+			memcpy(packet->data, buf, len);
+			return len;
+		}
+	}
+
+	++m_packetsOverflowed;
+	return len;
+}
+
+Int NetworkSimulator::read( UnsignedInt addr, UnsignedShort port, UnsignedByte *buf, Int len, UnsignedInt *fromAddr, UnsignedShort *fromPort )
+{
+	UnsignedInt now = getTime();
+
+	SimulatedPacket *oldest = NULL;
+	for (Int i = 0; i < MAX_SIMULATED_PACKETS; ++i)
+	{
+		SimulatedPacket *packet = &m_packets[i];
+		if (packet->length != 0 && packet->toAddr == addr && packet->toPort == port && packet->deliveryTime <= now)
+		{
+			if (oldest == NULL || packet->deliveryTime < oldest->deliveryTime)
+			{
+				oldest = packet;
+			}
+		}
+	}
+
+	if (oldest == NULL)
+	{
+		return 0;
+	}
+
+	Int packetLen = oldest->length;
+	if (packetLen > len)
+	{
+		packetLen = len;
+	}
+	memcpy(buf, oldest->data, packetLen);
+	*fromAddr = oldest->fromAddr;
+	*fromPort = oldest->fromPort;
+
+	Int bucket = (now - oldest->sendTime) / LATENCY_HISTOGRAM_BUCKET_SIZE;
+	if (bucket >= LATENCY_HISTOGRAM_BUCKETS)
+	{
+		bucket = LATENCY_HISTOGRAM_BUCKETS - 1;
+	}
+	++m_latencyHistogram[bucket];
+	++m_packetsDelivered;
+
+	oldest->length = 0;
+	return packetLen;
+}
+
+void NetworkSimulator::logStatistics( void ) const
+{
+	DEBUG_LOG(("NetworkSimulator - %d packets (%d bytes) sent, %d delivered, %d lost, %d dropped for lack of room\n",
+		m_packetsSent, m_bytesSent, m_packetsDelivered, m_packetsLost, m_packetsOverflowed));
+	for (Int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i)
+	{
+		if (m_latencyHistogram[i] != 0)
+		{
+			DEBUG_LOG(("NetworkSimulator - delivered in %d-%dms: %d\n", i * LATENCY_HISTOGRAM_BUCKET_SIZE,
+				(i + 1) * LATENCY_HISTOGRAM_BUCKET_SIZE - 1, m_latencyHistogram[i]));
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+// NetworkSoak
+//-------------------------------------------------------------------------------------------------
+
+static const UnsignedInt SOAK_BASE_ADDR = 0x7F000001;		// 127.0.0.1
+static const UnsignedShort SOAK_PORT = 8088;
+
+NetworkSoak::NetworkSoak()
+{
+	m_numClients = 0;
+	m_runAheadChanges = 0;
+	for (Int c = 0; c < MAX_SOAK_CLIENTS; ++c)
+	{
+		m_clients[c].transport = NULL;
+		for (Int p = 0; p < MAX_SOAK_CLIENTS; ++p)
+		{
+			m_clients[c].connections[p] = NULL;
+			m_clients[c].frameData[p] = NULL;
+		}
+	}
+}
+
+NetworkSoak::~NetworkSoak()
+{
+	for (Int c = 0; c < MAX_SOAK_CLIENTS; ++c)
+	{
+		SoakClient *client = &m_clients[c];
+		for (Int p = 0; p < MAX_SOAK_CLIENTS; ++p)
+		{
+			if (client->connections[p] != NULL)
+			{
+				client->connections[p]->deleteInstance();
+				client->connections[p] = NULL;
+			}
+			if (client->frameData[p] != NULL)
+			{
+				client->frameData[p]->deleteInstance();
+				client->frameData[p] = NULL;
+			}
+		}
+		if (client->transport != NULL)
+		{
+			delete client->transport;
+			client->transport = NULL;
+		}
+	}
+}
+
+/**
+ * The same frame the game would give a command issued now: run ahead frames out, but never
+ * earlier than one we've already issued commands for.
+ */
+UnsignedInt NetworkSoak::getExecutionFrame( Int c )
+{
+	SoakClient *client = &m_clients[c];
+	UnsignedInt frame = client->frame + client->runAhead;
+	if (frame > client->lastExecutionFrame)
+	{
+		client->lastExecutionFrame = frame;
+	}
+	return client->lastExecutionFrame;
+}
+
+/**
+ * Hand a command from client c to every player in relay, the way
+ * ConnectionManager::sendLocalCommandDirect does.
+ */
+void NetworkSoak::sendLocalCommand( Int c, NetCommandMsg *msg, UnsignedByte relay )
+{
+	SoakClient *client = &m_clients[c];
+	msg->setPlayerID(c);
+	if (DoesCommandRequireACommandID(msg->getNetCommandType()))
+	{
+		// Each machine numbers its own commands; sharing GenerateNextCommandID() between the
+		// clients would break up the runs of IDs NetPacket encodes as repeats.
+		msg->setID(++client->lastCommandID);
+	}
+
+	if ((relay & (1 << c)) && IsCommandSynchronized(msg->getNetCommandType()))
+	{
+		client->frameData[c]->addNetCommandMsg(msg);
+	}
+
+	for (Int p = 0; p < m_numClients; ++p)
+	{
+		if ((relay & (1 << p)) && client->connections[p] != NULL)
+		{
+			client->connections[p]->sendNetCommandMsg(msg, 1 << p);
+		}
+	}
+}
+
+/**
+ * The scripted command stream.  Most frames carry no commands, every few seconds a player
+ * gives an ordinary order, and now and then the first player selects a large group and
+ * orders it around, which is the kind of burst that shows up as lag.
+ */
+void NetworkSoak::issueCommands( Int c )
+{
+	SoakClient *client = &m_clients[c];
+	UnsignedInt frame = client->frame;
+	UnsignedInt hash = (frame * 2654435761U) ^ ((UnsignedInt)(c + 1) * 40503U);
+	Bool bigOrder = (c == 0 && (frame % 300) < 3);
+	if (!bigOrder && ((hash >> 7) % 10) != 0)
+	{
+		return;
+	}
+
+	UnsignedInt executionFrame = getExecutionFrame(c);
+	GameMessageArgumentType arg;
+
+	if (bigOrder)
+	{
+		NetGameCommandMsg *group = newInstance(NetGameCommandMsg);
+		group->setGameMessageType(GameMessage::MSG_CREATE_SELECTED_GROUP);
+		group->setExecutionFrame(executionFrame);
+		arg.boolean = TRUE;
+		group->addArgument(ARGUMENTDATATYPE_BOOLEAN, arg);
+		for (Int i = 0; i < 40; ++i)
+		{
+			arg.objectID = (ObjectID)(100 + i);
+			group->addArgument(ARGUMENTDATATYPE_OBJECTID, arg);
+		}
+		sendLocalCommand(c, group, 0xff);
+		group->detach();
+	}
+
+	NetGameCommandMsg *move = newInstance(NetGameCommandMsg);
+	move->setGameMessageType(GameMessage::MSG_DO_MOVETO);
+	move->setExecutionFrame(executionFrame);
+	arg.location.x = (Real)((hash >> 12) % 4000);
+	arg.location.y = (Real)((hash >> 20) % 4000);
+	arg.location.z = 0;
+	move->addArgument(ARGUMENTDATATYPE_LOCATION, arg);
+	sendLocalCommand(c, move, 0xff);
+	move->detach();
+}
+
+/**
+ * Client c has moved on to a new logic frame.  Like Network::processCommand, send the command
+ * count for every frame we can no longer issue commands for, then issue this frame's commands.
+ */
+void NetworkSoak::startFrame( Int c )
+{
+	SoakClient *client = &m_clients[c];
+	UnsignedInt executionFrame = getExecutionFrame(c);
+	for (UnsignedInt frame = client->lastFrameCompleted + 1; frame < executionFrame; ++frame)
+	{
+		NetFrameCommandMsg *msg = newInstance(NetFrameCommandMsg);
+		msg->setExecutionFrame(frame);
+		msg->setCommandCount(client->frameData[c]->getCommandCount(frame));
+		client->frameInfoTime[frame % SOAK_FRAME_WINDOW] = m_simulator.getTime();
+		sendLocalCommand(c, msg, 0xff & ~(1 << c));
+		msg->detach();
+		client->lastFrameCompleted = frame;
+	}
+
+	issueCommands(c);
+}
+
+/**
+ * One command that arrived for client c, handled the way ConnectionManager handles it.
+ */
+void NetworkSoak::processCommand( Int c, NetCommandRef *ref )
+{
+	SoakClient *client = &m_clients[c];
+	NetCommandMsg *msg = ref->getCommand();
+	Int p = msg->getPlayerID();
+	if (p < 0 || p >= m_numClients || p == c)
+	{
+		return;
+	}
+	Connection *connection = client->connections[p];
+
+	if (CommandRequiresAck(msg))
+	{
+		// Nothing is relayed, so every ack acks both stages, and goes straight back.
+		NetAckBothCommandMsg *ack = newInstance(NetAckBothCommandMsg)(msg);
+		ack->setPlayerID(c);
+		connection->sendNetCommandMsg(ack, 1 << p);
+		ack->detach();
+	}
+
+	NetCommandType type = msg->getNetCommandType();
+	if (type == NETCOMMANDTYPE_ACKSTAGE1 || type == NETCOMMANDTYPE_ACKBOTH)
+	{
+		NetCommandRef *acked = connection->processAck(msg);
+		if (acked != NULL)
+		{
+			// Round trip times come from frame info acks, like FrameMetrics::processLatencyResponse.
+			if (acked->getCommand()->getNetCommandType() == NETCOMMANDTYPE_FRAMEINFO)
+			{
+				UnsignedInt frame = acked->getCommand()->getExecutionFrame();
+				if (client->lastFrameCompleted - frame < SOAK_FRAME_WINDOW)
+				{
+					Real latency = (Real)(m_simulator.getTime() - client->frameInfoTime[frame % SOAK_FRAME_WINDOW]) / (Real)1000;
+					client->averageLatency += (latency - client->averageLatency) / TheGlobalData->m_networkLatencyHistoryLength;
+				}
+			}
+			acked->deleteInstance();
+		}
+		return;
+	}
+
+	// Resends of frames we've already executed would land on the frame FRAME_DATA_LENGTH later.
+	if (IsCommandSynchronized(type) && msg->getExecutionFrame() < client->frame)
+	{
+		return;
+	}
+
+	if (type == NETCOMMANDTYPE_FRAMEINFO)
+	{
+		client->frameData[p]->setFrameCommandCount(msg->getExecutionFrame(), ((NetFrameCommandMsg *)msg)->getCommandCount());
+	}
+	else if (IsCommandSynchronized(type))
+	{
+		client->frameData[p]->addNetCommandMsg(msg);
+	}
+}
+
+/**
+ * Take everything the transport has for client c and process it command by command.
+ */
+void NetworkSoak::receive( Int c )
+{
+	Transport *transport = m_clients[c].transport;
+	transport->doRecv();
+
+	for (Int i = 0; i < MAX_MESSAGES; ++i)
+	{
+		if (transport->m_inBuffer[i].length == 0)
+		{
+			continue;
+		}
+
+		NetPacket *packet = newInstance(NetPacket)(&transport->m_inBuffer[i]);
+		NetCommandList *cmdList = packet->getCommandList();
+		for (NetCommandRef *ref = cmdList->getFirstMessage(); ref != NULL; ref = ref->getNext())
+		{
+			processCommand(c, ref);
+		}
+		cmdList->deleteInstance();
+		packet->deleteInstance();
+
+		transport->m_inBuffer[i].length = 0;
+	}
+}
+
+/**
+ * Lockstep, from ConnectionManager::allCommandsReady: the frame can run once every player's
+ * frame data has as many commands as that player said it would.
+ */
+Bool NetworkSoak::allCommandsReady( Int c )
+{
+	SoakClient *client = &m_clients[c];
+	Bool ready = TRUE;
+	Bool resend = FALSE;
+	Int p;
+	for (p = 0; p < m_numClients; ++p)
+	{
+		FrameDataReturnType result = client->frameData[p]->allCommandsReady(client->frame, FALSE);
+		if (result == FRAMEDATA_NOTREADY)
+		{
+			ready = FALSE;
+		}
+		else if (result == FRAMEDATA_RESEND)
+		{
+			ready = FALSE;
+			resend = TRUE;
+		}
+	}
+
+	if (resend)
+	{
+		// The game asks for the frame again here; we only count it, since it means the commands didn't add up.
+		++client->frameDataResets;
+		for (p = 0; p < m_numClients; ++p)
+		{
+			if (p != c)
+			{
+				client->frameData[p]->resetFrame(client->frame, FALSE);
+			}
+		}
+	}
+
+	return ready;
+}
+
+/**
+ * Run client c's current frame: take its commands out of the frame data, act on any run ahead
+ * change among them, and let go of the frame FRAMES_TO_KEEP back.
+ */
+void NetworkSoak::executeFrame( Int c )
+{
+	SoakClient *client = &m_clients[c];
+	for (Int p = 0; p < m_numClients; ++p)
+	{
+		NetCommandList *list = client->frameData[p]->getFrameCommandList(client->frame);
+		for (NetCommandRef *ref = list->getFirstMessage(); ref != NULL; ref = ref->getNext())
+		{
+			NetCommandMsg *msg = ref->getCommand();
+			if (msg->getNetCommandType() == NETCOMMANDTYPE_GAMECOMMAND)
+			{
+				++client->executedCommands;
+			}
+			else if (msg->getNetCommandType() == NETCOMMANDTYPE_RUNAHEAD)
+			{
+				// Network::processRunAheadCommand
+				NetRunAheadCommandMsg *runAheadMsg = (NetRunAheadCommandMsg *)msg;
+				client->runAhead = runAheadMsg->getRunAhead();
+				client->frameRate = runAheadMsg->getFrameRate();
+				Int frameGrouping = RunAheadController::ComputeFrameGrouping(client->runAhead, client->frameRate, client->frameGrouping);
+				if (frameGrouping != client->frameGrouping)
+				{
+					client->frameGrouping = frameGrouping;
+					// The packet router sends twice as often, see ConnectionManager::setFrameGrouping.
+					Int grouping = (c == 0) ? frameGrouping / 2 : frameGrouping;
+					for (Int i = 0; i < m_numClients; ++i)
+					{
+						if (client->connections[i] != NULL)
+						{
+							client->connections[i]->setFrameGrouping(grouping);
+						}
+					}
+				}
+			}
+		}
+		if (client->frame > (UnsignedInt)FRAMES_TO_KEEP)
+		{
+			client->frameData[p]->resetFrame(client->frame - FRAMES_TO_KEEP);
+		}
+	}
+
+	++client->frame;
+	++client->executedFrames;
+}
+
+void NetworkSoak::run( Int numClients, Int numFrames )
+{
+	if (numClients < 2)
+	{
+		numClients = 2;
+	}
+	if (numClients > MAX_SOAK_CLIENTS)
+	{
+		numClients = MAX_SOAK_CLIENTS;
+	}
+	m_numClients = numClients;
+
+	// The link conditions come from the same settings the transport uses for its own latency insertion.
+	NetLinkConditions conditions;
+	conditions.latency = TheGlobalData->m_latencyAverage;
+	conditions.jitter = TheGlobalData->m_latencyNoise;
+	conditions.packetLoss = TheGlobalData->m_packetLoss;
+	conditions.bandwidth = TheGlobalData->m_packetBandwidth;
+	m_simulator.reset();
+	m_simulator.setDefaultLinkConditions(conditions);
+	m_simulator.setManualClock(TRUE);
+
+	// Network::init's starting run ahead, kept small enough for our frame info window.
+	Int runAhead = min(max(30, MIN_RUNAHEAD), MAX_FRAMES_AHEAD/2);
+	if (runAhead >= SOAK_FRAME_WINDOW / 2)
+	{
+		runAhead = SOAK_FRAME_WINDOW / 2 - 1;
+	}
+	Int frameRate = TheGlobalData->m_framesPerSecondLimit;
+	if (frameRate <= 0)
+	{
+		frameRate = 30;
+	}
+	m_runAheadChanges = 0;
+	m_runAheadController.reset();
+	m_runAheadController.setCurrent(runAhead, frameRate);
+
+	Int c, p, i;
+	for (c = 0; c < m_numClients; ++c)
+	{
+		SoakClient *client = &m_clients[c];
+		client->addr = SOAK_BASE_ADDR + c;
+		client->port = SOAK_PORT;
+		if (client->transport == NULL)
+		{
+			client->transport = NEW Transport;
+		}
+		client->transport->init(&m_simulator, client->addr, client->port);
+
+		client->frame = 1;		// the game starts on frame 1
+		client->lastFrameCompleted = runAhead - 1;
+		client->lastExecutionFrame = runAhead - 1;
+		client->runAhead = runAhead;
+		client->frameRate = frameRate;
+		client->frameGrouping = 0;
+		client->nextFrameTime = 0;
+		client->lastFrameTime = 0;
+		client->stallStart = 0;
+		client->executedFrames = 0;
+		client->executedCommands = 0;
+		client->stalls = 0;
+		client->stallTime = 0;
+		client->frameDataResets = 0;
+		client->lastCommandID = 64000;		// where GenerateNextCommandID() starts
+		client->averageLatency = (Real)0.2;
+		for (i = 0; i < FRAME_TIME_BUCKETS; ++i)
+		{
+			client->frameTimes[i] = 0;
+		}
+		for (i = 0; i < SOAK_FRAME_WINDOW; ++i)
+		{
+			client->frameInfoTime[i] = 0;
+		}
+	}
+
+	// Set up the way ConnectionManager::parseUserList and Network::parseUserList do.
+	for (c = 0; c < m_numClients; ++c)
+	{
+		SoakClient *client = &m_clients[c];
+		for (p = 0; p < m_numClients; ++p)
+		{
+			if (p != c)
+			{
+				if (client->connections[p] == NULL)
+				{
+					client->connections[p] = newInstance(Connection)();
+				}
+				client->connections[p]->init();
+				client->connections[p]->attachTransport(client->transport);
+				client->connections[p]->setUser(newInstance(User)(UnicodeString::TheEmptyString, m_clients[p].addr, m_clients[p].port));
+				if (TheGlobalData->m_networkPacketPacking)
+				{
+					client->transport->setPeerPacking(m_clients[p].addr, m_clients[p].port, TRUE);
+				}
+			}
+
+			if (client->frameData[p] == NULL)
+			{
+				client->frameData[p] = newInstance(FrameDataManager)(p == c);
+			}
+			client->frameData[p]->init();
+			client->frameData[p]->reset();
+			client->frameData[p]->zeroFrames(1, runAhead - 1);
+		}
+	}
+
+	DEBUG_LOG(("NetworkSoak - %d clients, %d frames, latency %dms, jitter %dms, loss %d%%, bandwidth %d bytes/sec\n",
+		m_numClients, numFrames, conditions.latency, conditions.jitter, conditions.packetLoss, conditions.bandwidth));
+
+	UnsignedInt lastMetricsTime = 0;
+
+	// A game that can't get anywhere in this long is never going to finish.
+	UnsignedInt timeLimit = (UnsignedInt)numFrames * 1000;
+
+	// Start the clock at 1, a stall start of 0 means "not stalled".
+	UnsignedInt now = 1;
+	m_simulator.setTime(now);
+	for (c = 0; c < m_numClients; ++c)
+	{
+		startFrame(c);
+	}
+
+	for (;;)
+	{
+		m_simulator.setTime(now);
+
+		for (c = 0; c < m_numClients; ++c)
+		{
+			receive(c);
+		}
+
+		Bool allDone = TRUE;
+		for (c = 0; c < m_numClients; ++c)
+		{
+			SoakClient *client = &m_clients[c];
+			if (client->executedFrames >= (UnsignedInt)numFrames)
+			{
+				continue;
+			}
+			allDone = FALSE;
+
+			if (now < client->nextFrameTime)
+			{
+				continue;
+			}
+
+			if (!allCommandsReady(c))
+			{
+				if (client->stallStart == 0)
+				{
+					client->stallStart = now;
+					++client->stalls;
+				}
+				continue;
+			}
+
+			if (client->stallStart != 0)
+			{
+				client->stallTime += now - client->stallStart;
+				client->stallStart = 0;
+			}
+
+			if (client->executedFrames > 0)
+			{
+				Int bucket = (Int)(now - client->lastFrameTime);
+				if (bucket >= FRAME_TIME_BUCKETS)
+				{
+					bucket = FRAME_TIME_BUCKETS - 1;
+				}
+				++client->frameTimes[bucket];
+			}
+			client->lastFrameTime = now;
+			executeFrame(c);
+
+			// Like the game, don't try to catch up on frames we lost while stalled.
+			client->nextFrameTime += 1000 / client->frameRate;
+			if (client->nextFrameTime < now)
+			{
+				client->nextFrameTime = now + 1000 / client->frameRate;
+			}
+
+			startFrame(c);
+		}
+
+		if (allDone)
+		{
+			break;
+		}
+
+		if (now > timeLimit)
+		{
+			DEBUG_CRASH(("NetworkSoak - game stopped making progress after %dms", now));
+			break;
+		}
+
+		// Client 0 plays packet router and picks the run ahead the way ConnectionManager::updateRunAhead
+		// does.  The frame rate it gets from each player is how fast that player can draw, and the
+		// simulated players have nothing slowing them down, so they all report the frame rate limit.
+		if ((now - lastMetricsTime) >= (UnsignedInt)TheGlobalData->m_networkRunAheadMetricsTime)
+		{
+			UnsignedInt playerMask = 0;
+			for (c = 0; c < m_numClients; ++c)
+			{
+				m_runAheadController.addLatencySample(c, m_clients[c].averageLatency);
+				m_runAheadController.addFpsSample(c, TheGlobalData->m_framesPerSecondLimit);
+				playerMask |= 1 << c;
+			}
+			lastMetricsTime = now;
+
+			if (m_runAheadController.update(now, playerMask))
+			{
+				SoakClient *router = &m_clients[0];
+				Int newRunAhead = m_runAheadController.getRunAhead();
+				if (newRunAhead >= SOAK_FRAME_WINDOW / 2)
+				{
+					newRunAhead = SOAK_FRAME_WINDOW / 2 - 1;
+				}
+
+				NetRunAheadCommandMsg *msg = newInstance(NetRunAheadCommandMsg);
+				UnsignedInt executionFrame = getExecutionFrame(0);
+				if (executionFrame < router->frame + router->runAhead)
+				{
+					executionFrame = router->frame + router->runAhead;
+				}
+				msg->setExecutionFrame(executionFrame);
+				msg->setRunAhead(newRunAhead);
+				msg->setFrameRate(m_runAheadController.getFrameRate());
+				sendLocalCommand(0, msg, 0xff);
+				msg->detach();
+
+				DEBUG_LOG(("NetworkSoak - %dms: run ahead %d -> %d, frame rate %d -> %d on frame %d (sent on frame %d)\n",
+					now, router->runAhead, newRunAhead, router->frameRate, m_runAheadController.getFrameRate(), executionFrame, router->frame));
+				++m_runAheadChanges;
+			}
+		}
+
+		// ConnectionManager::update: the connections packetize what's due, then the transport sends it.
+		for (c = 0; c < m_numClients; ++c)
+		{
+			SoakClient *client = &m_clients[c];
+			for (p = 0; p < m_numClients; ++p)
+			{
+				if (client->connections[p] != NULL)
+				{
+					client->connections[p]->doSend();
+				}
+			}
+			client->transport->doSend();
+		}
+
+		++now;
+	}
+
+	DEBUG_LOG(("NetworkSoak - finished after %dms of simulated time\n", now));
+	logResults(now);
+	m_simulator.logStatistics();
+
+	for (c = 0; c < m_numClients; ++c)
+	{
+		for (p = 0; p < m_numClients; ++p)
+		{
+			m_clients[c].frameData[p]->destroyGameMessages();
+		}
+	}
+}
+
+void NetworkSoak::logResults( UnsignedInt elapsed )
+{
+	UnsignedInt frameTimes[FRAME_TIME_BUCKETS];
+	UnsignedInt totalFrames = 0;
+	Int i;
+	for (i = 0; i < FRAME_TIME_BUCKETS; ++i)
+	{
+		frameTimes[i] = 0;
+	}
+
+	Real packedBytes = 0;
+	Real payloadBytes = 0;
+	for (Int c = 0; c < m_numClients; ++c)
+	{
+		SoakClient *client = &m_clients[c];
+		UnsignedInt resends = 0;
+		for (Int p = 0; p < m_numClients; ++p)
+		{
+			if (client->connections[p] != NULL)
+			{
+				resends += client->connections[p]->getTotalRetries();
+			}
+		}
+		Real packed = client->transport->getOutgoingBytesPerSecond();
+		Real payload = client->transport->getOutgoingPayloadBytesPerSecond();
+		packedBytes += packed;
+		payloadBytes += payload;
+
+		DEBUG_LOG(("NetworkSoak - client %d: %d frames, %d game commands, %d stalls (%dms), %d commands resent, %d frame data resets, latency %f, %f bytes/sec out (%f before packing)\n",
+			c, client->executedFrames, client->executedCommands, client->stalls, client->stallTime, resends, client->frameDataResets,
+			client->averageLatency, packed, payload));
+		DEBUG_ASSERTCRASH(client->executedCommands == m_clients[0].executedCommands,
+			("NetworkSoak - client %d executed %d game commands, client 0 executed %d", c, client->executedCommands, m_clients[0].executedCommands));
+		for (i = 0; i < FRAME_TIME_BUCKETS; ++i)
+		{
+			frameTimes[i] += client->frameTimes[i];
+			totalFrames += client->frameTimes[i];
+		}
+	}
+
+	DEBUG_LOG(("NetworkSoak - all clients: %f bytes/sec out, %f before packing (%f%%)\n",
+		packedBytes, payloadBytes, (payloadBytes > 0) ? (packedBytes * 100 / payloadBytes) : (Real)100));
+	if (elapsed < MAX_TRANSPORT_STATISTICS_SECONDS * 1000)
+	{
+		DEBUG_LOG(("NetworkSoak - the transport averages bytes/sec over %d seconds and this run took %dms, so those figures are low\n",
+			MAX_TRANSPORT_STATISTICS_SECONDS, elapsed));
+	}
+
+	// Percentiles of the time between frames, across every client.
+	const Int numPercentiles = 4;
+	const Int percentiles[numPercentiles] = { 50, 95, 99, 100 };
+	Int results[numPercentiles];
+	UnsignedInt count = 0;
+	Int next = 0;
+	for (i = 0; i < FRAME_TIME_BUCKETS && next < numPercentiles; ++i)
+	{
+		count += frameTimes[i];
+		while (next < numPercentiles && count * 100 >= totalFrames * percentiles[next] && count > 0)
+		{
+			results[next++] = i;
+		}
+	}
+	while (next < numPercentiles)
+	{
+		results[next++] = FRAME_TIME_BUCKETS - 1;
+	}
+
+	DEBUG_LOG(("NetworkSoak - frame time p50 %dms, p95 %dms, p99 %dms, max %dms%s; %d run ahead changes, final run ahead %d at %d fps\n",
+		results[0], results[1], results[2], results[3], (results[3] == FRAME_TIME_BUCKETS - 1) ? " or more" : "",
+		m_runAheadChanges, m_clients[0].runAhead, m_clients[0].frameRate));
+	m_runAheadController.logTelemetry();
+}
+
+#endif // defined(_DEBUG) || defined(_INTERNAL)
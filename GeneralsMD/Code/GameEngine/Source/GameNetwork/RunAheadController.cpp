@@ -0,0 +1,379 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+////////// RunAheadController.cpp ///////////////////////////
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+
+#include "Common/GlobalData.h"
+#include "GameNetwork/RunAheadController.h"
+#include "GameNetwork/ConnectionManager.h"
+
+static const char *s_decisionReasonNames[RunAheadController::DECISION_COUNT] =
+{
+	"no change",
+	"increase",
+	"decrease",
+	"hold",
+	"frame rate"
+};
+
+RunAheadController::RunAheadController()
+{
+	reset();
+}
+
+void RunAheadController::reset( void )
+{
+	for (Int i = 0; i < MAX_SLOTS; ++i)
+	{
+		m_numLatencySamples[i] = 0;
+		m_nextLatencySample[i] = 0;
+		m_smoothedFps[i] = -1;
+	}
+
+	m_runAhead = 0;
+	m_frameRate = 0;
+	m_minFpsPlayer = -1;
+	m_decreaseVotes = 0;
+
+	m_numDecisions = 0;
+	for (Int r = 0; r < DECISION_COUNT; ++r)
+	{
+		m_decisionCounts[r] = 0;
+	}
+}
+
+void RunAheadController::setCurrent( Int runAhead, Int frameRate )
+{
+	m_runAhead = runAhead;
+	m_frameRate = frameRate;
+	m_decreaseVotes = 0;
+}
+
+void RunAheadController::addLatencySample( Int slot, Real latency )
+{
+	if ((slot < 0) || (slot >= MAX_SLOTS) || (latency <= 0.0))
+	{
+		return; // a player that hasn't measured anything yet reports 0.
+	}
+
+	m_latencySamples[slot][m_nextLatencySample[slot]] = latency;
+	m_nextLatencySample[slot] = (m_nextLatencySample[slot] + 1) % LATENCY_WINDOW;
+	if (m_numLatencySamples[slot] < LATENCY_WINDOW)
+	{
+		++m_numLatencySamples[slot];
+	}
+}
+
+void RunAheadController::addFpsSample( Int slot, Int fps )
+{
+	if ((slot < 0) || (slot >= MAX_SLOTS) || (fps < 0))
+	{
+		return;
+	}
+
+	// The reports are already averaged over NetworkFPSHistoryLength seconds on the player's machine,
+	// this just keeps a single odd report from moving the game's frame rate.
+	if (m_smoothedFps[slot] < 0)
+	{
+		m_smoothedFps[slot] = (Real)fps;
+	}
+	else
+	{
+		m_smoothedFps[slot] += ((Real)fps - m_smoothedFps[slot]) / 4.0f;
+	}
+}
+
+void RunAheadController::removePlayer( Int slot )
+{
+	if ((slot < 0) || (slot >= MAX_SLOTS))
+	{
+		return;
+	}
+	m_numLatencySamples[slot] = 0;
+	m_nextLatencySample[slot] = 0;
+	m_smoothedFps[slot] = -1;
+}
+
+Real RunAheadController::getLatencyPercentile( Int slot, Int percentile ) const
+{
+	if ((slot < 0) || (slot >= MAX_SLOTS) || (m_numLatencySamples[slot] == 0))
+	{
+		return 0.0f;
+	}
+
+	Int count = m_numLatencySamples[slot];
+	if (count < MIN_LATENCY_SAMPLES)
+	{
+		// Not enough to say anything about the spread, go with the latest report.
+		return m_latencySamples[slot][(m_nextLatencySample[slot] + LATENCY_WINDOW - 1) % LATENCY_WINDOW];
+	}
+
+	// Only a few dozen samples a couple of times a second, so an insertion sort of a copy is fine.
+	Real sorted[LATENCY_WINDOW];
+	for (Int i = 0; i < count; ++i)
+	{
+		Real value = m_latencySamples[slot][i];
+		Int j = i;
+		while ((j > 0) && (sorted[j - 1] > value))
+		{
+			sorted[j] = sorted[j - 1];
+			--j;
+		}
+		sorted[j] = value;
+	}
+
+	return sorted[((count - 1) * percentile) / 100];
+}
+
+Int RunAheadController::getSmoothedFps( Int slot ) const
+{
+	if ((slot < 0) || (slot >= MAX_SLOTS) || (m_smoothedFps[slot] < 0))
+	{
+		return -1;
+	}
+	return REAL_TO_INT(m_smoothedFps[slot]);
+}
+
+/**
+ * The frame rate the game should run at, given the slowest player's smoothed fps.
+ */
+Int RunAheadController::chooseFrameRate( Int minFps ) const
+{
+	Int target = minFps;
+	if ((target >= ((m_frameRate * 9) / 10)) && (target < m_frameRate))
+	{
+		// if the minimum fps is within 10% of the current frame rate, keep the current frame rate.
+		target = m_frameRate;
+	}
+	if (target < MIN_FRAME_RATE)
+	{
+		target = MIN_FRAME_RATE;
+	}
+	if (target > TheGlobalData->m_framesPerSecondLimit)
+	{
+		target = TheGlobalData->m_framesPerSecondLimit;
+	}
+
+	if (target > m_frameRate + MAX_FRAME_RATE_STEP)
+	{
+		target = m_frameRate + MAX_FRAME_RATE_STEP;
+	}
+	else if (target < m_frameRate - MAX_FRAME_RATE_STEP)
+	{
+		target = m_frameRate - MAX_FRAME_RATE_STEP;
+	}
+	return target;
+}
+
+Bool RunAheadController::update( UnsignedInt now, UnsignedInt playerMask )
+{
+	DEBUG_ASSERTCRASH(hasCurrent(), ("RunAheadController::update - no current run ahead to start from"));
+
+	// The commands from one player get to another by way of the packet router, so the path we have to
+	// hide is the two slowest players' round trips added together, like getMaximumLatency.  Their medians
+	// add up, but the chance that both of them hit their worst case at once is small, so only the
+	// bigger of the two spreads is added on top.
+	Real p50[2] = { 0.0f, 0.0f };
+	Real p95[2] = { 0.0f, 0.0f };
+	Int minFps = -1;
+	Int minFpsPlayer = -1;
+	Int i;
+	for (i = 0; i < MAX_SLOTS; ++i)
+	{
+		if ((playerMask & (1 << i)) == 0)
+		{
+			continue;
+		}
+
+		Real median = getLatencyPercentile(i, 50);
+		if (median > p50[0])
+		{
+			p50[1] = p50[0];
+			p95[1] = p95[0];
+			p50[0] = median;
+			p95[0] = getLatencyPercentile(i, 95);
+		}
+		else if (median > p50[1])
+		{
+			p50[1] = median;
+			p95[1] = getLatencyPercentile(i, 95);
+		}
+
+		Int fps = getSmoothedFps(i);
+		if ((fps != -1) && ((minFps == -1) || (fps < minFps)))
+		{
+			minFps = fps;
+			minFpsPlayer = i;
+		}
+	}
+
+	if ((p50[0] == 0.0f) && (minFps == -1))
+	{
+		return FALSE; // nobody has reported anything yet.
+	}
+
+	Real spread = max(p95[0] - p50[0], p95[1] - p50[1]);
+
+	Decision decision;
+	decision.time = now;
+	decision.latencyP50 = p50[0] + p50[1];
+	decision.latencyP95 = p95[0] + p95[1];
+	decision.targetLatency = decision.latencyP50 + spread;
+	decision.minFps = minFps;
+	decision.oldRunAhead = m_runAhead;
+	decision.oldFrameRate = m_frameRate;
+
+	if (minFpsPlayer == -1)
+	{
+		minFpsPlayer = (m_minFpsPlayer != -1) ? m_minFpsPlayer : 0;
+		minFps = m_frameRate;
+	}
+	decision.minFpsPlayer = minFpsPlayer;
+	decision.newFrameRate = chooseFrameRate(minFps);
+	decision.targetRunAhead = ConnectionManager::ComputeRunAhead(decision.targetLatency, decision.newFrameRate);
+
+	Int maxStep = max((Int)TheGlobalData->m_networkRunAheadMaxStep, 1);
+	Int newRunAhead = m_runAhead;
+	decision.reason = DECISION_NO_CHANGE;
+	if (decision.targetRunAhead > m_runAhead)
+	{
+		// Too little run ahead means everyone stalls, so go up right away.
+		newRunAhead = m_runAhead + min(decision.targetRunAhead - m_runAhead, maxStep);
+		m_decreaseVotes = 0;
+		decision.reason = DECISION_INCREASE;
+	}
+	else if (decision.targetRunAhead < (m_runAhead - (Int)TheGlobalData->m_networkRunAheadHysteresis))
+	{
+		// Too much only costs responsiveness, so make sure it wasn't a blip before coming down.  Once it
+		// has been too high for long enough, keep coming down each decision until we're there.
+		if (m_decreaseVotes < DECREASE_HOLD_DECISIONS)
+		{
+			++m_decreaseVotes;
+		}
+		if (m_decreaseVotes >= DECREASE_HOLD_DECISIONS)
+		{
+			newRunAhead = m_runAhead - min(m_runAhead - decision.targetRunAhead, maxStep);
+			decision.reason = DECISION_DECREASE;
+		}
+		else
+		{
+			decision.reason = DECISION_HOLD;
+		}
+	}
+	else
+	{
+		m_decreaseVotes = 0;
+	}
+	decision.newRunAhead = newRunAhead;
+
+	Bool changed = (newRunAhead != m_runAhead) || (decision.newFrameRate != m_frameRate) || (minFpsPlayer != m_minFpsPlayer);
+	if (changed && (decision.reason == DECISION_NO_CHANGE || decision.reason == DECISION_HOLD))
+	{
+		decision.reason = DECISION_FRAME_RATE;
+	}
+
+	m_runAhead = newRunAhead;
+	m_frameRate = decision.newFrameRate;
+	m_minFpsPlayer = minFpsPlayer;
+	recordDecision(decision);
+
+	if (changed)
+	{
+		DEBUG_LOG(("RunAheadController::update - %s: run ahead %d -> %d (target %d), frame rate %d -> %d, latency p50 %f p95 %f planned %f, min fps %d from player %d\n",
+			getDecisionReasonName(decision.reason), decision.oldRunAhead, decision.newRunAhead, decision.targetRunAhead,
+			decision.oldFrameRate, decision.newFrameRate, decision.latencyP50, decision.latencyP95, decision.targetLatency,
+			decision.minFps, decision.minFpsPlayer));
+	}
+	return changed;
+}
+
+void RunAheadController::recordDecision( const Decision &decision )
+{
+	m_decisions[m_numDecisions % DECISION_HISTORY] = decision;
+	++m_numDecisions;
+	++m_decisionCounts[decision.reason];
+}
+
+const RunAheadController::Decision *RunAheadController::getDecision( Int decisionsAgo ) const
+{
+	if ((decisionsAgo < 0) || (decisionsAgo >= DECISION_HISTORY) || (decisionsAgo >= m_numDecisions))
+	{
+		return NULL;
+	}
+	return &m_decisions[(m_numDecisions - 1 - decisionsAgo) % DECISION_HISTORY];
+}
+
+void RunAheadController::logTelemetry( void ) const
+{
+	DEBUG_LOG(("RunAheadController - %d decisions:", m_numDecisions));
+	for (Int r = 0; r < DECISION_COUNT; ++r)
+	{
+		DEBUG_LOG((" %s %d", s_decisionReasonNames[r], m_decisionCounts[r]));
+	}
+	DEBUG_LOG(("; now run ahead %d at %d fps\n", m_runAhead, m_frameRate));
+
+	for (Int i = 0; i < MAX_SLOTS; ++i)
+	{
+		if (m_numLatencySamples[i] > 0 || m_smoothedFps[i] >= 0)
+		{
+			DEBUG_LOG(("RunAheadController - player %d: latency p50 %f p95 %f over %d reports, fps %d\n",
+				i, getLatencyPercentile(i, 50), getLatencyPercentile(i, 95), m_numLatencySamples[i], getSmoothedFps(i)));
+		}
+	}
+}
+
+const char *RunAheadController::getDecisionReasonName( DecisionReason reason )
+{
+	if ((reason < 0) || (reason >= DECISION_COUNT))
+	{
+		return "unknown";
+	}
+	return s_decisionReasonNames[reason];
+}
+
+Int RunAheadController::ComputeFrameGrouping( Int runAhead, Int frameRate, Int oldFrameGrouping )
+{
+	if (frameRate <= 0)
+	{
+		return oldFrameGrouping;
+	}
+
+	Int frameGrouping = (1000 * runAhead) / frameRate; // number of miliseconds between packet sends
+	frameGrouping = frameGrouping / 2; // since we only want the latency for one way to be a factor.
+	if (frameGrouping < 1) {
+		frameGrouping = 1; // Having a value less than 1 doesn't make sense.
+	}
+	if (frameGrouping > 500) {
+		frameGrouping = 500; // Max of a half a second.
+	}
+
+	// Every run ahead step would otherwise change how often we send; small changes aren't worth it.
+	if ((oldFrameGrouping > 0) && (abs(frameGrouping - oldFrameGrouping) * 10 < oldFrameGrouping))
+	{
+		return oldFrameGrouping;
+	}
+	return frameGrouping;
+}
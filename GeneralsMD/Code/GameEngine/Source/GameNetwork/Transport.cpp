@@ -28,6 +28,8 @@
 #include "Common/CRC.h"
 #include "GameNetwork/Transport.h"
 #include "GameNetwork/NetworkInterface.h"
+#include "GameNetwork/NetCompression.h"
+#include "GameNetwork/NetworkSimulator.h"
 
 #ifdef _INTERNAL
 // for occasional debugging...
@@ -76,6 +78,13 @@ Transport::Transport(void)
 {
 	m_winsockInit = false;
 	m_udpsock = NULL;
+	m_useLatency = false;
+	m_usePacketLoss = false;
+#if defined(_DEBUG) || defined(_INTERNAL)
+	m_simulator = NULL;
+	m_simulatedAddr = 0;
+#endif
+	clearPeerPacking();
 }
 
 Transport::~Transport(void)
@@ -130,6 +139,49 @@ Bool Transport::init( UnsignedInt ip, UnsignedShort port )
 		return false;
 	}
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+	m_simulator = NULL;
+#endif
+
+	initBuffers(port);
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+	if (TheGlobalData->m_latencyAverage > 0 || TheGlobalData->m_latencyNoise)
+		m_useLatency = true;
+
+	if (TheGlobalData->m_packetLoss)
+		m_usePacketLoss = true;
+#endif
+
+	return true;
+}
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+/**
+ * Attach to a simulated network rather than binding a socket.  The simulator applies its own
+ * link conditions, so our own latency and packet loss insertion is left off.
+ */
+Bool Transport::init( NetworkSimulator *simulator, UnsignedInt ip, UnsignedShort port )
+{
+	if (m_udpsock)
+	{
+		delete m_udpsock;
+		m_udpsock = NULL;
+	}
+
+	m_simulator = simulator;
+	m_simulatedAddr = ip;
+	m_useLatency = false;
+	m_usePacketLoss = false;
+
+	initBuffers(port);
+
+	return (m_simulator != NULL);
+}
+#endif
+
+void Transport::initBuffers( UnsignedShort port )
+{
 	// ------- Clear buffers --------
 	for (int i=0; i<MAX_MESSAGES; ++i)
 	{
@@ -147,21 +199,13 @@ Bool Transport::init( UnsignedInt ip, UnsignedShort port )
 		m_incomingPackets[i] = 0;
 		m_outgoingPackets[i] = 0;
 		m_unknownPackets[i] = 0;
+		m_outgoingPayloadBytes[i] = 0;
 	}
 	m_statisticsSlot = 0;
-	m_lastSecond = timeGetTime();
+	clearPeerPacking();
+	m_lastSecond = getTime();
 
 	m_port = port;
-
-#if defined(_DEBUG) || defined(_INTERNAL)
-	if (TheGlobalData->m_latencyAverage > 0 || TheGlobalData->m_latencyNoise)
-		m_useLatency = true;
-
-	if (TheGlobalData->m_packetLoss)
-		m_usePacketLoss = true;
-#endif
-
-	return true;
 }
 
 void Transport::reset( void )
@@ -172,6 +216,10 @@ void Transport::reset( void )
 		m_udpsock = NULL;
 	}
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+	m_simulator = NULL;
+#endif
+
 	if (m_winsockInit)
 	{
 		WSACleanup();
@@ -196,7 +244,7 @@ Bool Transport::update( void )
 }
 
 Bool Transport::doSend() {
-	if (!m_udpsock)
+	if (!isOpen())
 	{
 		DEBUG_LOG(("Transport::doSend() - m_udpSock is NULL!\n"));
 		return FALSE;
@@ -205,7 +253,7 @@ Bool Transport::doSend() {
 	Bool retval = TRUE;
 
 	// Statistics gathering
-	UnsignedInt now = timeGetTime();
+	UnsignedInt now = getTime();
 	if (m_lastSecond + 1000 < now)
 	{
 		m_lastSecond = now;
@@ -216,17 +264,27 @@ Bool Transport::doSend() {
 		m_incomingBytes[m_statisticsSlot] = 0;
 		m_unknownPackets[m_statisticsSlot] = 0;
 		m_unknownBytes[m_statisticsSlot] = 0;
+		m_outgoingPayloadBytes[m_statisticsSlot] = 0;
 	}
 
-	// Send all messages
+	// Pack up everything that was queued for packing peers since the last send
 	int i;
+	for (i=0; i<MAX_SLOTS; ++i)
+	{
+		if (m_peers[i].packing && m_peers[i].pendingLen > 0)
+		{
+			flushPeer(&m_peers[i]);
+		}
+	}
+
+	// Send all messages
 	for (i=0; i<MAX_MESSAGES; ++i)
 	{
 		if (m_outBuffer[i].length != 0)
 		{
 			int bytesSent = 0;
 			// Send this message
-			if ((bytesSent = m_udpsock->Write((unsigned char *)(&m_outBuffer[i]), m_outBuffer[i].length + sizeof(TransportMessageHeader), m_outBuffer[i].addr, m_outBuffer[i].port)) > 0)
+			if ((bytesSent = writePacket((unsigned char *)(&m_outBuffer[i]), m_outBuffer[i].length + sizeof(TransportMessageHeader), m_outBuffer[i].addr, m_outBuffer[i].port)) > 0)
 			{
 				//DEBUG_LOG(("Sending %d bytes to %d:%d\n", m_outBuffer[i].length + sizeof(TransportMessageHeader), m_outBuffer[i].addr, m_outBuffer[i].port));
 				m_outgoingPackets[m_statisticsSlot]++;
@@ -275,7 +333,7 @@ Bool Transport::doSend() {
 
 Bool Transport::doRecv() 
 {
-	if (!m_udpsock)
+	if (!isOpen())
 	{
 		DEBUG_LOG(("Transport::doRecv() - m_udpSock is NULL!\n"));
 		return FALSE;
@@ -284,16 +342,14 @@ Bool Transport::doRecv()
 	Bool retval = TRUE;
 
 	// Read in anything on our socket
-	sockaddr_in from;
-#if defined(_DEBUG) || defined(_INTERNAL)
-	UnsignedInt now = timeGetTime();
-#endif
+	UnsignedInt fromAddr;
+	UnsignedShort fromPort;
 
 	TransportMessage incomingMessage;
 	unsigned char *buf = (unsigned char *)&incomingMessage;
 	int len = MAX_MESSAGE_LEN;
 //	DEBUG_LOG(("Transport::doRecv - checking\n"));
-	while ( (len=m_udpsock->Read(buf, MAX_MESSAGE_LEN, &from)) > 0 )
+	while ( (len=readPacket(buf, MAX_MESSAGE_LEN, &fromAddr, &fromPort)) > 0 )
 	{
 #if defined(_DEBUG) || defined(_INTERNAL)
 		// Packet loss simulation
@@ -329,43 +385,34 @@ Bool Transport::doRecv()
 		m_incomingPackets[m_statisticsSlot]++;
 		m_incomingBytes[m_statisticsSlot] += len;
 
-		for (int i=0; i<MAX_MESSAGES; ++i)
+		incomingMessage.addr = fromAddr;
+		incomingMessage.port = fromPort;
+
+		if (incomingMessage.header.magic != GENERALS_MAGIC_NUMBER)
 		{
-#if defined(_DEBUG) || defined(_INTERNAL)
-			// Latency simulation
-			if (m_useLatency)
+			// either way, the sender takes packed packets.
+			TransportPeer *peer = findPeer(incomingMessage.addr, incomingMessage.port);
+			if (peer != NULL && !peer->peerAccepts)
 			{
-				if (m_delayedInBuffer[i].message.length == 0)
-				{
-					// Empty slot; use it
-					m_delayedInBuffer[i].deliveryTime =
-						now + TheGlobalData->m_latencyAverage +
-						(Int)(TheGlobalData->m_latencyAmplitude * sin(now * TheGlobalData->m_latencyPeriod)) +
-						GameClientRandomValue(-TheGlobalData->m_latencyNoise, TheGlobalData->m_latencyNoise);
-					m_delayedInBuffer[i].message.length = incomingMessage.length;
-					m_delayedInBuffer[i].message.addr = ntohl(from.sin_addr.S_un.S_addr);
-					m_delayedInBuffer[i].message.port = ntohs(from.sin_port);
-					memcpy(&m_delayedInBuffer[i].message, buf, len);
-					break;
-				}
+				DEBUG_LOG(("Transport::doRecv - %X:%d takes packed packets\n", incomingMessage.addr, incomingMessage.port));
+				peer->peerAccepts = TRUE;
 			}
-			else
+		}
+
+		if (incomingMessage.header.magic == GENERALS_PACKING_MAGIC_NUMBER)
+		{
+			incomingMessage.header.magic = GENERALS_MAGIC_NUMBER;
+		}
+		else if (incomingMessage.header.magic == GENERALS_PACKED_MAGIC_NUMBER)
+		{
+			if (!unpackMessage( &incomingMessage ))
 			{
-#endif
-				if (m_inBuffer[i].length == 0)
-				{
-					// Empty slot; use it
-					m_inBuffer[i].length = incomingMessage.length;
-					m_inBuffer[i].addr = ntohl(from.sin_addr.S_un.S_addr);
-					m_inBuffer[i].port = ntohs(from.sin_port);
-					memcpy(&m_inBuffer[i], buf, len);
-					break;
-				}
-#if defined(_DEBUG) || defined(_INTERNAL)
+				DEBUG_LOG(("Transport::doRecv - could not unpack %d bytes from %X:%d\n", len, incomingMessage.addr, incomingMessage.port));
 			}
-#endif
+			continue;
 		}
-		//DEBUG_ASSERTCRASH(i<MAX_MESSAGES, ("Message lost!"));
+
+		storeIncomingMessage( &incomingMessage );
 	}
 
 	if (len == -1) {
@@ -377,16 +424,218 @@ Bool Transport::doRecv()
 	return retval;
 }
 
+/**
+ * Put a packet on the wire - the socket, or the simulated network if we're attached to one.
+ */
+Int Transport::writePacket( const UnsignedByte *buf, Int len, UnsignedInt addr, UnsignedShort port )
+{
+#if defined(_DEBUG) || defined(_INTERNAL)
+	if (m_simulator)
+	{
+		return m_simulator->write(m_simulatedAddr, m_port, buf, len, addr, port);
+	}
+#endif
+	return m_udpsock->Write((unsigned char *)buf, len, addr, port);
+}
+
+/**
+ * Take a packet off the wire.  Returns the length read, 0 if there was nothing, or -1 on a socket error.
+ */
+Int Transport::readPacket( UnsignedByte *buf, Int len, UnsignedInt *addr, UnsignedShort *port )
+{
+#if defined(_DEBUG) || defined(_INTERNAL)
+	if (m_simulator)
+	{
+		return m_simulator->read(m_simulatedAddr, m_port, buf, len, addr, port);
+	}
+#endif
+	sockaddr_in from;
+	Int retval = m_udpsock->Read(buf, len, &from);
+	if (retval > 0)
+	{
+		*addr = ntohl(from.sin_addr.S_un.S_addr);
+		*port = ntohs(from.sin_port);
+	}
+	return retval;
+}
+
+/**
+ * A simulator on a hand-driven clock runs far faster than real time, so anything timed
+ * against a transport attached to one has to use the simulator's clock.
+ */
+UnsignedInt Transport::getTime( void ) const
+{
+#if defined(_DEBUG) || defined(_INTERNAL)
+	if (m_simulator)
+	{
+		return m_simulator->getTime();
+	}
+#endif
+	return timeGetTime();
+}
+
+Bool Transport::isOpen( void ) const
+{
+#if defined(_DEBUG) || defined(_INTERNAL)
+	if (m_simulator)
+	{
+		return true;
+	}
+#endif
+	return (m_udpsock != NULL);
+}
+
+void Transport::storeIncomingMessage( TransportMessage *msg )
+{
+#if defined(_DEBUG) || defined(_INTERNAL)
+	UnsignedInt now = timeGetTime();
+#endif
+
+	for (int i=0; i<MAX_MESSAGES; ++i)
+	{
+#if defined(_DEBUG) || defined(_INTERNAL)
+		// Latency simulation
+		if (m_useLatency)
+		{
+			if (m_delayedInBuffer[i].message.length == 0)
+			{
+				// Empty slot; use it
+				m_delayedInBuffer[i].deliveryTime =
+					now + TheGlobalData->m_latencyAverage +
+					(Int)(TheGlobalData->m_latencyAmplitude * sin(now * TheGlobalData->m_latencyPeriod)) +
+					GameClientRandomValue(-TheGlobalData->m_latencyNoise, TheGlobalData->m_latencyNoise);
+				memcpy(&m_delayedInBuffer[i].message, msg, msg->length + sizeof(TransportMessageHeader));
+				m_delayedInBuffer[i].message.length = msg->length;
+				m_delayedInBuffer[i].message.addr = msg->addr;
+				m_delayedInBuffer[i].message.port = msg->port;
+				break;
+			}
+		}
+		else
+		{
+#endif
+			if (m_inBuffer[i].length == 0)
+			{
+				// Empty slot; use it
+				memcpy(&m_inBuffer[i], msg, msg->length + sizeof(TransportMessageHeader));
+				m_inBuffer[i].length = msg->length;
+				m_inBuffer[i].addr = msg->addr;
+				m_inBuffer[i].port = msg->port;
+				break;
+			}
+#if defined(_DEBUG) || defined(_INTERNAL)
+		}
+#endif
+	}
+	//DEBUG_ASSERTCRASH(i<MAX_MESSAGES, ("Message lost!"));
+}
+
+/**
+ * Split a packed packet back into the messages that were queued on the other end, and
+ * store each of them as if it had arrived on its own.
+ */
+Bool Transport::unpackMessage( TransportMessage *msg )
+{
+	if (msg->length < 1)
+		return FALSE;
+
+	UnsignedByte flags = msg->data[0];
+	Int pos = PACKED_HEADER_SIZE;
+
+	if (flags & ~PACKED_FLAG_COMPRESSED)
+		return FALSE;
+
+	UnsignedByte body[PACKED_MAX_BODY];
+	Int bodyLen;
+	if (flags & PACKED_FLAG_COMPRESSED)
+	{
+		bodyLen = NetCompression::decompress(msg->data + pos, msg->length - pos, body, PACKED_MAX_BODY);
+	}
+	else
+	{
+		bodyLen = msg->length - pos;
+		if (bodyLen > PACKED_MAX_BODY)
+			return FALSE;
+		memcpy(body, msg->data + pos, bodyLen);
+	}
+
+	if (bodyLen <= 0)
+		return FALSE;
+
+	TransportMessage entry;
+	entry.header = msg->header;
+	entry.header.magic = GENERALS_MAGIC_NUMBER;
+	entry.addr = msg->addr;
+	entry.port = msg->port;
+
+	Int i = 0;
+	while (i + (Int)sizeof(UnsignedShort) <= bodyLen)
+	{
+		UnsignedShort entryLen;
+		memcpy(&entryLen, body + i, sizeof(UnsignedShort));
+		i += sizeof(UnsignedShort);
+
+		if (entryLen == 0 || i + entryLen > bodyLen)
+			return FALSE;
+
+		memcpy(entry.data, body + i, entryLen);
+		entry.length = entryLen;
+		storeIncomingMessage( &entry );
+		i += entryLen;
+	}
+
+	return TRUE;
+}
+
 Bool Transport::queueSend(UnsignedInt addr, UnsignedShort port, const UnsignedByte *buf, Int len /*,
 						  NetMessageFlags flags, Int id */)
 {
-	int i;
-
 	if (len < 1 || len > MAX_PACKET_SIZE)
 	{
 		return false;
 	}
 
+	m_outgoingPayloadBytes[m_statisticsSlot] += len + sizeof(TransportMessageHeader);
+
+	TransportPeer *peer = findPeer(addr, port);
+	if (peer == NULL)
+	{
+		return queueRawSend(addr, port, GENERALS_MAGIC_NUMBER, buf, len);
+	}
+
+	if (!peer->peerAccepts)
+	{
+		// keep offering until we hear that the other end packs too.
+		return queueRawSend(addr, port, GENERALS_PACKING_MAGIC_NUMBER, buf, len);
+	}
+
+	Int entryLen = len + sizeof(UnsignedShort);
+	if (peer->pendingLen + entryLen > PACKED_MAX_BODY)
+	{
+		// no room left in this update's packet; send what we have so far.
+		if (!flushPeer(peer))
+		{
+			return false;
+		}
+	}
+
+	if (entryLen > PACKED_MAX_BODY)
+	{
+		// too big to ever be packed.
+		return queueRawSend(addr, port, GENERALS_MAGIC_NUMBER, buf, len);
+	}
+
+	UnsignedShort shortLen = (UnsignedShort)len;
+	memcpy(peer->pending + peer->pendingLen, &shortLen, sizeof(UnsignedShort));
+	memcpy(peer->pending + peer->pendingLen + sizeof(UnsignedShort), buf, len);
+	peer->pendingLen += entryLen;
+	return true;
+}
+
+Bool Transport::queueRawSend( UnsignedInt addr, UnsignedShort port, UnsignedShort magic, const UnsignedByte *buf, Int len )
+{
+	int i;
+
 	for (i=0; i<MAX_MESSAGES; ++i)
 	{
 		if (m_outBuffer[i].length == 0)
@@ -398,7 +647,7 @@ Bool Transport::queueSend(UnsignedInt addr, UnsignedShort port, const UnsignedBy
 			m_outBuffer[i].port = port;
 //			m_outBuffer[i].header.flags = flags;
 //			m_outBuffer[i].header.id = id;
-			m_outBuffer[i].header.magic = GENERALS_MAGIC_NUMBER;
+			m_outBuffer[i].header.magic = magic;
 
 			CRC crc;
 			crc.computeCRC( (unsigned char *)(&(m_outBuffer[i].header.magic)), m_outBuffer[i].length + sizeof(TransportMessageHeader) - sizeof(UnsignedInt) );
@@ -416,6 +665,115 @@ Bool Transport::queueSend(UnsignedInt addr, UnsignedShort port, const UnsignedBy
 	return false;
 }
 
+/**
+ * Compress the messages queued for this peer into a single packet and put it on the send queue.
+ * If the send queue is full, the messages stay where they are until the next try.
+ */
+Bool Transport::flushPeer( TransportPeer *peer )
+{
+	if (peer->pendingLen == 0)
+	{
+		return true;
+	}
+
+	UnsignedByte packed[MAX_PACKET_SIZE];
+	Int compressedLen = NetCompression::compress(peer->pending, peer->pendingLen, packed + PACKED_HEADER_SIZE, MAX_PACKET_SIZE - PACKED_HEADER_SIZE);
+
+	// a lone message that doesn't get smaller goes out as it was queued, so packing never
+	// makes a packet bigger than the message it carries.
+	UnsignedShort firstLen;
+	memcpy(&firstLen, peer->pending, sizeof(UnsignedShort));
+	if (firstLen + (Int)sizeof(UnsignedShort) == peer->pendingLen &&
+			(compressedLen == 0 || PACKED_HEADER_SIZE + compressedLen >= firstLen))
+	{
+		if (!queueRawSend(peer->addr, peer->port, GENERALS_MAGIC_NUMBER, peer->pending + sizeof(UnsignedShort), firstLen))
+		{
+			return false;
+		}
+		peer->pendingLen = 0;
+		return true;
+	}
+
+	Int packedLen;
+	if (compressedLen > 0)
+	{
+		packed[0] = PACKED_FLAG_COMPRESSED;
+		packedLen = PACKED_HEADER_SIZE + compressedLen;
+	}
+	else
+	{
+		// didn't compress; the messages still go out as a single packet.
+		packed[0] = 0;
+		memcpy(packed + PACKED_HEADER_SIZE, peer->pending, peer->pendingLen);
+		packedLen = PACKED_HEADER_SIZE + peer->pendingLen;
+	}
+
+	if (!queueRawSend(peer->addr, peer->port, GENERALS_PACKED_MAGIC_NUMBER, packed, packedLen))
+	{
+		return false;
+	}
+
+	peer->pendingLen = 0;
+
+	return true;
+}
+
+void Transport::setPeerPacking( UnsignedInt addr, UnsignedShort port, Bool val )
+{
+	TransportPeer *peer = findPeer(addr, port);
+	if (val == FALSE)
+	{
+		if (peer != NULL)
+		{
+			flushPeer(peer);
+			peer->packing = FALSE;
+		}
+		return;
+	}
+
+	if (peer != NULL)
+	{
+		return;
+	}
+
+	for (Int i=0; i<MAX_SLOTS; ++i)
+	{
+		if (!m_peers[i].packing)
+		{
+			m_peers[i].addr = addr;
+			m_peers[i].port = port;
+			m_peers[i].packing = TRUE;
+			m_peers[i].peerAccepts = FALSE;
+			m_peers[i].pendingLen = 0;
+			DEBUG_LOG(("Transport::setPeerPacking - offering packed packets to %X:%d\n", addr, port));
+			return;
+		}
+	}
+	DEBUG_CRASH(("Transport::setPeerPacking - no free peer slot for %X:%d", addr, port));
+}
+
+void Transport::clearPeerPacking( void )
+{
+	for (Int i=0; i<MAX_SLOTS; ++i)
+	{
+		m_peers[i].packing = FALSE;
+		m_peers[i].peerAccepts = FALSE;
+		m_peers[i].pendingLen = 0;
+	}
+}
+
+Transport::TransportPeer * Transport::findPeer( UnsignedInt addr, UnsignedShort port )
+{
+	for (Int i=0; i<MAX_SLOTS; ++i)
+	{
+		if (m_peers[i].packing && m_peers[i].addr == addr && m_peers[i].port == port)
+		{
+			return &m_peers[i];
+		}
+	}
+	return NULL;
+}
+
 Bool Transport::isGeneralsPacket( TransportMessage *msg )
 {
 	if (!msg)
@@ -431,7 +789,8 @@ Bool Transport::isGeneralsPacket( TransportMessage *msg )
 	if (crc.get() != msg->header.crc)
 		return false;
 
-	if (msg->header.magic != GENERALS_MAGIC_NUMBER)
+	if (msg->header.magic != GENERALS_MAGIC_NUMBER && msg->header.magic != GENERALS_PACKED_MAGIC_NUMBER &&
+			msg->header.magic != GENERALS_PACKING_MAGIC_NUMBER)
 		return false;
 
 	return true;
@@ -504,5 +863,14 @@ Real Transport::getUnknownPacketsPerSecond( void )
 	return val / (MAX_TRANSPORT_STATISTICS_SECONDS-1);
 }
 
-
+Real Transport::getOutgoingPayloadBytesPerSecond( void )
+{
+	Real val = 0.0;
+	for (int i=0; i<MAX_TRANSPORT_STATISTICS_SECONDS; ++i)
+	{
+		if (i != m_statisticsSlot)
+			val += m_outgoingPayloadBytes[i];
+	}
+	return val / (MAX_TRANSPORT_STATISTICS_SECONDS-1);
+}
 
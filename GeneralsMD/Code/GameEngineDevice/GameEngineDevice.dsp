@@ -1165,6 +1165,10 @@ SOURCE=.\Source\W3DDevice\GameClient\TileData.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\Source\W3DDevice\GameClient\W3DAssetLoadQueue.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\Source\W3DDevice\GameClient\W3DAssetManager.cpp
 # End Source File
 # Begin Source File
@@ -1249,6 +1253,10 @@ SOURCE=.\Source\W3DDevice\GameClient\W3DScene.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\Source\W3DDevice\GameClient\W3DSceneCull.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\Source\W3DDevice\GameClient\W3DShaderManager.cpp
 # End Source File
 # Begin Source File
@@ -1533,6 +1541,10 @@ SOURCE=.\Include\W3DDevice\GameClient\TileData.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\Include\W3DDevice\GameClient\W3DAssetLoadQueue.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Include\W3DDevice\GameClient\W3DAssetManager.h
 # End Source File
 # Begin Source File
@@ -1645,6 +1657,10 @@ SOURCE=.\Include\W3DDevice\GameClient\W3DScene.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\Include\W3DDevice\GameClient\W3DSceneCull.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Include\W3DDevice\GameClient\W3DShaderManager.h
 # End Source File
 # Begin Source File
@@ -108,16 +108,27 @@ protected:
 	Int m_numVertexBufferTiles;	///<number of vertex buffers needed to store this heightmap
 	Int	m_numBlockColumnsInLastVB;///<a VB tile may be partially filled, this indicates how many 2x2 vertex blocks are filled.
 	Int	m_numBlockRowsInLastVB;///<a VB tile may be partially filled, this indicates how many 2x2 vertex blocks are filled.
+	UnsignedInt *m_dirtyCellRows;	///<for each VB tile, a mask per row of the cells that still need rebuilding (one bit per cell, so VERTEX_BUFFER_TILE_LENGTH can't exceed 32).
+	Int m_minDisplayHeight;		///<lowest height in the drawn portion of the map, used by updateCenter.
+	Bool m_minDisplayHeightValid;	///<false when the drawn heights may have changed since m_minDisplayHeight was found.
+	Bool m_relightDynamicLights;	///<true when vertex buffers were rebuilt without the dynamic lights, so they all need lighting again.
 
 
 	UnsignedInt doTheDynamicLight(VERTEX_FORMAT *vb, VERTEX_FORMAT *vbMirror, Vector3*light, Vector3*normal, W3DDynamicLight *pLights[], Int numLights);
 	Int getXWithOrigin(Int x);
 	Int getYWithOrigin(Int x);
+	///pick the dynamic lights whose terrain lighting is out of date, at most budget of them
+	Int selectDirtyLights(W3DDynamicLight *pLights[], Int numLights, W3DDynamicLight *pDirtyLights[], Int budget);
 	///update vertex diffuse color for dynamic lights inside given rectangle
 	Int updateVBForLight(DX8VertexBufferClass *pVB, char *data, Int x0, Int y0, Int x1, Int y1, Int originX, Int originY, W3DDynamicLight *pLights[], Int numLights);
 	Int updateVBForLightOptimized(DX8VertexBufferClass	*pVB, char *data, Int x0, Int y0, Int x1, Int y1, Int originX, Int originY, W3DDynamicLight *pLights[], Int numLights);
 	///update vertex buffer vertices inside given rectangle
-	Int updateVB(DX8VertexBufferClass	*pVB, char *data, Int x0, Int y0, Int x1, Int y1, Int originX, Int originY, WorldHeightMap *pMap, RefRenderObjListIterator *pLightsIterator);
+	void updateVB(VERTEX_FORMAT *vbHardware, char *data, Int x0, Int y0, Int x1, Int y1, Int originX, Int originY, WorldHeightMap *pMap, Vector3 *lightRay, RefRenderObjListIterator *pLightsIterator);
+	///flag the cells of a block for rebuilding by the next flushDirtyBlocks
+	void markBlockDirty(Int x0, Int y0, Int x1, Int y1);
+	///rebuild every flagged cell, locking each vertex buffer once
+	void flushDirtyBlocks(WorldHeightMap *pMap, RefRenderObjListIterator *pLightsIterator);
+	Int getMinDisplayHeight(void);
 	///upate vertex buffers associated with the given rectangle
 	void initDestAlphaLUT(void);	///<initialize water depth LUT stored in m_destAlphaTexture
 	void renderTerrainPass(CameraClass *pCamera);	///< renders additional terrain pass.
@@ -0,0 +1,146 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+// FILE: W3DAssetLoadQueue.h //////////////////////////////////////////////////
+//
+// Batched model preloading for map load.  The .w3d files are read from disk
+// in parallel, then registered with the asset manager on the main thread in
+// the order they were asked for.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __W3DASSETLOADQUEUE_H_
+#define __W3DASSETLOADQUEUE_H_
+
+// SYSTEM INCLUDES ////////////////////////////////////////////////////////////
+#include <set>
+#include <vector>
+
+// USER INCLUDES //////////////////////////////////////////////////////////////
+#include "Lib/BaseType.h"
+#include "Common/AsciiString.h"
+#include "GameClient/Display.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// PROTOTYPES /////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+class W3DAssetManager;
+
+//-----------------------------------------------------------------------------
+// W3DAssetLoadProfile
+//-----------------------------------------------------------------------------
+/** Where the time went while preloading, by kind of asset.  Textures that a
+	* mesh loads count towards the mesh.  File reads are added up over every
+	* thread that did them, so they can come to more than the wall clock. */
+//-----------------------------------------------------------------------------
+class W3DAssetLoadProfile
+{
+
+public:
+
+	enum AssetClass
+	{
+		ASSET_FILE_READ,
+		ASSET_HIERARCHY,
+		ASSET_ANIMATION,
+		ASSET_MESH,
+		ASSET_HLOD,
+		ASSET_OTHER_PROTOTYPE,		///< emitters, aggregates, boxes and the rest
+		ASSET_TEXTURE,
+
+		ASSET_CLASS_COUNT
+	};
+
+	W3DAssetLoadProfile() { reset(); }
+
+	void reset(void);
+	void add(AssetClass assetClass, Int64 ticks, Int bytes);
+	void log(Int64 wallTicks) const;		///< results go to the debug log
+
+	static Int64 getTicks(void);
+
+protected:
+
+	Int64 m_ticks[ASSET_CLASS_COUNT];
+	Int m_count[ASSET_CLASS_COUNT];
+	Int m_bytes[ASSET_CLASS_COUNT];
+};
+
+//-----------------------------------------------------------------------------
+// W3DAssetLoadQueue
+//-----------------------------------------------------------------------------
+/** Holds on to the models asked for between begin() and finish().  finish()
+	* works out where each file is on disk on the main thread, reads a window
+	* of them at a time with a WorkerPool, each file through its own handle,
+	* then parses and registers the window in order on the main thread, since
+	* the asset manager isn't thread safe.  The result is the same set of
+	* prototypes, hierarchies and animations, added in the same order, as
+	* loading each model when it was asked for. */
+//-----------------------------------------------------------------------------
+class W3DAssetLoadQueue
+{
+
+public:
+
+	W3DAssetLoadQueue();
+	~W3DAssetLoadQueue();
+
+	void begin(void);
+	Bool isBatching(void) const { return m_batching; }
+
+	void addModel(const char *filename);		///< queue a .w3d file, if it isn't already queued
+	void addTextureTime(Int64 ticks) { m_profile.add(W3DAssetLoadProfile::ASSET_TEXTURE, ticks, 0); }
+
+	/// Load everything queued, on numThreads workers (-1 for one less than the processors).
+	void finish(W3DAssetManager *assetManager, Int numThreads, Display::PreloadProgressCallback *callback);
+
+protected:
+
+	struct LoadEntry
+	{
+		AsciiString m_filename;		///< as asked for, eg. "avtank.w3d"
+		AsciiString m_diskPath;		///< the loose file or archive the bytes are in, empty to load it the usual way
+		UnsignedInt m_offset;			///< of the file within m_diskPath
+		Int m_size;								///< -1 if it's a loose file whose size isn't known yet
+		char *m_data;							///< filled in by the workers
+		Int64 m_readTicks;
+	};
+
+	friend class W3DAssetReadJob;
+
+	void locate(LoadEntry *entry);
+	void registerEntry(W3DAssetManager *assetManager, LoadEntry *entry);
+
+	typedef std::set<AsciiString, std::less<AsciiString> > NameSet;
+
+	std::vector<LoadEntry> m_entries;
+	NameSet m_queuedNames;
+	W3DAssetLoadProfile m_profile;
+	Int64 m_beginTicks;
+	Bool m_batching;
+};  // end class W3DAssetLoadQueue
+
+#endif  // end __W3DASSETLOADQUEUE_H_
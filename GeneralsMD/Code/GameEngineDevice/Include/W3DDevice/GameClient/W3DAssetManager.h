@@ -55,6 +55,7 @@
 class Vector3;
 class VertexMaterialClass;
 class GrannyAnimManagerClass;
+class W3DAssetLoadProfile;
 
 class W3DAssetManager: public WW3DAssetManager
 {
@@ -66,6 +67,7 @@ public:
 	// unique to W3DAssetManager
 	virtual HAnimClass *	Get_HAnim(const char * name);
 	virtual bool Load_3D_Assets( const char * filename ); // This CANNOT be Bool, as it will not inherit properly if you make Bool == Int
+	bool Load_3D_Assets_From_Memory( const char * filename, char * buffer, int size, W3DAssetLoadProfile * profile );	///< register a .w3d file that has already been read
 
 	virtual TextureClass *	Get_Texture
 	(
@@ -89,6 +91,9 @@ public:
 	int replacePrototypeTexture(RenderObjClass *robj, const char * oldname, const char * newname);
 
 private:
+#if defined(_DEBUG) || defined(_INTERNAL)
+	void Report_Preloaded_Asset(const char * filename);
+#endif
 	void Make_Mesh_Unique(RenderObjClass *robj,Bool geometry, Bool colors);
 	void Make_HLOD_Unique(RenderObjClass *robj,Bool geometry, Bool colors);
 	void Make_Unique(RenderObjClass *robj,Bool geometry, Bool colors);
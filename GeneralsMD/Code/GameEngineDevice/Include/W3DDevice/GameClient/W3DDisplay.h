@@ -43,6 +43,7 @@ class VideoBuffer;
 class W3DDebugDisplay;
 class DisplayString;
 class W3DAssetManager;
+class W3DAssetLoadQueue;
 class LightClass;
 class Render2DClass;
 class RTS3DScene;
@@ -138,6 +139,8 @@ public:
 #endif
 	virtual void preloadModelAssets( AsciiString model );			///< preload model asset
 	virtual void preloadTextureAssets( AsciiString texture );	///< preload texture asset
+	virtual void beginPreloadBatch( void );
+	virtual void endPreloadBatch( PreloadProgressCallback *callback );
 
 	/// @todo Need a scene abstraction
 	static RTS3DScene *m_3DScene;							///< our 3d scene representation
@@ -197,6 +200,7 @@ protected:
 	DisplayString *m_benchmarkDisplayString;
 
 	W3DDebugDisplay *m_nativeDebugDisplay;		///< W3D specific debug display interface
+	W3DAssetLoadQueue *m_assetLoadQueue;			///< models held back by preloadModelAssets during a preload batch
 
 };  // end W3DDisplay
 
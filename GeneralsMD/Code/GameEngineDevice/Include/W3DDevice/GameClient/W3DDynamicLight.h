@@ -48,9 +48,16 @@ protected:
 	Bool		m_processMe;
 	
 
-	Int			m_prevMinX, m_prevMinY, m_prevMaxX, m_prevMaxY;
+	Bool		m_dirty;				///< Terrain under the light is being relit this frame.
+
+	Int			m_prevMinX, m_prevMinY, m_prevMaxX, m_prevMaxY;	///< Area last lit into the terrain.
 	Int			m_minX, m_minY, m_maxX, m_maxY;
 
+	/// The light as it was when last lit into the terrain.
+	Vector3	m_appliedPosition;
+	Vector3	m_appliedDiffuse;
+	Real		m_appliedRange;
+
 	Bool		m_enabled;
 
 	Bool		m_decayRange;
@@ -57,6 +57,7 @@ public:
 
 	virtual char const * File_Name(void) const;
 	virtual char const * Set_Name(char const *filename);
+	char const * File_Path(void) const { return m_filePath; }	///< where Set_Name found the file
 
 	// (gth) had to re-instate these functions in the base class, for now just give empty implementations...
 	virtual int Create(void) { assert(0); return 1; }
@@ -37,6 +37,7 @@
 #define __W3DSCENE_H_
 
 // SYSTEM INCLUDES ////////////////////////////////////////////////////////////
+#include <vector>
 
 // USER INCLUDES //////////////////////////////////////////////////////////////
 #include "WW3D2/Scene.h"
@@ -53,6 +54,7 @@ enum CustomScenePassModes;
 class MaterialPassClass;
 class W3DShroudMaterialPassClass;
 class W3DMaskMaterialPassClass;
+class W3DSceneCullSystem;
 //-----------------------------------------------------------------------------
 // RTS3DScene
 //-----------------------------------------------------------------------------
@@ -74,6 +76,11 @@ public:
 	virtual void	Visibility_Check(CameraClass * camera);
 	virtual void  Render(RenderInfoClass & rinfo);
 
+	/// Keep the cull tree in step with the RenderList.
+	virtual void	Add_Render_Object(RenderObjClass * obj);
+	virtual void	Remove_Render_Object(RenderObjClass * obj);
+	virtual void	Remove_All_Render_Objects(void);
+
 	void setCustomPassMode (CustomScenePassModes mode) {m_customPassMode = mode;}
 	CustomScenePassModes getCustomPassMode (void)	{return m_customPassMode;}
 
@@ -103,14 +110,23 @@ public:
 protected:
 	void	renderOneObject(RenderInfoClass &rinfo, RenderObjClass *robj, Int localPlayerIndex);
 	void	updateFixedLightEnvironments(RenderInfoClass & rinfo);
+	void	gatherDynamicLights(void);
 	void flushTranslucentObjects(RenderInfoClass & rinfo);
 	void flushOccludedObjects(RenderInfoClass & rinfo);
 	void flagOccludedObjects(CameraClass * camera);
+	void binOccluders(void);
+	void getOccluderCellRange(RenderObjClass *occluder, Int *x0, Int *y0, Int *x1, Int *y1);
+	Bool isRayOccluded(RayCollisionTestClass &raytest);
+	static Bool clipToSlab(Real start, Real delta, Real lo, Real hi, Real *t0, Real *t1);
+	void checkVisibility(CameraClass * camera, RenderObjClass * robj, Int currentFrame);
+	void checkReflectionVisibility(CameraClass * camera, RenderObjClass * robj);
 	void flushOccludedObjectsIntoStencil(RenderInfoClass & rinfo);
 	void updatePlayerColorPasses(void);
 
 protected:
 	RefRenderObjListClass	m_dynamicLightList;
+	std::vector<W3DDynamicLight *> m_litDynamicLights;	///< dynamic lights bright enough to light anything, gathered by gatherDynamicLights.
+	std::vector<SphereClass> m_litDynamicLightSpheres;	///< bounding sphere of each light in m_litDynamicLights.
 	Bool									m_drawTerrainOnly;
 	LightClass						*m_globalLight[LightEnvironmentClass::MAX_LIGHTS];				///< The global directional light (sun, moon) Applies to objects.
 	LightClass						*m_scratchLight; ///< a workspace for copying global lights and modifying // MLorenzen
@@ -138,6 +154,20 @@ protected:
 	Int m_numPotentialOccludees;
 	Int m_numNonOccluderOrOccludee;	
 
+	// Grid of the potential occluders over the ground, rebuilt by flagOccludedObjects
+	Int *m_occluderCellStart;				///< where each cell's occluders start in m_occluderCellList, plus one past the last cell
+	Int *m_occluderCellList;				///< indices into m_potentialOccluders, grouped by cell
+	Int m_occluderCellListSize;
+	UnsignedInt *m_occluderVisitStamp;	///< the last occludee ray each occluder was tested against
+	UnsignedInt m_occludeeRayStamp;
+	Int m_occluderGridWidth;
+	Int m_occluderGridHeight;
+	Real m_occluderGridOriginX;
+	Real m_occluderGridOriginY;
+	Real m_occluderGridCellSize;
+
+	W3DSceneCullSystem *m_cullSystem;	///< AABTree of the render objects, NULL to test every object in Visibility_Check.
+
 	CameraClass *m_camera;
 };  // end class RTS3DScene
 
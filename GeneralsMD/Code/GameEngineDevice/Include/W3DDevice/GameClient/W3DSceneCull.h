@@ -0,0 +1,123 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+// FILE: W3DSceneCull.h ///////////////////////////////////////////////////////
+//
+// AABTree of the render objects in the 3D scene, so the visibility check
+// only has to look at the objects near the view frustum.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __W3DSCENECULL_H_
+#define __W3DSCENECULL_H_
+
+// SYSTEM INCLUDES ////////////////////////////////////////////////////////////
+#include <map>
+#include <vector>
+
+// USER INCLUDES //////////////////////////////////////////////////////////////
+#include "Lib/BaseType.h"
+#include "WWMath/aabtreecull.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// PROTOTYPES /////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+class RenderObjClass;
+class CameraClass;
+class SphereClass;
+
+//-----------------------------------------------------------------------------
+// W3DSceneCullProxy
+//-----------------------------------------------------------------------------
+/** Stands in for one render object in the tree.  Render objects aren't
+	* cullables themselves, so the proxy carries the cull box for them. */
+//-----------------------------------------------------------------------------
+class W3DSceneCullProxy : public W3DMPO, public CullableClass
+{
+	W3DMPO_GLUE(W3DSceneCullProxy)
+
+public:
+
+	W3DSceneCullProxy(RenderObjClass *robj, UnsignedInt sequence) :
+		m_robj(robj), m_sequence(sequence), m_checkStamp(0), m_index(-1) {}
+
+	RenderObjClass *m_robj;			///< not ref counted, the scene's RenderList holds the reference
+	UnsignedInt m_sequence;			///< when the object was added to the scene
+	UnsignedInt m_checkStamp;		///< the last visibility check this proxy was queued for
+	Int m_index;								///< position in W3DSceneCullSystem::m_proxies
+};
+
+//-----------------------------------------------------------------------------
+// W3DSceneCullSystem
+//-----------------------------------------------------------------------------
+/** Keeps a proxy in an AABTree for every render object in RTS3DScene.  There
+	* is no notification when a render object moves, so each check still makes
+	* one cheap pass over the proxies to find the ones that have left their
+	* (padded) cull box, then collects the frustum from the tree.  The objects
+	* it hands back are every object the tree says could be in view, plus every
+	* object that is currently visible or forced visible, in RenderList order.
+	* Any object not handed back is outside the frustum and already invisible,
+	* so the scene's full check would leave it exactly as it is. */
+//-----------------------------------------------------------------------------
+class W3DSceneCullSystem
+{
+
+public:
+
+	W3DSceneCullSystem();
+	~W3DSceneCullSystem();
+
+	void addRenderObject(RenderObjClass *robj);
+	void removeRenderObject(RenderObjClass *robj);
+	void removeAll(void);
+	Int getNumObjects(void) const { return m_proxies.size(); }
+
+	/// Gather the objects whose visibility has to be checked against this camera, returns how many there are.
+	Int collectObjectsToCheck(CameraClass *camera);
+	RenderObjClass *getObjectToCheck(Int i) const { return m_objectsToCheck[i]->m_robj; }
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+	/// Time the linear check against the tree with synthetic scenes, results go to the debug log.
+	static void runBenchmark(void);
+#endif
+
+protected:
+
+	void setCullBox(W3DSceneCullProxy *proxy, const SphereClass &sphere);
+
+	typedef TypedAABTreeCullSystemClass<W3DSceneCullProxy> ProxyTree;
+	typedef std::map<RenderObjClass *, W3DSceneCullProxy *, std::less<RenderObjClass *> > ProxyMap;
+
+	ProxyTree m_tree;
+	ProxyMap m_proxyMap;
+	std::vector<W3DSceneCullProxy *> m_proxies;
+	std::vector<W3DSceneCullProxy *> m_objectsToCheck;
+	UnsignedInt m_nextSequence;
+	UnsignedInt m_checkStamp;
+	Int m_changesSincePartition;	///< proxies added or moved since the tree was last rebuilt
+};  // end class W3DSceneCullSystem
+
+#endif  // end __W3DSCENECULL_H_
@@ -58,6 +58,7 @@
 #include "dx8indexbuffer.h"
 #include "shader.h"
 #include "vertmaterial.h"
+#include "aabox.h"
 #include "Lib/BaseType.h"
 #include "common/GameType.h"
 #include "Common/AsciiString.h"
@@ -111,7 +112,8 @@ typedef struct {
 	Int			swayType;					///< Which sway array entry we are using.
 
 	Int			firstIndex;				///< First index in the vertex buffer for this tree.
-	Int     bufferNdx;				///< Which vertex buffer this is in.
+	Int     bufferNdx;				///< Which vertex buffer this is in, -1 if it isn't in one.
+	Bool		active;						///< In m_activeTrees, because it is being pushed aside or toppling.
 
 	// Topple parameters. [7/7/2003]
 	Real					m_angularVelocity;				///< Velocity in degrees per frame (or is it radians per frame?)
@@ -195,8 +197,8 @@ public:
 	void setTextureLOD(Int lod);	///<used to adjust maximum mip level sent to hardware.
 	/// Empties the tree buffer. 
 	void clearAllTrees(void);
-	/// Empties the tree buffer.
-	void setBounds(const Region2D &bounds) {m_bounds = bounds;}
+	/// Sets the area covered by the area partition.
+	void setBounds(const Region2D &bounds);
 	/// Draws the trees.  Uses camera for culling.
 	void drawTrees(CameraClass * camera, RefRenderObjListIterator *pDynamicLightsIterator);
 	/// Called when the view changes, and sort key needs to be recalculated.
@@ -220,14 +222,24 @@ private:
 				MAX_SWAY_TYPES = 10,
 				MAX_BUFFERS = 1,
 				SORT_ITERATIONS_PER_FRAME=10};
-	enum {PARTITION_WIDTH_HEIGHT = 100};
+	enum {PARTITION_WIDTH_HEIGHT = 100,
+				CULL_BLOCK_BUCKETS = 10,	///< Partition buckets along each side of a cull block.
+				CULL_BLOCKS_WIDTH_HEIGHT = PARTITION_WIDTH_HEIGHT/CULL_BLOCK_BUCKETS};
 	DX8VertexBufferClass	*m_vertexTree[MAX_BUFFERS];	///<Tree vertex buffer.
 	DX8IndexBufferClass			*m_indexTree[MAX_BUFFERS];	///<indices defining a triangles for the tree drawing.
 	DWORD					m_dwTreePixelShader;	///<handle to D3D pixel shader
 	DWORD					m_dwTreeVertexShader;	///<handle to D3D vertex shader
 
-	Short		m_areaPartition[PARTITION_WIDTH_HEIGHT*PARTITION_WIDTH_HEIGHT];
+	Short		m_areaPartition[PARTITION_WIDTH_HEIGHT*PARTITION_WIDTH_HEIGHT];	///< Every tree, chained through nextInPartition.
 	Region2D m_bounds;
+	MinMaxAABoxClass m_cullBlockBounds[CULL_BLOCKS_WIDTH_HEIGHT*CULL_BLOCKS_WIDTH_HEIGHT];	///< Holds the bounds of every tree in the block.
+	Bool		m_cullBlockHasTrees[CULL_BLOCKS_WIDTH_HEIGHT*CULL_BLOCKS_WIDTH_HEIGHT];
+	Bool		m_cullBlockVisible[CULL_BLOCKS_WIDTH_HEIGHT*CULL_BLOCKS_WIDTH_HEIGHT];	///< False if the block was outside the view at the last cull.
+	Short		m_activeTrees[MAX_TREES];	///< Trees being pushed aside or toppling, the only ones updated each frame.
+	Int			m_numActiveTrees;
+	Short		m_treesToCollapse[MAX_TREES];	///< Removed trees still in the vertex buffer.
+	Short		m_collapseNumVertices[MAX_TREES];	///< Vertex count of each tree in m_treesToCollapse.
+	Int			m_numTreesToCollapse;
 	
 	TextureClass *m_treeTexture;	///<Trees texture
 	Int			m_textureWidth;				///<Width in pixels m_treeTexture;
@@ -278,6 +290,11 @@ protected:
 	void updateTexture(void);
 
 	Int  getPartitionBucket(const Coord3D &pos) const;
+	void addToPartition(Int treeNdx);							 ///< Links a tree into its bucket and grows its cull block.
+	void rebuildPartition(void);
+	void activateTree(Int treeNdx);
+	void deleteTree(Int treeNdx);									 ///< Marks a tree deleted, and takes it out of the vertex buffer.
+	void pushAside(Int treeNdx, const Coord3D *pusherPos, const Coord3D *pusherDirection, ObjectID pusherID);
 
 	void updateTopplingTree(TTree *tree);
 	void applyTopplingForce( TTree *tree, const Coord3D* toppleDirection, Real toppleSpeed,
@@ -121,6 +121,9 @@ protected:
 	VecICoord2D m_boundaries;	///< the in-game boundaries
 	Int m_dataSize;			///< size of m_data.
 	UnsignedByte *m_data;	///< array of z(height) values in the height map.
+
+	/// Level 0 holds the highest corner of each cell, each level above holds the highest of 2x2 entries of the one below.  Built on first use.
+	std::vector< std::vector<UnsignedByte> > m_maxHeightLevels;
 	
   UnsignedByte *m_seismicUpdateFlag;  ///< array of bits to prevent ovelapping physics-update regions from doubling effects on shared cells
   UnsignedInt   m_seismicUpdateWidth; ///< width of the array holding SeismicUpdateFlags
@@ -310,14 +313,25 @@ public:  // Flat tile texture info.
 public:  // modify height value
 	void setRawHeight(Int xIndex, Int yIndex, UnsignedByte height) { 
 		Int ndx = (yIndex*m_width)+xIndex;
-		if ((ndx>=0) && (ndx<m_dataSize) && m_data) m_data[ndx]=height;
+		if ((ndx>=0) && (ndx<m_dataSize) && m_data) {
+			m_data[ndx]=height;
+			if (!m_maxHeightLevels.empty()) updateMaxHeights(xIndex, yIndex);
+		}
 	};
+	/// Call after writing m_data directly, so the max heights get rebuilt.
+	void invalidateMaxHeights(void) { m_maxHeightLevels.clear(); }
+
+public:  // coarse max heights
+	/// Highest height value of any corner of the cells from (minX,minY) to (maxX,maxY).  May look at a few more cells, so it's never too low.
+	UnsignedByte getMaxHeightInCells(Int minX, Int minY, Int maxX, Int maxY);
 public: // Read tile utilities. jba [7/9/2003]
 	static Bool readTiles(InputStream *pStrm, TileData **tiles, Int numRows);
 	static Int countTiles(InputStream *pStrm, Bool *halfTile=NULL);
 
 protected:
 	void setCliffState(Int xIndex, Int yIndex, Bool state);
+	void buildMaxHeights(void);
+	void updateMaxHeights(Int xIndex, Int yIndex);
 
 };
 
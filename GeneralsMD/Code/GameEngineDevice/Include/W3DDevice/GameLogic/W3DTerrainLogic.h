@@ -57,6 +57,7 @@ public:
 	virtual void newMap( Bool saveGame );	///< Initialize the logic for new map.
 
 	virtual Real getGroundHeight( Real x, Real y, Coord3D* normal = NULL ) const;
+	virtual void getGroundHeights( const Coord2D *points, Real *heights, Int count ) const;
 
 	virtual Bool isCliffCell( Real x, Real y) const;			///< is point cliff cell.
 
@@ -1007,6 +1007,70 @@ Real BaseHeightMapRenderObjClass::getHeightMapHeight(Real x, Real y, Coord3D* no
 	return height;
 }
 
+//=============================================================================
+// BaseHeightMapRenderObjClass::getHeightMapHeights
+//=============================================================================
+/** getHeightMapHeight for a batch of points, without the normals.  Each height
+is worked out exactly the way getHeightMapHeight does it, this just looks up
+the height map once for the lot. */
+//=============================================================================
+void BaseHeightMapRenderObjClass::getHeightMapHeights(const Coord2D *points, Real *heights, Int count) const
+{
+  WorldHeightMap *logicHeightMap = TheTerrainVisual?TheTerrainVisual->getLogicHeightMap():m_map;
+	Int i;
+
+  if ( !logicHeightMap )
+  {
+		for (i = 0; i < count; i++)
+			heights[i] = 0;
+		return;
+  }
+
+	const Real MAP_XY_FACTOR_INV = 1.0f / MAP_XY_FACTOR;
+	const UnsignedByte* data = logicHeightMap->getDataPtr();
+	Int borderSize = logicHeightMap->getBorderSizeInline();
+	Int xExtent = logicHeightMap->getXExtent();
+	Int maxX = xExtent-3;
+	Int maxY = logicHeightMap->getYExtent()-3;
+
+	for (i = 0; i < count; i++)
+	{
+		float xdiv = points[i].x * MAP_XY_FACTOR_INV;
+		float ydiv = points[i].y * MAP_XY_FACTOR_INV;
+
+		float ixf = FAST_REAL_FLOOR(xdiv);
+		float iyf = FAST_REAL_FLOOR(ydiv);
+
+		float fx = xdiv - ixf; //get fraction
+		float fy = ydiv - iyf; //get fraction
+
+		Int	ix = fast_float2long_round(ixf) + borderSize;
+		Int	iy = fast_float2long_round(iyf) + borderSize;
+
+		if (ix > maxX || iy > maxY || iy < 1 || ix < 1)
+		{	
+			// sample point is not on the heightmap
+			heights[i] = getClipHeight(ix, iy) * MAP_HEIGHT_SCALE;
+			continue;
+		}
+
+		int idx = ix + iy*xExtent;
+		float p0 = data[idx];
+		float p2 = data[idx + xExtent + 1];
+		if (fy > fx) // test if we are in the upper triangle
+		{	
+			float p3 = data[idx + xExtent];
+			heights[i] = (p3 + (1.0f-fy)*(p0-p3) + fx*(p2-p3)) * MAP_HEIGHT_SCALE;
+		}
+		else
+		{	
+			// we are in the lower triangle
+			float p1 = data[idx + 1];
+			heights[i] = (p1 + fy*(p2-p1) + (1.0f-fx)*(p0-p1)) * MAP_HEIGHT_SCALE;
+		}
+	}
+}
+
 //=============================================================================
 Bool BaseHeightMapRenderObjClass::isClearLineOfSight(const Coord3D& pos, const Coord3D& posOther) const
 {
@@ -1090,52 +1154,115 @@ Bool BaseHeightMapRenderObjClass::isClearLineOfSight(const Coord3D& pos, const C
 	const UnsignedByte* data = logicHeightMap->getDataPtr();
 	Int xExtent = logicHeightMap->getXExtent();
 	Int yExtent = logicHeightMap->getYExtent();
-	for (Int curpixel = 0; curpixel < numpixels; curpixel++)
+
+	// if terrainHeight > z, we can't see, so punt.
+	// add a little fudge to account for slop.
+	const Real LOS_FUDGE = 0.5f;
+
+	// Spans of the line that are well clear of the highest terrain under them are stepped
+	// over without looking at each cell.  The answer is the same as walking every cell.
+	// Only the logic height map keeps its max heights current, so don't skip on any other map.
+	const Int NUM_SPAN_SIZES = 2;
+	static const Int spanSizes[NUM_SPAN_SIZES] = { 32, 8 };
+	const Real SPAN_Z_SLOP = 0.01f;		// more than the rounding from adding up zinc over a span
+	Bool skipSpans = (TheTerrainVisual != NULL);
+
+	Bool done = false;
+	Int curpixel = 0;
+	while (curpixel < numpixels && !done)
 	{
-		if (x < 0 || 
-				y < 0 ||
-				x >= xExtent-1 ||
-				y >= yExtent-1)
+		Bool skipped = false;
+		for (Int i = 0; skipSpans && i < NUM_SPAN_SIZES && !skipped; i++)
 		{
-			// once we go off the map, we're done
-			break;
+			Int span = spanSizes[i];
+			if (curpixel + span > numpixels)
+				continue;
+
+			// the line only moves one way in x and y, so its first and last cells bound the span.
+			Int minorSteps = (num + (span-1)*numadd) / den;
+			Int lastX = x + (span-1)*xinc2 + minorSteps*xinc1;
+			Int lastY = y + (span-1)*yinc2 + minorSteps*yinc1;
+			Int minX = __min(x, lastX);
+			Int minY = __min(y, lastY);
+			Int maxX = __max(x, lastX);
+			Int maxY = __max(y, lastY);
+			if (minX < 0 || minY < 0 || maxX >= xExtent-1 || maxY >= yExtent-1)
+				continue;	// goes off the map, so walk it.
+
+			Real minZ = __min(z, z + (span-1)*zinc) - SPAN_Z_SLOP;
+			Real height = logicHeightMap->getMaxHeightInCells(minX, minY, maxX, maxY) * MAP_HEIGHT_SCALE;
+			if (height > minZ + LOS_FUDGE)
+				continue;
+
+			// nothing in the span blocks, so step over it the same way the walk would have.
+			for (Int k = 0; k < span-1; k++)
+				z += zinc;
+			if (z >= getMaxHeight() && zinc > 0.0f)
+			{
+				done = true;
+				break;
+			}
+			z += zinc;
+
+			num += span*numadd;
+			minorSteps = num / den;
+			num -= minorSteps*den;
+			x += span*xinc2 + minorSteps*xinc1;
+			y += span*yinc2 + minorSteps*yinc1;
+			curpixel += span;
+			skipped = true;
 		}
+		if (skipped || done)
+			continue;
 
-		Int idx = x + y*xExtent;
-		float height = data[idx];
-		height = __max(height, data[idx + 1]);
-		height = __max(height, data[idx + xExtent]);
-		height = __max(height, data[idx + xExtent + 1]);
-		height *= MAP_HEIGHT_SCALE;
-
-		// if terrainHeight > z, we can't see, so punt.
-		// add a little fudge to account for slop.
-		const Real LOS_FUDGE = 0.5f;
-		if (height > z + LOS_FUDGE)
+		Int lastPixel = __min(curpixel + spanSizes[NUM_SPAN_SIZES-1], numpixels);
+		for (; curpixel < lastPixel; curpixel++)
 		{
-			result = false;
-			break;
-		}
+			if (x < 0 || 
+					y < 0 ||
+					x >= xExtent-1 ||
+					y >= yExtent-1)
+			{
+				// once we go off the map, we're done
+				done = true;
+				break;
+			}
 
-		// we're above the max height of the terrain and still looking up, so we're done.
-		// (don't bother for reverse test, since that doesn't generally happen)
-		if (z >= getMaxHeight() && zinc > 0.0f)
-		{
-			break;
-		}
+			Int idx = x + y*xExtent;
+			float height = data[idx];
+			height = __max(height, data[idx + 1]);
+			height = __max(height, data[idx + xExtent]);
+			height = __max(height, data[idx + xExtent + 1]);
+			height *= MAP_HEIGHT_SCALE;
 
-		z += zinc;
+			if (height > z + LOS_FUDGE)
+			{
+				result = false;
+				done = true;
+				break;
+			}
 
-		// continue with the maintenance.
-		num += numadd;										// Increase the numerator by the top of the fraction
-		if (num >= den)										// Check if numerator >= denominator
-		{
-			num -= den;											// Calculate the new numerator value
-			x += xinc1;											// Change the x as appropriate
-			y += yinc1;											// Change the y as appropriate
+			// we're above the max height of the terrain and still looking up, so we're done.
+			// (don't bother for reverse test, since that doesn't generally happen)
+			if (z >= getMaxHeight() && zinc > 0.0f)
+			{
+				done = true;
+				break;
+			}
+
+			z += zinc;
+
+			// continue with the maintenance.
+			num += numadd;										// Increase the numerator by the top of the fraction
+			if (num >= den)										// Check if numerator >= denominator
+			{
+				num -= den;											// Calculate the new numerator value
+				x += xinc1;											// Change the x as appropriate
+				y += yinc1;											// Change the y as appropriate
+			}
+			x += xinc2;												// Change the x as appropriate
+			y += yinc2;												// Change the y as appropriate
 		}
-		x += xinc2;												// Change the x as appropriate
-		y += yinc2;												// Change the y as appropriate
 	}
 	
 	return result;
@@ -105,6 +105,10 @@
 #define no_OPTIMIZED_HEIGHTMAP_LIGHTING	01
 // Doesn't work well.  jba.
 
+#define MAX_RELIT_DYNAMIC_LIGHTS 6				// most dynamic lights to relight the terrain for in one frame
+#define DYNAMIC_LIGHT_COLOR_CHANGE (4.0f/255.0f)	// change in a dynamic light's color that needs relighting
+#define DYNAMIC_LIGHT_MOVE_CHANGE (MAP_XY_FACTOR/4)	// distance a dynamic light moves or grows that needs relighting
+
 const Bool HALF_RES_MESH = false;
 
 HeightMapRenderObjClass *TheHeightMap = NULL;
@@ -149,6 +153,10 @@ void HeightMapRenderObjClass::freeIndexVertexBuffers(void)
 		delete m_vertexBufferBackup;
 		m_vertexBufferBackup = NULL;
 	}
+	if (m_dirtyCellRows) {
+		delete [] m_dirtyCellRows;
+		m_dirtyCellRows = NULL;
+	}
 	m_numVertexBufferTiles = 0;
 
 }
@@ -302,19 +310,33 @@ Int HeightMapRenderObjClass::getYWithOrigin(Int y)
 	return y;
 }
 
+//=============================================================================
+// setTerrainLightRays
+//=============================================================================
+/** Fills in the ray of each global terrain light.  They are the same for every
+vertex, so they are worked out once per update rather than once per cell. */
+//=============================================================================
+static void setTerrainLightRays(Vector3 *lightRay)
+{
+	for (Int lightIndex=0; lightIndex < TheGlobalData->m_numGlobalLights; lightIndex++)
+	{
+		const Coord3D *lightPos=&TheGlobalData->m_terrainLightPos[lightIndex];
+		lightRay[lightIndex].Set(-lightPos->x,-lightPos->y,	-lightPos->z);
+	}
+}
+
 //=============================================================================
 // HeightMapRenderObjClass::updateVB
 //=============================================================================
 /** Update a rectangular block of the given Vertex Buffer. 
 data is expected to be an array same dimensions as current heightmap
-mapped into this VB.
+mapped into this VB.  vbHardware is the locked vertex array of the VB, and
+lightRay holds the rays of the global terrain lights.
 */
 //=============================================================================
-Int HeightMapRenderObjClass::updateVB(DX8VertexBufferClass	*pVB, char *data, Int x0, Int y0, Int x1, Int y1, Int originX, Int originY, WorldHeightMap *pMap, RefRenderObjListIterator *pLightsIterator)
+void HeightMapRenderObjClass::updateVB(VERTEX_FORMAT *vbHardware, char *data, Int x0, Int y0, Int x1, Int y1, Int originX, Int originY, WorldHeightMap *pMap, Vector3 *lightRay, RefRenderObjListIterator *pLightsIterator)
 {
 	Int i,j;
-	Vector3 lightRay[MAX_GLOBAL_LIGHTS];
-	const Coord3D *lightPos;
 	Int xCoord, yCoord;
 	Int vn0,un0,vp1,up1;
 	Vector3 l2r,n2f,normalAtTexel;
@@ -325,249 +347,236 @@ Int HeightMapRenderObjClass::updateVB(DX8VertexBufferClass	*pVB, char *data, Int
 		cellOffset = 2;
 	}
 
-	REF_PTR_SET(m_map, pMap);	//update our heightmap pointer in case it changed since last call.
-	if (m_vertexBufferTiles && pMap)
-	{
 #ifdef _DEBUG
-		assert(x0 >= originX && y0 >= originY && x1>x0 && y1>y0 && x1<=originX+VERTEX_BUFFER_TILE_LENGTH && y1<=originY+VERTEX_BUFFER_TILE_LENGTH);
+	assert(x0 >= originX && y0 >= originY && x1>x0 && y1>y0 && x1<=originX+VERTEX_BUFFER_TILE_LENGTH && y1<=originY+VERTEX_BUFFER_TILE_LENGTH);
 #endif 
 
-		DX8VertexBufferClass::WriteLockClass lockVtxBuffer(pVB);
-		VERTEX_FORMAT *vbHardware = (VERTEX_FORMAT*)lockVtxBuffer.Get_Vertex_Array();
-		VERTEX_FORMAT *vBase = (VERTEX_FORMAT*)data;
-		// Note that we are building the vertex buffer data in the memory buffer, data.
-		// At the bottom, we will copy the final vertex data for one cell into the 
-		// hardware vertex buffer. 
-		
-		for (j=y0; j<y1; j++)
+	VERTEX_FORMAT *vBase = (VERTEX_FORMAT*)data;
+	// Note that we are building the vertex buffer data in the memory buffer, data.
+	// At the bottom, we will copy the final vertex data for one cell into the 
+	// hardware vertex buffer. 
+	
+	for (j=y0; j<y1; j++)
+	{
+		VERTEX_FORMAT *vb = vBase;
+		if (HALF_RES_MESH) {
+			if (j&1) continue;
+			vb += ((j-originY)/2)*vertsPerRow/2;	//skip to correct row in vertex buffer
+			vb += ((x0-originX)/2)*4;		//skip to correct vertex in row.
+		} else {
+			vb += (j-originY)*vertsPerRow;	//skip to correct row in vertex buffer
+			vb += (x0-originX)*4;		//skip to correct vertex in row.
+		}
+		vn0 = getYWithOrigin(j)-cellOffset;
+		if (vn0 < -pMap->getDrawOrgY())
+			vn0=-pMap->getDrawOrgY();
+		vp1 = getYWithOrigin(j+cellOffset)+cellOffset;
+		if (vp1 >= pMap->getYExtent()-pMap->getDrawOrgY())
+			vp1=pMap->getYExtent()-pMap->getDrawOrgY()-1;
+
+		yCoord = getYWithOrigin(j)+pMap->getDrawOrgY();
+		for (i=x0; i<x1; i++)
 		{
-			VERTEX_FORMAT *vb = vBase;
 			if (HALF_RES_MESH) {
-				if (j&1) continue;
-				vb += ((j-originY)/2)*vertsPerRow/2;	//skip to correct row in vertex buffer
-				vb += ((x0-originX)/2)*4;		//skip to correct vertex in row.
-			} else {
-				vb += (j-originY)*vertsPerRow;	//skip to correct row in vertex buffer
-				vb += (x0-originX)*4;		//skip to correct vertex in row.
+				if (i&1) continue;
 			}
-			vn0 = getYWithOrigin(j)-cellOffset;
-			if (vn0 < -pMap->getDrawOrgY())
-				vn0=-pMap->getDrawOrgY();
-			vp1 = getYWithOrigin(j+cellOffset)+cellOffset;
-			if (vp1 >= pMap->getYExtent()-pMap->getDrawOrgY())
-				vp1=pMap->getYExtent()-pMap->getDrawOrgY()-1;
-
-			yCoord = getYWithOrigin(j)+pMap->getDrawOrgY();
-			for (i=x0; i<x1; i++)
-			{
-				if (HALF_RES_MESH) {
-					if (i&1) continue;
-				}
-				un0 = getXWithOrigin(i)-cellOffset;
-				if (un0 < -pMap->getDrawOrgX())
-					un0=-pMap->getDrawOrgX();
-				up1 = getXWithOrigin(i+cellOffset)+cellOffset;
-				if (up1 >= pMap->getXExtent()-pMap->getDrawOrgX())
-					up1=pMap->getXExtent()-pMap->getDrawOrgX()-1;
-				xCoord = getXWithOrigin(i)+pMap->getDrawOrgX();
-
-				//update the 4 vertices in this block
-				float U[4], V[4];
-				UnsignedByte alpha[4];
-				float UA[4], VA[4];
-				Bool flipForBlend = false;			 // True if the blend needs the triangles flipped.
-
-				if (pMap) {
-					pMap->getUVData(getXWithOrigin(i),getYWithOrigin(j),U, V, HALF_RES_MESH);
-					pMap->getAlphaUVData(getXWithOrigin(i),getYWithOrigin(j), UA, VA, alpha, &flipForBlend, HALF_RES_MESH);
-				} 
+			un0 = getXWithOrigin(i)-cellOffset;
+			if (un0 < -pMap->getDrawOrgX())
+				un0=-pMap->getDrawOrgX();
+			up1 = getXWithOrigin(i+cellOffset)+cellOffset;
+			if (up1 >= pMap->getXExtent()-pMap->getDrawOrgX())
+				up1=pMap->getXExtent()-pMap->getDrawOrgX()-1;
+			xCoord = getXWithOrigin(i)+pMap->getDrawOrgX();
+
+			//update the 4 vertices in this block
+			float U[4], V[4];
+			UnsignedByte alpha[4];
+			float UA[4], VA[4];
+			Bool flipForBlend = false;			 // True if the blend needs the triangles flipped.
 
+			if (pMap) {
+				pMap->getUVData(getXWithOrigin(i),getYWithOrigin(j),U, V, HALF_RES_MESH);
+				pMap->getAlphaUVData(getXWithOrigin(i),getYWithOrigin(j), UA, VA, alpha, &flipForBlend, HALF_RES_MESH);
+			} 
 
-				for (Int lightIndex=0; lightIndex < TheGlobalData->m_numGlobalLights; lightIndex++)
-				{
-					lightPos=&TheGlobalData->m_terrainLightPos[lightIndex];
-					lightRay[lightIndex].Set(-lightPos->x,-lightPos->y,	-lightPos->z);
-				}
 
-				//top-left sample
-				l2r.Set(2*MAP_XY_FACTOR,0,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset, getYWithOrigin(j)) - pMap->getDisplayHeight(un0, getYWithOrigin(j))));
-				n2f.Set(0,2*MAP_XY_FACTOR,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i), (getYWithOrigin(j)+cellOffset)) - pMap->getDisplayHeight(getXWithOrigin(i), vn0)));
-				
+			//top-left sample
+			l2r.Set(2*MAP_XY_FACTOR,0,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset, getYWithOrigin(j)) - pMap->getDisplayHeight(un0, getYWithOrigin(j))));
+			n2f.Set(0,2*MAP_XY_FACTOR,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i), (getYWithOrigin(j)+cellOffset)) - pMap->getDisplayHeight(getXWithOrigin(i), vn0)));
+			
 #ifdef ALLOW_TEMPORARIES
-				normalAtTexel= Normalize(Vector3::Cross_Product(l2r,n2f));
+			normalAtTexel= Normalize(Vector3::Cross_Product(l2r,n2f));
 #else
-				Vector3::Normalized_Cross_Product(l2r, n2f, &normalAtTexel);
+			Vector3::Normalized_Cross_Product(l2r, n2f, &normalAtTexel);
 #endif
 
-				vb->x=xCoord;
-				vb->y=yCoord;
-				vb->z=  ((float)pMap->getDisplayHeight(getXWithOrigin(i), getYWithOrigin(j)))*MAP_HEIGHT_SCALE;
-				vb->x = ADJUST_FROM_INDEX_TO_REAL(vb->x);
-				vb->y = ADJUST_FROM_INDEX_TO_REAL(vb->y);
-				vb->u1=U[0];
-				vb->v1=V[0];
-				vb->u2=UA[0];
-				vb->v2=VA[0];
-				doTheLight(vb, lightRay, &normalAtTexel, pLightsIterator, alpha[0]);
-				vb++;
-
-				//top-right sample
-				l2r.Set(2*MAP_XY_FACTOR,0,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(up1 , getYWithOrigin(j) ) - pMap->getDisplayHeight(getXWithOrigin(i) , getYWithOrigin(j) )));
-				n2f.Set(0,2*MAP_XY_FACTOR,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , (getYWithOrigin(j)+cellOffset) ) - pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , vn0 )));
-				
+			vb->x=xCoord;
+			vb->y=yCoord;
+			vb->z=  ((float)pMap->getDisplayHeight(getXWithOrigin(i), getYWithOrigin(j)))*MAP_HEIGHT_SCALE;
+			vb->x = ADJUST_FROM_INDEX_TO_REAL(vb->x);
+			vb->y = ADJUST_FROM_INDEX_TO_REAL(vb->y);
+			vb->u1=U[0];
+			vb->v1=V[0];
+			vb->u2=UA[0];
+			vb->v2=VA[0];
+			doTheLight(vb, lightRay, &normalAtTexel, pLightsIterator, alpha[0]);
+			vb++;
+
+			//top-right sample
+			l2r.Set(2*MAP_XY_FACTOR,0,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(up1 , getYWithOrigin(j) ) - pMap->getDisplayHeight(getXWithOrigin(i) , getYWithOrigin(j) )));
+			n2f.Set(0,2*MAP_XY_FACTOR,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , (getYWithOrigin(j)+cellOffset) ) - pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , vn0 )));
+			
 #ifdef ALLOW_TEMPORARIES
-				normalAtTexel= Normalize(Vector3::Cross_Product(l2r,n2f));
+			normalAtTexel= Normalize(Vector3::Cross_Product(l2r,n2f));
 #else
-				Vector3::Normalized_Cross_Product(l2r, n2f, &normalAtTexel);
+			Vector3::Normalized_Cross_Product(l2r, n2f, &normalAtTexel);
 #endif
 
-				vb->x=xCoord+cellOffset;
-				vb->y=yCoord;
-				vb->z=  ((float)pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset, getYWithOrigin(j)))*MAP_HEIGHT_SCALE;
-				vb->x = ADJUST_FROM_INDEX_TO_REAL(vb->x);
-				vb->y = ADJUST_FROM_INDEX_TO_REAL(vb->y);
-				vb->u1=U[1];
-				vb->v1=V[1];
-				vb->u2=UA[1];
-				vb->v2=VA[1];
-				doTheLight(vb, lightRay, &normalAtTexel, pLightsIterator, alpha[1]);
-				vb++;
-
-				//bottom-right sample
-				l2r.Set(2*MAP_XY_FACTOR,0,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(up1 , (getYWithOrigin(j)+cellOffset) ) - pMap->getDisplayHeight(getXWithOrigin(i) , (getYWithOrigin(j)+cellOffset) )));
-				n2f.Set(0,2*MAP_XY_FACTOR,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , vp1 ) - pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , getYWithOrigin(j) )));
-				
+			vb->x=xCoord+cellOffset;
+			vb->y=yCoord;
+			vb->z=  ((float)pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset, getYWithOrigin(j)))*MAP_HEIGHT_SCALE;
+			vb->x = ADJUST_FROM_INDEX_TO_REAL(vb->x);
+			vb->y = ADJUST_FROM_INDEX_TO_REAL(vb->y);
+			vb->u1=U[1];
+			vb->v1=V[1];
+			vb->u2=UA[1];
+			vb->v2=VA[1];
+			doTheLight(vb, lightRay, &normalAtTexel, pLightsIterator, alpha[1]);
+			vb++;
+
+			//bottom-right sample
+			l2r.Set(2*MAP_XY_FACTOR,0,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(up1 , (getYWithOrigin(j)+cellOffset) ) - pMap->getDisplayHeight(getXWithOrigin(i) , (getYWithOrigin(j)+cellOffset) )));
+			n2f.Set(0,2*MAP_XY_FACTOR,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , vp1 ) - pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , getYWithOrigin(j) )));
+			
 #ifdef ALLOW_TEMPORARIES
-				normalAtTexel= Normalize(Vector3::Cross_Product(l2r,n2f));
+			normalAtTexel= Normalize(Vector3::Cross_Product(l2r,n2f));
 #else
-				Vector3::Normalized_Cross_Product(l2r, n2f, &normalAtTexel);
+			Vector3::Normalized_Cross_Product(l2r, n2f, &normalAtTexel);
 #endif
 
-				vb->x=xCoord+cellOffset;
-				if (yCoord + 1 == pMap->getDrawOrgY() + m_y - 1) { 
-					vb->y=yCoord+1;
-				} else {
-					vb->y=yCoord+cellOffset;
-				}
-				vb->z=  ((float)pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset, getYWithOrigin(j)+cellOffset))*MAP_HEIGHT_SCALE;
-				vb->x = ADJUST_FROM_INDEX_TO_REAL(vb->x);
-				vb->y = ADJUST_FROM_INDEX_TO_REAL(vb->y);
-				vb->u1=U[2];
-				vb->v1=V[2];
-				vb->u2=UA[2];
-				vb->v2=VA[2];
-				doTheLight(vb, lightRay, &normalAtTexel, pLightsIterator, alpha[2]);
-				vb++;
-
-				//bottom-left sample
-				l2r.Set(2*MAP_XY_FACTOR,0,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , (getYWithOrigin(j)+cellOffset) ) - pMap->getDisplayHeight(un0 , (getYWithOrigin(j)+cellOffset) )));
-				n2f.Set(0,2*MAP_XY_FACTOR,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i) , vp1 ) - pMap->getDisplayHeight(getXWithOrigin(i) , getYWithOrigin(j) )));
-				
+			vb->x=xCoord+cellOffset;
+			if (yCoord + 1 == pMap->getDrawOrgY() + m_y - 1) { 
+				vb->y=yCoord+1;
+			} else {
+				vb->y=yCoord+cellOffset;
+			}
+			vb->z=  ((float)pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset, getYWithOrigin(j)+cellOffset))*MAP_HEIGHT_SCALE;
+			vb->x = ADJUST_FROM_INDEX_TO_REAL(vb->x);
+			vb->y = ADJUST_FROM_INDEX_TO_REAL(vb->y);
+			vb->u1=U[2];
+			vb->v1=V[2];
+			vb->u2=UA[2];
+			vb->v2=VA[2];
+			doTheLight(vb, lightRay, &normalAtTexel, pLightsIterator, alpha[2]);
+			vb++;
+
+			//bottom-left sample
+			l2r.Set(2*MAP_XY_FACTOR,0,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i)+cellOffset , (getYWithOrigin(j)+cellOffset) ) - pMap->getDisplayHeight(un0 , (getYWithOrigin(j)+cellOffset) )));
+			n2f.Set(0,2*MAP_XY_FACTOR,MAP_HEIGHT_SCALE*(pMap->getDisplayHeight(getXWithOrigin(i) , vp1 ) - pMap->getDisplayHeight(getXWithOrigin(i) , getYWithOrigin(j) )));
+			
 #ifdef ALLOW_TEMPORARIES
-				normalAtTexel= Normalize(Vector3::Cross_Product(l2r,n2f));
+			normalAtTexel= Normalize(Vector3::Cross_Product(l2r,n2f));
 #else
-				Vector3::Normalized_Cross_Product(l2r, n2f, &normalAtTexel);
+			Vector3::Normalized_Cross_Product(l2r, n2f, &normalAtTexel);
 #endif
 
-				if (xCoord == pMap->getDrawOrgX()) { 
-					vb->x=xCoord;
-					//if (vb->x < 0) vb->x = 0;
-				} else {
-					vb->x=xCoord;
-				}
-				if (yCoord + 1 == pMap->getDrawOrgY() + m_y - 1) { 
-					vb->y=yCoord+1;
-				} else {
-					vb->y=yCoord+cellOffset;
-				}
-				vb->z=  ((float)pMap->getDisplayHeight(getXWithOrigin(i), getYWithOrigin(j)+cellOffset))*MAP_HEIGHT_SCALE;
-				vb->x = ADJUST_FROM_INDEX_TO_REAL(vb->x);
-				vb->y = ADJUST_FROM_INDEX_TO_REAL(vb->y);
-				vb->u1=U[3];
-				vb->v1=V[3];
-				vb->u2=UA[3];
-				vb->v2=VA[3];
-				doTheLight(vb, lightRay, &normalAtTexel, pLightsIterator, alpha[3]);
-				vb++;
-
-				VERTEX_FORMAT *pCurVertices = vb-4;
+			if (xCoord == pMap->getDrawOrgX()) { 
+				vb->x=xCoord;
+				//if (vb->x < 0) vb->x = 0;
+			} else {
+				vb->x=xCoord;
+			}
+			if (yCoord + 1 == pMap->getDrawOrgY() + m_y - 1) { 
+				vb->y=yCoord+1;
+			} else {
+				vb->y=yCoord+cellOffset;
+			}
+			vb->z=  ((float)pMap->getDisplayHeight(getXWithOrigin(i), getYWithOrigin(j)+cellOffset))*MAP_HEIGHT_SCALE;
+			vb->x = ADJUST_FROM_INDEX_TO_REAL(vb->x);
+			vb->y = ADJUST_FROM_INDEX_TO_REAL(vb->y);
+			vb->u1=U[3];
+			vb->v1=V[3];
+			vb->u2=UA[3];
+			vb->v2=VA[3];
+			doTheLight(vb, lightRay, &normalAtTexel, pLightsIterator, alpha[3]);
+			vb++;
+
+			VERTEX_FORMAT *pCurVertices = vb-4;
 #ifdef FLIP_TRIANGLES // jba - reduces "diamonding" in some cases, not others.  Better cliffs, though.
-				VERTEX_FORMAT tmpVertex;
-				if (flipForBlend) {
-					tmpVertex = pCurVertices[0];
-					pCurVertices[0] = pCurVertices[1];
-					pCurVertices[1] = pCurVertices[2];
-					pCurVertices[2] = pCurVertices[3];
-					pCurVertices[3] = tmpVertex;
-				}
+			VERTEX_FORMAT tmpVertex;
+			if (flipForBlend) {
+				tmpVertex = pCurVertices[0];
+				pCurVertices[0] = pCurVertices[1];
+				pCurVertices[1] = pCurVertices[2];
+				pCurVertices[2] = pCurVertices[3];
+				pCurVertices[3] = tmpVertex;
+			}
 #endif
 
-				if (m_showImpassableAreas) {
-					// Color impassable cells "red"
-					DEBUG_ASSERTCRASH(PATHFIND_CELL_SIZE_F == MAP_XY_FACTOR, ("Pathfind must be terrain cell size, or this code needs reworking.  John A."));
-					Real borderHiX = (pMap->getXExtent()-2*pMap->getBorderSizeInline())*MAP_XY_FACTOR;
-					Real borderHiY = (pMap->getYExtent()-2*pMap->getBorderSizeInline())*MAP_XY_FACTOR;
-					Bool border = pCurVertices[0].x == -MAP_XY_FACTOR || pCurVertices[0].y == -MAP_XY_FACTOR;
-					Bool cliffMapped = pMap->isCliffMappedTexture(getXWithOrigin(i), getYWithOrigin(j));
-					if (pCurVertices[0].x == borderHiX) {
-						border = true;
-					}
-					if (pCurVertices[0].y == borderHiY) {
-						border = true;
-					}
-					Bool isCliff = pMap->getCliffState(getXWithOrigin(i)+pMap->getDrawOrgX(), getYWithOrigin(j)+pMap->getDrawOrgY())
-												 || showAsVisibleCliff(getXWithOrigin(i) + pMap->getDrawOrgX(), getYWithOrigin(j)+pMap->getDrawOrgY());
-
-					if ( isCliff || border || cliffMapped) {
-						Int cellX, cellY;
-						for (cellX=0; cellX<2; cellX++) {
-							for (cellY=0; cellY<2; cellY++) {
-								Int vertex = cellX+2*cellY;
-								if (border) {
-									Bool doBorder = false;
-									if (pCurVertices[vertex].y >= 0 && pCurVertices[vertex].y <= borderHiY) {
-										if (pCurVertices[vertex].x == 0 || pCurVertices[vertex].x == borderHiX) {
-											doBorder = true;
-										}
-									}
-									if (pCurVertices[vertex].x >= 0 && pCurVertices[vertex].x <= borderHiX) {
-										if (pCurVertices[vertex].y == 0 || pCurVertices[vertex].y == borderHiY) {
-											doBorder = true;
-										}
+			if (m_showImpassableAreas) {
+				// Color impassable cells "red"
+				DEBUG_ASSERTCRASH(PATHFIND_CELL_SIZE_F == MAP_XY_FACTOR, ("Pathfind must be terrain cell size, or this code needs reworking.  John A."));
+				Real borderHiX = (pMap->getXExtent()-2*pMap->getBorderSizeInline())*MAP_XY_FACTOR;
+				Real borderHiY = (pMap->getYExtent()-2*pMap->getBorderSizeInline())*MAP_XY_FACTOR;
+				Bool border = pCurVertices[0].x == -MAP_XY_FACTOR || pCurVertices[0].y == -MAP_XY_FACTOR;
+				Bool cliffMapped = pMap->isCliffMappedTexture(getXWithOrigin(i), getYWithOrigin(j));
+				if (pCurVertices[0].x == borderHiX) {
+					border = true;
+				}
+				if (pCurVertices[0].y == borderHiY) {
+					border = true;
+				}
+				Bool isCliff = pMap->getCliffState(getXWithOrigin(i)+pMap->getDrawOrgX(), getYWithOrigin(j)+pMap->getDrawOrgY())
+											 || showAsVisibleCliff(getXWithOrigin(i) + pMap->getDrawOrgX(), getYWithOrigin(j)+pMap->getDrawOrgY());
+
+				if ( isCliff || border || cliffMapped) {
+					Int cellX, cellY;
+					for (cellX=0; cellX<2; cellX++) {
+						for (cellY=0; cellY<2; cellY++) {
+							Int vertex = cellX+2*cellY;
+							if (border) {
+								Bool doBorder = false;
+								if (pCurVertices[vertex].y >= 0 && pCurVertices[vertex].y <= borderHiY) {
+									if (pCurVertices[vertex].x == 0 || pCurVertices[vertex].x == borderHiX) {
+										doBorder = true;
 									}
-									if (doBorder) {
-										pCurVertices[vertex].diffuse &= 0xFF0000ff; // blue with alpha.
+								}
+								if (pCurVertices[vertex].x >= 0 && pCurVertices[vertex].x <= borderHiX) {
+									if (pCurVertices[vertex].y == 0 || pCurVertices[vertex].y == borderHiY) {
+										doBorder = true;
 									}
-								} else if (isCliff) {
-									pCurVertices[vertex].diffuse &= 0xFFFF0000; // red with alpha.
 								}
-								if (cliffMapped && vertex==0) {
-									pCurVertices[vertex].diffuse &= 0xFF000000; // Black.
-									pCurVertices[vertex].diffuse |= 0xff00; // Add green.
+								if (doBorder) {
+									pCurVertices[vertex].diffuse &= 0xFF0000ff; // blue with alpha.
 								}
+							} else if (isCliff) {
+								pCurVertices[vertex].diffuse &= 0xFFFF0000; // red with alpha.
+							}
+							if (cliffMapped && vertex==0) {
+								pCurVertices[vertex].diffuse &= 0xFF000000; // Black.
+								pCurVertices[vertex].diffuse |= 0xff00; // Add green.
 							}
 						}
 					}
 				}
-
-				// Note - We have been building the vertex buffer in the memory location.
-				// Now copy the set of vertices into the hardware buffer.
-				// We don't copy the whole vertex buffer because we often update only
-				// a couple of rows and its a lot faster to just copy the ones that change.
-				Int offset = pCurVertices - vBase;
-				memcpy(vbHardware+offset, pCurVertices, 4*sizeof(VERTEX_FORMAT));
 			}
+
+			// Note - We have been building the vertex buffer in the memory location.
+			// Now copy the set of vertices into the hardware buffer.
+			// We don't copy the whole vertex buffer because we often update only
+			// a couple of rows and its a lot faster to just copy the ones that change.
+			Int offset = pCurVertices - vBase;
+			memcpy(vbHardware+offset, pCurVertices, 4*sizeof(VERTEX_FORMAT));
 		}
-		return 0; //success.
 	}
-	return -1;
 }
 
 //=============================================================================
 // HeightMapRenderObjClass::updateVBForLight
 //=============================================================================
 /** Update the dynamic lighting values only in a rectangular block of the given Vertex Buffer. 
-The vertex locations and texture coords are unchanged.
+The vertex locations and texture coords are unchanged.  Only vertices under the lights 
+flagged m_dirty are touched, but all of pLights are summed into them.
 */
 Int HeightMapRenderObjClass::updateVBForLight(DX8VertexBufferClass	*pVB, char *data, Int x0, Int y0, Int x1, Int y1, Int originX, Int originY, W3DDynamicLight *pLights[], Int numLights)
 {
@@ -599,6 +608,9 @@ Int HeightMapRenderObjClass::updateVBForLight(DX8VertexBufferClass	*pVB, char *d
 			Int yCoord = getYWithOrigin(j)+m_map->getDrawOrgY()-m_map->getBorderSizeInline();
 			Bool intersect = false;
 			for (k=0; k<numLights; k++) {
+				if (!pLights[k]->m_dirty) {
+					continue;
+				}
 				if (pLights[k]->m_minY <= yCoord+1 && 
 					pLights[k]->m_maxY >= yCoord) {
 					intersect = true;
@@ -626,6 +638,9 @@ Int HeightMapRenderObjClass::updateVBForLight(DX8VertexBufferClass	*pVB, char *d
 				Int xCoord = getXWithOrigin(i)+m_map->getDrawOrgX()-m_map->getBorderSizeInline();
 				Bool intersect = false;
 				for (k=0; k<numLights; k++) {
+					if (!pLights[k]->m_dirty) {
+						continue;
+					}
 					if (pLights[k]->m_minX <= xCoord+1 && 
 						pLights[k]->m_maxX >= xCoord &&
 						pLights[k]->m_minY <= yCoord+1 && 
@@ -774,6 +789,9 @@ Int HeightMapRenderObjClass::updateVBForLightOptimized(DX8VertexBufferClass	*pVB
 			Int yCoord = getYWithOrigin(j)+m_map->getDrawOrgY()-m_map->getBorderSizeInline();
 			Bool intersect = false;
 			for (k=0; k<numLights; k++) {
+				if (!pLights[k]->m_dirty) {
+					continue;
+				}
 				if (pLights[k]->m_minY <= yCoord+1 && 
 					pLights[k]->m_maxY >= yCoord) {
 					intersect = true;
@@ -801,6 +819,9 @@ Int HeightMapRenderObjClass::updateVBForLightOptimized(DX8VertexBufferClass	*pVB
 				Int xCoord = getXWithOrigin(i)+m_map->getDrawOrgX()-m_map->getBorderSizeInline();
 				Bool intersect = false;
 				for (k=0; k<numLights; k++) {
+					if (!pLights[k]->m_dirty) {
+						continue;
+					}
 					if (pLights[k]->m_minX <= xCoord+1 && 
 						pLights[k]->m_maxX >= xCoord &&
 						pLights[k]->m_minY <= yCoord+1 && 
@@ -916,6 +937,33 @@ Int HeightMapRenderObjClass::updateVBForLightOptimized(DX8VertexBufferClass	*pVB
 
 
 
+//=============================================================================
+// wrapRangeToOrigin
+//=============================================================================
+/** Converts the range [lo,hi) of drawn cells on one axis into vertex buffer 
+cells, which are shifted by origin and wrap at size-1.  Returns the number of
+pieces (1 or 2) written to pieceLo and pieceHi. */
+//=============================================================================
+static Int wrapRangeToOrigin(Int lo, Int hi, Int origin, Int size, Int *pieceLo, Int *pieceHi)
+{
+	lo += origin;
+	hi += origin;
+	if (lo > size-1) {
+		lo -= size-1;
+		hi -= size-1;
+	}
+	if (hi > size-1) {
+		pieceLo[0] = lo;
+		pieceHi[0] = size-1;
+		pieceLo[1] = 0;
+		pieceHi[1] = hi-(size-1);
+		return 2;
+	}
+	pieceLo[0] = lo;
+	pieceHi[0] = hi;
+	return 1;
+}
+
 //=============================================================================
 // HeightMapRenderObjClass::doPartialUpdate
 //=============================================================================
@@ -936,28 +984,17 @@ void HeightMapRenderObjClass::doPartialUpdate(const IRegion2D &partialRange, Wor
 	if (maxY > m_y-1) maxY = m_y-1;
 	if (maxX < minX) return;
 	if (maxY < minY) return;
-	if (m_originX == 0 && m_originY == 0) {
-		// simple case.
-		updateBlock(minX, minY, maxX, maxY,
-								htMap, pLightsIterator);
-	}
-	else
-	{
-		minY = minY+m_originY;
-		maxY = maxY+m_originY;
-
-		if (minY> m_y-1) {
-			minY -= m_y-1;
- 			maxY -= m_y-1;
-		}
-		if (maxY > m_y-1) {
-			maxY -= m_y-1;
-			updateBlock(0, minY, m_x-1, m_y-1, htMap, pLightsIterator);
-			updateBlock(0, 0, m_x-1, maxY, htMap, pLightsIterator);
-		} else {
-			updateBlock(0, minY, m_x-1, maxY, htMap, pLightsIterator);
+	// The vertex buffers scroll as a ring, so the block may wrap around the end on either axis.
+	Int loX[2], hiX[2], loY[2], hiY[2];
+	Int numX = wrapRangeToOrigin(minX, maxX, m_originX, m_x, loX, hiX);
+	Int numY = wrapRangeToOrigin(minY, maxY, m_originY, m_y, loY, hiY);
+	Int i, j;
+	for (j=0; j<numY; j++) {
+		for (i=0; i<numX; i++) {
+			markBlockDirty(loX[i], loY[j], hiX[i], hiY[j]);
 		}
 	}
+	flushDirtyBlocks(htMap, pLightsIterator);
 
 	if (!m_extraBlendTilePositions)
 	{	//Need to allocate memory
@@ -968,7 +1005,6 @@ void HeightMapRenderObjClass::doPartialUpdate(const IRegion2D &partialRange, Wor
 	//Find list of all extra blend tiles used on map.  These are tiles with 3 materials/textures
 	//over the same tile and require an extra render pass.
 
-	Int i, j;
 	//First remove any existing extra blend tiles within this partial region
 	for (j=0; j<m_numExtraBlendTiles; j++)
 	{	Int x = m_extraBlendTilePositions[j] & 0xffff;
@@ -1025,16 +1061,29 @@ Int HeightMapRenderObjClass::updateBlock(Int x0, Int y0, Int x1, Int y1,  WorldH
 	DEBUG_ASSERTCRASH(x0<=x1, ("HeightMapRenderObjClass::UpdateBlock parameters have inside-out rectangle (on X)."));
 	DEBUG_ASSERTCRASH(y0<=y1, ("HeightMapRenderObjClass::UpdateBlock parameters have inside-out rectangle (on Y)."));
 #endif
-	Invalidate_Cached_Bounding_Volumes();
-	if (pMap) {
-		REF_PTR_SET(m_stageZeroTexture, pMap->getTerrainTexture());
-		REF_PTR_SET(m_stageOneTexture, pMap->getAlphaTerrainTexture());
+	markBlockDirty(x0, y0, x1, y1);
+	flushDirtyBlocks(pMap, pLightsIterator);
+
+	return 0;
+}
+
+//=============================================================================
+// HeightMapRenderObjClass::markBlockDirty
+//=============================================================================
+/** Flags the cells from [x0,y0 to x1,y1) for rebuilding.  Nothing is written 
+until flushDirtyBlocks, so several strips that land in the same vertex buffer 
+(the rows and columns exposed by a scroll, or the two halves of a block that 
+wraps around the origin) only lock it once between them.
+*/
+void HeightMapRenderObjClass::markBlockDirty(Int x0, Int y0, Int x1, Int y1)
+{
+	m_minDisplayHeightValid = false;
+	if (m_dirtyCellRows == NULL) {
+		return;
 	}
 
-	Int i,j;
-	DX8VertexBufferClass	**pVB;
+	Int i,j,k;
 	Int originX,originY;
-	//step through each vertex buffer that needs updating
 	for (j=0; j<m_numVBTilesY; j++)
 	{
 		originY=j*VERTEX_BUFFER_TILE_LENGTH;	//location of this VB on the large full-size heightmap
@@ -1057,13 +1106,116 @@ Int HeightMapRenderObjClass::updateBlock(Int x0, Int y0, Int x1, Int y1,  WorldH
 			if (xMin >= xMax) {
 				continue;
 			}
-			pVB=m_vertexBufferTiles+j*m_numVBTilesX+i;	//point to correct row/column of vertex buffers 
-			char **pData = m_vertexBufferBackup+j*m_numVBTilesX+i;
-			updateVB(*pVB, *pData, xMin, yMin, xMax, yMax, originX, originY, pMap, pLightsIterator);
+			Int numCells = xMax-xMin;
+			UnsignedInt mask = 0xffffffff;
+			if (numCells < 32) {
+				mask = ((UnsignedInt)1<<numCells)-1;
+			}
+			mask <<= xMin-originX;
+			UnsignedInt *rowMasks = m_dirtyCellRows + (j*m_numVBTilesX+i)*VERTEX_BUFFER_TILE_LENGTH;
+			for (k=yMin; k<yMax; k++) {
+				rowMasks[k-originY] |= mask;
+			}
 		}
 	}
+}
 
-	return 0;
+//=============================================================================
+// HeightMapRenderObjClass::flushDirtyBlocks
+//=============================================================================
+/** Rebuilds every cell flagged by markBlockDirty.  Each vertex buffer with 
+flagged cells is locked once, and only the runs of flagged cells in each of 
+its rows are rebuilt and copied in.
+*/
+void HeightMapRenderObjClass::flushDirtyBlocks(WorldHeightMap *pMap, RefRenderObjListIterator *pLightsIterator)
+{
+	Invalidate_Cached_Bounding_Volumes();
+	if (pMap) {
+		REF_PTR_SET(m_stageZeroTexture, pMap->getTerrainTexture());
+		REF_PTR_SET(m_stageOneTexture, pMap->getAlphaTerrainTexture());
+	}
+	REF_PTR_SET(m_map, pMap);	//update our heightmap pointer in case it changed since last call.
+	if (m_dirtyCellRows == NULL || m_vertexBufferTiles == NULL || pMap == NULL) {
+		return;
+	}
+
+	Vector3 lightRay[MAX_GLOBAL_LIGHTS];
+	setTerrainLightRays(lightRay);
+
+	Int i,j,k;
+	Int originX,originY;
+	for (j=0; j<m_numVBTilesY; j++)
+	{
+		originY=j*VERTEX_BUFFER_TILE_LENGTH;	//location of this VB on the large full-size heightmap
+		for (i=0; i<m_numVBTilesX; i++)
+		{	
+			originX=i*VERTEX_BUFFER_TILE_LENGTH;	//location of this VB on the large full-size heightmap
+			UnsignedInt *rowMasks = m_dirtyCellRows + (j*m_numVBTilesX+i)*VERTEX_BUFFER_TILE_LENGTH;
+			Bool dirty = false;
+			for (k=0; k<VERTEX_BUFFER_TILE_LENGTH; k++) {
+				if (rowMasks[k]) {
+					dirty = true;
+					break;
+				}
+			}
+			if (!dirty) {
+				continue;
+			}
+
+			// The rebuilt cells only have the static lights, so the dynamic lights need redoing.
+			m_relightDynamicLights = true;
+			char *data = m_vertexBufferBackup[j*m_numVBTilesX+i];
+			DX8VertexBufferClass::WriteLockClass lockVtxBuffer(m_vertexBufferTiles[j*m_numVBTilesX+i]);
+			VERTEX_FORMAT *vbHardware = (VERTEX_FORMAT*)lockVtxBuffer.Get_Vertex_Array();
+			for (k=0; k<VERTEX_BUFFER_TILE_LENGTH; k++) 
+			{
+				UnsignedInt mask = rowMasks[k];
+				rowMasks[k] = 0;
+				Int cell = 0;
+				while (mask) {
+					// find the next run of flagged cells in this row.
+					while ((mask & 1) == 0) {
+						mask >>= 1;
+						cell++;
+					}
+					Int runStart = cell;
+					while (mask & 1) {
+						mask >>= 1;
+						cell++;
+					}
+					if (HALF_RES_MESH) {
+						runStart &= ~1;	// updateVB steps through the cells in pairs.
+					}
+					updateVB(vbHardware, data, originX+runStart, originY+k, originX+cell, originY+k+1, 
+						originX, originY, pMap, lightRay, pLightsIterator);
+				}
+			}
+		}
+	}
+}
+
+//=============================================================================
+// HeightMapRenderObjClass::getMinDisplayHeight
+//=============================================================================
+/** Returns the lowest height in the drawn portion of the map.  It only changes 
+when the drawn vertices do, so it is kept until the next markBlockDirty rather 
+than found again every frame.
+*/
+Int HeightMapRenderObjClass::getMinDisplayHeight(void)
+{
+	if (!m_minDisplayHeightValid) {
+		Int i, j;
+		Int minHt = m_map->getMaxHeightValue();
+		for (i=0; i<m_x; i++) {
+			for (j=0; j<m_y; j++) {
+				Short cur = m_map->getDisplayHeight(i,j);
+				if (cur<minHt) minHt = cur;
+			}
+		}
+		m_minDisplayHeight = minHt;
+		m_minDisplayHeightValid = true;
+	}
+	return m_minDisplayHeight;
 }
 
 
@@ -1104,7 +1256,11 @@ m_numVBTilesX(0),
 m_numVBTilesY(0),
 m_numVertexBufferTiles(0),
 m_numBlockColumnsInLastVB(0),
-m_numBlockRowsInLastVB(0)
+m_numBlockRowsInLastVB(0),
+m_dirtyCellRows(NULL),
+m_minDisplayHeight(0),
+m_minDisplayHeightValid(false),
+m_relightDynamicLights(false)
 {
 	TheHeightMap = this;
 }
@@ -1374,6 +1530,8 @@ Int HeightMapRenderObjClass::initHeightData(Int x, Int y, WorldHeightMap *pMap,
 		m_y=y;
 		m_vertexBufferTiles = NEW DX8VertexBufferClass*[m_numVertexBufferTiles];
 		m_vertexBufferBackup = NEW char *[m_numVertexBufferTiles];
+		m_dirtyCellRows = NEW UnsignedInt[m_numVertexBufferTiles*VERTEX_BUFFER_TILE_LENGTH];
+		memset(m_dirtyCellRows, 0, m_numVertexBufferTiles*VERTEX_BUFFER_TILE_LENGTH*sizeof(UnsignedInt));
 
 		Int numVertex = VERTEX_BUFFER_TILE_LENGTH*2*VERTEX_BUFFER_TILE_LENGTH*2;
 
@@ -1395,13 +1553,88 @@ Int HeightMapRenderObjClass::initHeightData(Int x, Int y, WorldHeightMap *pMap,
 }
 
 
+//=============================================================================
+// HeightMapRenderObjClass::selectDirtyLights
+//=============================================================================
+/** Flags the lights whose lighting on the terrain is out of date, and copies them 
+to pDirtyLights.  A light is out of date if it was turned on or off, or if it moved, 
+grew, shrank or changed color by more than a little since it was last lit in.  When 
+there are more than budget of them, lights being turned on or off go first, then 
+the ones with the biggest change over the largest area.  The rest wait for a later 
+frame, and go on looking as they did. */
+//=============================================================================
+Int HeightMapRenderObjClass::selectDirtyLights(W3DDynamicLight *pLights[], Int numLights, W3DDynamicLight *pDirtyLights[], Int budget)
+{
+	Real priority[MAX_ENABLED_DYNAMIC_LIGHTS];
+	Int numDirty = 0;
+	Int k;
+	for (k=0; k<numLights; k++) {
+		W3DDynamicLight *pLight = pLights[k];
+		Real range = pLight->Get_Attenuation_Range();
+		Real change;
+		if (pLight->m_enabled != pLight->m_priorEnable) {
+			change = 1.0f + range;	// turned on or off, do these first.
+		} else if (m_relightDynamicLights || pLight->m_minX != pLight->m_prevMinX || pLight->m_minY != pLight->m_prevMinY || 
+				pLight->m_maxX != pLight->m_prevMaxX || pLight->m_maxY != pLight->m_prevMaxY) {
+			change = 1.0f;
+		} else {
+			Vector3 diffuse;
+			pLight->Get_Diffuse(&diffuse);
+			diffuse -= pLight->m_appliedDiffuse;
+			change = WWMath::Max(WWMath::Fabs(diffuse.X), WWMath::Max(WWMath::Fabs(diffuse.Y), WWMath::Fabs(diffuse.Z)));
+			if (change < DYNAMIC_LIGHT_COLOR_CHANGE) {
+				change = 0.0f;
+			}
+			Vector3 moved = pLight->Get_Position() - pLight->m_appliedPosition;
+			if (moved.Length2() > DYNAMIC_LIGHT_MOVE_CHANGE*DYNAMIC_LIGHT_MOVE_CHANGE || 
+					WWMath::Fabs(range - pLight->m_appliedRange) > DYNAMIC_LIGHT_MOVE_CHANGE) {
+				change = 1.0f;
+			}
+		}
+		if (change <= 0.0f) {
+			continue;
+		}
+		// Bigger lights cover more terrain, so a change in them shows more.
+		priority[numDirty] = change*range;
+		pDirtyLights[numDirty] = pLight;
+		numDirty++;
+	}
+
+	if (numDirty > budget) {
+		// Partial selection sort, just enough to get the first budget lights.
+		for (k=0; k<budget; k++) {
+			Int best = k;
+			Int m;
+			for (m=k+1; m<numDirty; m++) {
+				if (priority[m] > priority[best]) {
+					best = m;
+				}
+			}
+			Real tmpPriority = priority[k];
+			priority[k] = priority[best];
+			priority[best] = tmpPriority;
+			W3DDynamicLight *tmpLight = pDirtyLights[k];
+			pDirtyLights[k] = pDirtyLights[best];
+			pDirtyLights[best] = tmpLight;
+		}
+		numDirty = budget;
+	}
+
+	for (k=0; k<numDirty; k++) {
+		pDirtyLights[k]->m_dirty = true;
+	}
+	return numDirty;
+}
+
 //=============================================================================
 // HeightMapRenderObjClass::On_Frame_Update
 //=============================================================================
 /** Updates the diffuse color values in the vertices as affected by the dynamic lights.*/
 //=============================================================================
+DECLARE_PERF_TIMER(Terrain_OnFrameUpdate)
 void HeightMapRenderObjClass::On_Frame_Update(void)
 {	
+	USE_PERF_TIMER(Terrain_OnFrameUpdate)
 	BaseHeightMapRenderObjClass::On_Frame_Update();
 	Int i,j,k;
 	DX8VertexBufferClass	**pVB;
@@ -1436,16 +1669,16 @@ void HeightMapRenderObjClass::On_Frame_Update(void)
 
 	for (pDynamicLightsIterator.First(); !pDynamicLightsIterator.Is_Done(); pDynamicLightsIterator.Next())
 	{		
+		if (numDynaLights == MAX_ENABLED_DYNAMIC_LIGHTS) {
+			// No room for any more.  Leave the rest exactly as they were, so the ones in view 
+			// still look out of date when there is room to light them.
+			break;
+		}
 		W3DDynamicLight *pLight = (W3DDynamicLight*)pDynamicLightsIterator.Peek_Obj();
 		pLight->m_processMe = false;
+		pLight->m_dirty = false;
 		if (pLight->m_enabled || pLight->m_priorEnable) {
 			Real range = pLight->Get_Attenuation_Range();
-			if (pLight->m_priorEnable) {
-				pLight->m_prevMinX = pLight->m_minX;
-				pLight->m_prevMinY = pLight->m_minY;
-				pLight->m_prevMaxX = pLight->m_maxX;
-				pLight->m_prevMaxY = pLight->m_maxY;
-			} 
 			Vector3	pos = pLight->Get_Position();
 			pLight->m_minX = (pos.X-range)/MAP_XY_FACTOR;
 			pLight->m_maxX = (pos.X+range)/MAP_XY_FACTOR+1.0f;
@@ -1474,14 +1707,26 @@ void HeightMapRenderObjClass::On_Frame_Update(void)
 			if (pLight->m_processMe) {
 				enabledLights[numDynaLights] = pLight;
 				numDynaLights++;
-				if (numDynaLights == MAX_ENABLED_DYNAMIC_LIGHTS) {
-					break;
-				}
+				continue;
 			}
 		}
+		// Off, or off the drawn terrain, so there is nothing to light.  Start from here next time.
+		pLight->m_processMe = false;
+		pLight->m_prevMinX = pLight->m_minX;
+		pLight->m_prevMinY = pLight->m_minY;
+		pLight->m_prevMaxX = pLight->m_maxX;
+		pLight->m_prevMaxY = pLight->m_maxY;
 		pLight->m_priorEnable = pLight->m_enabled;
 	}
-	if (numDynaLights > 0) {
+
+	// Only the lights that changed enough since they were last lit get relit.  After the 
+	// vertex buffers were rebuilt, every light in view has to be, whatever the budget.
+	W3DDynamicLight *dirtyLights[MAX_ENABLED_DYNAMIC_LIGHTS];
+	Int budget = m_relightDynamicLights ? MAX_ENABLED_DYNAMIC_LIGHTS : MAX_RELIT_DYNAMIC_LIGHTS;
+	Int numDirtyLights = selectDirtyLights(enabledLights, numDynaLights, dirtyLights, budget);
+	m_relightDynamicLights = false;
+
+	if (numDirtyLights > 0) {
 		//step through each vertex buffer that needs updating
 		for (j=0; j<m_numVBTilesY; j++)
 		{
@@ -1494,14 +1739,14 @@ void HeightMapRenderObjClass::On_Frame_Update(void)
 			Int yCoordMax = getYWithOrigin(yMax-1)+m_map->getDrawOrgY()+1-m_map->getBorderSizeInline();
 			if (yCoordMax>yCoordMin) {
 				// no wrap occurred.
-				for (k=0; k<numDynaLights; k++) {
-					if (enabledLights[k]->m_minY < yCoordMax && 
-						enabledLights[k]->m_maxY > yCoordMin) {
+				for (k=0; k<numDirtyLights; k++) {
+					if (dirtyLights[k]->m_minY < yCoordMax && 
+						dirtyLights[k]->m_maxY > yCoordMin) {
 						intersect = true;
 						break;
 					}
-					if (enabledLights[k]->m_prevMinY < yCoordMax && 
-						enabledLights[k]->m_prevMaxY > yCoordMin) {
+					if (dirtyLights[k]->m_prevMinY < yCoordMax && 
+						dirtyLights[k]->m_prevMaxY > yCoordMin) {
 						intersect = true;
 						break;
 					}
@@ -1511,14 +1756,14 @@ void HeightMapRenderObjClass::On_Frame_Update(void)
 				int tmp=yCoordMin;
 				yCoordMin = yCoordMax;
 				yCoordMax = tmp;
-				for (k=0; k<numDynaLights; k++) {
-					if (enabledLights[k]->m_minY <=  yCoordMin || 
-						enabledLights[k]->m_maxY >= yCoordMax) {
+				for (k=0; k<numDirtyLights; k++) {
+					if (dirtyLights[k]->m_minY <=  yCoordMin || 
+						dirtyLights[k]->m_maxY >= yCoordMax) {
 						intersect = true;
 						break;
 					}
-					if (enabledLights[k]->m_prevMinY <=  yCoordMin || 
-						enabledLights[k]->m_prevMaxY >= yCoordMax) {
+					if (dirtyLights[k]->m_prevMinY <=  yCoordMin || 
+						dirtyLights[k]->m_prevMaxY >= yCoordMax) {
 						intersect = true;
 						break;
 					}
@@ -1540,14 +1785,14 @@ void HeightMapRenderObjClass::On_Frame_Update(void)
 				Int xCoordMax = getXWithOrigin(xMax-1)+m_map->getDrawOrgX()+1-m_map->getBorderSizeInline();
 				if (xCoordMax>xCoordMin) {
 					// no wrap occurred.
-					for (k=0; k<numDynaLights; k++) {
-						if (enabledLights[k]->m_minX < xCoordMax && 
-							enabledLights[k]->m_maxX > xCoordMin) {
+					for (k=0; k<numDirtyLights; k++) {
+						if (dirtyLights[k]->m_minX < xCoordMax && 
+							dirtyLights[k]->m_maxX > xCoordMin) {
 							intersect = true;
 							break;
 						}
-						if (enabledLights[k]->m_prevMinX < xCoordMax && 
-							enabledLights[k]->m_prevMaxX > xCoordMin) {
+						if (dirtyLights[k]->m_prevMinX < xCoordMax && 
+							dirtyLights[k]->m_prevMaxX > xCoordMin) {
 							intersect = true;
 							break;
 						}
@@ -1557,14 +1802,14 @@ void HeightMapRenderObjClass::On_Frame_Update(void)
 					int tmp=xCoordMin;
 					xCoordMin = xCoordMax;
 					xCoordMax = tmp;
-					for (k=0; k<numDynaLights; k++) {
-						if (enabledLights[k]->m_minX <=  xCoordMin || 
-							enabledLights[k]->m_maxX >= xCoordMax) {
+					for (k=0; k<numDirtyLights; k++) {
+						if (dirtyLights[k]->m_minX <=  xCoordMin || 
+							dirtyLights[k]->m_maxX >= xCoordMax) {
 							intersect = true;
 							break;
 						}
-						if (enabledLights[k]->m_prevMinX <=  xCoordMin ||
-							enabledLights[k]->m_prevMaxX >= xCoordMax) {
+						if (dirtyLights[k]->m_prevMinX <=  xCoordMin ||
+							dirtyLights[k]->m_prevMaxX >= xCoordMax) {
 							intersect = true;
 							break;
 						}
@@ -1579,6 +1824,20 @@ void HeightMapRenderObjClass::On_Frame_Update(void)
 			}
 		}
 	}
+
+	// Remember what the relit lights looked like, to tell when they next change.
+	for (k=0; k<numDirtyLights; k++) {
+		W3DDynamicLight *pLight = dirtyLights[k];
+		pLight->m_dirty = false;
+		pLight->m_prevMinX = pLight->m_minX;
+		pLight->m_prevMinY = pLight->m_minY;
+		pLight->m_prevMaxX = pLight->m_maxX;
+		pLight->m_prevMaxY = pLight->m_maxY;
+		pLight->m_priorEnable = pLight->m_enabled;
+		pLight->m_appliedPosition = pLight->Get_Position();
+		pLight->Get_Diffuse(&pLight->m_appliedDiffuse);
+		pLight->m_appliedRange = pLight->Get_Attenuation_Range();
+	}
 }
 
 //=============================================================================
@@ -1684,8 +1943,10 @@ rendered portion of the terrain.  Only a 96x96 section is rendered at any time,
 even though maps can be up to 1024x1024.  This function determines which subset
 is rendered. */
 //=============================================================================
+DECLARE_PERF_TIMER(Terrain_UpdateCenter)
 void HeightMapRenderObjClass::updateCenter(CameraClass *camera , RefRenderObjListIterator *pLightsIterator)
 {
+	USE_PERF_TIMER(Terrain_UpdateCenter)
 	if (m_map==NULL) {
 		return;
 	}
@@ -1728,17 +1989,10 @@ void HeightMapRenderObjClass::updateCenter(CameraClass *camera , RefRenderObjLis
 	rayLocation = camera_location; 
 	// determine the location of the screen coordinate in camera-model space
 	const ViewportClass &viewport = camera->Get_Viewport();
-	Int i, j, minHt;
+	Int i, j;
 
 	Real intersectionZ;
-	minHt = m_map->getMaxHeightValue();
-	for (i=0; i<m_x; i++) {
-		for (j=0; j<m_y; j++) {
-			Short cur = m_map->getDisplayHeight(i,j);
-			if (cur<minHt) minHt = cur;
-		}
-	}
-	intersectionZ = (float)minHt;
+	intersectionZ = (float)getMinDisplayHeight();
 //	float aspect = camera->Get_Aspect_Ratio();
 
 	Vector2 min,max;
@@ -1856,16 +2110,17 @@ void HeightMapRenderObjClass::updateCenter(CameraClass *camera , RefRenderObjLis
 					if (minY<0) {
 						minY += m_y-1;
 						if (minY<0) minY = 0;
-						updateBlock(0, minY, m_x-1, m_y-1, m_map, pLightsIterator);
-						updateBlock(0, 0, m_x-1, maxY, m_map, pLightsIterator);
+						markBlockDirty(0, minY, m_x-1, m_y-1);
+						markBlockDirty(0, 0, m_x-1, maxY);
 					} else {
-						updateBlock(0, minY, m_x-1, maxY, m_map, pLightsIterator);
+						markBlockDirty(0, minY, m_x-1, maxY);
 					}
 				}
 				// It is much more efficient to update a cople of columns one frame, and then
 				// a couple of rows.  So if we aren't "jumping" to a new view, and have done X
 				// recently, return.
 				if (abs(deltaX) < BIG_JUMP && !m_doXNextTime) {
+					flushDirtyBlocks(m_map, pLightsIterator);
 					m_updating = false;
 					m_doXNextTime = true;
 					return;	// Only do the y this frame.  Do x next frame.  jba.
@@ -1893,13 +2148,16 @@ void HeightMapRenderObjClass::updateCenter(CameraClass *camera , RefRenderObjLis
 					if (minX<0) {
 						minX += m_x-1;
 						if (minX<0) minX = 0;
-						updateBlock(minX,0,m_x-1, m_y-1, m_map, pLightsIterator);
-						updateBlock(0,0,maxX, m_y-1, m_map, pLightsIterator);
+						markBlockDirty(minX,0,m_x-1, m_y-1);
+						markBlockDirty(0,0,maxX, m_y-1);
 					} else {
-						updateBlock(minX,0,maxX, m_y-1, m_map, pLightsIterator);
+						markBlockDirty(minX,0,maxX, m_y-1);
 					}
 				}
 			} 
+			// Build the rows and columns that scrolled into view, each vertex buffer
+			// they touch is only locked once.
+			flushDirtyBlocks(m_map, pLightsIterator);
 		}
 	}
 	m_updating = false;
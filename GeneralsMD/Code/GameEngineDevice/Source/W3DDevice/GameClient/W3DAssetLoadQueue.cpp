@@ -0,0 +1,357 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+// FILE: W3DAssetLoadQueue.cpp ////////////////////////////////////////////////
+//
+// Batched model preloading for map load.  The .w3d files are read from disk
+// in parallel, then registered with the asset manager on the main thread in
+// the order they were asked for.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES ////////////////////////////////////////////////////////////
+#include <windows.h>
+
+// USER INCLUDES //////////////////////////////////////////////////////////////
+#include "Lib/BaseType.h"
+#include "Common/ArchiveFileSystem.h"
+#include "Common/Debug.h"
+#include "Common/GameMemory.h"
+#include "Common/LocalFileSystem.h"
+#include "Common/WorkerPool.h"
+#include "W3DDevice/GameClient/W3DAssetLoadQueue.h"
+#include "W3DDevice/GameClient/W3DAssetManager.h"
+#include "W3DDevice/GameClient/W3DFileSystem.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+/// Most files read ahead of registration at once.  Each window is also one step of load screen progress.
+static const Int MAX_FILES_PER_WINDOW = 64;
+
+/// Stop adding files to a window once it holds this many bytes, so a big preload doesn't hold every file in memory at once.
+static const Int MAX_BYTES_PER_WINDOW = 8 * 1024 * 1024;
+
+static const char *const TheAssetClassNames[W3DAssetLoadProfile::ASSET_CLASS_COUNT] =
+{
+	"File read",
+	"Hierarchy",
+	"Animation",
+	"Mesh",
+	"HLOD",
+	"Other prototype",
+	"Texture",
+};
+
+//=============================================================================
+// W3DAssetLoadProfile::reset
+//=============================================================================
+/** */
+//=============================================================================
+void W3DAssetLoadProfile::reset(void)
+{
+	for (Int i = 0; i < ASSET_CLASS_COUNT; ++i)
+	{
+		m_ticks[i] = 0;
+		m_count[i] = 0;
+		m_bytes[i] = 0;
+	}
+}
+
+//=============================================================================
+// W3DAssetLoadProfile::add
+//=============================================================================
+/** */
+//=============================================================================
+void W3DAssetLoadProfile::add(AssetClass assetClass, Int64 ticks, Int bytes)
+{
+	m_ticks[assetClass] += ticks;
+	m_count[assetClass]++;
+	m_bytes[assetClass] += bytes;
+}
+
+//=============================================================================
+// W3DAssetLoadProfile::log
+//=============================================================================
+/** */
+//=============================================================================
+void W3DAssetLoadProfile::log(Int64 wallTicks) const
+{
+	Int64 freq;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&freq);
+	Real msPerTick = 1000.0f / (Real)freq;
+
+	DEBUG_LOG(("Asset preload took %.1f ms\n", (Real)wallTicks * msPerTick));
+	for (Int i = 0; i < ASSET_CLASS_COUNT; ++i)
+	{
+		if (m_count[i] == 0)
+			continue;
+
+		DEBUG_LOG(("  %-16s %9.1f ms  %5d items  %7d KB\n", TheAssetClassNames[i],
+			(Real)m_ticks[i] * msPerTick, m_count[i], m_bytes[i] / 1024));
+	}
+}
+
+//=============================================================================
+// W3DAssetLoadProfile::getTicks
+//=============================================================================
+/** */
+//=============================================================================
+Int64 W3DAssetLoadProfile::getTicks(void)
+{
+	Int64 ticks;
+	QueryPerformanceCounter((LARGE_INTEGER *)&ticks);
+	return ticks;
+}
+
+//-----------------------------------------------------------------------------
+/** Reads one window of the queue, one file per batch.  Every file gets its
+	* own handle, so nothing is shared with the main thread's File objects or
+	* with the other workers. */
+//-----------------------------------------------------------------------------
+class W3DAssetReadJob : public WorkerJob
+{
+
+public:
+
+	W3DAssetReadJob(W3DAssetLoadQueue::LoadEntry *entries) : m_entries(entries) {}
+
+	virtual void runBatch(Int batch)
+	{
+		W3DAssetLoadQueue::LoadEntry *entry = &m_entries[batch];
+		if (entry->m_diskPath.isEmpty())
+			return;
+
+		Int64 startTicks = W3DAssetLoadProfile::getTicks();
+
+		HANDLE handle = CreateFile(entry->m_diskPath.str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (handle != INVALID_HANDLE_VALUE)
+		{
+			if (entry->m_size < 0)
+				entry->m_size = (Int)GetFileSize(handle, NULL);
+
+			if (entry->m_size > 0 && SetFilePointer(handle, entry->m_offset, NULL, FILE_BEGIN) == entry->m_offset)
+			{
+				entry->m_data = MSGNEW("W3DAssetLoadQueue") char[entry->m_size];
+
+				DWORD bytesRead = 0;
+				if (!ReadFile(handle, entry->m_data, entry->m_size, &bytesRead, NULL) || bytesRead != (DWORD)entry->m_size)
+				{
+					delete [] entry->m_data;
+					entry->m_data = NULL;
+				}
+			}
+			CloseHandle(handle);
+		}
+
+		entry->m_readTicks = W3DAssetLoadProfile::getTicks() - startTicks;
+	}
+
+protected:
+
+	W3DAssetLoadQueue::LoadEntry *m_entries;
+};
+
+//=============================================================================
+// W3DAssetLoadQueue::W3DAssetLoadQueue
+//=============================================================================
+/** */
+//=============================================================================
+W3DAssetLoadQueue::W3DAssetLoadQueue() :
+	m_beginTicks(0),
+	m_batching(FALSE)
+{
+}
+
+//=============================================================================
+// W3DAssetLoadQueue::~W3DAssetLoadQueue
+//=============================================================================
+/** */
+//=============================================================================
+W3DAssetLoadQueue::~W3DAssetLoadQueue()
+{
+	DEBUG_ASSERTCRASH(m_entries.empty(), ("W3DAssetLoadQueue destroyed with models still queued"));
+}
+
+//=============================================================================
+// W3DAssetLoadQueue::begin
+//=============================================================================
+/** */
+//=============================================================================
+void W3DAssetLoadQueue::begin(void)
+{
+	DEBUG_ASSERTCRASH(!m_batching, ("W3DAssetLoadQueue::begin - already batching"));
+
+	m_entries.clear();
+	m_queuedNames.clear();
+	m_profile.reset();
+	m_beginTicks = W3DAssetLoadProfile::getTicks();
+	m_batching = TRUE;
+}
+
+//=============================================================================
+// W3DAssetLoadQueue::addModel
+//=============================================================================
+/** */
+//=============================================================================
+void W3DAssetLoadQueue::addModel(const char *filename)
+{
+	AsciiString name = filename;
+	name.toLower();
+	if (m_queuedNames.find(name) != m_queuedNames.end())
+		return;
+	m_queuedNames.insert(name);
+
+	LoadEntry entry;
+	entry.m_filename = filename;
+	entry.m_offset = 0;
+	entry.m_size = 0;
+	entry.m_data = NULL;
+	entry.m_readTicks = 0;
+	m_entries.push_back(entry);
+}
+
+//=============================================================================
+// W3DAssetLoadQueue::locate
+//=============================================================================
+/** Find the bytes of the file the same way GameFileClass would: it picks the
+	* path, and the file system prefers a loose file to one in an archive. */
+//=============================================================================
+void W3DAssetLoadQueue::locate(LoadEntry *entry)
+{
+	entry->m_diskPath.clear();
+
+	GameFileClass file(entry->m_filename.str());
+	if (!file.Is_Available())
+		return;
+
+	if (TheLocalFileSystem && TheLocalFileSystem->doesFileExist(file.File_Path()))
+	{
+		entry->m_diskPath = file.File_Path();
+		entry->m_offset = 0;
+		entry->m_size = -1;
+		return;
+	}
+
+	ArchivedFileInfo fileInfo;
+	if (TheArchiveFileSystem && TheArchiveFileSystem->getArchivedFileInfo(AsciiString(file.File_Path()), &fileInfo))
+	{
+		entry->m_diskPath = fileInfo.m_archiveFilename;
+		entry->m_offset = fileInfo.m_offset;
+		entry->m_size = fileInfo.m_size;
+	}
+}
+
+//=============================================================================
+// W3DAssetLoadQueue::registerEntry
+//=============================================================================
+/** */
+//=============================================================================
+void W3DAssetLoadQueue::registerEntry(W3DAssetManager *assetManager, LoadEntry *entry)
+{
+	if (entry->m_data)
+	{
+		m_profile.add(W3DAssetLoadProfile::ASSET_FILE_READ, entry->m_readTicks, entry->m_size);
+		assetManager->Load_3D_Assets_From_Memory(entry->m_filename.str(), entry->m_data, entry->m_size, &m_profile);
+
+		delete [] entry->m_data;
+		entry->m_data = NULL;
+	}
+	else
+	{
+		// couldn't be found or read up front, so let the asset manager have a go (and complain)
+		assetManager->Load_3D_Assets(entry->m_filename.str());
+	}
+}
+
+//=============================================================================
+// W3DAssetLoadQueue::finish
+//=============================================================================
+/** */
+//=============================================================================
+void W3DAssetLoadQueue::finish(W3DAssetManager *assetManager, Int numThreads, Display::PreloadProgressCallback *callback)
+{
+	DEBUG_ASSERTCRASH(m_batching, ("W3DAssetLoadQueue::finish - not batching"));
+	m_batching = FALSE;
+
+	// drop anything that was loaded some other way while the queue was filling up
+	std::vector<LoadEntry> entries;
+	entries.reserve(m_entries.size());
+	Int i;
+	for (i = 0; i < m_entries.size(); ++i)
+	{
+		char basename[_MAX_PATH];
+		strncpy(basename, m_entries[i].m_filename.str(), _MAX_PATH);
+		basename[_MAX_PATH - 1] = 0;
+		char *ext = strrchr(basename, '.');
+		if (ext)
+			*ext = 0;
+
+		if (assetManager->Find_Prototype(basename) == NULL)
+			entries.push_back(m_entries[i]);
+	}
+	Int skipped = m_entries.size() - entries.size();
+	m_entries.clear();
+	m_queuedNames.clear();
+
+	for (i = 0; i < entries.size(); ++i)
+		locate(&entries[i]);
+
+	Int numEntries = entries.size();
+
+	WorkerPool pool;
+	if (numEntries > 1)
+		pool.init(numThreads);
+
+	Int first = 0;
+	while (first < numEntries)
+	{
+		Int count = 0;
+		Int bytes = 0;
+		while (first + count < numEntries && count < MAX_FILES_PER_WINDOW && bytes < MAX_BYTES_PER_WINDOW)
+		{
+			if (entries[first + count].m_size > 0)
+				bytes += entries[first + count].m_size;
+			++count;
+		}
+
+		W3DAssetReadJob job(&entries[first]);
+		pool.run(&job, count);
+
+		for (i = first; i < first + count; ++i)
+			registerEntry(assetManager, &entries[i]);
+
+		first += count;
+		if (callback)
+			callback(first, numEntries);
+	}
+
+	DEBUG_LOG(("W3DAssetLoadQueue::finish - loaded %d models (%d were already loaded) with %d worker threads\n",
+		numEntries, skipped, pool.getNumThreads()));
+	m_profile.log(W3DAssetLoadProfile::getTicks() - m_beginTicks);
+
+	pool.shutdown();
+}
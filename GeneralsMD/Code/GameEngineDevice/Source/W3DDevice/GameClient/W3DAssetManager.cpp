@@ -65,8 +65,12 @@
 #include "ffactory.h"
 #include "font3d.h"
 #include "render2dsentence.h"
+#include "chunkio.h"
+#include "RAMFILE.H"
+#include "w3d_file.h"
 #include <stdio.h>
 #include "W3DDevice/GameClient/W3DGranny.h"
+#include "W3DDevice/GameClient/W3DAssetLoadQueue.h"
 #include "Common/PerfTimer.h"
 #include "Common/GlobalData.h"
 #include "Common/GameCommon.h"
@@ -1047,18 +1051,8 @@ bool W3DAssetManager::Load_3D_Assets( const char * filename )
 	bool result = WW3DAssetManager::Load_3D_Assets(filename);
 
 #if defined(_DEBUG) || defined(_INTERNAL)
-	if (result && TheGlobalData->m_preloadReport)
-	{	
-		//loading a new asset and app is requesting a log of all loaded assets.
-		FILE *logfile=fopen("PreloadedAssets.txt","a+");	//append to log
-		if (logfile)
-		{	
-			StringClass lower_case_name(filename,true);
-			_strlwr(lower_case_name.Peek_Buffer());
-			fprintf(logfile,"3D: %s\n",lower_case_name.Peek_Buffer());
-			fclose(logfile);
-		}
-	}
+	if (result)
+		Report_Preloaded_Asset(filename);
 #endif
 #ifdef DUMP_PERF_STATS
 	if (Load_3D_Asset_Recursions == 1)
@@ -1105,6 +1099,89 @@ bool W3DAssetManager::Load_3D_Assets( const char * filename )
 #endif
 }
 
+//---------------------------------------------------------------------
+/** Register the assets in a .w3d file that has already been read into
+	* memory, the same way Load_3D_Assets(FileClass &) does.  The time spent
+	* on each kind of chunk goes into profile, if there is one. */
+//---------------------------------------------------------------------
+bool W3DAssetManager::Load_3D_Assets_From_Memory( const char * filename, char * buffer, int size, W3DAssetLoadProfile * profile )
+{
+	RAMFileClass w3dfile(buffer, size);
+	if (!w3dfile.Open()) {
+		return false;
+	}
+
+	ChunkLoadClass cload(&w3dfile);
+
+	while (cload.Open_Chunk()) {
+
+		Int64 startTicks = W3DAssetLoadProfile::getTicks();
+		W3DAssetLoadProfile::AssetClass assetClass;
+
+		switch (cload.Cur_Chunk_ID()) {
+
+			case W3D_CHUNK_HIERARCHY:
+				HTreeManager.Load_Tree(cload);
+				assetClass = W3DAssetLoadProfile::ASSET_HIERARCHY;
+				break;
+
+			case W3D_CHUNK_ANIMATION:
+			case W3D_CHUNK_COMPRESSED_ANIMATION:
+			case W3D_CHUNK_MORPH_ANIMATION:
+				HAnimManager.Load_Anim(cload);
+				assetClass = W3DAssetLoadProfile::ASSET_ANIMATION;
+				break;
+
+			case W3D_CHUNK_MESH:
+				Load_Prototype(cload);
+				assetClass = W3DAssetLoadProfile::ASSET_MESH;
+				break;
+
+			case W3D_CHUNK_HLOD:
+				Load_Prototype(cload);
+				assetClass = W3DAssetLoadProfile::ASSET_HLOD;
+				break;
+
+			default:
+				Load_Prototype(cload);
+				assetClass = W3DAssetLoadProfile::ASSET_OTHER_PROTOTYPE;
+				break;
+		}
+
+		if (profile)
+			profile->add(assetClass, W3DAssetLoadProfile::getTicks() - startTicks, cload.Cur_Chunk_Length());
+
+		cload.Close_Chunk();
+	}
+
+	w3dfile.Close();
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+	Report_Preloaded_Asset(filename);
+#endif
+
+	return true;
+}
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+//---------------------------------------------------------------------
+void W3DAssetManager::Report_Preloaded_Asset( const char * filename )
+{
+	if (TheGlobalData->m_preloadReport)
+	{	
+		//loading a new asset and app is requesting a log of all loaded assets.
+		FILE *logfile=fopen("PreloadedAssets.txt","a+");	//append to log
+		if (logfile)
+		{	
+			StringClass lower_case_name(filename,true);
+			_strlwr(lower_case_name.Peek_Buffer());
+			fprintf(logfile,"3D: %s\n",lower_case_name.Peek_Buffer());
+			fclose(logfile);
+		}
+	}
+}
+#endif
+
 #ifdef DUMP_PERF_STATS
 __int64 Total_Get_HAnim_Time=0;
 static HAnim_Recursions=0;
@@ -48,6 +48,7 @@ static void drawFramerateBar(void);
 #include "Common/LocalFileSystem.h"
 #include "Common/Player.h"
 #include "Common/PlayerList.h"
+#include "Common/StateMachine.h"
 #include "Common/ThingTemplate.h"
 #include "Common/GameLOD.h"
 #include "Common/DrawModule.h"
@@ -66,6 +67,7 @@ static void drawFramerateBar(void);
 #include "Common/ModelState.h"
 #include "Lib/BaseType.h"
 #include "W3DDevice/Common/W3DConvert.h"
+#include "W3DDevice/GameClient/W3DAssetLoadQueue.h"
 #include "W3DDevice/GameClient/W3DAssetManager.h"
 #include "W3DDevice/GameClient/W3DGameClient.h"
 #include "W3DDevice/GameClient/W3DFileSystem.h"
@@ -73,6 +75,7 @@ static void drawFramerateBar(void);
 #include "W3DDevice/GameClient/HeightMap.h"
 #include "W3DDevice/GameClient/WorldHeightMap.h"
 #include "W3DDevice/GameClient/W3DScene.h"
+#include "W3DDevice/GameClient/W3DSceneCull.h"
 #include "W3DDevice/GameClient/W3DTerrainTracks.h"
 #include "W3DDevice/GameClient/W3DWater.h"
 #include "W3DDevice/GameClient/W3DVideoBuffer.h"
@@ -95,6 +98,9 @@ static void drawFramerateBar(void);
 #include "WW3D2/DX8WebBrowser.h"
 #include "WW3D2/Mesh.h"
 #include "WW3D2/HLOD.h"
+#include "WW3D2/HTree.h"
+#include "WW3D2/HAnim.h"
+#include "WW3D2/HCAnim.h"
 #include "WW3D2/Meshmatdesc.h"
 #include "WW3D2/Meshmdl.h"
 #include "WW3D2/rddesc.h"
@@ -282,6 +288,27 @@ void StatDumpClass::dumpStats( Bool brief, Bool flagSpikes )
 	fprintf(m_fp, "Partition Manager Statistics:\n");
 	fprintf(m_fp, "  Total time for object scans this frame is %.5f msec\n", gcoTimeThisFrameTotal);
 	fprintf(m_fp, "  Avg time per object scan this frame is %.5f msec\n", gcoTimeThisFrameAvg);
+	Int enemyScans, enemyCellsTouched, enemyCellsBuilt;
+	ThePartitionManager->getEnemyScanStats(enemyScans, enemyCellsTouched, enemyCellsBuilt);
+	fprintf(m_fp, "  Shared enemy scans this frame: %d, looking in %d cells (%d cells sorted for enemies)\n", enemyScans, enemyCellsTouched, enemyCellsBuilt);
+	Int losQueries, losCacheHits;
+	ThePartitionManager->getLineOfSightStats(losQueries, losCacheHits);
+	fprintf(m_fp, "  Terrain line of sight checks this frame: %d, %d answered from the cache (%.1f%%)\n", losQueries, losCacheHits,
+		losQueries > 0 ? losCacheHits * 100.0f / losQueries : 0.0f);
+	fprintf( m_fp, "\n" );
+
+	//AI player stats
+	fprintf(m_fp, "AI Player Statistics:\n");
+	for (Int playerIndex = 0; playerIndex < ThePlayerList->getPlayerCount(); ++playerIndex)
+	{
+		Player *player = ThePlayerList->getNthPlayer(playerIndex);
+		double plannerTimeThisFrame, plannerTimeAvg;
+		if (player && player->getAiPlannerStats(plannerTimeThisFrame, plannerTimeAvg))
+			fprintf(m_fp, "  %s: %.5f msec this frame, %.5f msec avg\n", TheNameKeyGenerator->keyToName(player->getPlayerNameKey()).str(), plannerTimeThisFrame, plannerTimeAvg);
+	}
+	Int stateUpdatesExecuted, stateUpdatesSkipped;
+	StateMachine::getUpdateStats(stateUpdatesExecuted, stateUpdatesSkipped);
+	fprintf(m_fp, "  State machine updates this frame: %d run, %d skipped while asleep\n", stateUpdatesExecuted, stateUpdatesSkipped);
 	fprintf( m_fp, "\n" );
 
 	// setup texture stats
@@ -416,6 +443,8 @@ W3DDisplay::W3DDisplay()
 	for (i = 0; i < DisplayStringCount; i++)
 		m_displayStrings[i] = NULL;
 
+	m_assetLoadQueue = NEW W3DAssetLoadQueue;
+
 }  // end W3DDisplay
 
 // W3DDisplay::~W3DDisplay ====================================================
@@ -427,6 +456,9 @@ W3DDisplay::~W3DDisplay()
 	// get rid of the debug display
 	delete m_debugDisplay;
 
+	delete m_assetLoadQueue;
+	m_assetLoadQueue = NULL;
+
 	// delete the display strings
 	for (int i = 0; i < DisplayStringCount; i++)
 		TheDisplayStringManager->freeDisplayString(m_displayStrings[i]);
@@ -648,6 +680,146 @@ void W3DDisplay::init2DScene( void )
 
 }  // end init2DScene
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+//=============================================================================
+/** Run the deformed skin meshes of a model through the CPU skinning path,
+	* recursing into any sub objects.  Returns a sum of the vertices so runs can
+	* be compared. */
+//=============================================================================
+static Real skinAnimationBenchmarkObject( RenderObjClass *robj, Vector3 *verts, Vector3 *norms, Int maxVerts )
+{
+	Real sum = 0.0f;
+	if( robj->Class_ID() == RenderObjClass::CLASSID_MESH )
+	{
+		MeshClass *mesh = (MeshClass *)robj;
+		MeshModelClass *model = mesh->Peek_Model();
+		if( model && model->Get_Flag( MeshGeometryClass::SKIN ) && model->Get_Vertex_Count() <= maxVerts )
+		{
+			mesh->Get_Deformed_Vertices( verts, norms );
+			for( Int v = 0; v < model->Get_Vertex_Count(); v += 16 )
+				sum += verts[v].X + verts[v].Y + verts[v].Z;
+		}
+	}
+
+	for( Int i = 0; i < robj->Get_Num_Sub_Objects(); ++i )
+	{
+		RenderObjClass *sub = robj->Get_Sub_Object( i );
+		if( sub )
+		{
+			sum += skinAnimationBenchmarkObject( sub, verts, norms, maxVerts );
+			sub->Release_Ref();
+		}
+	}
+	return sum;
+}
+
+//=============================================================================
+/** Animate and skin a crowd of copies of one model, the way a few hundred
+	* infantry would be, first evaluating every pose and then with pose sharing.
+	* Each copy starts the animation a few frames after the last one, so only
+	* every so often do two of them land on the same frame.  Results go to the
+	* debug log. */
+//=============================================================================
+static void runAnimationBenchmark( const char *modelName, const char *animName, Int count )
+{
+	const Int NUM_FRAMES = 300;
+	const Int MAX_SKIN_VERTS = 8192;
+
+	WW3DAssetManager *assetManager = WW3DAssetManager::Get_Instance();
+	HAnimClass *anim = assetManager->Get_HAnim( animName );
+	if( anim == NULL || anim->Get_Num_Frames() <= 0 || count <= 0 )
+	{
+		DEBUG_LOG(("Animation benchmark: can't play %s\n", animName));
+		REF_PTR_RELEASE( anim );
+		return;
+	}
+
+	RenderObjClass **robjs = NEW RenderObjClass *[count];
+	Real *startFrames = NEW Real[count];
+	Int i;
+	for( i = 0; i < count; ++i )
+	{
+		robjs[i] = assetManager->Create_Render_Obj( modelName );
+		if( robjs[i] == NULL )
+			break;
+
+		Matrix3D tm( true );
+		tm.Set_Translation( Vector3( (i % 25) * 20.0f, (i / 25) * 20.0f, 0.0f ) );
+		robjs[i]->Set_Transform( tm );
+		startFrames[i] = (Real)((i * 7) % anim->Get_Num_Frames());
+	}
+
+	Int numObjects = i;
+	if( numObjects == count )
+	{
+		Vector3 *verts = NEW Vector3[MAX_SKIN_VERTS];
+		Vector3 *norms = NEW Vector3[MAX_SKIN_VERTS];
+		Real numAnimFrames = (Real)anim->Get_Num_Frames();
+		Real frameStep = anim->Get_Frame_Rate() / LOGICFRAMES_PER_SECOND;
+		Bool wasSharing = HTreeClass::Is_Pose_Sharing_Enabled();
+
+		Int64 freq64 = getPerformanceCounterFrequency();
+		Real toMs = 1000.0f / ((Real)freq64 * NUM_FRAMES);
+
+		for( Int pass = 0; pass < 2; ++pass )
+		{
+			HTreeClass::Enable_Pose_Sharing( pass == 1 );
+			HTreeClass::Reset_Pose_Sharing_Stats();
+			HCompressedAnimClass::Reset_Frame_Cache_Stats();
+
+			Int64 animTime = 0;
+			Int64 skinTime = 0;
+			Real checksum = 0.0f;
+			for( Int f = 0; f < NUM_FRAMES; ++f )
+			{
+				Int64 startTime64 = getPerformanceCounter();
+				for( i = 0; i < numObjects; ++i )
+				{
+					Real frame = fmod( startFrames[i] + f * frameStep, numAnimFrames );
+					robjs[i]->Set_Animation( anim, frame, RenderObjClass::ANIM_MODE_MANUAL );
+					robjs[i]->Update_Sub_Object_Transforms();
+				}
+				Int64 midTime64 = getPerformanceCounter();
+				for( i = 0; i < numObjects; ++i )
+					checksum += skinAnimationBenchmarkObject( robjs[i], verts, norms, MAX_SKIN_VERTS );
+				Int64 endTime64 = getPerformanceCounter();
+
+				animTime += midTime64 - startTime64;
+				skinTime += endTime64 - midTime64;
+			}
+
+			Int hits, misses;
+			HTreeClass::Get_Pose_Sharing_Stats( hits, misses );
+			DEBUG_LOG(("Animation benchmark: %d x %s playing %s, %d frames, pose sharing %s\n", 
+				numObjects, modelName, animName, NUM_FRAMES, pass ? "on" : "off"));
+			DEBUG_LOG(("  animation: %.4f ms per frame, %d shared poses used, %d evaluated\n", (Real)animTime * toMs, hits, misses));
+			DEBUG_LOG(("  skinning:  %.4f ms per frame, checksum %f\n", (Real)skinTime * toMs, checksum));
+
+			Int frameHits, frameMisses;
+			Real decodeSeconds, savedSeconds;
+			HCompressedAnimClass::Get_Frame_Cache_Stats( frameHits, frameMisses, decodeSeconds, savedSeconds );
+			if( frameHits + frameMisses > 0 )
+				DEBUG_LOG(("  decoded frames: %d hits, %d misses, %.4f ms decoding, about %.4f ms saved\n", 
+					frameHits, frameMisses, decodeSeconds * 1000.0f, savedSeconds * 1000.0f));
+		}
+
+		HTreeClass::Enable_Pose_Sharing( wasSharing );
+		delete [] verts;
+		delete [] norms;
+	}
+	else
+	{
+		DEBUG_LOG(("Animation benchmark: can't create %s\n", modelName));
+	}
+
+	for( i = 0; i < numObjects; ++i )
+		REF_PTR_RELEASE( robjs[i] );
+	delete [] robjs;
+	delete [] startFrames;
+	REF_PTR_RELEASE( anim );
+}
+#endif
+
 // W3DDisplay::init ===========================================================
 /** Initialize or re-initialize the W3D display system.  Here we need to
   * create our window, and get our 3D hardware setup and online */
@@ -689,6 +861,11 @@ void W3DDisplay::init( void )
 	if( TheGlobalData->m_wireframe )
 		m_3DScene->Set_Polygon_Mode( SceneClass::LINE );
 #endif
+#if defined(_DEBUG) || defined(_INTERNAL)
+	// the game engine quits as soon as it's done initializing
+	if( TheGlobalData->m_viewCullBenchmark )
+		W3DSceneCullSystem::runBenchmark();
+#endif
 //============================================================================
 	// m_myLight = NEW_REF
 //============================================================================
@@ -733,6 +910,9 @@ void W3DDisplay::init( void )
 	if (WW3D::Init( ApplicationHWnd ) != WW3D_ERROR_OK)
 		throw ERROR_INVALID_D3D;	//failed to initialize.  User probably doesn't have DX 8.1
 
+	HTreeClass::Enable_Pose_Sharing( TheGlobalData->m_shareAnimationPoses );
+	HCompressedAnimClass::Set_Frame_Cache_Budget( TheGlobalData->m_animationFrameCacheSize * 1024 );
+
 	WW3D::Set_Prelit_Mode( WW3D::PRELIT_MODE_LIGHTMAP_MULTI_PASS );
 	WW3D::Set_Collision_Box_Display_Mask(0x00);	///<set to 0xff to make collision boxes visible
 	WW3D::Enable_Static_Sort_Lists(true);
@@ -801,6 +981,12 @@ void W3DDisplay::init( void )
 	init3DScene();
 	W3DShaderManager::init();
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+	// the game engine quits as soon as it's done initializing
+	if( TheGlobalData->m_animBenchmarkModel.isNotEmpty() )
+		runAnimationBenchmark( TheGlobalData->m_animBenchmarkModel.str(), TheGlobalData->m_animBenchmarkAnim.str(), TheGlobalData->m_animBenchmarkCount );
+#endif
+
 	// Create and initialize the debug display
 	m_nativeDebugDisplay = NEW W3DDebugDisplay();
 	m_debugDisplay = m_nativeDebugDisplay;
@@ -1365,8 +1551,8 @@ void W3DDisplay::gatherDebugStats( void )
 			m_displayStrings[NetIncoming]->setText( unibuffer );
 
 			// Network outgoing bandwidth stats
-			unibuffer.format(L"OUT: %.2f bytes/sec, %.2f packets/sec",
-				TheNetwork->getOutgoingBytesPerSecond(), TheNetwork->getOutgoingPacketsPerSecond());
+			unibuffer.format(L"OUT: %.2f bytes/sec (%.2f unpacked), %.2f packets/sec",
+				TheNetwork->getOutgoingBytesPerSecond(), TheNetwork->getOutgoingPayloadBytesPerSecond(), TheNetwork->getOutgoingPacketsPerSecond());
 			m_displayStrings[NetOutgoing]->setText( unibuffer );
 
 			// Network performance stats
@@ -3224,7 +3410,10 @@ void W3DDisplay::preloadModelAssets( AsciiString model )
 		AsciiString nameWithExtension;
 
 		nameWithExtension.format( "%s.w3d", model.str() );
-		m_assetManager->Load_3D_Assets( nameWithExtension.str() );
+		if( m_assetLoadQueue->isBatching() )
+			m_assetLoadQueue->addModel( nameWithExtension.str() );
+		else
+			m_assetManager->Load_3D_Assets( nameWithExtension.str() );
 
 	}  // end if
 
@@ -3238,12 +3427,39 @@ void W3DDisplay::preloadTextureAssets( AsciiString texture )
 
 	if( m_assetManager )
 	{
+		Int64 startTicks = W3DAssetLoadProfile::getTicks();
+
 		TextureClass *theTexture = m_assetManager->Get_Texture( texture.str() );
 		theTexture->Release_Ref();//release reference
+
+		if( m_assetLoadQueue->isBatching() )
+			m_assetLoadQueue->addTextureTime( W3DAssetLoadProfile::getTicks() - startTicks );
 	}  // end if
 
 }  // end preloadModelAssets
 
+//-------------------------------------------------------------------------------------------------
+/** From here until endPreloadBatch, preloadModelAssets only queues the models, so the files can
+	* be read in parallel */
+//-------------------------------------------------------------------------------------------------
+void W3DDisplay::beginPreloadBatch( void )
+{
+
+	m_assetLoadQueue->begin();
+
+}  // end beginPreloadBatch
+
+//-------------------------------------------------------------------------------------------------
+/** Load every model queued since beginPreloadBatch, reporting progress as it goes */
+//-------------------------------------------------------------------------------------------------
+void W3DDisplay::endPreloadBatch( PreloadProgressCallback *callback )
+{
+
+	if( m_assetLoadQueue->isBatching() )
+		m_assetLoadQueue->finish( m_assetManager, TheGlobalData->m_assetLoadThreads, callback );
+
+}  // end endPreloadBatch
+
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
 void W3DDisplay::doSmartAssetPurgeAndPreload(const char* usageFileName)
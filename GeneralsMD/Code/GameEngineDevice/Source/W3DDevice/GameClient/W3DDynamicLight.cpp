@@ -34,7 +34,12 @@ LightClass(LightClass::POINT)
 {
 
 	m_priorEnable = false;
+	m_processMe = false;
+	m_dirty = false;
 	m_enabled = true;
+	m_appliedPosition.Set(0,0,0);
+	m_appliedDiffuse.Set(0,0,0);
+	m_appliedRange = 0;
 
 }
 
@@ -33,6 +33,7 @@
 
 // SYSTEM INCLUDES ////////////////////////////////////////////////////////////
 #include <stdlib.h>
+#include <float.h>
 
 // USER INCLUDES //////////////////////////////////////////////////////////////
 #include "Lib/BaseType.h"
@@ -48,6 +49,7 @@
 #include "GameClient/View.h"
 #include "W3DDevice/GameClient/HeightMap.h"
 #include "W3DDevice/GameClient/W3DScene.h"
+#include "W3DDevice/GameClient/W3DSceneCull.h"
 #include "W3DDevice/GameClient/W3DDynamicLight.h"
 #include "W3DDevice/GameClient/W3DGranny.h"
 #include "W3DDevice/GameClient/W3DShadow.h"
@@ -87,6 +89,9 @@ extern void DoParticles(RenderInfoClass & rinfo);
 	ShaderClass::DETAILCOLOR_DISABLE, ShaderClass::DETAILALPHA_DISABLE) )
 static ShaderClass PlayerColorShader(SC_PLAYER_COLOR);
 
+#define OCCLUDER_GRID_MAX_CELLS	32								///< the occluder grid is at most this many cells on a side
+static const Real OCCLUDER_GRID_MIN_CELL_SIZE = 100.0f;	///< about the size of a large building
+
 //=============================================================================
 // RTS3DScene::RTS3DScene
 //=============================================================================
@@ -166,6 +171,23 @@ RTS3DScene::RTS3DScene()
 	m_potentialOccludees=NULL;
 	m_nonOccludersOrOccludees=NULL;
 
+	m_occluderCellStart = NEW Int [OCCLUDER_GRID_MAX_CELLS * OCCLUDER_GRID_MAX_CELLS + 1];
+	m_occluderCellList = NULL;
+	m_occluderCellListSize = 0;
+	m_occluderVisitStamp = NEW UnsignedInt [TheGlobalData->m_maxVisibleOccluderObjects];
+	memset(m_occluderVisitStamp, 0, TheGlobalData->m_maxVisibleOccluderObjects * sizeof(UnsignedInt));
+	m_occludeeRayStamp = 0;
+	m_occluderGridWidth = 0;
+	m_occluderGridHeight = 0;
+	m_occluderGridOriginX = 0;
+	m_occluderGridOriginY = 0;
+	m_occluderGridCellSize = OCCLUDER_GRID_MIN_CELL_SIZE;
+
+	if (TheGlobalData->m_useHierarchicalViewCulling)
+		m_cullSystem = NEW W3DSceneCullSystem;
+	else
+		m_cullSystem = NULL;
+
 	//Modify the shader to make occlusion transparent
 	ShaderClass shader = PlayerColorShader;
 	shader.Set_Src_Blend_Func(ShaderClass::SRCBLEND_SRC_ALPHA);
@@ -228,6 +250,15 @@ RTS3DScene::~RTS3DScene()
 	if (m_potentialOccluders)
 		delete [] m_potentialOccluders;
 
+	delete [] m_occluderCellStart;
+	delete [] m_occluderCellList;
+	delete [] m_occluderVisitStamp;
+
+	// the render objects stay in the RenderList until the base class lets them go, but the tree is done with them
+	if (m_cullSystem)
+		delete m_cullSystem;
+	m_cullSystem = NULL;
+
 	for (i=0; i<MAX_PLAYER_COUNT; i++)
 	{	REF_PTR_RELEASE(m_occludedMaterialPass[i]);
 	}
@@ -242,38 +273,152 @@ void	RTS3DScene::setGlobalLight(LightClass *pLight, Int lightIndex)
 	REF_PTR_SET(m_globalLight[lightIndex], pLight);
 }
 
-/**Find all objects which need to be drawn in a special way because they are occluded by other
-objects.
-@todo:  Need some kind of scene subdivision or find way to use Partition manger to speed up the ray
-intersection tests.  Maybe truncate the ray to terrain length before using it?
-*/
-void RTS3DScene::flagOccludedObjects(CameraClass * camera)
+//=============================================================================
+// RTS3DScene::binOccluders
+//=============================================================================
+/** Sort the potential occluders into a 2D grid over the ground, by the
+	* footprint of their bounding spheres, so that the ray to each occludee only
+	* has to look at the occluders it passes over. */
+//=============================================================================
+void RTS3DScene::binOccluders(void)
 {
-	Vector3 camPosition=camera->Get_Position();
+	Int i;
+	Real minX=FLT_MAX, minY=FLT_MAX, maxX=-FLT_MAX, maxY=-FLT_MAX;
 
-	//Find which objects are actually occluded
-	RenderObjClass **occludee=m_potentialOccludees;
-	LineSegClass lineseg;
-	CastResultStruct result;
-	Bool hit=FALSE;
-	Vector3 newEndPoint;
-	result.ComputeContactPoint=false;
-	RayCollisionTestClass raytest(lineseg,&result,COLL_TYPE_ALL,false,false);
-	raytest.CollisionType=COLL_TYPE_ALL;
+	for (i=0; i<m_numPotentialOccluders; i++)
+	{
+		const SphereClass &sphere = m_potentialOccluders[i]->Get_Bounding_Sphere();
+		minX = min(minX, sphere.Center.X - sphere.Radius);
+		minY = min(minY, sphere.Center.Y - sphere.Radius);
+		maxX = max(maxX, sphere.Center.X + sphere.Radius);
+		maxY = max(maxY, sphere.Center.Y + sphere.Radius);
+	}
 
-	m_occludedObjectsCount=0;
+	// cells no smaller than a typical building, and no more of them than the grid holds
+	Real cellSize = max(OCCLUDER_GRID_MIN_CELL_SIZE, max(maxX - minX, maxY - minY) / OCCLUDER_GRID_MAX_CELLS);
+	m_occluderGridCellSize = cellSize;
+	m_occluderGridOriginX = minX;
+	m_occluderGridOriginY = minY;
+	m_occluderGridWidth = min((Int)OCCLUDER_GRID_MAX_CELLS, (Int)((maxX - minX) / cellSize) + 1);
+	m_occluderGridHeight = min((Int)OCCLUDER_GRID_MAX_CELLS, (Int)((maxY - minY) / cellSize) + 1);
 
-	for (Int i=0; i<m_numPotentialOccludees; i++,occludee++)
-	{	
-		raytest.Ray.Set(camPosition,(*occludee)->Get_Position());
+	Int numCells = m_occluderGridWidth * m_occluderGridHeight;
+	memset(m_occluderCellStart, 0, (numCells + 1) * sizeof(Int));
 
-		RenderObjClass **occluder=m_potentialOccluders;
+	// count the occluders in each cell, then turn the counts into the end of each cell's run
+	Int x, y, x0, y0, x1, y1;
+	for (i=0; i<m_numPotentialOccluders; i++)
+	{
+		getOccluderCellRange(m_potentialOccluders[i], &x0, &y0, &x1, &y1);
+		for (y=y0; y<=y1; y++)
+			for (x=x0; x<=x1; x++)
+				m_occluderCellStart[y * m_occluderGridWidth + x]++;
+	}
+
+	Int total = 0;
+	for (i=0; i<numCells; i++)
+	{
+		total += m_occluderCellStart[i];
+		m_occluderCellStart[i] = total;
+	}
+	m_occluderCellStart[numCells] = total;
+
+	if (total > m_occluderCellListSize)
+	{
+		delete [] m_occluderCellList;
+		m_occluderCellListSize = max(total, m_occluderCellListSize * 2);
+		m_occluderCellList = NEW Int [m_occluderCellListSize];
+	}
 
-		//Check this object against all other possible blocking objects
-		for (Int j=0; j<m_numPotentialOccluders; j++,occluder++)
+	// fill each run from the back, which leaves m_occluderCellStart pointing at the front
+	for (i=m_numPotentialOccluders-1; i>=0; i--)
+	{
+		getOccluderCellRange(m_potentialOccluders[i], &x0, &y0, &x1, &y1);
+		for (y=y0; y<=y1; y++)
+			for (x=x0; x<=x1; x++)
+				m_occluderCellList[--m_occluderCellStart[y * m_occluderGridWidth + x]] = i;
+	}
+}
+
+//=============================================================================
+// RTS3DScene::getOccluderCellRange
+//=============================================================================
+/** The cells of the occluder grid covered by an occluder's bounding sphere. */
+//=============================================================================
+void RTS3DScene::getOccluderCellRange(RenderObjClass *occluder, Int *x0, Int *y0, Int *x1, Int *y1)
+{
+	const SphereClass &sphere = occluder->Get_Bounding_Sphere();
+	Real scale = 1.0f / m_occluderGridCellSize;
+
+	*x0 = (Int)((sphere.Center.X - sphere.Radius - m_occluderGridOriginX) * scale);
+	*y0 = (Int)((sphere.Center.Y - sphere.Radius - m_occluderGridOriginY) * scale);
+	*x1 = (Int)((sphere.Center.X + sphere.Radius - m_occluderGridOriginX) * scale);
+	*y1 = (Int)((sphere.Center.Y + sphere.Radius - m_occluderGridOriginY) * scale);
+
+	*x0 = max(0, min(m_occluderGridWidth - 1, *x0));
+	*y0 = max(0, min(m_occluderGridHeight - 1, *y0));
+	*x1 = max(0, min(m_occluderGridWidth - 1, *x1));
+	*y1 = max(0, min(m_occluderGridHeight - 1, *y1));
+}
+
+//=============================================================================
+// RTS3DScene::isRayOccluded
+//=============================================================================
+/** Walk the cells of the occluder grid under the ray, from the camera end to
+	* the occludee end, and test the occluders in them until one blocks the ray.
+	* The cells are chosen by the ray's shadow on the ground and the occluders
+	* by their spheres' footprints, so every occluder the ray could touch is
+	* tested.  Occluders that span several cells are only tested once. */
+//=============================================================================
+Bool RTS3DScene::isRayOccluded(RayCollisionTestClass &raytest)
+{
+	if (++m_occludeeRayStamp == 0)
+	{	//wrapped, so forget every occluder's old stamp
+		memset(m_occluderVisitStamp, 0, TheGlobalData->m_maxVisibleOccluderObjects * sizeof(UnsignedInt));
+		m_occludeeRayStamp = 1;
+	}
+
+	// the ray in grid space
+	Real scale = 1.0f / m_occluderGridCellSize;
+	Real startX = (raytest.Ray.Get_P0().X - m_occluderGridOriginX) * scale;
+	Real startY = (raytest.Ray.Get_P0().Y - m_occluderGridOriginY) * scale;
+	Real dx = (raytest.Ray.Get_P1().X - m_occluderGridOriginX) * scale - startX;
+	Real dy = (raytest.Ray.Get_P1().Y - m_occluderGridOriginY) * scale - startY;
+
+	// clip it to the grid
+	Real t0 = 0.0f, t1 = 1.0f;
+	if (!clipToSlab(startX, dx, 0.0f, (Real)m_occluderGridWidth, &t0, &t1) ||
+			!clipToSlab(startY, dy, 0.0f, (Real)m_occluderGridHeight, &t0, &t1))
+		return FALSE;	//passes beside all the occluders
+
+	Real x0 = startX + dx * t0;
+	Real y0 = startY + dy * t0;
+	Int cellX = max(0, min(m_occluderGridWidth - 1, (Int)x0));
+	Int cellY = max(0, min(m_occluderGridHeight - 1, (Int)y0));
+	Int endX = max(0, min(m_occluderGridWidth - 1, (Int)(startX + dx * t1)));
+	Int endY = max(0, min(m_occluderGridHeight - 1, (Int)(startY + dy * t1)));
+
+	// step from cell to cell across whichever boundary the ray reaches first
+	Int stepX = (dx > 0.0f) ? 1 : -1;
+	Int stepY = (dy > 0.0f) ? 1 : -1;
+	Real deltaX = (dx != 0.0f) ? fabs(1.0f / dx) : FLT_MAX;
+	Real deltaY = (dy != 0.0f) ? fabs(1.0f / dy) : FLT_MAX;
+	Real nextX = (dx > 0.0f) ? (cellX + 1 - x0) * deltaX : ((dx < 0.0f) ? (x0 - cellX) * deltaX : FLT_MAX);
+	Real nextY = (dy > 0.0f) ? (cellY + 1 - y0) * deltaY : ((dy < 0.0f) ? (y0 - cellY) * deltaY : FLT_MAX);
+	Int numSteps = abs(endX - cellX) + abs(endY - cellY);
+
+	for (Int step=0; step<=numSteps; step++)
+	{
+		Int cell = cellY * m_occluderGridWidth + cellX;
+		for (Int k=m_occluderCellStart[cell]; k<m_occluderCellStart[cell+1]; k++)
 		{
+			Int j = m_occluderCellList[k];
+			if (m_occluderVisitStamp[j] == m_occludeeRayStamp)
+				continue;	//already tested from another cell
+			m_occluderVisitStamp[j] = m_occludeeRayStamp;
+
 			// Do a quick ray-sphere test (Graphics Gems I,  p388)
-			RenderObjClass *robj=*occluder;
+			RenderObjClass *robj=m_potentialOccluders[j];
 
 			const SphereClass *sphere = &robj->Get_Bounding_Sphere();
 
@@ -291,16 +436,85 @@ void RTS3DScene::flagOccludedObjects(CameraClass * camera)
 			//Do a more accurate test against object geometry
 			if (robj->Cast_Ray(raytest))
 			{
-				//Found an object closer than last closest object
-				//Adjust our results and refine search
 				raytest.CollidedRenderObj = robj;
-				hit=TRUE;
 				//reset the result space for next test
-				result.StartBad = false; result.Fraction = 1.0f;
-				break;
+				raytest.Result->StartBad = false; raytest.Result->Fraction = 1.0f;
+				return TRUE;
 			}
 		}
-		if (hit)
+
+		if (nextX < nextY)
+		{
+			cellX += stepX;
+			nextX += deltaX;
+		}
+		else
+		{
+			cellY += stepY;
+			nextY += deltaY;
+		}
+		if (cellX < 0 || cellX >= m_occluderGridWidth || cellY < 0 || cellY >= m_occluderGridHeight)
+			break;	//rounding took us off the grid, we've seen all of the ray that's on it.
+	}
+
+	return FALSE;
+}
+
+//=============================================================================
+// RTS3DScene::clipToSlab
+//=============================================================================
+/** Narrow [t0,t1] to the part of start + t * delta that lies between lo and hi.
+	* Returns FALSE if none of it does. */
+//=============================================================================
+Bool RTS3DScene::clipToSlab(Real start, Real delta, Real lo, Real hi, Real *t0, Real *t1)
+{
+	if (delta == 0.0f)
+		return start >= lo && start <= hi;
+
+	Real tLo = (lo - start) / delta;
+	Real tHi = (hi - start) / delta;
+	if (tLo > tHi)
+	{
+		Real temp = tLo;
+		tLo = tHi;
+		tHi = temp;
+	}
+	*t0 = max(*t0, tLo);
+	*t1 = min(*t1, tHi);
+	return *t0 <= *t1;
+}
+
+/**Find all objects which need to be drawn in a special way because they are occluded by other
+objects.  The occluders are binned into a grid over the ground first, so each ray is only tested
+against the occluders it passes over rather than all of them.
+*/
+DECLARE_PERF_TIMER(flagOccludedObjects)
+void RTS3DScene::flagOccludedObjects(CameraClass * camera)
+{
+	USE_PERF_TIMER(flagOccludedObjects)
+
+	Vector3 camPosition=camera->Get_Position();
+
+	//Find which objects are actually occluded
+	RenderObjClass **occludee=m_potentialOccludees;
+	LineSegClass lineseg;
+	CastResultStruct result;
+	result.ComputeContactPoint=false;
+	RayCollisionTestClass raytest(lineseg,&result,COLL_TYPE_ALL,false,false);
+	raytest.CollisionType=COLL_TYPE_ALL;
+
+	m_occludedObjectsCount=0;
+
+	if (m_numPotentialOccluders == 0)
+		return;	//nothing to hide behind
+
+	binOccluders();
+
+	for (Int i=0; i<m_numPotentialOccludees; i++,occludee++)
+	{	
+		raytest.Ray.Set(camPosition,(*occludee)->Get_Position());
+
+		if (isRayOccluded(raytest))
 		{	//ocludee was blocked by something so flag it for custom rendering
 			DrawableInfo *drawInfo=(DrawableInfo *)(*occludee)->Get_User_Data();
 			drawInfo->m_flags |= DrawableInfo::ERF_IS_OCCLUDED;
@@ -385,6 +599,120 @@ Bool RTS3DScene::castRay(RayCollisionTestClass & raytest, Bool testAll, Int coll
 	return hit;
 }
 
+//=============================================================================
+// RTS3DScene::checkReflectionVisibility
+//=============================================================================
+/** Visibility of one top-level render object for the reflection pass.  If the
+  * bounding sphere is not in front of all the frustum planes, it is invisible. */
+//=============================================================================
+void RTS3DScene::checkReflectionVisibility(CameraClass * camera, RenderObjClass * robj)
+{
+	Drawable *draw=NULL;
+	DrawableInfo *drawInfo = (DrawableInfo *)robj->Get_User_Data();
+	if (drawInfo)
+		draw=drawInfo->m_drawable;
+
+	if( draw )
+	{
+		if (robj->Is_Force_Visible()) {
+			robj->Set_Visible(true);
+		} else {
+			robj->Set_Visible(draw->getDrawsInMirror() && !camera->Cull_Sphere(robj->Get_Bounding_Sphere()));
+		}
+	}
+	else
+	{	//perform normal culling on non-drawables
+		if (robj->Is_Force_Visible()) {
+			robj->Set_Visible(true);
+		} else {
+			robj->Set_Visible(!camera->Cull_Sphere(robj->Get_Bounding_Sphere()));
+		}
+	}
+}
+
+//=============================================================================
+// RTS3DScene::checkVisibility
+//=============================================================================
+/** Visibility of one top-level render object.  If the bounding sphere is not
+  * in front of all the frustum planes, it is invisible.  Visible drawables are
+  * also queued up for the translucent and occlusion passes. */
+//=============================================================================
+void RTS3DScene::checkVisibility(CameraClass * camera, RenderObjClass * robj, Int currentFrame)
+{
+	DrawableInfo *drawInfo = NULL;
+	Drawable	*draw = NULL;
+
+	if (robj->Is_Force_Visible()) {
+		robj->Set_Visible(true);
+	} else if (robj->Is_Hidden()) {
+		robj->Set_Visible(false);
+	} else {
+
+		bool isVisible=!camera->Cull_Sphere(robj->Get_Bounding_Sphere());
+
+		if (isVisible)
+		{	//need to keep track of occluders and ocludees for subsequent code.
+			drawInfo = (DrawableInfo *)robj->Get_User_Data();
+			if (drawInfo && (draw=drawInfo->m_drawable) != NULL)
+			{
+				if (draw->isDrawableEffectivelyHidden() || draw->getFullyObscuredByShroud())
+				{	
+					isVisible = FALSE;
+				  robj->Set_Visible(isVisible);
+        }
+				//assume normal rendering.
+				drawInfo->m_flags = DrawableInfo::ERF_IS_NORMAL;	//clear any rendering flags that may be in effect.
+
+        if ( ! isVisible )
+          return;
+
+				if (draw->getEffectiveOpacity() != 1.0f && m_translucentObjectsCount < TheGlobalData->m_maxVisibleTranslucentObjects)
+				{	drawInfo->m_flags |= DrawableInfo::ERF_IS_TRANSLUCENT;	//object is translucent
+					m_translucentObjectsBuffer[m_translucentObjectsCount++] = robj;
+				}
+				if (TheGlobalData->m_enableBehindBuildingMarkers && TheGameLogic->getShowBehindBuildingMarkers())
+				{
+					//visible drawable. Check if it's either an occluder or occludee
+					if (draw->isKindOf(KINDOF_STRUCTURE) && m_numPotentialOccluders < TheGlobalData->m_maxVisibleOccluderObjects)
+					{	//object which could occlude other objects that need to be visible.
+						//Make sure this object is not translucent so it's not rendered twice (from m_potentialOccluders and m_translucentObjectsBuffer)
+						if (drawInfo->m_flags ^ DrawableInfo::ERF_IS_TRANSLUCENT)
+							m_potentialOccluders[m_numPotentialOccluders++]=robj;
+						drawInfo->m_flags |= DrawableInfo::ERF_POTENTIAL_OCCLUDER;
+					}
+					else
+					if (draw->getObject() &&
+							(draw->isKindOf(KINDOF_SCORE) || draw->isKindOf(KINDOF_SCORE_CREATE) || draw->isKindOf(KINDOF_SCORE_DESTROY) || draw->isKindOf(KINDOF_MP_COUNT_FOR_VICTORY)) &&
+							(draw->getObject()->getSafeOcclusionFrame()) <= currentFrame && m_numPotentialOccludees < TheGlobalData->m_maxVisibleOccludeeObjects)
+					{	//object which could be occluded but still needs to be visible.
+						//We process transucent units twice (also in m_translucentObjectsBuffer) because we need to see them when occluded.
+						m_potentialOccludees[m_numPotentialOccludees++]=robj;
+						drawInfo->m_flags |= DrawableInfo::ERF_POTENTIAL_OCCLUDEE;
+					}
+					else
+					if (drawInfo->m_flags == DrawableInfo::ERF_IS_NORMAL && m_numNonOccluderOrOccludee < TheGlobalData->m_maxVisibleNonOccluderOrOccludeeObjects)
+					{	//regular object with no custom effects but still needs to be delayed to get the occlusion feature to work correctly.
+						//Make sure this object is not translucent so it's not rendered twice (from m_potentialOccluders and m_translucentObjectsBuffer)
+						if (drawInfo->m_flags ^ DrawableInfo::ERF_IS_TRANSLUCENT)	//make sure not translucent
+							m_nonOccludersOrOccludees[m_numNonOccluderOrOccludee++]=robj;
+						drawInfo->m_flags |= DrawableInfo::ERF_IS_NON_OCCLUDER_OR_OCCLUDEE;
+					}
+				}
+			}
+		}
+
+		robj->Set_Visible(isVisible);
+	}
+
+	///@todo: We're not using LOD yet so I disabled this code. MW
+	// Also, should check how multiple passes (reflections) get along
+	// with the LOD manager - we're rendering double the load it thinks we are.
+	// Prepare visible objects for LOD:
+	//	if (robj->Is_Really_Visible()) {
+	//			robj->Prepare_LOD(*camera);
+	//		}
+}
+
 //=============================================================================
 // RTS3DScene::Visibility_Check
 //=============================================================================
@@ -398,9 +726,6 @@ void RTS3DScene::Visibility_Check(CameraClass * camera)
 #endif
 
 	RefRenderObjListIterator it(&RenderList);
-	DrawableInfo *drawInfo = NULL;
-	Drawable	*draw = NULL;
-	RenderObjClass * robj;
 
 	m_numPotentialOccluders=0;
 	m_numPotentialOccludees=0;
@@ -412,124 +737,74 @@ void RTS3DScene::Visibility_Check(CameraClass * camera)
 	if (currentFrame <= TheGlobalData->m_defaultOcclusionDelay)
 		currentFrame = TheGlobalData->m_defaultOcclusionDelay+1;	//make sure occlusion is enabled when game starts (frame 0).
 
+	Bool reflection = ShaderClass::Is_Backface_Culling_Inverted();	///@todo: Have better flag to detect reflection pass
 
-	if (ShaderClass::Is_Backface_Culling_Inverted()) 
+	if (m_cullSystem)
+	{	//only look at what the tree says might be in view, plus whatever is visible now and may need hiding.
+		//Everything else is outside the frustum and already invisible, so checking it wouldn't change anything.
+		Int numToCheck = m_cullSystem->collectObjectsToCheck(camera);
+		for (Int i=0; i<numToCheck; i++)
+		{
+			if (reflection)
+				checkReflectionVisibility(camera, m_cullSystem->getObjectToCheck(i));
+			else
+				checkVisibility(camera, m_cullSystem->getObjectToCheck(i), currentFrame);
+		}
+	}
+	else if (reflection) 
 	{	//we are rendering reflections
-		///@todo: Have better flag to detect reflection pass
-
-		// Loop over all top-level RenderObjects in this scene. If the bounding sphere is not in front
-		// of all the frustum planes, it is invisible.
+		// Loop over all top-level RenderObjects in this scene.
 		for (it.First(); !it.Is_Done(); it.Next()) {
-
-			robj = it.Peek_Obj();
-
-			draw=NULL;
-			drawInfo = (DrawableInfo *)robj->Get_User_Data();
-			if (drawInfo)
-				draw=drawInfo->m_drawable;
-
-			if( draw )
-			{
-				if (robj->Is_Force_Visible()) {
-					robj->Set_Visible(true);
-				} else {
-					robj->Set_Visible(draw->getDrawsInMirror() && !camera->Cull_Sphere(robj->Get_Bounding_Sphere()));
-				}
-			}
-			else
-			{	//perform normal culling on non-drawables
-				if (robj->Is_Force_Visible()) {
-					robj->Set_Visible(true);
-				} else {
-					robj->Set_Visible(!camera->Cull_Sphere(robj->Get_Bounding_Sphere()));
-				}
-			}
+			checkReflectionVisibility(camera, it.Peek_Obj());
 		}
 	}
 	else
 	{
-
-		// Loop over all top-level RenderObjects in this scene. If the bounding sphere is not in front
-		// of all the frustum planes, it is invisible.
+		// Loop over all top-level RenderObjects in this scene.
 		for (it.First(); !it.Is_Done(); it.Next()) {
-
-			robj = it.Peek_Obj();
-
-			if (robj->Is_Force_Visible()) {
-				robj->Set_Visible(true);
-			} else if (robj->Is_Hidden()) {
-				robj->Set_Visible(false);
-			} else {
-
-				bool isVisible=!camera->Cull_Sphere(robj->Get_Bounding_Sphere());
-
-				if (isVisible)
-				{	//need to keep track of occluders and ocludees for subsequent code.
-					drawInfo = (DrawableInfo *)robj->Get_User_Data();
-					if (drawInfo && (draw=drawInfo->m_drawable) != NULL)
-					{
-						if (draw->isDrawableEffectivelyHidden() || draw->getFullyObscuredByShroud())
-						{	
-							isVisible = FALSE;
-						  robj->Set_Visible(isVisible);
-            }
-						//assume normal rendering.
-						drawInfo->m_flags = DrawableInfo::ERF_IS_NORMAL;	//clear any rendering flags that may be in effect.
-
-            if ( ! isVisible )
-              continue;
-
-						if (draw->getEffectiveOpacity() != 1.0f && m_translucentObjectsCount < TheGlobalData->m_maxVisibleTranslucentObjects)
-						{	drawInfo->m_flags |= DrawableInfo::ERF_IS_TRANSLUCENT;	//object is translucent
-							m_translucentObjectsBuffer[m_translucentObjectsCount++] = robj;
-						}
-						if (TheGlobalData->m_enableBehindBuildingMarkers && TheGameLogic->getShowBehindBuildingMarkers())
-						{
-							//visible drawable. Check if it's either an occluder or occludee
-							if (draw->isKindOf(KINDOF_STRUCTURE) && m_numPotentialOccluders < TheGlobalData->m_maxVisibleOccluderObjects)
-							{	//object which could occlude other objects that need to be visible.
-								//Make sure this object is not translucent so it's not rendered twice (from m_potentialOccluders and m_translucentObjectsBuffer)
-								if (drawInfo->m_flags ^ DrawableInfo::ERF_IS_TRANSLUCENT)
-									m_potentialOccluders[m_numPotentialOccluders++]=robj;
-								drawInfo->m_flags |= DrawableInfo::ERF_POTENTIAL_OCCLUDER;
-							}
-							else
-							if (draw->getObject() &&
-									(draw->isKindOf(KINDOF_SCORE) || draw->isKindOf(KINDOF_SCORE_CREATE) || draw->isKindOf(KINDOF_SCORE_DESTROY) || draw->isKindOf(KINDOF_MP_COUNT_FOR_VICTORY)) &&
-									(draw->getObject()->getSafeOcclusionFrame()) <= currentFrame && m_numPotentialOccludees < TheGlobalData->m_maxVisibleOccludeeObjects)
-							{	//object which could be occluded but still needs to be visible.
-								//We process transucent units twice (also in m_translucentObjectsBuffer) because we need to see them when occluded.
-								m_potentialOccludees[m_numPotentialOccludees++]=robj;
-								drawInfo->m_flags |= DrawableInfo::ERF_POTENTIAL_OCCLUDEE;
-							}
-							else
-							if (drawInfo->m_flags == DrawableInfo::ERF_IS_NORMAL && m_numNonOccluderOrOccludee < TheGlobalData->m_maxVisibleNonOccluderOrOccludeeObjects)
-							{	//regular object with no custom effects but still needs to be delayed to get the occlusion feature to work correctly.
-								//Make sure this object is not translucent so it's not rendered twice (from m_potentialOccluders and m_translucentObjectsBuffer)
-								if (drawInfo->m_flags ^ DrawableInfo::ERF_IS_TRANSLUCENT)	//make sure not translucent
-									m_nonOccludersOrOccludees[m_numNonOccluderOrOccludee++]=robj;
-								drawInfo->m_flags |= DrawableInfo::ERF_IS_NON_OCCLUDER_OR_OCCLUDEE;
-							}
-						}
-					}
-				}
-
-				robj->Set_Visible(isVisible);
-			}
-
-			///@todo: We're not using LOD yet so I disabled this code. MW
-			// Also, should check how multiple passes (reflections) get along
-			// with the LOD manager - we're rendering double the load it thinks we are.
-			// Prepare visible objects for LOD:
-			//	if (robj->Is_Really_Visible()) {
-			//			robj->Prepare_LOD(*camera);
-			//		}
+			checkVisibility(camera, it.Peek_Obj(), currentFrame);
 		}
 	}
 
    Visibility_Checked = true;
 }
 
+//=============================================================================
+// RTS3DScene::Add_Render_Object
+//=============================================================================
+/** */
+//=============================================================================
+void RTS3DScene::Add_Render_Object(RenderObjClass * obj)
+{
+	SimpleSceneClass::Add_Render_Object(obj);
+	if (m_cullSystem)
+		m_cullSystem->addRenderObject(obj);
+}
+
+//=============================================================================
+// RTS3DScene::Remove_Render_Object
+//=============================================================================
+/** */
+//=============================================================================
+void RTS3DScene::Remove_Render_Object(RenderObjClass * obj)
+{
+	if (m_cullSystem)
+		m_cullSystem->removeRenderObject(obj);
+	SimpleSceneClass::Remove_Render_Object(obj);
+}
+
+//=============================================================================
+// RTS3DScene::Remove_All_Render_Objects
+//=============================================================================
+/** */
+//=============================================================================
+void RTS3DScene::Remove_All_Render_Objects(void)
+{
+	if (m_cullSystem)
+		m_cullSystem->removeAll();
+	SimpleSceneClass::Remove_All_Render_Objects();
+}
+
 //============================================================================
 // RTS3DScene::renderSingleDrawable
 //=============================================================================
@@ -541,6 +816,7 @@ void RTS3DScene::renderSpecificDrawables(RenderInfoClass &rinfo, Int numDrawable
 	StDrawableDirtyStuffLocker lockDirtyStuff;
 #endif
 	Int localPlayerIndex = ThePlayerList ? ThePlayerList->getLocalPlayer()->getPlayerIndex() : 0;
+	gatherDynamicLights();
 	RefRenderObjListIterator it(&UpdateList);	
 	// loop through all render objects in the list:
 	for (it.First(&RenderList); !it.Is_Done();) 
@@ -769,18 +1045,13 @@ void RTS3DScene::renderOneObject(RenderInfoClass &rinfo, RenderObjClass *robj, I
     if( draw && draw->getReceivesDynamicLights() )
     {
 		  // dynamic lights
-		  RefRenderObjListIterator dynaLightIt(&m_dynamicLightList);	
-		  for (dynaLightIt.First(); !dynaLightIt.Is_Done(); dynaLightIt.Next())
+		  for (Int dynaIndex = 0; dynaIndex < m_litDynamicLights.size(); dynaIndex++)
 		  {	
-			  W3DDynamicLight* pDyna = (W3DDynamicLight*)dynaLightIt.Peek_Obj();
-			  if (!pDyna->isEnabled()) {
+			  W3DDynamicLight* pDyna = m_litDynamicLights[dynaIndex];
+			  if (pDyna->Get_Type() == LightClass::POINT && !Spheres_Intersect(sph, m_litDynamicLightSpheres[dynaIndex])) {
 				  continue;
 			  }
-			  SphereClass lSph = pDyna->Get_Bounding_Sphere();
-			  if (pDyna->Get_Type() == LightClass::POINT && !Spheres_Intersect(sph, lSph)) {
-				  continue;
-			  }
-			  lightEnv.Add_Light(*(LightClass*)dynaLightIt.Peek_Obj());
+			  lightEnv.Add_Light(*pDyna);
 		  }
     }
 		
@@ -920,6 +1191,36 @@ void RTS3DScene::updateFixedLightEnvironments(RenderInfoClass & rinfo)
 	m_infantryAmbient = Get_Ambient_Light();// * infantryLightScale;	//for now don't adjust ambient so that we don't lose directional lighting.
 }
 
+//=============================================================================
+// RTS3DScene::gatherDynamicLights
+//=============================================================================
+/** Collects the dynamic lights that can light an object, with their bounding spheres, 
+so each object only looks at those.  Lights that are off, or too dark for the light 
+environment to take, are left out.  The pool of dynamic lights keeps every light an 
+explosion ever used, so most of the list is usually off. */
+//=============================================================================
+void RTS3DScene::gatherDynamicLights(void)
+{
+	m_litDynamicLights.clear();
+	m_litDynamicLightSpheres.clear();
+	RefRenderObjListIterator dynaLightIt(&m_dynamicLightList);	
+	for (dynaLightIt.First(); !dynaLightIt.Is_Done(); dynaLightIt.Next())
+	{	
+		W3DDynamicLight* pDyna = (W3DDynamicLight*)dynaLightIt.Peek_Obj();
+		if (!pDyna->isEnabled()) {
+			continue;
+		}
+		// LightEnvironmentClass::Add_Light ignores lights this dark.
+		Vector3 diffuse;
+		pDyna->Get_Diffuse(&diffuse);
+		if (diffuse.X < 0.05f && diffuse.Y < 0.05f && diffuse.Z < 0.05f) {
+			continue;
+		}
+		m_litDynamicLights.push_back(pDyna);
+		m_litDynamicLightSpheres.push_back(pDyna->Get_Bounding_Sphere());
+	}
+}
+
 /**Generate custom rendering passes for each potential player color.  This is currently only used
 to render occluded objects using the color of the player*/
 void RTS3DScene::updatePlayerColorPasses(void)
@@ -1087,6 +1388,7 @@ void RTS3DScene::Customized_Render( RenderInfoClass &rinfo )
 	RenderObjClass *terrainObject=NULL,*robj;
 	m_translucentObjectsCount = 0;	//start of new frame so no translucent objects
 	m_occludedObjectsCount = 0;
+	gatherDynamicLights();
 
 	Int localPlayerIndex = ThePlayerList ? ThePlayerList->getLocalPlayer()->getPlayerIndex() : 0;
 
@@ -0,0 +1,381 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+//																																						//
+//  (c) 2001-2003 Electronic Arts Inc.																				//
+//																																						//
+////////////////////////////////////////////////////////////////////////////////
+
+// FILE: W3DSceneCull.cpp /////////////////////////////////////////////////////
+//
+// AABTree of the render objects in the 3D scene, so the visibility check
+// only has to look at the objects near the view frustum.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES ////////////////////////////////////////////////////////////
+#include <windows.h>
+#include <algorithm>
+
+// USER INCLUDES //////////////////////////////////////////////////////////////
+#include "Lib/BaseType.h"
+#include "Common/Debug.h"
+#include "Common/RandomValue.h"
+#include "W3DDevice/GameClient/W3DSceneCull.h"
+#include "WW3D2/camera.h"
+#include "WW3D2/rendobj.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// DEFINITIONS ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+/// Slack around each object's bounding sphere, so units wandering about don't have to be re-inserted every frame.
+static const Real CULL_BOX_PADDING = 20.0f;
+
+/// Rebuild the tree once this many objects (or half of them, if that's more) have been added or moved.
+static const Int MIN_REPARTITION_CHANGES = 256;
+
+//-----------------------------------------------------------------------------
+/** RenderList adds to the head, so newest first is the order the scene
+	* would have visited the objects in. */
+//-----------------------------------------------------------------------------
+static bool isNewerProxy(const W3DSceneCullProxy *a, const W3DSceneCullProxy *b)
+{
+	return a->m_sequence > b->m_sequence;
+}
+
+//=============================================================================
+// W3DSceneCullSystem::W3DSceneCullSystem
+//=============================================================================
+/** */
+//=============================================================================
+W3DSceneCullSystem::W3DSceneCullSystem() :
+	m_nextSequence(0),
+	m_checkStamp(0),
+	m_changesSincePartition(0)
+{
+}
+
+//=============================================================================
+// W3DSceneCullSystem::~W3DSceneCullSystem
+//=============================================================================
+/** */
+//=============================================================================
+W3DSceneCullSystem::~W3DSceneCullSystem()
+{
+	removeAll();
+}
+
+//=============================================================================
+// W3DSceneCullSystem::setCullBox
+//=============================================================================
+/** Fit the proxy's cull box around the sphere, with some slack.  If the proxy
+	* is already in the tree, setting the box re-inserts it. */
+//=============================================================================
+void W3DSceneCullSystem::setCullBox(W3DSceneCullProxy *proxy, const SphereClass &sphere)
+{
+	Real extent = sphere.Radius + CULL_BOX_PADDING;
+	proxy->Set_Cull_Box(AABoxClass(sphere.Center, Vector3(extent, extent, extent)));
+}
+
+//=============================================================================
+// W3DSceneCullSystem::addRenderObject
+//=============================================================================
+/** */
+//=============================================================================
+void W3DSceneCullSystem::addRenderObject(RenderObjClass *robj)
+{
+	if (m_proxyMap.find(robj) != m_proxyMap.end())
+	{
+		DEBUG_CRASH(("W3DSceneCullSystem::addRenderObject - render object is already in the scene"));
+		return;
+	}
+
+	W3DSceneCullProxy *proxy = NEW_REF(W3DSceneCullProxy, (robj, m_nextSequence++));
+	setCullBox(proxy, robj->Get_Bounding_Sphere());
+	proxy->m_index = m_proxies.size();
+	m_proxies.push_back(proxy);
+	m_proxyMap[robj] = proxy;
+
+	m_tree.Add_Object(proxy);
+	++m_changesSincePartition;
+}
+
+//=============================================================================
+// W3DSceneCullSystem::removeRenderObject
+//=============================================================================
+/** */
+//=============================================================================
+void W3DSceneCullSystem::removeRenderObject(RenderObjClass *robj)
+{
+	ProxyMap::iterator it = m_proxyMap.find(robj);
+	if (it == m_proxyMap.end())
+		return;
+
+	W3DSceneCullProxy *proxy = it->second;
+	m_proxyMap.erase(it);
+
+	// fill the hole with the last proxy, the order of m_proxies doesn't matter
+	W3DSceneCullProxy *last = m_proxies.back();
+	m_proxies[proxy->m_index] = last;
+	last->m_index = proxy->m_index;
+	m_proxies.pop_back();
+
+	m_tree.Remove_Object(proxy);
+	REF_PTR_RELEASE(proxy);
+}
+
+//=============================================================================
+// W3DSceneCullSystem::removeAll
+//=============================================================================
+/** */
+//=============================================================================
+void W3DSceneCullSystem::removeAll(void)
+{
+	for (Int i=0; i<m_proxies.size(); i++)
+	{
+		W3DSceneCullProxy *proxy = m_proxies[i];
+		m_tree.Remove_Object(proxy);
+		REF_PTR_RELEASE(proxy);
+	}
+	m_proxies.clear();
+	m_proxyMap.clear();
+	m_objectsToCheck.clear();
+	m_changesSincePartition = 0;
+}
+
+//=============================================================================
+// W3DSceneCullSystem::collectObjectsToCheck
+//=============================================================================
+/** Bring the tree up to date with wherever the objects are now, then gather
+	* everything that is visible at the moment or could be in the camera's
+	* frustum.  The tree test is against the padded cull boxes, so it may let
+	* through a few objects that the exact sphere test will still cull, but it
+	* never leaves out one that the sphere test would pass. */
+//=============================================================================
+Int W3DSceneCullSystem::collectObjectsToCheck(CameraClass *camera)
+{
+	++m_checkStamp;
+	m_objectsToCheck.clear();
+
+	Int numProxies = m_proxies.size();
+	for (Int i=0; i<numProxies; i++)
+	{
+		W3DSceneCullProxy *proxy = m_proxies[i];
+		RenderObjClass *robj = proxy->m_robj;
+
+		const SphereClass &sphere = robj->Get_Bounding_Sphere();
+		const AABoxClass &box = proxy->Get_Cull_Box();
+		if (fabs(sphere.Center.X - box.Center.X) + sphere.Radius > box.Extent.X ||
+				fabs(sphere.Center.Y - box.Center.Y) + sphere.Radius > box.Extent.Y ||
+				fabs(sphere.Center.Z - box.Center.Z) + sphere.Radius > box.Extent.Z)
+		{	//moved out of its box
+			setCullBox(proxy, sphere);
+			++m_changesSincePartition;
+		}
+
+		// whatever is visible now has to be checked again, even if it left the frustum
+		if (robj->Is_Visible() || robj->Is_Force_Visible())
+		{
+			proxy->m_checkStamp = m_checkStamp;
+			m_objectsToCheck.push_back(proxy);
+		}
+	}
+
+	if (numProxies > 0 && m_changesSincePartition > max(MIN_REPARTITION_CHANGES, numProxies/2))
+	{
+		m_tree.Re_Partition();
+		m_changesSincePartition = 0;
+	}
+
+	m_tree.Reset_Collection();
+	m_tree.Collect_Objects(camera->Get_Frustum());
+	for (W3DSceneCullProxy *proxy = m_tree.Get_First_Collected_Object(); proxy; proxy = m_tree.Get_Next_Collected_Object(proxy))
+	{
+		if (proxy->m_checkStamp != m_checkStamp)
+		{
+			proxy->m_checkStamp = m_checkStamp;
+			m_objectsToCheck.push_back(proxy);
+		}
+	}
+
+	// the occlusion and translucency buffers are filled in the order objects are checked, so keep it the same
+	std::sort(m_objectsToCheck.begin(), m_objectsToCheck.end(), isNewerProxy);
+
+	return m_objectsToCheck.size();
+}
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+
+//-----------------------------------------------------------------------------
+/** Just a bounding sphere, for filling the benchmark scenes. */
+//-----------------------------------------------------------------------------
+class CullBenchmarkObjClass : public RenderObjClass
+{
+public:
+	CullBenchmarkObjClass(Real radius) : m_radius(radius) {}
+
+	virtual RenderObjClass *Clone(void) const { return NEW_REF(CullBenchmarkObjClass, (m_radius)); }
+	virtual void Render(RenderInfoClass &rinfo) {}
+	virtual void Get_Obj_Space_Bounding_Sphere(SphereClass &sphere) const { sphere.Center.Set(0, 0, 0); sphere.Radius = m_radius; }
+	virtual void Get_Obj_Space_Bounding_Box(AABoxClass &box) const { box.Center.Set(0, 0, 0); box.Extent.Set(m_radius, m_radius, m_radius); }
+
+protected:
+	Real m_radius;
+};
+
+//=============================================================================
+// W3DSceneCullSystem::runBenchmark
+//=============================================================================
+/** Scatter 1000, 5000 and 20000 objects over a large map, keep a tenth of
+	* them moving, and pan a game-like camera across it.  Each frame runs the
+	* plain sphere test over every object and the tree path over the objects it
+	* collects, and checks that both come up with the same visible set, object by
+	* object.  The linear pass goes first, and the flags the tree path left last
+	* frame are put back before it runs, since it re-checks whatever it had as
+	* visible and mustn't be handed the linear pass's answers. */
+//=============================================================================
+void W3DSceneCullSystem::runBenchmark(void)
+{
+	const Int NUM_SCENES = 3;
+	const Int sceneSizes[NUM_SCENES] = { 1000, 5000, 20000 };
+	const Int NUM_FRAMES = 300;
+	const Real MAP_SIZE = 4000.0f;
+	const Real UNIT_SPEED = 3.0f;
+	const Real CAMERA_HEIGHT = 300.0f;
+
+	__int64 freq64, startTime64, endTime64;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&freq64);
+
+	CameraClass *camera = NEW_REF(CameraClass, ());
+	camera->Set_Clip_Planes(1.0f, 1500.0f);
+	camera->Set_View_Plane(DEG_TO_RADF(50.0f), -1);
+
+	for (Int scene=0; scene<NUM_SCENES; scene++)
+	{
+		Int i;
+		Int numObjects = sceneSizes[scene];
+		Int numMoving = numObjects / 10;
+		RenderObjClass **objects = NEW RenderObjClass* [numObjects];
+		Bool *linearFlags = NEW Bool [numObjects];
+		Bool *treeFlags = NEW Bool [numObjects];
+		W3DSceneCullSystem *cullSystem = NEW W3DSceneCullSystem;
+
+		for (i=0; i<numObjects; i++)
+		{
+			// the moving ones are unit sized, the rest are anything from a shrub to a building
+			Real radius = (i < numMoving) ? GameClientRandomValueReal(5.0f, 15.0f) : GameClientRandomValueReal(3.0f, 60.0f);
+			objects[i] = NEW_REF(CullBenchmarkObjClass, (radius));
+			objects[i]->Set_Position(Vector3(GameClientRandomValueReal(0, MAP_SIZE), GameClientRandomValueReal(0, MAP_SIZE), 0));
+			objects[i]->Set_Visible(false);
+			treeFlags[i] = false;
+			cullSystem->addRenderObject(objects[i]);
+		}
+
+		__int64 linearTime = 0;
+		__int64 treeTime = 0;
+		Int checked = 0;
+		Int visible = 0;
+		Int mismatches = 0;
+		Int mismatchedFrames = 0;
+
+		for (Int frame=0; frame<NUM_FRAMES; frame++)
+		{
+			for (i=0; i<numMoving; i++)
+			{
+				Vector3 pos = objects[i]->Get_Position();
+				pos.X += GameClientRandomValueReal(-UNIT_SPEED, UNIT_SPEED);
+				pos.Y += GameClientRandomValueReal(-UNIT_SPEED, UNIT_SPEED);
+				objects[i]->Set_Position(pos);
+			}
+
+			// pan diagonally across the map and back
+			Real t = (Real)frame / (Real)(NUM_FRAMES - 1);
+			Real along = (t < 0.5f) ? t * 2.0f : (1.0f - t) * 2.0f;
+			Vector3 target(along * MAP_SIZE, along * MAP_SIZE, 0);
+			Vector3 source(target.X, target.Y - CAMERA_HEIGHT, CAMERA_HEIGHT);
+			Matrix3D camTransform;
+			camTransform.Look_At(source, target, 0);
+			camera->Set_Transform(camTransform);
+
+			// linear, as RTS3DScene does it without the tree
+			QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+			for (i=0; i<numObjects; i++)
+			{
+				RenderObjClass *robj = objects[i];
+				robj->Set_Visible(!camera->Cull_Sphere(robj->Get_Bounding_Sphere()));
+			}
+			QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+			linearTime += endTime64 - startTime64;
+			for (i=0; i<numObjects; i++)
+			{
+				linearFlags[i] = objects[i]->Is_Visible();
+				if (linearFlags[i])
+					++visible;
+
+				// back to what the tree path left, which is all it would have to go on
+				objects[i]->Set_Visible(treeFlags[i]);
+			}
+
+			// tree
+			QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+			Int numToCheck = cullSystem->collectObjectsToCheck(camera);
+			for (i=0; i<numToCheck; i++)
+			{
+				RenderObjClass *robj = cullSystem->getObjectToCheck(i);
+				robj->Set_Visible(!camera->Cull_Sphere(robj->Get_Bounding_Sphere()));
+			}
+			QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+			treeTime += endTime64 - startTime64;
+			checked += numToCheck;
+
+			Int frameMismatches = 0;
+			for (i=0; i<numObjects; i++)
+			{
+				treeFlags[i] = objects[i]->Is_Visible();
+				if (treeFlags[i] != linearFlags[i])
+					++frameMismatches;
+			}
+			if (frameMismatches > 0)
+			{
+				mismatches += frameMismatches;
+				++mismatchedFrames;
+			}
+		}
+
+		Real toMs = 1000.0f / ((Real)freq64 * NUM_FRAMES);
+		DEBUG_LOG(("View cull benchmark: %d objects (%d moving), %d frames\n", numObjects, numMoving, NUM_FRAMES));
+		DEBUG_LOG(("  linear: %.4f ms per check\n", (Real)linearTime * toMs));
+		DEBUG_LOG(("  tree:   %.4f ms per check, %d objects checked, %d visible\n", (Real)treeTime * toMs, checked / NUM_FRAMES, visible / NUM_FRAMES));
+		DEBUG_ASSERTCRASH(mismatches == 0, ("View cull benchmark: the tree disagreed with the linear check on %d objects over %d frames", mismatches, mismatchedFrames));
+
+		delete cullSystem;
+		for (i=0; i<numObjects; i++)
+		{
+			REF_PTR_RELEASE(objects[i]);
+		}
+		delete [] objects;
+		delete [] linearFlags;
+		delete [] treeFlags;
+	}
+
+	REF_PTR_RELEASE(camera);
+}
+
+#endif // defined(_DEBUG) || defined(_INTERNAL)
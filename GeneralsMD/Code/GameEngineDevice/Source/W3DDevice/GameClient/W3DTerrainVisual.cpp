@@ -1266,6 +1266,7 @@ void W3DTerrainVisual::xfer( Xfer *xfer )
 		xfer->xferUser(data, len);	
 		if (xfer->getXferMode() == XFER_LOAD)	
     {	
+			m_logicHeightMap->invalidateMaxHeights();
 			// Update the display height map.
 			m_terrainRenderObject->staticLightingChanged();
 		}
@@ -292,6 +292,8 @@ ShaderClass ShaderClass::_PresetAlpha2DShader(SC_ALPHA_2D);
 //         Private Functions                                               
 //-----------------------------------------------------------------------------
 
+DECLARE_PERF_TIMER(Tree_Cull)
+
 //=============================================================================
 // W3DTreeBuffer::cull
 //=============================================================================
@@ -300,6 +302,7 @@ it's sortKey */
 //=============================================================================
 void W3DTreeBuffer::cull(const CameraClass * camera)
 {
+	USE_PERF_TIMER(Tree_Cull)
 	Int curTree;
 
 	// Calulate the vector direction that the camera is looking at.
@@ -310,21 +313,47 @@ void W3DTreeBuffer::cull(const CameraClass * camera)
 	float z = zmod * camera_matrix[2][2] ;
 	m_cameraLookAtVector.Set(x,y,z);
 
-	for (curTree=0; curTree<m_numTrees; curTree++) {
-		Bool doKey = false;	// We calculate the key when a tree becomes visible.
-		Bool visible = !camera->Cull_Sphere(m_trees[curTree].bounds);
-		if (visible != m_trees[curTree].visible) {
-			m_trees[curTree].visible=visible;
-			m_anythingChanged = true;
-			if (visible) {
-				doKey = true;
+	// Cull a block of the area partition at a time.  If the block is outside the view, so 
+	// is every tree in it, and if it was outside last time too they are already invisible.
+	Int blockX, blockY;
+	for (blockY=0; blockY<CULL_BLOCKS_WIDTH_HEIGHT; blockY++) {
+		for (blockX=0; blockX<CULL_BLOCKS_WIDTH_HEIGHT; blockX++) {
+			Int block = blockY*CULL_BLOCKS_WIDTH_HEIGHT + blockX;
+			if (!m_cullBlockHasTrees[block]) {
+				continue;
+			}
+			Bool blockVisible = !camera->Cull_Box(AABoxClass(m_cullBlockBounds[block]));
+			if (!blockVisible && !m_cullBlockVisible[block]) {
+				continue;
+			}
+			m_cullBlockVisible[block] = blockVisible;
+
+			Int i, j;
+			for (j=blockY*CULL_BLOCK_BUCKETS; j<(blockY+1)*CULL_BLOCK_BUCKETS; j++) {
+				for (i=blockX*CULL_BLOCK_BUCKETS; i<(blockX+1)*CULL_BLOCK_BUCKETS; i++) {
+					for (curTree = m_areaPartition[i + PARTITION_WIDTH_HEIGHT*j]; curTree != END_OF_PARTITION; 
+							curTree = m_trees[curTree].nextInPartition) {
+						if (m_trees[curTree].treeType<0) {
+							continue; // Deleted tree.
+						}
+						Bool doKey = false;	// We calculate the key when a tree becomes visible.
+						Bool visible = blockVisible && !camera->Cull_Sphere(m_trees[curTree].bounds);
+						if (visible != m_trees[curTree].visible) {
+							m_trees[curTree].visible=visible;
+							m_anythingChanged = true;
+							if (visible) {
+								doKey = true;
+							}
+						}
+						// Also calculate sort key if a tree is visible, and the view changed setting m_updateAllKeys to true.
+						if (doKey || (visible&&m_updateAllKeys)) {
+							// The sort key is essentially the distance of location in the direction of the 
+							// camera look at.
+							m_trees[curTree].sortKey = Vector3::Dot_Product(m_trees[curTree].location, m_cameraLookAtVector); 
+						}
+					}
+				}
 			}
-		}
-		// Also calculate sort key if a tree is visible, and the view changed setting m_updateAllKeys to true.
-		if (doKey || (visible&&m_updateAllKeys)) {
-			// The sort key is essentially the distance of location in the direction of the 
-			// camera look at.
-			m_trees[curTree].sortKey = Vector3::Dot_Product(m_trees[curTree].location, m_cameraLookAtVector); 
 		}
 	}
 	m_updateAllKeys = false;
@@ -348,6 +377,100 @@ Int W3DTreeBuffer::getPartitionBucket(const Coord3D &pos) const
 	return yIndex*PARTITION_WIDTH_HEIGHT + xIndex;
 }
 
+//=============================================================================
+// W3DTreeBuffer::addToPartition
+//=============================================================================
+/** Links a tree into the area partition bucket for its location, and grows the 
+bounds of the cull block holding that bucket to include the tree. */
+//=============================================================================
+void W3DTreeBuffer::addToPartition(Int treeNdx)
+{
+	TTree *tree = &m_trees[treeNdx];
+	Coord3D location;
+	location.set(tree->location.X, tree->location.Y, tree->location.Z);
+	Int bucket = getPartitionBucket(location);
+	tree->nextInPartition = m_areaPartition[bucket];
+	m_areaPartition[bucket] = treeNdx;
+
+	Int blockX = (bucket%PARTITION_WIDTH_HEIGHT)/CULL_BLOCK_BUCKETS;
+	Int blockY = (bucket/PARTITION_WIDTH_HEIGHT)/CULL_BLOCK_BUCKETS;
+	Int block = blockY*CULL_BLOCKS_WIDTH_HEIGHT + blockX;
+	Vector3 radius(tree->bounds.Radius, tree->bounds.Radius, tree->bounds.Radius);
+	m_cullBlockBounds[block].Add_Box(tree->bounds.Center-radius, tree->bounds.Center+radius);
+	m_cullBlockHasTrees[block] = true;
+	// Make the next cull look at the block, as the new tree may be in view.
+	m_cullBlockVisible[block] = true;
+}
+
+//=============================================================================
+// W3DTreeBuffer::rebuildPartition
+//=============================================================================
+/** Puts every tree back in the area partition, after the bounds changed. */
+//=============================================================================
+void W3DTreeBuffer::rebuildPartition(void)
+{
+	Int i;
+	for (i=0; i<PARTITION_WIDTH_HEIGHT*PARTITION_WIDTH_HEIGHT; i++) {
+		m_areaPartition[i] = END_OF_PARTITION;
+	}
+	for (i=0; i<CULL_BLOCKS_WIDTH_HEIGHT*CULL_BLOCKS_WIDTH_HEIGHT; i++) {
+		m_cullBlockBounds[i].Init_Empty();
+		m_cullBlockHasTrees[i] = false;
+		m_cullBlockVisible[i] = true;
+	}
+	for (i=0; i<m_numTrees; i++) {
+		addToPartition(i);
+	}
+}
+
+//=============================================================================
+// W3DTreeBuffer::setBounds
+//=============================================================================
+/** Sets the area covered by the area partition. */
+//=============================================================================
+void W3DTreeBuffer::setBounds(const Region2D &bounds)
+{
+	Bool changed = m_bounds.lo.x != bounds.lo.x || m_bounds.lo.y != bounds.lo.y ||
+		m_bounds.hi.x != bounds.hi.x || m_bounds.hi.y != bounds.hi.y;
+	m_bounds = bounds;
+	if (changed && m_numTrees>0) {
+		rebuildPartition();
+	}
+}
+
+//=============================================================================
+// W3DTreeBuffer::activateTree
+//=============================================================================
+/** Adds a tree to the list of trees that are updated each frame. */
+//=============================================================================
+void W3DTreeBuffer::activateTree(Int treeNdx)
+{
+	if (!m_trees[treeNdx].active) {
+		m_trees[treeNdx].active = true;
+		m_activeTrees[m_numActiveTrees++] = treeNdx;
+	}
+}
+
+//=============================================================================
+// W3DTreeBuffer::deleteTree
+//=============================================================================
+/** Deletes a tree.  If it was drawn it gets collapsed out of the vertex buffer on 
+the next draw, rather than reloading every tree. */
+//=============================================================================
+void W3DTreeBuffer::deleteTree(Int treeNdx)
+{
+	if (m_trees[treeNdx].treeType < 0) {
+		return;
+	}
+	Int type = m_trees[treeNdx].treeType;
+	if (m_trees[treeNdx].visible && m_trees[treeNdx].bufferNdx >= 0 && m_treeTypes[type].m_mesh) {
+		m_treesToCollapse[m_numTreesToCollapse] = treeNdx;
+		m_collapseNumVertices[m_numTreesToCollapse] = m_treeTypes[type].m_mesh->Peek_Model()->Get_Vertex_Count();
+		m_numTreesToCollapse++;
+	}
+	m_trees[treeNdx].treeType = DELETED_TREE_TYPE;
+}
+
 //=============================================================================
 // W3DTreeBuffer::cull
 //=============================================================================
@@ -718,7 +841,13 @@ void W3DTreeBuffer::loadTreesInVertexAndIndexBuffers(RefRenderObjListIterator *p
 	}
 	
 	m_anythingChanged = false;
+	// Everything gets reloaded, so nothing is left to collapse.
+	m_numTreesToCollapse = 0;
 	Int curTree=0;
+	for (curTree=0; curTree<m_numTrees; curTree++) {
+		m_trees[curTree].bufferNdx = -1;
+	}
+	curTree = 0;
 	Int bNdx;
 	const GlobalData::TerrainLighting *objectLighting = TheGlobalData->m_terrainObjectsLighting[TheGlobalData->m_timeOfDay];
 	for (bNdx=0; bNdx<MAX_BUFFERS; bNdx++) {
@@ -792,8 +921,6 @@ void W3DTreeBuffer::loadTreesInVertexAndIndexBuffers(RefRenderObjListIterator *p
 
 
 			Int startVertex = m_curNumTreeVertices[bNdx];
-			m_trees[curTree].firstIndex = startVertex;
-			m_trees[curTree].bufferNdx = bNdx;
 			Int i;
 			Int numVertex = m_treeTypes[type].m_mesh->Peek_Model()->Get_Vertex_Count();
 			Vector3 *pVert = m_treeTypes[type].m_mesh->Peek_Model()->Get_Vertex_Array();
@@ -809,6 +936,9 @@ void W3DTreeBuffer::loadTreesInVertexAndIndexBuffers(RefRenderObjListIterator *p
 			if (m_curNumTreeIndices[bNdx]+3*numIndex+6 >= MAX_TREE_INDEX) {
 				break;
 			}
+			// Only trees that made it into the buffer get a place in it.
+			m_trees[curTree].firstIndex = startVertex;
+			m_trees[curTree].bufferNdx = bNdx;
 
 			const Vector2*uvs=m_treeTypes[type].m_mesh->Peek_Model()->Get_UV_Array_By_Index(0);
 			
@@ -988,13 +1118,16 @@ void W3DTreeBuffer::loadTreesInVertexAndIndexBuffers(RefRenderObjListIterator *p
 //=============================================================================
 // W3DTreeBuffer::updateVertexBuffer
 //=============================================================================
-/** Updates the push aside offset in vertex buffer. */
+/** Updates the push aside offset in vertex buffer for the active trees, and 
+collapses the trees deleted since the buffer was loaded. */
 //=============================================================================
 void W3DTreeBuffer::updateVertexBuffer(void)
 {
 	if (!m_indexTree[0] || !m_vertexTree[0] || !m_initialized) {
 		return;
 	}
+	Int numToCollapse = m_numTreesToCollapse;
+	m_numTreesToCollapse = 0;
 	Int bNdx;
 	for	(bNdx = 0; bNdx<MAX_BUFFERS; bNdx++) {
 		if (m_curNumTreeIndices[bNdx]==0) {
@@ -1012,7 +1145,25 @@ void W3DTreeBuffer::updateVertexBuffer(void)
 		VertexFormatXYZNDUV1 *curVb;
 
 		Int curTree;
-		for (curTree=0; curTree<m_numTrees; curTree++) {
+		Int k;
+		// Collapse deleted trees to a point, so their triangles have no area.
+		for (k=0; k<numToCollapse; k++) {
+			curTree = m_treesToCollapse[k];
+			if (m_trees[curTree].bufferNdx!=bNdx) {
+				continue;
+			}
+			curVb = vb+m_trees[curTree].firstIndex;
+			Int i;
+			for (i=0; i<m_collapseNumVertices[k]; i++) {
+				curVb->x = m_trees[curTree].location.X;
+				curVb->y = m_trees[curTree].location.Y;
+				curVb->z = m_trees[curTree].location.Z;
+				curVb++;
+			}
+		}
+
+		for (k=0; k<m_numActiveTrees; k++) {
+			curTree = m_activeTrees[k];
 			if (m_trees[curTree].bufferNdx!=bNdx) {
 				continue;
 			}
@@ -1149,6 +1300,8 @@ void W3DTreeBuffer::freeTreeBuffers(void)
 	m_dwTreeVertexShader = 0;
 }
 
+DECLARE_PERF_TIMER(Tree_UnitMoved)
+
 //=============================================================================
 // W3DTreeBuffer::unitMoved
 //=============================================================================
@@ -1156,6 +1309,7 @@ void W3DTreeBuffer::freeTreeBuffers(void)
 //=============================================================================
 void W3DTreeBuffer::unitMoved(Object *unit)
 {
+	USE_PERF_TIMER(Tree_UnitMoved)
 	if (unit->isKindOf(KINDOF_IMMOBILE)) {
 		// This is the initial positioning of the object, and we don't care. jba. [6/5/2003]
 		return;
@@ -1204,20 +1358,25 @@ void W3DTreeBuffer::unitMoved(Object *unit)
 					treeNdx = m_trees[treeNdx].nextInPartition;
 					continue;	//  Tree is deleted. [7/11/2003]
 				}
+				const W3DTreeDrawModuleData *data = m_treeTypes[m_trees[treeNdx].treeType].m_data;
+				if (data->m_framesToMoveOutward <= 2 && !data->m_doTopple) {
+					treeNdx = m_trees[treeNdx].nextInPartition;
+					continue;	// Tree doesn't react to units.
+				}
 				Coord3D delta;
 				delta.set(m_trees[treeNdx].location.X, m_trees[treeNdx].location.Y, m_trees[treeNdx].location.Z );
 				delta.sub(&pos);
 				if (radius*radius>delta.lengthSqr()) {
 					bool canTopple = unit->getCrusherLevel() > 1;
-					if (canTopple && m_treeTypes[m_trees[treeNdx].treeType].m_data->m_doTopple) {
+					if (canTopple && data->m_doTopple) {
 						// Give a vector with direction to thing.
 						Coord3D toppleVector;
 						toppleVector.set(m_trees[treeNdx].location.X, m_trees[treeNdx].location.Y, 0);
 						toppleVector.x -= unit->getPosition()->x;
 						toppleVector.y -= unit->getPosition()->y;
 						applyTopplingForce(m_trees+treeNdx, &toppleVector, 0, W3D_TOPPLE_OPTIONS_NONE);
-					} else if (m_treeTypes[m_trees[treeNdx].treeType].m_data->m_framesToMoveOutward>1) {
-						pushAsideTree(m_trees[treeNdx].drawableID, &pos, unit->getUnitDirectionVector2D(), unit->getID());
+					} else if (data->m_framesToMoveOutward>1) {
+						pushAside(treeNdx, &pos, unit->getUnitDirectionVector2D(), unit->getID());
 					}
 				}
 				treeNdx = m_trees[treeNdx].nextInPartition;
@@ -1290,6 +1449,13 @@ void W3DTreeBuffer::clearAllTrees(void)
 	for (i=0; i<PARTITION_WIDTH_HEIGHT*PARTITION_WIDTH_HEIGHT; i++) {
 		m_areaPartition[i] = END_OF_PARTITION;
 	}
+	for (i=0; i<CULL_BLOCKS_WIDTH_HEIGHT*CULL_BLOCKS_WIDTH_HEIGHT; i++) {
+		m_cullBlockBounds[i].Init_Empty();
+		m_cullBlockHasTrees[i] = false;
+		m_cullBlockVisible[i] = true;
+	}
+	m_numActiveTrees = 0;
+	m_numTreesToCollapse = 0;
 	m_numTreeTypes = 0;
 }
 
@@ -1303,12 +1469,11 @@ void W3DTreeBuffer::removeTree(DrawableID id)
 	Int i;
 	for (i=0; i<m_numTrees; i++) {
 		if (m_trees[i].drawableID == id) {
+			deleteTree(i);
 			m_trees[i].location = Vector3(0,0,0);
-			m_trees[i].treeType = DELETED_TREE_TYPE;
 			// Translate the bounding sphere of the model.
 			m_trees[i].bounds.Center = Vector3(0,0,0);
 			m_trees[i].bounds.Radius = 1;
-			m_anythingChanged = true;
 		}
 	}
 }
@@ -1320,20 +1485,38 @@ void W3DTreeBuffer::removeTree(DrawableID id)
 //=============================================================================
 void W3DTreeBuffer::removeTreesForConstruction(const Coord3D* pos, const GeometryInfo& geom, Real angle )
 {
-	// Just iterate all trees, as even non-collidable ones get removed. jba. [7/11/2003]
-	Int i;
-	for (i=0; i<m_numTrees; i++) {				// small, height,							radius,									minor radius
-		if (m_trees[i].treeType < 0) {
-			continue; // already deleted. jba [7/11/2003]
+	// Every tree is in the area partition, even non-collidable ones, so only the buckets 
+	// the building could reach need checking.
+	Real radius = geom.getBoundingCircleRadius() + 2*TREE_RADIUS_APPROX;
+	Int xIndex, yIndex, xMax, yMax;
+	Coord3D corner;
+	corner.set(pos->x-radius, pos->y-radius, 0);
+	Int bucket = getPartitionBucket(corner);
+	xIndex = bucket%PARTITION_WIDTH_HEIGHT;
+	yIndex = bucket/PARTITION_WIDTH_HEIGHT;
+	corner.set(pos->x+radius, pos->y+radius, 0);
+	bucket = getPartitionBucket(corner);
+	xMax = bucket%PARTITION_WIDTH_HEIGHT;
+	yMax = bucket/PARTITION_WIDTH_HEIGHT;
+
+	GeometryInfo info(GEOMETRY_CYLINDER, false, 5*TREE_RADIUS_APPROX, 2*TREE_RADIUS_APPROX, 2*TREE_RADIUS_APPROX);
+	Int i, j;
+	for (j=yIndex; j<=yMax; j++) {
+		for (i=xIndex; i<=xMax; i++) {
+			Int treeNdx;
+			for (treeNdx = m_areaPartition[i + PARTITION_WIDTH_HEIGHT*j]; treeNdx != END_OF_PARTITION; 
+					treeNdx = m_trees[treeNdx].nextInPartition) {
+				if (m_trees[treeNdx].treeType < 0) {
+					continue; // already deleted. jba [7/11/2003]
+				}
+				Coord3D treePos;
+				treePos.set(m_trees[treeNdx].location.X, m_trees[treeNdx].location.Y, m_trees[treeNdx].location.Z);
+				if (ThePartitionManager->geomCollidesWithGeom( pos, geom, angle, &treePos, info, 0.0f)) {
+					// remove it [7/11/2003]
+					deleteTree(treeNdx);
+				} 
+			}
 		}
-		GeometryInfo info(GEOMETRY_CYLINDER, false, 5*TREE_RADIUS_APPROX, 2*TREE_RADIUS_APPROX, 2*TREE_RADIUS_APPROX);
-		Coord3D treePos;
-		treePos.set(m_trees[i].location.X, m_trees[i].location.Y, m_trees[i].location.Z);
-		if (ThePartitionManager->geomCollidesWithGeom( pos, geom, angle, &treePos, info, 0.0f)) {
-			// remove it [7/11/2003]
-			m_trees[i].treeType = DELETED_TREE_TYPE;
-			m_anythingChanged = true;
-		} 
 	}
 }
 
@@ -1427,15 +1610,6 @@ void W3DTreeBuffer::addTree(DrawableID id, Coord3D location, Real scale, Real an
 		}
 		m_needToUpdateTexture = true;
 	}
-	if (data->m_framesToMoveOutward > 2 || data->m_doTopple) {
-		// Trees/grass that topples or gets pushed aside (outward) gets put in the area partition. jba [7/7/2003]
-		Short bucket = getPartitionBucket(location);
-		m_trees[m_numTrees].nextInPartition = m_areaPartition[bucket];
-		m_areaPartition[bucket] = m_numTrees;
-	} else {
-		m_trees[m_numTrees].nextInPartition = END_OF_PARTITION;
-	}
-
 	Real randomScale = GameClientRandomValueReal( 1.0f - randomScaleAmount, 1.0f+ randomScaleAmount );
 	m_trees[m_numTrees].sin = WWMath::Sin(angle);
 	m_trees[m_numTrees].cos = WWMath::Cos(angle);
@@ -1468,6 +1642,10 @@ void W3DTreeBuffer::addTree(DrawableID id, Coord3D location, Real scale, Real an
 	m_trees[m_numTrees].pushAsideCos = 1;
 	m_trees[m_numTrees].pushAsideSin = 1;
 	m_trees[m_numTrees].m_toppleState = TOPPLE_UPRIGHT;
+	m_trees[m_numTrees].active = false;
+	// Every tree goes in the area partition, it is used for culling as well as for 
+	// trees that topple or get pushed aside. 
+	addToPartition(m_numTrees);
 	m_numTrees++;
 }
 
@@ -1507,34 +1685,47 @@ void W3DTreeBuffer::pushAsideTree(DrawableID id, const Coord3D *pusherPos,
 	Int i;
 	for (i=0; i<m_numTrees; i++) {
 		if (m_trees[i].drawableID == id) {
-			UnsignedInt lastFrame = m_trees[i].lastFrameUpdated;
-			m_trees[i].lastFrameUpdated = TheGameLogic->getFrame();
-			if(m_trees[i].pushAsideSource == pusherID) {
-				if (m_trees[i].lastFrameUpdated - lastFrame < 3)
-					return; // already pushing. [5/28/2003]
-			}
-
-			if(m_trees[i].pushAside != 0.0f) {
-				return; // already pushing. [5/28/2003]
-			}
-			m_trees[i].pushAsideSource = pusherID;
-			Coord3D delta;
-			delta.set(m_trees[i].location.X, m_trees[i].location.Y, m_trees[i].location.Z);
-			delta.sub(pusherPos);
-
-			if (pusherDirection->x*delta.y - pusherDirection->y*delta.x > 0.0f) {
-				m_trees[i].pushAsideCos = -pusherDirection->y;
-				m_trees[i].pushAsideSin = pusherDirection->x;
-			} else {
-				m_trees[i].pushAsideCos = pusherDirection->y;
-				m_trees[i].pushAsideSin = -pusherDirection->x;
-			}
-			m_anyPushChanged = true;
-			m_trees[i].pushAsideDelta = 1.0f/(Real)m_treeTypes[m_trees[i].treeType].m_data->m_framesToMoveOutward;
+			pushAside(i, pusherPos, pusherDirection, pusherID);
 		}
 	}
 }
 
+//=============================================================================
+// W3DTreeBuffer::pushAside
+//=============================================================================
+/** Push sideways tree or grass, by index. */
+//=============================================================================
+void W3DTreeBuffer::pushAside(Int treeNdx, const Coord3D *pusherPos, 
+															const Coord3D *pusherDirection, ObjectID pusherID )
+{
+	TTree *tree = &m_trees[treeNdx];
+	UnsignedInt lastFrame = tree->lastFrameUpdated;
+	tree->lastFrameUpdated = TheGameLogic->getFrame();
+	if(tree->pushAsideSource == pusherID) {
+		if (tree->lastFrameUpdated - lastFrame < 3)
+			return; // already pushing. [5/28/2003]
+	}
+
+	if(tree->pushAside != 0.0f) {
+		return; // already pushing. [5/28/2003]
+	}
+	tree->pushAsideSource = pusherID;
+	Coord3D delta;
+	delta.set(tree->location.X, tree->location.Y, tree->location.Z);
+	delta.sub(pusherPos);
+
+	if (pusherDirection->x*delta.y - pusherDirection->y*delta.x > 0.0f) {
+		tree->pushAsideCos = -pusherDirection->y;
+		tree->pushAsideSin = pusherDirection->x;
+	} else {
+		tree->pushAsideCos = pusherDirection->y;
+		tree->pushAsideSin = -pusherDirection->x;
+	}
+	m_anyPushChanged = true;
+	tree->pushAsideDelta = 1.0f/(Real)m_treeTypes[tree->treeType].m_data->m_framesToMoveOutward;
+	activateTree(treeNdx);
+}
+
 DECLARE_PERF_TIMER(Tree_Render)
 
 //=============================================================================
@@ -1616,11 +1807,13 @@ void W3DTreeBuffer::drawTrees(CameraClass * camera, RefRenderObjListIterator *pD
 		TheW3DProjectedShadowManager->flushDecals(m_shadow->getTexture(0), SHADOW_DECAL);
 	}
 
-	// Update pushed aside and toppling trees.
-	for (curTree=0; curTree<m_numTrees; curTree++) {
+	// Update pushed aside and toppling trees.  Only the active trees can be moving.
+	Int k;
+	for (k=0; k<m_numActiveTrees; k++) {
 		if (pause) {
 			break;
 		}
+		curTree = m_activeTrees[k];
 		Int type = m_trees[curTree].treeType;
 		if (type<0) { // deleted.
 			continue;
@@ -1631,8 +1824,7 @@ void W3DTreeBuffer::drawTrees(CameraClass * camera, RefRenderObjListIterator *pD
 		} else if(m_trees[curTree].m_toppleState == TOPPLE_DOWN) {
 			if (m_treeTypes[type].m_data->m_killWhenToppled) {
 				if (m_trees[curTree].m_sinkFramesLeft==0) {
-					m_trees[curTree].treeType = DELETED_TREE_TYPE; // delete it. [7/11/2003]
-					m_anythingChanged = true; // need to regenerate trees. [7/11/2003]
+					deleteTree(curTree); // delete it. [7/11/2003]
 				}
 				m_trees[curTree].m_sinkFramesLeft--;
 				m_trees[curTree].location.Z -= m_treeTypes[type].m_data->m_sinkDistance/m_treeTypes[type].m_data->m_sinkFrames;
@@ -1652,11 +1844,35 @@ void W3DTreeBuffer::drawTrees(CameraClass * camera, RefRenderObjListIterator *pD
 	if (m_anythingChanged) {
 		loadTreesInVertexAndIndexBuffers(pDynamicLightsIterator);
 		m_anythingChanged = false;
-	} else if (m_anyPushChanged) {
+	} else if (m_anyPushChanged || m_numTreesToCollapse>0) {
 		m_anyPushChanged = false;
 		updateVertexBuffer();
 	}
 
+	// Drop the trees that have come to rest from the active list.  Toppled trees that
+	// don't sink have been written in their final position, and stay that way.
+	Int numActive = 0;
+	for (k=0; k<m_numActiveTrees; k++) {
+		curTree = m_activeTrees[k];
+		TTree *tree = &m_trees[curTree];
+		Bool atRest = true;
+		if (tree->treeType>=0) {
+			if (tree->m_toppleState == TOPPLE_UPRIGHT) {
+				atRest = tree->pushAsideDelta==0.0f;
+			} else if (tree->m_toppleState == TOPPLE_DOWN) {
+				atRest = !m_treeTypes[tree->treeType].m_data->m_killWhenToppled;
+			} else {
+				atRest = false;
+			}
+		}
+		if (atRest) {
+			tree->active = false;
+		} else {
+			m_activeTrees[numActive++] = curTree;
+		}
+	}
+	m_numActiveTrees = numActive;
+
 //#define DEBUG_TEXTURE 1
 #ifdef DEBUG_TEXTURE // Draw the combined texture for debugging. jba. [4/21/2003]
 	// Setup the vertex buffer, shader & texture.
@@ -1852,6 +2068,7 @@ void W3DTreeBuffer::applyTopplingForce( TTree *tree, const Coord3D* toppleDirect
 	m_anyPushChanged = true;
 	tree->m_mtx.Make_Identity();
 	tree->m_mtx.Set_Translation(tree->location);
+	activateTree(tree - m_trees);
 
 }
 
@@ -1962,9 +2179,9 @@ void W3DTreeBuffer::xfer( Xfer *xfer )
 	xfer->xferInt(&numTrees);
 	if (xfer->getXferMode() == XFER_LOAD)	{	
 		m_numTrees = 0;
-		for (i=0; i<PARTITION_WIDTH_HEIGHT*PARTITION_WIDTH_HEIGHT; i++) {
-			m_areaPartition[i] = END_OF_PARTITION;
-		}
+		m_numActiveTrees = 0;
+		m_numTreesToCollapse = 0;
+		rebuildPartition();
 	}
 
 	// Save trees. [8/11/2003]
@@ -2029,6 +2246,10 @@ void W3DTreeBuffer::xfer( Xfer *xfer )
 				curTree->m_options = tree.m_options;
 				curTree->m_mtx = tree.m_mtx;
 				curTree->m_sinkFramesLeft = tree.m_sinkFramesLeft;
+				if (curTree->m_toppleState != TOPPLE_UPRIGHT) {
+					activateTree(m_numTrees-1);
+					m_anyPushChanged = true;
+				}
 			}
 		}
 	}
@@ -38,6 +38,7 @@
 
 // USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
 #include "Common/BuildAssistant.h"
+#include "Common/GameEngine.h"
 #include "Common/GlobalData.h"
 #include "Common/Module.h"
 #include "Common/RandomValue.h"
@@ -140,19 +141,91 @@ static void normAngle(Real &angle)
 #define TERRAIN_SAMPLE_SIZE 40.0f
 static Real getHeightAroundPos(Real x, Real y)
 {
-	// terrain height + desired height offset == cameraOffset * actual zoom
-	Real terrainHeight = TheTerrainLogic->getGroundHeight(x, y);
-
-	// find best approximation of max terrain height we can see
-	Real terrainHeightMax = terrainHeight;
-	terrainHeightMax = max(terrainHeightMax, TheTerrainLogic->getGroundHeight(x+TERRAIN_SAMPLE_SIZE, y-TERRAIN_SAMPLE_SIZE));
-	terrainHeightMax = max(terrainHeightMax, TheTerrainLogic->getGroundHeight(x-TERRAIN_SAMPLE_SIZE, y-TERRAIN_SAMPLE_SIZE));
-	terrainHeightMax = max(terrainHeightMax, TheTerrainLogic->getGroundHeight(x+TERRAIN_SAMPLE_SIZE, y+TERRAIN_SAMPLE_SIZE));
-	terrainHeightMax = max(terrainHeightMax, TheTerrainLogic->getGroundHeight(x-TERRAIN_SAMPLE_SIZE, y+TERRAIN_SAMPLE_SIZE));
+	// terrain height + desired height offset == cameraOffset * actual zoom, and the
+	// best approximation of max terrain height we can see.  Done every frame, so in one batch.
+	const Int NUM_SAMPLES = 5;
+	Coord2D samples[NUM_SAMPLES];
+	Real heights[NUM_SAMPLES];
+	samples[0].x = x;			samples[0].y = y;
+	samples[1].x = x+TERRAIN_SAMPLE_SIZE;	samples[1].y = y-TERRAIN_SAMPLE_SIZE;
+	samples[2].x = x-TERRAIN_SAMPLE_SIZE;	samples[2].y = y-TERRAIN_SAMPLE_SIZE;
+	samples[3].x = x+TERRAIN_SAMPLE_SIZE;	samples[3].y = y+TERRAIN_SAMPLE_SIZE;
+	samples[4].x = x-TERRAIN_SAMPLE_SIZE;	samples[4].y = y+TERRAIN_SAMPLE_SIZE;
+	TheTerrainLogic->getGroundHeights(samples, heights, NUM_SAMPLES);
+
+	Real terrainHeightMax = heights[0];
+	for (Int i = 1; i < NUM_SAMPLES; i++)
+		terrainHeightMax = max(terrainHeightMax, heights[i]);
 
 	return terrainHeightMax;
 }
 
+#if defined(_DEBUG) || defined(_INTERNAL)
+//-------------------------------------------------------------------------------------------------
+/** Headless terrain pan benchmark.  Moves a copy of the view's camera over the loaded map along a 
+	* fixed path, a fast scroll up the diagonal and then back along the top edge, and has the terrain 
+	* catch up with it each step through updateCenter (and so flushDirtyBlocks), without drawing 
+	* anything.  Logs how long the terrain took per step. */
+//-------------------------------------------------------------------------------------------------
+static void runTerrainPanBenchmark( CameraClass *viewCamera, const Coord3D *lookAt, Int numFrames )
+{
+	Region3D extent;
+	TheTerrainLogic->getExtent( &extent );
+
+	// keep the camera where it is relative to what it looks at, and move what it looks at
+	CameraClass *camera = NEW_REF( CameraClass, (*viewCamera) );
+	Matrix3D transform = viewCamera->Get_Transform();
+	Vector3 offset = transform.Get_Translation();
+	offset.X -= lookAt->x;
+	offset.Y -= lookAt->y;
+
+	RefRenderObjListIterator *it = W3DDisplay::m_3DScene->createLightsIterator();
+
+	__int64 startTime64, endTime64, freq64, totalTime64 = 0, slowestTime64 = 0;
+	QueryPerformanceFrequency( (LARGE_INTEGER *)&freq64 );
+
+	// start from the beginning of the path, untimed, so the first step isn't a full rebuild
+	for( Int frame = -1; frame < numFrames; ++frame )
+	{
+		Real t = (frame < 0 || numFrames < 2) ? 0.0f : (Real)frame / (Real)(numFrames - 1);
+		Real x, y;
+		if( t < 0.5f )
+		{
+			x = t * 2.0f;
+			y = t * 2.0f;
+		}
+		else
+		{
+			x = (1.0f - t) * 2.0f;
+			y = 1.0f;
+		}
+		transform.Set_Translation( Vector3( extent.lo.x + x * extent.width() + offset.X, 
+																				extent.lo.y + y * extent.height() + offset.Y, offset.Z ) );
+		camera->Set_Transform( transform );
+
+		QueryPerformanceCounter( (LARGE_INTEGER *)&startTime64 );
+		TheTerrainRenderObject->updateCenter( camera, it );
+		QueryPerformanceCounter( (LARGE_INTEGER *)&endTime64 );
+		if( frame < 0 )
+			continue;
+
+		totalTime64 += endTime64 - startTime64;
+		if( endTime64 - startTime64 > slowestTime64 )
+			slowestTime64 = endTime64 - startTime64;
+	}
+
+	if( it )
+		W3DDisplay::m_3DScene->destroyLightsIterator( it );
+	REF_PTR_RELEASE( camera );
+
+	Real pathLength = sqrtf( extent.width() * extent.width() + extent.height() * extent.height() ) + extent.width();
+	DEBUG_LOG(( "Terrain pan benchmark: %d steps, %.1f world units per step\n", numFrames, pathLength / numFrames ));
+	DEBUG_LOG(( "  updateCenter: %.3f ms average, %.3f ms slowest\n",
+		(Real)((double)totalTime64 * 1000.0 / (double)freq64) / numFrames,
+		(Real)((double)slowestTime64 * 1000.0 / (double)freq64) ));
+}
+#endif
+
 
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
@@ -1086,6 +1159,18 @@ void W3DView::update(void)
 	//USE_PERF_TIMER(W3DView_updateView)
 	Bool recalcCamera = false;
 	Bool didScriptedMovement = false;
+
+#if defined(_DEBUG) || defined(_INTERNAL)
+	static Bool terrainPanBenchmarkRun = FALSE;
+	if (!terrainPanBenchmarkRun && TheGlobalData->m_terrainPanBenchmarkFrames > 0 && TheTerrainRenderObject && 
+			TheGameLogic->isInGame() && !TheGameLogic->isInShellGame())
+	{
+		// pan the terrain across the map we were given, log how long it took, and quit
+		terrainPanBenchmarkRun = TRUE;
+		runTerrainPanBenchmark(m_3DCamera, getPosition(), TheGlobalData->m_terrainPanBenchmarkFrames);
+		TheGameEngine->setQuitting(TRUE);
+	}
+#endif
 #ifdef LOG_FRAME_TIMES
 	__int64 curTime64,freq64;
 	static __int64 prevTime64=0;
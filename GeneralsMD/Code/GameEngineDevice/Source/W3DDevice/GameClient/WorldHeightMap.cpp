@@ -760,6 +760,143 @@ void WorldHeightMap::setCliffState(Int xIndex, Int yIndex, Bool state)
 	m_cellCliffState[yIndex*m_flipStateWidth + (xIndex >> 3)] = flagByte;
 }
 
+//=============================================================================
+// maxOfBlock
+//=============================================================================
+/** Highest of the (up to) 2x2 entries of a max height level starting at x,y. */
+//=============================================================================
+static UnsignedByte maxOfBlock(const std::vector<UnsignedByte> &level, Int width, Int height, Int x, Int y)
+{
+	Int ndx = x + y*width;
+	UnsignedByte maxHeight = level[ndx];
+	Bool haveRight = (x+1 < width);
+	if (haveRight && level[ndx+1] > maxHeight) maxHeight = level[ndx+1];
+	if (y+1 < height) {
+		ndx += width;
+		if (level[ndx] > maxHeight) maxHeight = level[ndx];
+		if (haveRight && level[ndx+1] > maxHeight) maxHeight = level[ndx+1];
+	}
+	return maxHeight;
+}
+
+//=============================================================================
+// buildMaxHeights
+//=============================================================================
+/** Builds the cell max heights, and the coarser levels of them up to a single
+entry for the whole map. */
+//=============================================================================
+void WorldHeightMap::buildMaxHeights(void)
+{
+	m_maxHeightLevels.clear();
+	if (!m_data || m_width < 2 || m_height < 2) return;
+
+	Int width = m_width-1;
+	Int height = m_height-1;
+	m_maxHeightLevels.push_back(std::vector<UnsignedByte>(width*height));
+	std::vector<UnsignedByte> &cells = m_maxHeightLevels.back();
+	Int x, y;
+	for (y=0; y<height; y++) {
+		for (x=0; x<width; x++) {
+			Int ndx = x + y*m_width;
+			UnsignedByte maxHeight = m_data[ndx];
+			if (m_data[ndx+1] > maxHeight) maxHeight = m_data[ndx+1];
+			if (m_data[ndx+m_width] > maxHeight) maxHeight = m_data[ndx+m_width];
+			if (m_data[ndx+m_width+1] > maxHeight) maxHeight = m_data[ndx+m_width+1];
+			cells[x + y*width] = maxHeight;
+		}
+	}
+
+	while (width > 1 || height > 1) {
+		Int newWidth = (width+1)/2;
+		Int newHeight = (height+1)/2;
+		m_maxHeightLevels.push_back(std::vector<UnsignedByte>(newWidth*newHeight));
+		const std::vector<UnsignedByte> &prev = m_maxHeightLevels[m_maxHeightLevels.size()-2];
+		std::vector<UnsignedByte> &level = m_maxHeightLevels.back();
+		for (y=0; y<newHeight; y++) {
+			for (x=0; x<newWidth; x++) {
+				level[x + y*newWidth] = maxOfBlock(prev, width, height, 2*x, 2*y);
+			}
+		}
+		width = newWidth;
+		height = newHeight;
+	}
+}
+
+//=============================================================================
+// updateMaxHeights
+//=============================================================================
+/** Redoes the max heights above the 4 cells that share the height value at
+xIndex, yIndex. */
+//=============================================================================
+void WorldHeightMap::updateMaxHeights(Int xIndex, Int yIndex)
+{
+	Int width = m_width-1;
+	Int height = m_height-1;
+	Int minX = __max(xIndex-1, 0);
+	Int minY = __max(yIndex-1, 0);
+	Int maxX = __min(xIndex, width-1);
+	Int maxY = __min(yIndex, height-1);
+	if (minX > maxX || minY > maxY) return;
+
+	Int x, y;
+	std::vector<UnsignedByte> &cells = m_maxHeightLevels[0];
+	for (y=minY; y<=maxY; y++) {
+		for (x=minX; x<=maxX; x++) {
+			Int ndx = x + y*m_width;
+			UnsignedByte maxHeight = m_data[ndx];
+			if (m_data[ndx+1] > maxHeight) maxHeight = m_data[ndx+1];
+			if (m_data[ndx+m_width] > maxHeight) maxHeight = m_data[ndx+m_width];
+			if (m_data[ndx+m_width+1] > maxHeight) maxHeight = m_data[ndx+m_width+1];
+			cells[x + y*width] = maxHeight;
+		}
+	}
+
+	for (Int i=1; i<(Int)m_maxHeightLevels.size(); i++) {
+		const std::vector<UnsignedByte> &prev = m_maxHeightLevels[i-1];
+		std::vector<UnsignedByte> &level = m_maxHeightLevels[i];
+		Int newWidth = (width+1)/2;
+		minX >>= 1; minY >>= 1; maxX >>= 1; maxY >>= 1;
+		for (y=minY; y<=maxY; y++) {
+			for (x=minX; x<=maxX; x++) {
+				level[x + y*newWidth] = maxOfBlock(prev, width, height, 2*x, 2*y);
+			}
+		}
+		width = newWidth;
+		height = (height+1)/2;
+	}
+}
+
+//=============================================================================
+// getMaxHeightInCells
+//=============================================================================
+/** Goes up the max height levels until the range fits in 2x2 entries, so the
+answer takes at most 4 lookups. */
+//=============================================================================
+UnsignedByte WorldHeightMap::getMaxHeightInCells(Int minX, Int minY, Int maxX, Int maxY)
+{
+	if (m_maxHeightLevels.empty()) {
+		buildMaxHeights();
+		if (m_maxHeightLevels.empty()) return K_MAX_HEIGHT;
+	}
+
+	Int width = m_width-1;
+	Int height = m_height-1;
+	minX = __max(minX, 0);
+	minY = __max(minY, 0);
+	maxX = __min(maxX, width-1);
+	maxY = __min(maxY, height-1);
+	if (minX > maxX || minY > maxY) return 0;
+
+	Int level = 0;
+	while (maxX-minX > 1 || maxY-minY > 1) {
+		minX >>= 1; minY >>= 1; maxX >>= 1; maxY >>= 1;
+		width = (width+1)/2;
+		height = (height+1)/2;
+		level++;
+	}
+	return maxOfBlock(m_maxHeightLevels[level], width, height, minX, minY);
+}
+
 Bool WorldHeightMap::ParseWorldDictDataChunk(DataChunkInput &file, DataChunkInfo *info, void *userData)
 {
 	Dict d = file.readDict();
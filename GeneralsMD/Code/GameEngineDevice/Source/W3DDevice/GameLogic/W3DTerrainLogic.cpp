@@ -299,6 +299,22 @@ Real W3DTerrainLogic::getGroundHeight( Real x, Real y, Coord3D* normal ) const
 #endif
 }  // end getHight
 
+//-------------------------------------------------------------------------------------------------
+/** W3D specific batched get height function for logical terrain */
+//-------------------------------------------------------------------------------------------------
+void W3DTerrainLogic::getGroundHeights( const Coord2D *points, Real *heights, Int count ) const
+{
+	if (TheTerrainRenderObject) 
+	{
+		TheTerrainRenderObject->getHeightMapHeights(points, heights, count);
+	}	
+	else 
+	{
+		for (Int i = 0; i < count; i++)
+			heights[i] = 0;
+	}
+}  // end getGroundHeights
+
 //-------------------------------------------------------------------------------------------------
 /** Get the height considering the layer. */
 //-------------------------------------------------------------------------------------------------
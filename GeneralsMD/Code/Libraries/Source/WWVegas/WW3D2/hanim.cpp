@@ -48,6 +48,20 @@
 
 
 
+/*
+**
+**	HAnimClass
+**
+**
+*/
+
+HAnimClass::~HAnimClass(void)
+{
+	// Trees may be sharing poses computed from this animation
+	HTreeClass::Forget_Anim(this);
+}
+
+
 /*
 **
 **	HAnimComboClass
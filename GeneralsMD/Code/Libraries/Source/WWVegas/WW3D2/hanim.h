@@ -84,7 +84,7 @@ public:
 
 	HAnimClass(void)	:
 		EmbeddedSoundBoneIndex (EMBEDDED_SOUND_BONE_INDEX_NOT_SET)	{ }
-	virtual ~HAnimClass(void)		{ }
+	virtual ~HAnimClass(void);
 
 	virtual const char *		Get_Name(void) const = 0;
 	virtual const char *		Get_HName(void) const = 0;
@@ -46,6 +46,8 @@
  *   HCompressedAnimClass::read_bit_channel -- read a bit channel from the file                *
  *   HCompressedAnimClass::add_bit_channel -- install a bit channel into the animation         *
  *   HCompressedAnimClass::Get_Visibility -- return visibility state for given pivot/frame     *
+ *   HCompressedAnimClass::get_decoded_frame -- returns a frame of the animation, decoded      *
+ *   HCompressedAnimClass::decode_frame -- decodes every pivot of an adaptive delta frame      *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 
@@ -56,6 +58,7 @@
 #include "chunkio.h"
 #include "w3d_file.h"
 #include "wwdebug.h"
+#include "wwprofile.h"
 #include <string.h>
 #include <nstrdup.h>
 
@@ -158,6 +161,176 @@ NodeCompressedMotionStruct::~NodeCompressedMotionStruct()
 }  // ~NodeCompressedMotionStruct
 
 
+/*
+** Decoded frames of adaptive delta animations, see HCompressedAnimClass::Set_Frame_Cache_Budget.
+** Each frame holds the channel values of every pivot at one whole frame number, so a query at
+** a fractional frame interpolates between two of them exactly the way the channels would.
+*/
+#define DECODED_FRAME_HASH_SIZE	1024
+
+struct DecodedFrameStruct
+{
+	const HCompressedAnimClass *	Anim;
+	int									Frame;
+	int									Bytes;
+	DecodedFrameStruct *				HashNext;
+	DecodedFrameStruct *				LRUPrev;				// towards the most recently used
+	DecodedFrameStruct *				LRUNext;
+	Vector3 *							Translation;		// per pivot, zero where there's no channel
+	Quaternion *						Orientation;		// per pivot, identity where there's no channel
+};
+
+class DecodedFrameCacheClass
+{
+public:
+
+	DecodedFrameCacheClass(void);
+	~DecodedFrameCacheClass(void)		{ Free_All(); }
+
+	DecodedFrameStruct *		Find(const HCompressedAnimClass * anim,int frame);
+	DecodedFrameStruct *		Create(const HCompressedAnimClass * anim,int frame,int num_pivots);
+	void							Remove_Anim(const HCompressedAnimClass * anim);
+	void							Free_All(void);
+	void							Set_Budget(int bytes)		{ Budget = bytes; trim(NULL); }
+
+	int							Budget;
+	int							Bytes;
+	int							Hits;
+	int							Misses;
+	float							DecodeSeconds;
+
+private:
+
+	static unsigned int		hash(const HCompressedAnimClass * anim,int frame)	{ return ((((unsigned int)anim) >> 4) * 31 + frame) & (DECODED_FRAME_HASH_SIZE - 1); }
+	void							link_at_head(DecodedFrameStruct * entry);
+	void							unlink(DecodedFrameStruct * entry);
+	void							remove(DecodedFrameStruct * entry);
+	void							trim(DecodedFrameStruct * keep);
+
+	DecodedFrameStruct *		Hash[DECODED_FRAME_HASH_SIZE];
+	DecodedFrameStruct *		Head;
+	DecodedFrameStruct *		Tail;
+};
+
+static DecodedFrameCacheClass	_DecodedFrameCache;
+
+DecodedFrameCacheClass::DecodedFrameCacheClass(void) :
+	Budget(0),
+	Bytes(0),
+	Hits(0),
+	Misses(0),
+	DecodeSeconds(0.0f),
+	Head(NULL),
+	Tail(NULL)
+{
+	memset(Hash,0,sizeof(Hash));
+}
+
+DecodedFrameStruct * DecodedFrameCacheClass::Find(const HCompressedAnimClass * anim,int frame)
+{
+	DecodedFrameStruct * entry = Hash[hash(anim,frame)];
+	while (entry != NULL) {
+		if ((entry->Anim == anim) && (entry->Frame == frame)) {
+			if (entry != Head) {
+				unlink(entry);
+				link_at_head(entry);
+			}
+			return entry;
+		}
+		entry = entry->HashNext;
+	}
+	return NULL;
+}
+
+DecodedFrameStruct * DecodedFrameCacheClass::Create(const HCompressedAnimClass * anim,int frame,int num_pivots)
+{
+	DecodedFrameStruct * entry = W3DNEW DecodedFrameStruct;
+	entry->Anim = anim;
+	entry->Frame = frame;
+	entry->Bytes = sizeof(DecodedFrameStruct) + num_pivots * (sizeof(Vector3) + sizeof(Quaternion));
+	entry->Translation = MSGW3DNEWARRAY("HCompressedAnimClass::DecodedFrame") Vector3[num_pivots];
+	entry->Orientation = MSGW3DNEWARRAY("HCompressedAnimClass::DecodedFrame") Quaternion[num_pivots];
+
+	unsigned int bucket = hash(anim,frame);
+	entry->HashNext = Hash[bucket];
+	Hash[bucket] = entry;
+	link_at_head(entry);
+	Bytes += entry->Bytes;
+
+	// make room, but never by throwing away the frame the caller is about to use
+	trim(entry);
+	return entry;
+}
+
+void DecodedFrameCacheClass::Remove_Anim(const HCompressedAnimClass * anim)
+{
+	DecodedFrameStruct * entry = Head;
+	while (entry != NULL) {
+		DecodedFrameStruct * next = entry->LRUNext;
+		if (entry->Anim == anim) {
+			remove(entry);
+		}
+		entry = next;
+	}
+}
+
+void DecodedFrameCacheClass::Free_All(void)
+{
+	while (Head != NULL) {
+		remove(Head);
+	}
+}
+
+void DecodedFrameCacheClass::link_at_head(DecodedFrameStruct * entry)
+{
+	entry->LRUPrev = NULL;
+	entry->LRUNext = Head;
+	if (Head != NULL) {
+		Head->LRUPrev = entry;
+	} else {
+		Tail = entry;
+	}
+	Head = entry;
+}
+
+void DecodedFrameCacheClass::unlink(DecodedFrameStruct * entry)
+{
+	if (entry->LRUPrev != NULL) {
+		entry->LRUPrev->LRUNext = entry->LRUNext;
+	} else {
+		Head = entry->LRUNext;
+	}
+	if (entry->LRUNext != NULL) {
+		entry->LRUNext->LRUPrev = entry->LRUPrev;
+	} else {
+		Tail = entry->LRUPrev;
+	}
+}
+
+void DecodedFrameCacheClass::remove(DecodedFrameStruct * entry)
+{
+	unlink(entry);
+
+	DecodedFrameStruct ** link = &Hash[hash(entry->Anim,entry->Frame)];
+	while (*link != entry) {
+		link = &((*link)->HashNext);
+	}
+	*link = entry->HashNext;
+
+	Bytes -= entry->Bytes;
+	delete[] entry->Translation;
+	delete[] entry->Orientation;
+	delete entry;
+}
+
+void DecodedFrameCacheClass::trim(DecodedFrameStruct * keep)
+{
+	while ((Bytes > Budget) && (Tail != NULL) && (Tail != keep)) {
+		remove(Tail);
+	}
+}
+
+
 /*********************************************************************************************** 
  * HCompressedAnimClass::HCompressedAnimClass -- constructor                                   * 
  *                                                                                             * 
@@ -217,6 +390,8 @@ void HCompressedAnimClass::Free(void)
 	if (NodeMotion != NULL) {
 		delete[] NodeMotion;
 	}
+
+	_DecodedFrameCache.Remove_Anim(this);
 }
 
 
@@ -540,6 +715,16 @@ void HCompressedAnimClass::Get_Translation( Vector3& trans, int pividx, float fr
 			if (motion->tc.Z) motion->tc.Z->Get_Vector(frame, &(trans[2]));
 			break;
 		case ANIM_FLAVOR_ADAPTIVE_DELTA:
+			if (_DecodedFrameCache.Budget > 0) {
+				uint32 frame1 = frame;
+				float ratio = frame - frame1;
+				Vector3 trans1 = get_decoded_frame(frame1)->Translation[pividx];
+				const Vector3 & trans2 = get_decoded_frame(frame1 + 1)->Translation[pividx];
+				if (motion->ad.X) trans[0] = WWMath::Lerp(trans1[0],trans2[0],ratio);
+				if (motion->ad.Y) trans[1] = WWMath::Lerp(trans1[1],trans2[1],ratio);
+				if (motion->ad.Z) trans[2] = WWMath::Lerp(trans1[2],trans2[2],ratio);
+				break;
+			}
 			if (motion->ad.X) motion->ad.X->Get_Vector(frame, &(trans[0]));
 			if (motion->ad.Y) motion->ad.Y->Get_Vector(frame, &(trans[1]));
 			if (motion->ad.Z) motion->ad.Z->Get_Vector(frame, &(trans[2]));
@@ -570,8 +755,16 @@ void HCompressedAnimClass::Get_Orientation(Quaternion& q, int pividx,float frame
 			else q.Make_Identity();
 			break;
 		case ANIM_FLAVOR_ADAPTIVE_DELTA:
-			if (NodeMotion[pividx].ad.Q) q = NodeMotion[pividx].ad.Q->Get_QuatVector(frame);
-			else q.Make_Identity();
+			if (NodeMotion[pividx].ad.Q == NULL) {
+				q.Make_Identity();
+			} else if (_DecodedFrameCache.Budget > 0) {
+				uint32 frame1 = frame;
+				Quaternion q1 = get_decoded_frame(frame1)->Orientation[pividx];
+				const Quaternion & q2 = get_decoded_frame(frame1 + 1)->Orientation[pividx];
+				Fast_Slerp(q, q1, q2, frame - frame1);
+			} else {
+				q = NodeMotion[pividx].ad.Q->Get_QuatVector(frame);
+			}
 			break;
 		default:
 			WWASSERT(0); // unknown flavor
@@ -608,6 +801,27 @@ void HCompressedAnimClass::Get_Transform( Matrix3D& mtx, int pividx, float frame
 			if (motion->tc.Z) motion->tc.Z->Get_Vector(frame, &(mtx[2][3]));
 			break;
 		case ANIM_FLAVOR_ADAPTIVE_DELTA:
+			if (_DecodedFrameCache.Budget > 0) {
+				uint32 frame1 = frame;
+				float ratio = frame - frame1;
+				const DecodedFrameStruct * decoded1 = get_decoded_frame(frame1);
+				Vector3 trans1 = decoded1->Translation[pividx];
+				Quaternion q1 = decoded1->Orientation[pividx];
+				const DecodedFrameStruct * decoded2 = get_decoded_frame(frame1 + 1);
+
+				if (motion->ad.Q) {
+					Quaternion q;
+					Fast_Slerp(q, q1, decoded2->Orientation[pividx], ratio);
+					::Build_Matrix3D(q,mtx);
+				}
+				else mtx.Make_Identity();
+
+				if (motion->ad.X) mtx[0][3] = WWMath::Lerp(trans1[0],decoded2->Translation[pividx][0],ratio);
+				if (motion->ad.Y) mtx[1][3] = WWMath::Lerp(trans1[1],decoded2->Translation[pividx][1],ratio);
+				if (motion->ad.Z) mtx[2][3] = WWMath::Lerp(trans1[2],decoded2->Translation[pividx][2],ratio);
+				break;
+			}
+
 			if (NodeMotion[pividx].ad.Q) {
 				Quaternion q;
 				q = NodeMotion[pividx].ad.Q->Get_QuatVector(frame);
@@ -651,6 +865,121 @@ bool HCompressedAnimClass::Get_Visibility(int pividx,float frame)
 
 
 
+/***********************************************************************************************
+ * HCompressedAnimClass::get_decoded_frame -- returns a frame of the animation, decoded        *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * frame_idx - whole frame number, clamped to the last frame like the channels do              *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * The frame may be thrown away by the next call, copy out what you need first.               *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+const DecodedFrameStruct * HCompressedAnimClass::get_decoded_frame(int frame_idx) const
+{
+	WWASSERT(NumFrames > 0);
+	if ((uint32)frame_idx >= (uint32)NumFrames) frame_idx = NumFrames - 1;
+
+	DecodedFrameStruct * decoded = _DecodedFrameCache.Find(this,frame_idx);
+	if (decoded != NULL) {
+		_DecodedFrameCache.Hits++;
+		return decoded;
+	}
+
+	_DecodedFrameCache.Misses++;
+	decoded = _DecodedFrameCache.Create(this,frame_idx,NumNodes);
+
+	float seconds = 0.0f;
+	{
+		WWMeasureItClass measure(&seconds);
+		decode_frame(decoded);
+	}
+	_DecodedFrameCache.DecodeSeconds += seconds;
+	return decoded;
+}
+
+/***********************************************************************************************
+ * HCompressedAnimClass::decode_frame -- decodes every pivot of an adaptive delta frame        *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Doing the pivots one after the other keeps each channel's own two frame window useful,     *
+ * the next frame along will usually already be sitting in it.                                 *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void HCompressedAnimClass::decode_frame(DecodedFrameStruct * decoded) const
+{
+	WWASSERT(Flavor == ANIM_FLAVOR_ADAPTIVE_DELTA);
+	uint32 frame = decoded->Frame;
+
+	for (int pividx = 0; pividx < NumNodes; pividx++) {
+		struct NodeCompressedMotionStruct * motion = &NodeMotion[pividx];
+
+		Vector3 & trans = decoded->Translation[pividx];
+		trans.Set(0.0f,0.0f,0.0f);
+		if (motion->ad.X) trans[0] = motion->ad.X->getframe(frame);
+		if (motion->ad.Y) trans[1] = motion->ad.Y->getframe(frame);
+		if (motion->ad.Z) trans[2] = motion->ad.Z->getframe(frame);
+
+		Quaternion & q = decoded->Orientation[pividx];
+		if (motion->ad.Q) {
+			q.Set(motion->ad.Q->getframe(frame, 0),
+					motion->ad.Q->getframe(frame, 1),
+					motion->ad.Q->getframe(frame, 2),
+					motion->ad.Q->getframe(frame, 3));
+		} else {
+			q.Make_Identity();
+		}
+	}
+}
+
+void HCompressedAnimClass::Set_Frame_Cache_Budget(int bytes)
+{
+	_DecodedFrameCache.Set_Budget(bytes);
+}
+
+int HCompressedAnimClass::Get_Frame_Cache_Budget(void)
+{
+	return _DecodedFrameCache.Budget;
+}
+
+void HCompressedAnimClass::Free_Frame_Cache(void)
+{
+	if (_DecodedFrameCache.Hits + _DecodedFrameCache.Misses > 0) {
+		int hits,misses;
+		float decode_seconds,saved_seconds;
+		Get_Frame_Cache_Stats(hits,misses,decode_seconds,saved_seconds);
+		WWDEBUG_SAY(("Decoded frame cache: %d hits, %d misses (%.1f%% hit), %.3fs decoding, about %.3fs saved\n",
+			hits,misses,100.0f * hits / (hits + misses),decode_seconds,saved_seconds));
+	}
+	_DecodedFrameCache.Free_All();
+}
+
+void HCompressedAnimClass::Get_Frame_Cache_Stats(int & hits,int & misses,float & decode_seconds,float & saved_seconds)
+{
+	hits = _DecodedFrameCache.Hits;
+	misses = _DecodedFrameCache.Misses;
+	decode_seconds = _DecodedFrameCache.DecodeSeconds;
+
+	// every hit would have cost about what an average miss did
+	saved_seconds = (misses > 0) ? hits * (decode_seconds / misses) : 0.0f;
+}
+
+void HCompressedAnimClass::Reset_Frame_Cache_Stats(void)
+{
+	_DecodedFrameCache.Hits = 0;
+	_DecodedFrameCache.Misses = 0;
+	_DecodedFrameCache.DecodeSeconds = 0.0f;
+}
+
+
 /***********************************************************************************************
  * HAnimClass::Is_Node_Motion_Present -- return true if there is motion defined for this frame *
  *                                                                                             *
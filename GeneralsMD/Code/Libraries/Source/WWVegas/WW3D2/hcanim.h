@@ -58,6 +58,7 @@ class AdaptiveDeltaMotionChannelClass;
 class HTreeClass;
 class ChunkLoadClass;
 class ChunkSaveClass;
+struct DecodedFrameStruct;
 
 
 /**********************************************************************************
@@ -110,6 +111,17 @@ public:
 	bool							Has_Rotation (int pividx);
 	bool							Has_Visibility (int pividx);
 
+	// Decoded frame cache.  Getting a frame out of an adaptive delta channel means walking
+	// the deltas forward from the last frame that channel decoded, which is slow when many
+	// units are sampling the same animation at different frames.  With a budget set, each
+	// frame is decoded for every pivot at once and kept, least recently used frames going
+	// first once the budget is used up.  A budget of zero turns the cache off.
+	static void					Set_Frame_Cache_Budget(int bytes);
+	static int					Get_Frame_Cache_Budget(void);
+	static void					Free_Frame_Cache(void);
+	static void					Get_Frame_Cache_Stats(int & hits,int & misses,float & decode_seconds,float & saved_seconds);
+	static void					Reset_Frame_Cache_Stats(void);
+
 private:
 
 	char							Name[2*W3D_NAME_LEN];
@@ -132,6 +144,9 @@ private:
 	bool read_bit_channel(ChunkLoadClass & cload,TimeCodedBitChannelClass * * newchan);
 	void add_bit_channel(TimeCodedBitChannelClass * newchan);
 
+	const DecodedFrameStruct * get_decoded_frame(int frame_idx) const;
+	void decode_frame(DecodedFrameStruct * decoded) const;
+
 };
 
 
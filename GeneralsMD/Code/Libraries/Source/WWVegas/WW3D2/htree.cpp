@@ -63,6 +63,33 @@
 #include "hrawanim.h"
 #include "motchan.h"
 
+
+/*
+** Poses shared between copies of the same tree, see HTreeClass::Enable_Pose_Sharing.
+** The cache is direct mapped on (tree, anim, frame); a collision simply throws the
+** older pose away, so the only cost of a miss is one extra pass over the pivots.
+*/
+#define SHARED_POSE_CACHE_SIZE	256
+
+struct SharedPoseStruct
+{
+	unsigned int		TreeID;					// 0 for an empty slot
+	float					ScaleFactor;
+	HAnimClass *		Motion;
+	float					Frame;
+	int					NumPivots;
+	int					Capacity;
+	Matrix3D *			Transform;				// relative to the root pivot
+	bool *				IsVisible;
+};
+
+static SharedPoseStruct		_SharedPoses[SHARED_POSE_CACHE_SIZE];
+static int						_SharedPoseHits = 0;
+static int						_SharedPoseMisses = 0;
+
+bool				HTreeClass::PoseSharingEnabled = false;
+unsigned int	HTreeClass::NextPoseSourceID = 1;
+
 /*********************************************************************************************** 
  * HTreeClass::HTreeClass -- constructor                                                       * 
  *                                                                                             * 
@@ -78,7 +105,8 @@
 HTreeClass::HTreeClass(void) :
 	NumPivots(0),
 	Pivot(NULL),
-	ScaleFactor(1.0f)
+	ScaleFactor(1.0f),
+	PoseSourceID(NextPoseSourceID++)
 {
 }
 
@@ -139,7 +167,8 @@ HTreeClass::~HTreeClass(void)
 HTreeClass::HTreeClass(const HTreeClass & src) :
 	NumPivots(0),
 	Pivot(NULL),
-	ScaleFactor(1.0f)
+	ScaleFactor(1.0f),
+	PoseSourceID(src.PoseSourceID)
 {
 	memcpy(&Name,&src.Name,sizeof(Name));
 
@@ -365,6 +394,9 @@ void HTreeClass::Free(void)
 
 	// Also clean up other members:
 	ScaleFactor = 1.0f;
+
+	// Whatever gets loaded next won't have the old base pose
+	PoseSourceID = NextPoseSourceID++;
 }
 
 
@@ -560,6 +592,22 @@ void HTreeClass::Base_Update(const Matrix3D & root)
  *   08/11/1997 GH  : Created.                                                                 * 
  *=============================================================================================*/
 void HTreeClass::Anim_Update(const Matrix3D & root,HAnimClass * motion,float frame)
+{
+	if (!PoseSharingEnabled || any_bones_captured()) {
+		anim_update(root,motion,frame);
+		return;
+	}
+
+	bool found;
+	SharedPoseStruct * pose = find_shared_pose(motion,frame,&found);
+	if (!found) {
+		anim_update(Matrix3D::Identity,motion,frame);
+		save_shared_pose(*pose,motion,frame);
+	}
+	apply_shared_pose(root,*pose,motion->Get_Num_Pivots());
+}
+
+void HTreeClass::anim_update(const Matrix3D & root,HAnimClass * motion,float frame)
 {
 	PivotClass *pivot;
 	Matrix3D mtx;
@@ -609,6 +657,28 @@ void HTreeClass::Anim_Update(const Matrix3D & root,HAnimClass * motion,float fra
 /*Customized version of the above which excludes interpolation and assumes HRawAnimClass
 For use by 'Generals' -MW*/
 void HTreeClass::Anim_Update(const Matrix3D & root,HRawAnimClass * motion,float frame)
+{
+	//Get integer frame
+	int iframe=WWMath::Float_To_Long(frame);
+	if (iframe >= motion->Get_Num_Frames()) 
+		iframe = 0;
+
+	if (!PoseSharingEnabled || any_bones_captured()) {
+		anim_update(root,motion,iframe);
+		return;
+	}
+
+	// The pose only depends on the integer frame, so that's what it's shared under
+	bool found;
+	SharedPoseStruct * pose = find_shared_pose(motion,(float)iframe,&found);
+	if (!found) {
+		anim_update(Matrix3D::Identity,motion,iframe);
+		save_shared_pose(*pose,motion,(float)iframe);
+	}
+	apply_shared_pose(root,*pose,motion->Get_Num_Pivots());
+}
+
+void HTreeClass::anim_update(const Matrix3D & root,HRawAnimClass * motion,int iframe)
 {
 	PivotClass *pivot,*endpivot,*lastAnimPivot;
 
@@ -618,11 +688,6 @@ void HTreeClass::Anim_Update(const Matrix3D & root,HRawAnimClass * motion,float
 
 	int num_anim_pivots = motion->Get_Num_Pivots ();
 
-	//Get integer frame
-	int iframe=WWMath::Float_To_Long(frame);
-	if (iframe >= motion->Get_Num_Frames()) 
-		iframe = 0;
-
 	Vector3 trans;
 	Quaternion q;
 	Matrix3D mtx;
@@ -685,6 +750,156 @@ void HTreeClass::Anim_Update(const Matrix3D & root,HRawAnimClass * motion,float
 }								
 
 
+bool HTreeClass::any_bones_captured(void) const
+{
+	for (int piv_idx=1; piv_idx < NumPivots; piv_idx++) {
+		if (Pivot[piv_idx].Is_Captured()) return true;
+	}
+	return false;
+}
+
+/*********************************************************************************************** 
+ * HTreeClass::find_shared_pose -- finds the cache slot for this tree's pose at a frame        * 
+ *                                                                                             * 
+ * INPUT:                                                                                      * 
+ * motion - animation being played                                                             * 
+ * frame - frame of the animation, exactly as the pose is evaluated                            * 
+ * found - set to true if the slot already holds the pose                                      * 
+ *                                                                                             * 
+ * OUTPUT:                                                                                     * 
+ * the slot the pose lives in, or should be saved to                                           * 
+ *                                                                                             * 
+ * WARNINGS:                                                                                   * 
+ *                                                                                             * 
+ * HISTORY:                                                                                    * 
+ *=============================================================================================*/
+SharedPoseStruct * HTreeClass::find_shared_pose(HAnimClass * motion,float frame,bool * found) const
+{
+	unsigned int hash = PoseSourceID * 2654435761u;
+	hash ^= ((unsigned int)motion >> 4) * 40503u;
+	hash ^= (unsigned int)WWMath::Float_To_Long(frame * 8.0f) * 19u;
+	hash = (hash ^ (hash >> 16)) & (SHARED_POSE_CACHE_SIZE - 1);
+
+	SharedPoseStruct * pose = &_SharedPoses[hash];
+	*found =	(pose->TreeID == PoseSourceID) && 
+				(pose->ScaleFactor == ScaleFactor) && 
+				(pose->Motion == motion) && 
+				(pose->Frame == frame);
+
+	if (*found) {
+		WWASSERT(pose->NumPivots == NumPivots);
+		_SharedPoseHits++;
+	} else {
+		_SharedPoseMisses++;
+	}
+	return pose;
+}
+
+/*********************************************************************************************** 
+ * HTreeClass::save_shared_pose -- keeps the pose just evaluated (with an identity root)       * 
+ *                                                                                             * 
+ * INPUT:                                                                                      * 
+ *                                                                                             * 
+ * OUTPUT:                                                                                     * 
+ *                                                                                             * 
+ * WARNINGS:                                                                                   * 
+ *                                                                                             * 
+ * HISTORY:                                                                                    * 
+ *=============================================================================================*/
+void HTreeClass::save_shared_pose(SharedPoseStruct & pose,HAnimClass * motion,float frame) const
+{
+	if (pose.Capacity < NumPivots) {
+		delete[] pose.Transform;
+		delete[] pose.IsVisible;
+		pose.Transform = MSGW3DNEWARRAY("HTreeClass::SharedPose") Matrix3D[NumPivots];
+		pose.IsVisible = MSGW3DNEWARRAY("HTreeClass::SharedPose") bool[NumPivots];
+		pose.Capacity = NumPivots;
+	}
+
+	pose.TreeID = PoseSourceID;
+	pose.ScaleFactor = ScaleFactor;
+	pose.Motion = motion;
+	pose.Frame = frame;
+	pose.NumPivots = NumPivots;
+
+	for (int piv_idx=0; piv_idx < NumPivots; piv_idx++) {
+		pose.Transform[piv_idx] = Pivot[piv_idx].Transform;
+		pose.IsVisible[piv_idx] = Pivot[piv_idx].IsVisible;
+	}
+}
+
+/*********************************************************************************************** 
+ * HTreeClass::apply_shared_pose -- puts a shared pose on this tree's root                     * 
+ *                                                                                             * 
+ * INPUT:                                                                                      * 
+ *                                                                                             * 
+ * OUTPUT:                                                                                     * 
+ *                                                                                             * 
+ * WARNINGS:                                                                                   * 
+ * Same as Anim_Update, the pivots the animation has no data for keep their visibility.       * 
+ *                                                                                             * 
+ * HISTORY:                                                                                    * 
+ *=============================================================================================*/
+void HTreeClass::apply_shared_pose(const Matrix3D & root,const SharedPoseStruct & pose,int num_anim_pivots)
+{
+	int piv_idx;
+
+	Pivot[0].Transform = root;
+	Pivot[0].IsVisible = true;
+
+	for (piv_idx=1; piv_idx < NumPivots; piv_idx++) {
+		Matrix3D::Multiply(root, pose.Transform[piv_idx], &(Pivot[piv_idx].Transform));
+	}
+
+	int num_vis_pivots = MIN(num_anim_pivots, NumPivots);
+	for (piv_idx=1; piv_idx < num_vis_pivots; piv_idx++) {
+		Pivot[piv_idx].IsVisible = pose.IsVisible[piv_idx];
+	}
+}
+
+/*********************************************************************************************** 
+ * HTreeClass::Forget_Anim -- drops any shared poses of an animation that's going away         * 
+ *                                                                                             * 
+ * INPUT:                                                                                      * 
+ *                                                                                             * 
+ * OUTPUT:                                                                                     * 
+ *                                                                                             * 
+ * WARNINGS:                                                                                   * 
+ *                                                                                             * 
+ * HISTORY:                                                                                    * 
+ *=============================================================================================*/
+void HTreeClass::Forget_Anim(HAnimClass * motion)
+{
+	for (int i=0; i<SHARED_POSE_CACHE_SIZE; i++) {
+		if (_SharedPoses[i].Motion == motion) {
+			_SharedPoses[i].TreeID = 0;
+			_SharedPoses[i].Motion = NULL;
+		}
+	}
+}
+
+void HTreeClass::Free_Shared_Poses(void)
+{
+	for (int i=0; i<SHARED_POSE_CACHE_SIZE; i++) {
+		delete[] _SharedPoses[i].Transform;
+		delete[] _SharedPoses[i].IsVisible;
+		memset(&_SharedPoses[i],0,sizeof(SharedPoseStruct));
+	}
+}
+
+void HTreeClass::Get_Pose_Sharing_Stats(int & hits,int & misses)
+{
+	hits = _SharedPoseHits;
+	misses = _SharedPoseMisses;
+}
+
+void HTreeClass::Reset_Pose_Sharing_Stats(void)
+{
+	_SharedPoseHits = 0;
+	_SharedPoseMisses = 0;
+}
+
+
 /***********************************************************************************************
  * HTreeClass::Blend_Update -- computes each pivot as a blend of two anims                     *
  *                                                                                             *
@@ -1122,6 +1337,7 @@ HTreeClass * HTreeClass::Alter_Avatar_HTree( const HTreeClass *tree, Vector3 &sc
 		new_tree->Pivot[pi].BaseTransform.Set_Translation( new_relative_vector );
 	}
 
+	new_tree->PoseSourceID = NextPoseSourceID++;
 	return new_tree;
 }
 
@@ -1156,6 +1372,7 @@ HTreeClass * HTreeClass::Create_Morphed(	int num_morph_sources,
 		new_tree->Pivot[pi].BaseTransform.Set_Translation( pos );
 	}
 
+	new_tree->PoseSourceID = NextPoseSourceID++;
 	return new_tree;
 }
 
@@ -1188,6 +1405,7 @@ HTreeClass * HTreeClass::Create_Interpolated(	const HTreeClass * tree_a0_b0,
 		new_tree->Pivot[pi].BaseTransform.Set_Translation( pos );
 	}
 
+	new_tree->PoseSourceID = NextPoseSourceID++;
 	return new_tree;
 }
 
@@ -1226,6 +1444,7 @@ HTreeClass * HTreeClass::Create_Interpolated(const HTreeClass * tree_base,
 		}
 	}
 
+	new_tree->PoseSourceID = NextPoseSourceID++;
 	return new_tree;
 }
 
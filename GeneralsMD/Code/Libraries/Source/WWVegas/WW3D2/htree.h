@@ -56,6 +56,7 @@ class MeshClass;
 class ChunkLoadClass;
 class ChunkSaveClass;
 class HRawAnimClass;
+struct SharedPoseStruct;
 
 /*
 
@@ -159,16 +160,38 @@ public:
 														   const HTreeClass * tree_b, 
 														   float a_scale, float b_scale );
 
+	// Pose sharing.  Copies of the same tree playing the same frame of the same
+	// animation end up in the same pose relative to their root, so when this is
+	// enabled Anim_Update evaluates the pose once, keeps it, and hands it to the
+	// other copies.  Trees with captured bones always evaluate their own pose.
+	static void			Enable_Pose_Sharing(bool onoff)		{ PoseSharingEnabled = onoff; }
+	static bool			Is_Pose_Sharing_Enabled(void)			{ return PoseSharingEnabled; }
+	static void			Forget_Anim(HAnimClass * motion);
+	static void			Free_Shared_Poses(void);
+	static void			Get_Pose_Sharing_Stats(int & hits,int & misses);
+	static void			Reset_Pose_Sharing_Stats(void);
+
 private:
 
 	char					Name[W3D_NAME_LEN];
 	int					NumPivots;
 	PivotClass *		Pivot;
 	float					ScaleFactor;
+	unsigned int		PoseSourceID;		// copies of a tree share this, along with their base pose
 
 	void					Free(void);	
 	bool					read_pivots(ChunkLoadClass & cload,bool pre30);
 
+	void					anim_update(const Matrix3D & root,HAnimClass * motion,float frame);
+	void					anim_update(const Matrix3D & root,HRawAnimClass * motion,int iframe);
+	bool					any_bones_captured(void) const;
+	void					apply_shared_pose(const Matrix3D & root,const SharedPoseStruct & pose,int num_anim_pivots);
+	void					save_shared_pose(SharedPoseStruct & pose,HAnimClass * motion,float frame) const;
+	SharedPoseStruct *	find_shared_pose(HAnimClass * motion,float frame,bool * found) const;
+
+	static bool			PoseSharingEnabled;
+	static unsigned int	NextPoseSourceID;
+
 	friend class MeshClass;
 
 
@@ -2051,11 +2051,22 @@ void MeshGeometryClass::Scale(const Vector3 &sc)
 // Destination pointers MUST point to arrays large enough to hold all vertices
 void MeshGeometryClass::get_deformed_vertices(Vector3 *dst_vert,const HTreeClass * htree)
 {
+	int vertex_count=Get_Vertex_Count();
 	Vector3 * src_vert = Vertex->Get_Array();
 	uint16 * bonelink = VertexBoneLink->Get_Array();
-	for (int vi = 0; vi < Get_Vertex_Count(); vi++) {
-		const Matrix3D & tm = htree->Get_Transform(bonelink[vi]);
-		Matrix3D::Transform_Vector(tm, src_vert[vi], &(dst_vert[vi]));
+
+	// The vertices are sorted by bone, so transform each bone's run in one go
+	for (int vi = 0; vi < vertex_count;) {
+		int idx=bonelink[vi];
+		int cnt;
+		for (cnt = vi; cnt < vertex_count; cnt++) {
+			if (idx!=bonelink[cnt]) {
+				break;
+			}
+		}
+
+		VectorProcessorClass::Transform(dst_vert+vi,src_vert+vi,htree->Get_Transform(idx),cnt-vi);
+		vi=cnt;
 	}
 }
 
@@ -2074,11 +2085,6 @@ void MeshGeometryClass::get_deformed_vertices(Vector3 *dst_vert, Vector3 *dst_no
 	uint16 * bonelink = VertexBoneLink->Get_Array();
 
 	for (vi = 0; vi < vertex_count;) {
-		const Matrix3D & tm = htree->Get_Transform(bonelink[vi]);
-
-		// Make a copy so we can set the translation to zero
-		Matrix3D mytm=tm;		
-
 		int idx=bonelink[vi];
 		int cnt;
 		for (cnt = vi; cnt < vertex_count; cnt++) {
@@ -2087,9 +2093,8 @@ void MeshGeometryClass::get_deformed_vertices(Vector3 *dst_vert, Vector3 *dst_no
 			}
 		}
 
-		VectorProcessorClass::Transform(dst_vert+vi,src_vert+vi,mytm,cnt-vi);
-		mytm.Set_Translation(Vector3(0.0f,0.0f,0.0f));
-		VectorProcessorClass::Transform(dst_norm+vi,src_norm+vi,mytm,cnt-vi);
+		// Points and normals together, the normals skip the translation
+		VectorProcessorClass::Transform(dst_vert+vi,dst_norm+vi,src_vert+vi,src_norm+vi,htree->Get_Transform(idx),cnt-vi);
 		vi=cnt;
 	}
 }
@@ -118,6 +118,8 @@
 #include "dx8texman.h"
 #include "formconv.h"
 #include "animatedsoundmgr.h"
+#include "htree.h"
+#include "hcanim.h"
 #include "static_sort_list.h"
 
 #include "shdlib.h"
@@ -378,6 +380,16 @@ WW3DErrorType WW3D::Shutdown(void)
 	*/
 	AnimatedSoundMgrClass::Shutdown ();
 
+	/*
+	** Release the poses shared between hierarchy trees
+	*/
+	HTreeClass::Free_Shared_Poses();
+
+	/*
+	** Release the decoded animation frames
+	*/
+	HCompressedAnimClass::Free_Frame_Cache();
+
 	IsInitted = false;
 	return WW3D_ERROR_OK;
 }
@@ -312,6 +312,96 @@ void VectorProcessorClass::Transform (Vector3* dst,const Vector3 *src, const Mat
 	}
 }
 
+// Used for CPU skinning, where each bone's vertices are usually only a few dozen long.  The SSE
+// version keeps the transposed matrix in registers for the whole run and writes both outputs
+// without the alignment dance of the single array version, which doesn't pay for short runs.
+void VectorProcessorClass::Transform(Vector3* dst_vert,Vector3* dst_norm,const Vector3 *src_vert,const Vector3 *src_norm, const Matrix3D& mtx, const int count)
+{
+	if (count<=0) return;
+
+	WWASSERT(dst_vert != src_vert && dst_norm != src_norm);
+
+#if defined (__ICL) || (defined (_MSC_VER) && _MSC_VER >= 1300)	// Compilers whose inline assembler knows SSE
+	if (CPUDetectClass::_Has_SSE_Instruction_Set()) {
+
+		__asm	{
+			mov		ebx,mtx
+			mov		eax,src_vert
+			mov		esi,src_norm
+			mov		edx,dst_vert
+			mov		edi,dst_norm
+			mov		ecx,count
+
+			movups	xmm4,[ebx+0]
+			movups	xmm5,[ebx+16]
+			movups	xmm6,[ebx+32]
+			movups	xmm7,lastrow
+
+			TRANSPOSE(xmm4, xmm5, xmm6, xmm7, xmm0);
+
+			// Duplicate x into the bottom lane so a result can go out with movss+movhps
+			shufps	xmm4,xmm4,SHUFFLE(2,1,0,0)
+			shufps	xmm5,xmm5,SHUFFLE(2,1,0,0)
+			shufps	xmm6,xmm6,SHUFFLE(2,1,0,0)
+			shufps	xmm7,xmm7,SHUFFLE(2,1,0,0)
+
+			align	16
+
+		_lp:
+			movss	xmm0,[eax]
+			BROADCAST(xmm0,0)
+			movss	xmm1,[eax+4]
+			BROADCAST(xmm1,0)
+			movss	xmm2,[eax+8]
+			BROADCAST(xmm2,0)
+			mulps	xmm0,xmm4
+			mulps	xmm1,xmm5
+			mulps	xmm2,xmm6
+			addps	xmm0,xmm1
+			addps	xmm0,xmm2
+			addps	xmm0,xmm7
+			movss	[edx],xmm0
+			movhps	[edx+4],xmm0
+
+			movss	xmm1,[esi]
+			BROADCAST(xmm1,0)
+			movss	xmm2,[esi+4]
+			BROADCAST(xmm2,0)
+			movss	xmm3,[esi+8]
+			BROADCAST(xmm3,0)
+			mulps	xmm1,xmm4
+			mulps	xmm2,xmm5
+			mulps	xmm3,xmm6
+			addps	xmm1,xmm2
+			addps	xmm1,xmm3
+			movss	[edi],xmm1
+			movhps	[edi+4],xmm1
+
+			add		eax,12
+			add		esi,12
+			add		edx,12
+			add		edi,12
+			dec		ecx
+			jnz		_lp
+		}
+
+	}
+	else
+#endif
+	{
+		for (int i=0; i<count; i++) {
+			const Vector3 & v = src_vert[i];
+			const Vector3 & n = src_norm[i];
+			dst_vert[i].X = mtx[0][0]*v.X + mtx[0][1]*v.Y + mtx[0][2]*v.Z + mtx[0][3];
+			dst_vert[i].Y = mtx[1][0]*v.X + mtx[1][1]*v.Y + mtx[1][2]*v.Z + mtx[1][3];
+			dst_vert[i].Z = mtx[2][0]*v.X + mtx[2][1]*v.Y + mtx[2][2]*v.Z + mtx[2][3];
+			dst_norm[i].X = mtx[0][0]*n.X + mtx[0][1]*n.Y + mtx[0][2]*n.Z;
+			dst_norm[i].Y = mtx[1][0]*n.X + mtx[1][1]*n.Y + mtx[1][2]*n.Z;
+			dst_norm[i].Z = mtx[2][0]*n.X + mtx[2][1]*n.Y + mtx[2][2]*n.Z;
+		}
+	}
+}
+
 void VectorProcessorClass::Transform(Vector4* dst,const Vector3 *src, const Matrix4x4& matrix, const int count)
 {
 	if (count<=0) return;
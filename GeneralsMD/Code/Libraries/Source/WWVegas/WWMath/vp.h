@@ -36,6 +36,7 @@
  *---------------------------------------------------------------------------------------------*
  * Functions:                                                                                  *
  * Transform - transforms a vector array given  Matrix3D                                       *
+ * Transform - transforms a vertex and a normal array given a Matrix3D                         *
  * Copy - Copies data from source to destination                                                *
  * CopyIndexed-copies dst[]=src[index[]]                                                        *
  * Clear - clears array to zero                                                                 *
@@ -63,6 +64,8 @@ class VectorProcessorClass
 public:
 	static void Transform(Vector3* dst,const Vector3 *src, const Matrix3D& matrix, const int count);
 	static void Transform(Vector4* dst,const Vector3 *src, const Matrix4x4& matrix, const int count);
+	// Points and normals of a skin run in one pass; the normals only get the rotation part of the matrix
+	static void Transform(Vector3* dst_vert,Vector3* dst_norm,const Vector3 *src_vert,const Vector3 *src_norm, const Matrix3D& matrix, const int count);
 	static void Copy(unsigned *dst,const unsigned *src, const int count);
 	static void Copy(Vector2 *dst,const Vector2 *src, const int count);
 	static void Copy(Vector3 *dst,const Vector3 *src, const int count);